@@ -162,3 +162,138 @@ const uint64_t LIST[22][NWORDS64_FIELD] = {
 	  0xBA0C2E509FC0510B, 0x957E35D641D5DDB5, 0x922F901AA4A236D8, 0xCBFA24C0F7E172E3, 0xB05A32F88CB5B9DC, 0x00001DC7A766A676 },
 	{ 0x6128F8C2B276D2A1, 0x857530A2A633CE28, 0xEB624F41494C5D1E, 0x3FA62AE33B92CCA8, 0x11BCABB4CC4FBE22, 0x91EA14743FDBAC70, 
 	  0x9876F7DF900DC277, 0x375FD25E09091CBA, 0x580F3084B099A111, 0x58E9B3FB623FB297, 0x957732F791F6C337, 0x00000B070F784B99 } };
+
+// Entries -1/(1+(4+i)*r^2) of LIST_SQR_R that are squares in GF(p751^2), in Montgomery representation.
+// Elligator 2 x-coordinates derived from them have a quadratic character that is known from that of A.
+const uint64_t LIST_SQR[2*NLIST_SQR][NWORDS64_FIELD] = {
+	{ 0x7E0E3CF3F602CC03, 0x240AE231C56EB636, 0x1630875FADB3CA47, 0x3FDF66239B9021FE, 0x4FA6BEA94AAE8287, 0x20BD32942BAEF1D9,
+	  0x3DBE52BE754CD223, 0xD46D6B986A4C461E, 0x31772CCF6AB0EC49, 0x0362808B445792BE, 0xA57068B23D5D4F04, 0x0000233188CFA1F9 },
+	{ 0xDB72B65CA8D1D274, 0x286A73457D063FD5, 0x7355642D132BA567, 0x2A970D9461C0DC41, 0x93D2A07ED36F3BCC, 0xFD59A18D2D03447E,
+	  0xBC047FB33098286A, 0x153E65AE22E4D2F0, 0xBC3F628AF44DDCEB, 0xCF8C49463A2BEC5D, 0x64D31CBF9A0FAE5B, 0x00000E88DF789F48 },
+	{ 0xAE911D5E41FDE1D5, 0x09FD291EAE9A7528, 0xD94DB04CE76D674F, 0xF269A050B317A36A, 0x1010C2464C5B488A, 0x165E22C0571F72CE,
+	  0xB649686CDD7FAA40, 0xC65F833CCBC8E854, 0xA1DC607E92B4EC01, 0x6A9F6EA6C5D5598C, 0xB73B45E033D20693, 0x0000126974812437 },
+	{ 0x5CFEB9EE80FF8802, 0x641C991F35243E77, 0x109BF7F4D15352D9, 0xF57027C40F2AEC39, 0x78834C224A9E8F4D, 0x3B53C38C5DDA4903,
+	  0x2472CAD0E4A1DD20, 0x91121637EFEFBFEB, 0x555DDF1E4E875433, 0xD185E0CEBC9A6BF8, 0x247E7766FEA9846A, 0x00004E24131398C0 },
+	{ 0xF2BF1FF8427C7315, 0x591042D093B90137, 0x23EF8D48782832C9, 0x8DFB39E92296E3D6, 0x0C39FF556BEBDD42, 0x369F6980A4270C5D,
+	  0x901F9AD6FCBAA761, 0x0E8E81D435F5FC7F, 0x9A795B9A8409D3D3, 0xD29FB9AE4384290F, 0x3B58F53DD7270C90, 0x00001E27D50D0631 },
+	{ 0x7EF889C1569E078D, 0x8B4790D31AFC6D2F, 0x24BAD80FCF2607D2, 0x13C099586804EDD0, 0x0B219830D09F67F8, 0xFEEBDD0A795A4E0D,
+	  0x2C86D567D8A5A5C6, 0x29EFDB5516CD064B, 0xAFB0A05F0230B35C, 0x73FCFA65EC7C5CB4, 0x245E08DC310C14E1, 0x00001778AC2903DF },
+	{ 0xC6A87C086F2D688B, 0xEED31365A04F0271, 0xDD794EC2839C94AF, 0xC44E3E055437B751, 0x3142657FE154FC23, 0x1DDF0CFBD23B842C,
+	  0x296FCD68D2FC7C39, 0x5C4A194057D29FB2, 0x8F30F49E5BA63348, 0x0E7E025BF677DA6C, 0x5C82F322B8A3FDEF, 0x000008AD1CA35C8B },
+	{ 0x3A3BFF3721098530, 0x824A369C8B3C963D, 0xB219A0EB683FDAE4, 0xC295F4F55A5823E2, 0x300BD325BE00F96B, 0xDB57A4065DF208B8,
+	  0xB9F6AC61C292FA06, 0x549C1848CF3B2F74, 0x97947250AB99EF56, 0x0886598989ABB8DF, 0x33CD656F751DF788, 0x00001CDD11D356B0 },
+	{ 0x6A46D8C167411EFE, 0x930D3D3383D0F2D6, 0x101C4891A6B55EE4, 0xC2212322E01BDDBE, 0x081EA06791C63376, 0xB1B61EAD4902CCC4,
+	  0xFBF9C77D054B0ECB, 0x2302BB264C94FC47, 0xCFC5A3C4A3EE5846, 0xFB15F41F987AFFED, 0x8AD464F7DCC6C862, 0x00005C85EF562260 },
+	{ 0x9A8268961AD2526E, 0x7B6AE33EF4AEBE8C, 0x89873213F33AAEE4, 0x2B1824660389C7B7, 0x39522B8C207F7831, 0x6A821D2F97D60589,
+	  0x1365BB5B03A6BA60, 0x0A5C08C42E1CF932, 0x9D1FE9B5BB603352, 0x8E8423BB6C490C58, 0xB38D876E03458460, 0x00004A74FCD5574C },
+	{ 0x299A329EB58FC342, 0x8DAE5B001FB1D4CF, 0x75295EC155F4F843, 0xD54AEED26ED9F41D, 0x0CE287BBE18A021A, 0x5692E2B9A5789719,
+	  0x691C09B666A5ABCB, 0xA8CED50F46B731AF, 0x288D8D919428B7CC, 0x6E8878BB01CE4B03, 0x846745764A4ACFF9, 0x00005CDDC2DC51C6 },
+	{ 0x49B69DCE6F052D13, 0x61F560B59D93EE02, 0x1075957F6D299C8E, 0x146C8F15C733E112, 0x8B40727998000ED3, 0xF57E11DE16F01A35,
+	  0x85D487C43B32DDC7, 0x202E717224D5AE24, 0x59A38B5D0FFE627D, 0x6160CA0E3458A732, 0x3B08DC02C1AEC132, 0x0000432B39FCCA53 },
+	{ 0x19526217450EFC00, 0x6CB3509EDCB85645, 0x287D4F7457090D17, 0x07846F4274B76345, 0xA02FB740C6CB2F56, 0x17D47CFAB49C68A0,
+	  0xB6912BB65B508782, 0x1934394AFE0FC95A, 0xA91399330A9DFCFB, 0x65DE1274B9B9743F, 0x28ABFE3C4FA6A47E, 0x0000549B8524E407 },
+	{ 0x0D1BDC2D87E8F722, 0xFDEEC136BAC83959, 0xA04EEC25CBCB68A3, 0xBC9001CA1E984E9C, 0x69E38AFF30860445, 0xFF8E0221F51A558A,
+	  0x09839077091E1FCB, 0x92CE96AB606E58DF, 0xE8473228C00F982D, 0x5F4A7BA161B1AFDF, 0xEC12DA5D498C0D14, 0x000055BFDB2DF684 },
+	{ 0x3BC85F795E135FC5, 0x5155AABDC79F9BE1, 0xB253D470091EC11B, 0x7756A2C31E13F5C7, 0x652D6A2D4BC2608D, 0x004B56E446F14AD8,
+	  0x945135EFFA4BEEFB, 0xB061A27D5A375219, 0x5869665D9D9790FA, 0x17CB609D23C8613F, 0x4C2947C4913A584A, 0x000030B62FAEDE21 },
+	{ 0xF6FC9B98C1120384, 0x88466047539EAD45, 0xC3D6FA8F7A275AEE, 0xE839CCAFEC832CC1, 0x2AEB761879B4B43C, 0x944B3B4EC1E498E4,
+	  0x5418DFFEF6A79532, 0xBB0F65C716FE1FD0, 0xD87DA6C4F4404069, 0x80E3DA4534C6CB1D, 0x838E722DF9C801D8, 0x000057254D3DA6B9 },
+	{ 0xA2F44211C69EB4FB, 0xAD92273BB9B88E8A, 0x23669021494DABE3, 0x01B9D0E5219B54E1, 0x24156867647CF2EB, 0x2F1CE5063B2E2E2C,
+	  0xCCDB779D6E7A8D81, 0x21FE7955230EC3A7, 0xA85DF39CA7E8A599, 0xF782ACB451BD1DF7, 0x68BE9C91764DFD67, 0x000030852024E56B },
+	{ 0x3884D3F464868DE2, 0x6AC90D39F449BDE0, 0x2EA1C9F77A1E3BEA, 0x5801C693A9B4D85D, 0xD3283330C82E28A1, 0x051F0448DB9CF149,
+	  0x658EFFB6729E6480, 0x04269BE01709A82D, 0xF8589041EB474D09, 0xC9C301E4970F3570, 0x4269FD53224A5D47, 0x00003BF3F448E235 },
+	{ 0x2CBBCB833B8EBA00, 0x8707FA4908E21E20, 0xAD7ED652815637A5, 0xBA2A2BBBE51A460D, 0x0C5D0E4740C1FCC9, 0x5FDB18F417659907,
+	  0x0A1FFD6FFB7FC64C, 0xE9BF02BF2C3EEAEA, 0xC5C872DC969FDD66, 0x2427A2756ABAB997, 0x3B01A93267B7CAB1, 0x00002B92A31A639A },
+	{ 0xBDE1BDF4E151946F, 0x02ACBD3CD21323E9, 0x58CF469EC3DB4534, 0xD3D8260A86AD9BA5, 0x49B38F850E018B33, 0x7CB89BAEFD0C85AE,
+	  0xC210A0DD6BF49886, 0x3B58583C093963DB, 0xC437BBCC52FA409A, 0x1107925FD3AD49B4, 0xC0E54AD6AC41D609, 0x000000F6C57560F1 },
+	{ 0x9F997642A09B5510, 0x748B1312DB7268F6, 0x923714AE2C112606, 0x544048AF0793B7C1, 0xE87815E2A88833D2, 0x8AC72FAFAC35A50D,
+	  0xD9EC4047F4D16A7F, 0x1354DB33219965F8, 0xB3C6AEBFB0106AB4, 0xF5C349579CF115DA, 0x453A7FEFC88A0DE8, 0x000029E664853C0F },
+	{ 0x5BFD3A2BE68CE08A, 0xA542ADF39DBDB450, 0x637F017112EFB7D2, 0x5C36C4C96722532D, 0x722C400F2AD53A74, 0xEBE0974BA64847B1,
+	  0xF52DE94279B1E3BE, 0xB575D0EAC2139053, 0x83BDA426DDA6BBDB, 0xFED4E777CBA6E43C, 0xF7BC4C2461580031, 0x000019B2B3472E80 },
+	{ 0x11829D91142826B7, 0x256B90CEB659A7CD, 0xC0EF1D582E0499A3, 0x7BFE6B196E68B8E1, 0x8895B1F7872E933F, 0xF8F442CE9E5C07BD,
+	  0xE9CEC1449A6B2DBE, 0x2C562693F5429204, 0xCBD60737494763D6, 0xD17D0AE993D55D04, 0x463B7AB6A6EDBC69, 0x0000456267CDF1B2 },
+	{ 0xD263CE6CF8FBF9AB, 0x9607945F518D1534, 0x1245B8FD4905511E, 0x4C5B14532FDFE4A9, 0xED892F454B283E8E, 0xB4A7EF9B84E39908,
+	  0x9FC5F149C458764A, 0x2D149326D6C2AFA2, 0xBD6CA39D675319F5, 0xB12E89D50CF12F85, 0xEAAA8266316F0530, 0x000055AD9CED6A89 },
+	{ 0x2471A43B583333EB, 0x52A7E4EECCD01413, 0x424D57E1125DA8FF, 0xE0D5155BFCDDFA1E, 0x86E8BE9AD562901A, 0x3130217C0FCEE9F0,
+	  0xC4F634AAEB6D4DBC, 0xB9F9023D4ADF7BDF, 0x7339F5F989C7E3FD, 0x92390CECA5AD5AD7, 0xE94DFAD5745CEEFA, 0x00005D57921A2E34 },
+	{ 0x565E044F4AFEEED4, 0xBB121C3C08CFE7A5, 0x605278EE10E1207A, 0x3D9B1CDB49EF9F14, 0xF63D67DB93C9392F, 0xF86E3F6EF66ECCFE,
+	  0xC4B7E66E4CC11D89, 0x91AB7582E993BD2F, 0xCC81AE7FCEC35706, 0x05E4C5979344E362, 0x5C53A5695FB6E622, 0x0000166979F6B49A },
+	{ 0x2E06115DD882ECDF, 0x85938D51204FA6D0, 0x5E7DCA9AAF3957A9, 0x4C5EA7326B7C4936, 0x5E5AE505F24CC79C, 0x15BE87033C9E9EE4,
+	  0x655DABB39B0323BB, 0x1575E24D86D2B26D, 0xC5724C6799F7C906, 0x279BB49AD67733C6, 0xB0783F974DA14027, 0x000049653CE57D5E },
+	{ 0x36AD74A2A2BCB8E1, 0x8C74748C83ACF976, 0x6C7A5C2D18B75814, 0x2A197A98FB92B482, 0x2002FB6C80FE7429, 0x02FFDE6386EB98C5,
+	  0x9A4F3652E7E32B6E, 0xB51A2658241DFE4F, 0x4FD00C660F9276EF, 0x0CC9E6269CFD4407, 0x99D6AC41968E2219, 0x0000079D728C820E },
+	{ 0x0C5B057ED0F64AA2, 0xDEBB46F4CCF800A2, 0x9B1DD30AF272CFC1, 0xEF9CB1B5D762B8CD, 0x1D3AC805E2FDDDDD, 0xA802D92A7FB65439,
+	  0xDB2B0025C224E108, 0xE24ECB932C9BB27D, 0x9749AD8A573CCD42, 0x0637BCA07FCB5124, 0x897EEB8DF60E8724, 0x000006AF242B21CF },
+	{ 0x4C3B821F59327D2E, 0x5FDC9712317A36B8, 0x1BBDD92D35727DFC, 0x5EFDDA0BB83ED01B, 0xC339EE343B4EE9EB, 0x6F79F0F850C5F8D0,
+	  0x4A0B062F746F626E, 0x1C39F177D55EB5E3, 0xDD6F3B2B72ADF2D5, 0x5F15E0BE4E6FE2B5, 0x4B1785B417A1CB5E, 0x00001EFF4AB95550 },
+	{ 0xCCEB631DAFE29139, 0x1BD19DAA3CC9C1D0, 0xDFEE759344B5E914, 0x3920F09CB0C5B538, 0x84188F1E4861F0A5, 0x8C749CE710AE5F5E,
+	  0x90D8EA1F9486B148, 0x43ABEDF8FA90DCDF, 0xCCDE23CBC0367C25, 0xAEBD9339B5E7B9EA, 0xED02E690FCF87E32, 0x0000666780A65178 },
+	{ 0x06ADC09753D8327E, 0x096E48F49CD6980A, 0x42CC6C8C50AFF008, 0x96D5811B33BD8916, 0x825332DA600AF1F5, 0xFE30D28733756EF1,
+	  0x20428A5747A1737A, 0x1E7B56B377AEE9EA, 0xA086BE203D34CA57, 0x7819B88BEC48F65A, 0xA209B90F59778963, 0x000000ADE4881926 },
+	{ 0xE06EF0EB9C24E93B, 0x11B3ED3F3A3AB5DB, 0x4C77A94316A008E5, 0xD5441F8D3E156B89, 0x9B236329408C85D2, 0xF8C6F78B1B739757,
+	  0xF0C8E9E03C84602F, 0x75B7F5AC5368C0C2, 0xDFE21ED373FE424A, 0x309472426537411B, 0xD5E53260F682F997, 0x000047818F629896 },
+	{ 0x389820FB77CBF590, 0x5B0521FE73B6568A, 0x23B6B6EFCAB73BB5, 0x9CD72269FE5D2D02, 0xEF60B21DD6DBFCD6, 0x9A75EC90F2C8175A,
+	  0x8B0F1E6C3EAC55BD, 0x5A8B15A15E6988BA, 0xD9CB0B2054417DF1, 0x1D058E8A7ED17C2B, 0xF01A86546ECEDA24, 0x00004A931F9576FE },
+	{ 0x53B00327CED146F4, 0xCA05DC8129BF90B2, 0x82170AC3E26837A0, 0x1E6D90AEDEE79D76, 0x82076595D45C3757, 0xD84C0A164A2E1557,
+	  0x5BB822B1CFAFA8A7, 0x8570E023A91F070E, 0x237885C0C6300F88, 0x3D904C5D32667B80, 0x01CC60152D8AF67C, 0x0000505825D98286 },
+	{ 0xD7515E2CE8F9BB4D, 0xBDDC3C7413B2B155, 0x8E1F8D7624E8EB50, 0xC403FCCE0AAA5253, 0x6A99566953E484C1, 0x62689645AC512F71,
+	  0x9AB450FA2B452794, 0xAE2E4DF4723163CD, 0x1B9FB880BE7C1BA0, 0xDF623C5B21B70B4F, 0x73D92689229E9DA6, 0x00004A7FB2981988 },
+	{ 0x4E1B6A2D549B47ED, 0x3C26AFD9E97974BF, 0x0B936B76E76E4432, 0x76AB11EB3817C2BB, 0xC9195C83E9B82394, 0xE646E341C569A393,
+	  0x8CF2908ABFF1E4DD, 0x1B6A9EDB71091A97, 0x75EC79DC91908ADB, 0xD2C455489F20696D, 0x49432EB69BDE1A53, 0x000040DB9A5625E8 },
+	{ 0xA8930ABC158DB61B, 0x8FDD97A185913E72, 0x9CB8FD5EF9F0D949, 0x3096D94687B566C7, 0x11012636C95DBB48, 0x9FB49CD477667FC6,
+	  0x06CC85BADAA36F50, 0x99AB1A5295CE0FB1, 0xBE93FB92C7514F8E, 0x9E7AAD5A5EBF8661, 0xEB9943642F067E73, 0x000065FE538060FE },
+	{ 0x9B38C675D39A98B5, 0x83AE69D6C265CCB8, 0x5DCFA6FA45547DAA, 0xDBDE0B869DC86737, 0x6B439B0BDC463B62, 0xAE80DC83EF7830FE,
+	  0xFDCF20DF4823041C, 0x12AC3A3D314D1C59, 0xE70271808A87D466, 0xB7B0DD51F6A9310F, 0xE7038DE25B2F5AE1, 0x0000657F4EEF9A75 },
+	{ 0x42BE7F15C7AAF6D2, 0xCDD8F67636312EB1, 0x19B404D09986042E, 0xA83F32E91C07A873, 0x83D7E7A468C14AB3, 0x5856CBCC9FC9A401,
+	  0x0575FE1A1FCCC357, 0x460A6638DDF2AE97, 0x465B6BAC5DB349C1, 0xF00437B0F46A8695, 0x7811C4E8DE998934, 0x0000639EF46589F3 },
+	{ 0xAD9F9789B1DB28B3, 0x2E1A8DE139D0B9C0, 0x024BF48B9C2361C5, 0xB525D4753907ED78, 0x7D9CF7A7EFBD2A0B, 0x40E390F63F546ECD,
+	  0x3BF3E0F5B9208093, 0x296DD204A97ECB0E, 0xC238AA98AA202A8B, 0x7D61B8B32022B08E, 0x354EA773D8D8EC06, 0x000045D89A542F96 },
+	{ 0xE8FC07FA2211A74C, 0x6D1F0D173B556DF6, 0xF6A2A3CB1B12BD21, 0xE97500F38D7BA5CD, 0x9B47A644DF7BC04B, 0x5C9F90A10C955795,
+	  0x23BFE963FF1AF9F0, 0x8DE95CA59ABF4FED, 0x25FD343CA9462372, 0x300DB5BD979BF0C9, 0x5D894398C94EB6AF, 0x00003C9D16DD2D7A },
+	{ 0xEEF0674C7D42B600, 0xFFCBA6A0A9C48414, 0xD5161DB722ECAF5C, 0xCD8E49776BE56F90, 0xC4955556EF49D67B, 0xA7C0793F6C3AC8A0,
+	  0xF12E4A172AA84B35, 0xE1F72E4C87DF7C0A, 0x12D2D88FE6B3EDF1, 0xA72C4D7B75DBE151, 0x3105332EDF8C4CC8, 0x0000265897237FE9 },
+	{ 0xA95E09263A65753A, 0x4AF3563B98592C6D, 0xC05B40A9777C1E56, 0x0501D102E79315B9, 0xAEFF3218BE1219A6, 0xC43A313809B3A0C3,
+	  0xC8144BCC3BDD8467, 0x3541FC18B61B0D5C, 0xA7148AE7A01B0C61, 0x59202307CFA612DA, 0xF9B248BB913946E6, 0x0000329AA1AE0F88 },
+	{ 0xA020065489D0E575, 0x2FEC2F9783CE90CE, 0x0A981E8578204EC1, 0xA52BECE3941F06FE, 0x1E590B13A6EA3853, 0x302A2628E7EA6F52,
+	  0x01AF8DC9A7CA97E3, 0x70EB68990BDEFEF9, 0xCF434246CE46DF68, 0x257838F9B33F1F82, 0x5C7B61C964147E04, 0x0000257AE042E018 },
+	{ 0x6B8667B88B80C810, 0x607FDB6D031212A9, 0x2E7ECB6683C48329, 0x3B1DB21857B15B3F, 0x2EA35E473CC4553C, 0x463D5B709693F3C7,
+	  0x02B1D889996DD062, 0x2B0844EACEC198AC, 0x0DAE2B5B10D6F574, 0xB1584DC6F5131EF5, 0xA31C39E8F4F7B428, 0x00001EC37C7D7DB9 },
+	{ 0x3A1ADFB29757C899, 0x9E33E2ED3E3BBF61, 0xA2B5A5051A600903, 0x6E2744440E053C31, 0xEED16D9C1907BB95, 0xEB3E8E0EB3A4EA59,
+	  0x42A60BE37CC366A5, 0xA5536C933AAC7264, 0x30A69EC3163EFB4D, 0xCDDEA91C99BA8AE4, 0xAB87B0BBCB7014E5, 0x000019EB3A79536E },
+	{ 0xC0C7D7614F40FF6E, 0x7857EFEB72D42579, 0xD17D69494C82A216, 0x44A788305738A941, 0xC734F41CC1F5754A, 0x099DF1B478130991,
+	  0xEAFFF0DB5460B00F, 0xCB383EA3BBEF1380, 0x04337B35867741BB, 0xDF0227AFF187721E, 0xEC29E4B3B2687FBB, 0x0000021B62A11DBD },
+	{ 0x55452EB825D7FCCF, 0x452D17B2234D40BB, 0x951A564CABA57B9C, 0x71A65C753909895A, 0x1B003F4914EE1159, 0xD29490E560BD5176,
+	  0xCFCAB009EB2740E2, 0x304AC6C8E036F0F9, 0x7ACEBA9B214DE5C3, 0xC28C3C86FA49BFDF, 0xD69F343E2E32EB92, 0x00001149549FE620 },
+	{ 0xAC9D57B5683FDD16, 0xE426A2121152BDCE, 0x0C04E7512C66572A, 0x5DF3B69487295D7C, 0xA7564B46497C9A33, 0x15372F3C8F01DC41,
+	  0xE2EE9B886209B325, 0x3E26B2B162C2E1A6, 0x60A821E875A92385, 0xE5DAE53ACA3E98E4, 0x3936F0D235D560A3, 0x00002D90F4FBE954 },
+	{ 0xE27AF9B692E37CB4, 0xB539A72644C5B7B6, 0xC57781DB8ADC67CB, 0x63F06AA1397B1C31, 0x5D1E0208D426E2C8, 0x25A7C84293600C82,
+	  0x99ADD45CF3B056CE, 0x6FFD1DE2BAB3A23F, 0x2879C28190E833BC, 0x46E8B1EA40626642, 0xF53952DECC1CE884, 0x00006DFCB0760516 },
+	{ 0xEC7154282636ACC4, 0x04E081F516369B67, 0x72BF20DC091EEAA5, 0x1D80AE78B4641256, 0xE26049480D68F192, 0x6EF8B692D052C1B6,
+	  0xF6A7B07E4BED18AB, 0x45BDBBBF48425A10, 0xC9187AF49DA5B9D7, 0x6E412D9068659293, 0xEE29CCE66D0BBF95, 0x0000573681E45E80 },
+	{ 0x5944C2D1C0B62230, 0xA0C9F1851C90806B, 0x08BE8AFEF1082783, 0x9486DDCD593DAF38, 0x6CA8A91696B8E504, 0xBFBB571B8C28977D,
+	  0x21573CFD18778DE4, 0x1EFC76B0F0B9B737, 0x6376158FF46CE340, 0x7E1C55ED8B63A3FB, 0x4A1B788F527C89C5, 0x0000112F93531675 },
+	{ 0x8E77EBBDBD181936, 0xAAC25993A8F3056B, 0x3EA2ED62AB8A0BAB, 0x6FEFDB0785601A89, 0xBC33E908BB60EABC, 0x308DD5170D891639,
+	  0x138C4070E8D2B030, 0x355F131FB31DCF59, 0x84DEA54513E4E0BA, 0x7B70FDD48536476C, 0x1E239BFCB64FECE0, 0x000058D76EE4EAF3 },
+	{ 0xE663E91F06C01669, 0x9B0E7963D148AF71, 0x92A65FC7A40528BD, 0x4A471EE0BA95A784, 0xB874BC911443FA7B, 0xD69012F5ACB3CE39,
+	  0x466C6964F979FEBE, 0x326CC09C9152C9A3, 0x68A8B85F0F835918, 0x29FCB45EEA3ED4B8, 0x152E2FC80E46AE21, 0x000020FE9EC6E55C },
+	{ 0xB98DD2462408CB97, 0x5F8A53D0CA86F502, 0x379522465E8FCD6D, 0xCC9DC83FB4EA24BB, 0x9AD5D2BEF3D75405, 0x157B2892A46C0048,
+	  0x7FE40306F7653B91, 0xEF9CB2B52FD2C779, 0xD9812B64468EDDF7, 0xCD86E3893C1D4018, 0x20D0B9419F0B67B2, 0x00003B93D530B67C },
+	{ 0x08A6B7C3E8B6B469, 0x293F9087EB47702C, 0xB528BEBBF4358875, 0x6F499AAA28FEDD9A, 0x83C7E0B9188D24A0, 0xFDE4756D02796561,
+	  0xF3B4222EBAFF747C, 0x2597641596A147A9, 0x9FB32D871F0431A9, 0xEBDA5AD7DA0698F4, 0xD37F7F0124720701, 0x000035F4FF1177DF },
+	{ 0x9DF8C471B84C78E1, 0x77EC378DECBB8CE8, 0xFEAB69804F976EB1, 0xB8FEDE1F6147CECF, 0xAEDFC16A55CA34E6, 0xD6F86CD8C875561B,
+	  0x039C5D5375CCA54B, 0x61ECC62BB2D5D2B2, 0xEAC5099D8E446031, 0x6582AD35E51D59EB, 0x43EFC46B02D5E9D9, 0x0000377CA02DE9D6 },
+	{ 0x363555FF116D6552, 0xC7AD4C6FE7807DEA, 0x8CB297DE63DC35A1, 0x2281DB38466E97F8, 0xE0CA7F494AA48C4D, 0x6854538A26A1CA5F,
+	  0xE6CB271F708BD709, 0x340A912EDA0255E3, 0x431884398B71F034, 0xCCF17B5596E517B6, 0xD5A899298D97EA11, 0x00004DD0A1768A26 },
+	{ 0x8AEADD9699CFFF0F, 0x33F82C2ED5B72EEE, 0xD0533AB851854815, 0xB2FFD0A95755AB42, 0x2D5A761F3F557659, 0x8EA98B887D08D844,
+	  0x3DD8D60BB4E20E13, 0xAC56A4FC213D46F5, 0x7CD94C9A7755785B, 0x7FC11E39F98FD3D2, 0x5C9F73F53CA22FBC, 0x00000176795D2D53 },
+	{ 0xDA0E9EE4A0674BC8, 0x02ACD6DC2EE85BAD, 0x85149CA827C16C3E, 0x51086463153FA03C, 0x9BC49428CACD00D0, 0x267D5A3F8FE8C218,
+	  0x996BC89D4E56A4DD, 0x7AE3FA4DD9FC3D55, 0x19915FCBB20D9550, 0x4D53BDB39C796046, 0x5A753C6BED9ECF55, 0x00000B828605B4CB },
+	{ 0x6E4F69C79803F614, 0x84D52A8BAFE759EB, 0xE2861B2FF0152DF2, 0x9AF555C709DEE7AD, 0x16F7819C50021E8C, 0xA73AB974A10D5347,
+	  0x68146A4C1E38512B, 0x41C2F66B5A64C743, 0xFB6B6F7348A804A7, 0x7CEAFA3B92685047, 0xAE0CC20BE04CA8FB, 0x000022F1B8E18976 },
+	{ 0x23B74A2E55DBD801, 0x0FCAA373783031AD, 0x2B6BBC0D33E796C6, 0x34A84F36595841FC, 0x90F6388353BBF660, 0xCAC16E9B0F430F7E,
+	  0xCD2AF378398F00C9, 0xA025DCF25E59C810, 0x5E6343B7D33F7C91, 0x7F19333B888AB393, 0xC08A65D1C6F062AE, 0x000014C2DAAF8C78 },
+	{ 0xCC5D0A2D056D9782, 0x542C0181FD5B0351, 0x967ED7BDE7814D7D, 0xEF0FD27EA8600E6E, 0x863A51585BDBC610, 0xA32036A1AA16068C,
+	  0x7EAF8AE1C1DB96A0, 0xF6DFA96E6C14F462, 0x1A0BED77746A2487, 0x5F5C1BF672499B78, 0x8DA5CC2E0DF5A89E, 0x00002FC0D1913703 }
+};
+
+const unsigned int LIST_SQR_R[NLIST_SQR] = { 7, 8, 9, 12, 19, 20, 21, 23, 25, 27, 28, 29, 30, 31, 33, 34, 37, 38, 39, 40, 43, 44, 46, 49, 55, 56, 57, 60, 65, 66, 68, 70 };
@@ -108,6 +108,24 @@ extern "C" {
 #endif
 
 
+// Selection of bounded-stack mode, which moves the large temporaries of the API functions off the stack
+
+#if defined(_BOUNDED_STACK_)                      
+    #define SIDH_BOUNDED_STACK
+    #define SIDH_MAX_STACK_BYTES    12288           // Guaranteed upper bound (in bytes) for the stack used by any API function
+#endif
+
+
+// Selection of multithreaded discrete logarithms in public key compression (see SIDH_curve_set_ph_workers())
+
+#if defined(_PTHREADS_)                      
+    #define SIDH_PTHREADS
+    #define SIDH_MAX_PH_WORKERS     4               // Maximum number of threads computing the discrete logarithms of one compression
+#else
+    #define SIDH_MAX_PH_WORKERS     1
+#endif
+
+
 // Unsupported configurations
 
 #if (TARGET != TARGET_AMD64) && (TARGET != TARGET_ARM64) && !defined(GENERIC_IMPLEMENTATION)
@@ -139,6 +157,7 @@ extern "C" {
 #define MAXBITS_FIELD   768                
 #define MAXWORDS_FIELD  ((MAXBITS_FIELD+RADIX-1)/RADIX)     // Max. number of words to represent field elements
 #define NWORDS64_FIELD  ((NBITS_FIELD+63)/64)               // Number of 64-bit words of a 751-bit field element 
+#define NBYTES_PACKED_FIELD ((NBITS_FIELD+7)/8)             // Number of bytes of a field element in the packed wire format
 #define NBITS_ORDER     384
 #define NWORDS_ORDER    ((NBITS_ORDER+RADIX-1)/RADIX)       // Number of words of oA and oB, where oA and oB are the subgroup orders of Alice and Bob, resp.
 #define NWORDS64_ORDER  ((NBITS_ORDER+63)/64)               // Number of 64-bit words of a 384-bit element 
@@ -151,6 +170,37 @@ extern "C" {
 #define BIGMONT_MAXBITS_ORDER   768  
 #define BIGMONT_NWORDS_ORDER    ((BIGMONT_NBITS_ORDER+RADIX-1)/RADIX)       // Number of words of BigMont's subgroup order.
 #define BIGMONT_MAXWORDS_ORDER  ((BIGMONT_MAXBITS_ORDER+RADIX-1)/RADIX)     // Max. number of words to represent elements in [1, BigMont_order].
+
+// Fixed-base comb for BigMont (see BigMont_fixed_base_precompute())
+
+#define BIGMONT_COMB_TEETH      6                                           // Teeth per comb: each table holds 2^6 points
+#define BIGMONT_COMB_TABLES     2                                           // Number of tables, each one halves the number of doublings
+#define BIGMONT_COMB_SPACING    ((BIGMONT_NBITS_ORDER+BIGMONT_COMB_TEETH*BIGMONT_COMB_TABLES-1)/(BIGMONT_COMB_TEETH*BIGMONT_COMB_TABLES))  // Comb spacing e = 63, i.e., 62 doublings 
+#define BIGMONT_FIXED_BASE_TABLE_BYTES  (BIGMONT_COMB_TABLES*(1 << BIGMONT_COMB_TEETH)*3*NWORDS_FIELD*sizeof(digit_t))   // Size of a fixed-base table, 36864 bytes
+
+// Curve models implementing the point operations of the isogeny computations (see SIDH_curve_select_models())
+
+#define SIDH_MODEL_MONTGOMERY   0                   // Montgomery x-only formulas
+#define SIDH_MODEL_EDWARDS      1                   // Formulas on the (Y:Z) coordinates of the birationally equivalent Edwards curve
+
+// Wire encodings of the GF(p751^2) elements in public keys and shared secrets (see SIDH_curve_set_encoding())
+
+#define SIDH_ENCODING_STANDARD    0                 // Standard representation a in [0, p751-1]
+#define SIDH_ENCODING_MONTGOMERY  1                 // Montgomery representation a*R mod p751 in [0, p751-1], where R = 2^768
+
+// Sources of the random values of private keys (see SIDH_curve_set_random_source())
+
+#define SIDH_RANDOM_CALLBACK      0                 // One call to the random_bytes function per sampling attempt
+#define SIDH_RANDOM_DRBG          1                 // Per-thread ChaCha20 DRBG seeded and periodically reseeded from the random_bytes function
+
+// Sampling methods of private keys (see SIDH_curve_set_key_sampling())
+
+#define SIDH_SAMPLING_REJECTION   0                 // Rejection sampling, with a variable number of requests to the random source
+#define SIDH_SAMPLING_REDUCTION   1                 // Constant-time reduction of one request with 64 extra bits
+
+// Alignment in bytes of the key buffers returned by SIDH_key_buffer_allocate() (one cache line, a multiple of the digit size)
+
+#define SIDH_KEY_ALIGNMENT        64
    
 
 // Definitions of the error-handling type and error codes
@@ -195,6 +245,12 @@ typedef CRYPTO_STATUS (*RandomBytes)(unsigned int nbytes, unsigned char* random_
 typedef char CurveIsogeny_ID[10];
 
 
+// Key buffers for the wire format of public keys and shared secrets (see SIDH_api.h), aligned to digits.
+// The API accepts byte buffers at any offset, but digit-aligned ones are read and written in place, without bytewise accesses.
+typedef union { unsigned char bytes[3*2*NWORDS_FIELD*sizeof(digit_t)]; digit_t words[3*2*NWORDS_FIELD]; } PublicKeyBuffer;    // Three elements in GF(p751^2)
+typedef union { unsigned char bytes[2*NWORDS_FIELD*sizeof(digit_t)]; digit_t words[2*NWORDS_FIELD]; } SharedSecretBuffer;       // One element in GF(p751^2)
+
+
 // Supersingular elliptic curve isogeny structures:
 
 // This data struct contains the static curve isogeny data
@@ -245,6 +301,14 @@ typedef struct
     digit_t*         Montgomery_pp;                          // Montgomery constant -p^-1 mod 2^W, using a suitable value W
     digit_t*         Montgomery_one;                         // Value one in Montgomery representation
     RandomBytes      RandomBytesFunction;                    // Function providing random bytes to generate nonces or secret keys
+    unsigned int*    splits_Alice;                           // Strategy for traversing Alice's isogeny tree (split sizes indexed by subtree size)
+    unsigned int*    splits_Bob;                             // Strategy for traversing Bob's isogeny tree (split sizes indexed by subtree size)
+    unsigned int*    splits_Alice8;                          // Strategy for traversing Alice's tree of 8-isogenies
+    unsigned int*    splits_Bob9;                            // Strategy for traversing Bob's tree of 9-isogenies
+    unsigned int*    splits_ph2;                             // Strategy for the 2-torsion Pohlig-Hellman in Alice's key compression
+    unsigned int*    splits_ph3;                             // Strategy for the 3-torsion Pohlig-Hellman in Bob's key compression
+    void*            Dispatch;                               // Implementations selected for the point operations (see SIDH_curve_select_models())
+    void*            Workspace;                              // Scratch memory for large temporaries in bounded-stack mode (NULL otherwise)
 } CurveIsogenyStruct, *PCurveIsogenyStruct;
 
 
@@ -258,22 +322,80 @@ extern CurveIsogenyStaticData CurveIsogeny_SIDHp751;
 /*************** Setup/initialization functions *****************/ 
 
 // Dynamic allocation of memory for curve isogeny structure.
+// In bounded-stack mode this also allocates the workspace used by the API functions, so a structure cannot be shared by concurrent computations.
 // Returns NULL on error.
 PCurveIsogenyStruct SIDH_curve_allocate(PCurveIsogenyStaticData CurveData);
 
 // Initialize curve isogeny structure pCurveIsogeny with static data extracted from pCurveIsogenyData. 
 // This needs to be called after allocating memory for "pCurveIsogeny" using SIDH_curve_allocate().
+// The curve models for the point operations are selected by SIDH_curve_tune_models().
 CRYPTO_STATUS SIDH_curve_initialize(PCurveIsogenyStruct pCurveIsogeny, RandomBytes RandomBytesFunction, PCurveIsogenyStaticData pCurveIsogenyData); 
 
+// Select the curve model (SIDH_MODEL_MONTGOMERY or SIDH_MODEL_EDWARDS) used for the doubling chains in Alice's isogeny tree, 
+// the tripling chains in Bob's isogeny tree and the base-field ladder in key generation.
+// The Edwards pipeline of Alice's tree is not an optimization: it measures about 20% slower than the Montgomery (A+2C:4C) path with both the x64 
+// and the generic field arithmetic, and is kept selectable for platforms where SIDH_curve_tune_models() finds otherwise.
+CRYPTO_STATUS SIDH_curve_select_models(PCurveIsogenyStruct pCurveIsogeny, unsigned int DBL_model, unsigned int TPL_model, unsigned int ladder_model);
+
+// Time both curve models for each point operation on the running machine and select the fastest ones
+CRYPTO_STATUS SIDH_curve_tune_models(PCurveIsogenyStruct pCurveIsogeny);
+
+// Select the degree of the isogeny steps in Alice's tree (4 or 8) and Bob's tree (3 or 9). SIDH_curve_initialize() selects 4 and 3.
+// The trees of 8- and 9-isogenies have fewer, more expensive steps, always computed with Montgomery formulas for Alice's doublings.
+CRYPTO_STATUS SIDH_curve_set_isogeny_degrees(PCurveIsogenyStruct pCurveIsogeny, unsigned int degree_Alice, unsigned int degree_Bob);
+
+// Replace the strategies of the isogeny trees currently selected in pCurveIsogeny by optimal ones for the given relative costs of one multiplication step 
+// (two doublings for Alice, one tripling for Bob, or three doublings and two triplings with 8- and 9-isogenies) and one isogeny evaluation. 
+// SIDH_curve_initialize() sets the default strategies.
+CRYPTO_STATUS SIDH_curve_set_strategies(PCurveIsogenyStruct pCurveIsogeny, unsigned int mul_cost_Alice, unsigned int isog_cost_Alice, unsigned int mul_cost_Bob, unsigned int isog_cost_Bob);
+
+// Select the number of threads (1, 2 or 4) sharing the four discrete logarithms of public key compression. SIDH_curve_initialize() selects 1.
+// More than one worker requires building with pthreads support (_PTHREADS_), otherwise CRYPTO_ERROR_NOT_IMPLEMENTED is returned.
+// The extra threads are started here, reused by every compression and stopped by SIDH_curve_free() or the next call; a compression that runs
+// while another one uses them computes its discrete logarithms on its own thread.
+CRYPTO_STATUS SIDH_curve_set_ph_workers(PCurveIsogenyStruct pCurveIsogeny, unsigned int workers);
+
+// Select the wire encoding (SIDH_ENCODING_STANDARD or SIDH_ENCODING_MONTGOMERY) of the uncompressed public keys produced by EphemeralKeyGeneration_A/B() 
+// and consumed by EphemeralSecretAgreement_A/B() and PublicKeyCompression_A/B(), and of the shared secrets of all EphemeralSecretAgreement functions. 
+// Both parties must use the same encoding. SIDH_curve_initialize() selects SIDH_ENCODING_STANDARD. Compressed public keys are not affected.
+CRYPTO_STATUS SIDH_curve_set_encoding(PCurveIsogenyStruct pCurveIsogeny, unsigned int encoding);
+
+// Select the source (SIDH_RANDOM_CALLBACK or SIDH_RANDOM_DRBG) of the random values of the private keys sampled with pCurveIsogeny. SIDH_curve_initialize() selects SIDH_RANDOM_CALLBACK. 
+// With SIDH_RANDOM_DRBG each thread draws from its own DRBG, which is seeded on first use and reseeded periodically and after fork() from the random_bytes function 
+// of the structure in use at that time. The DRBG state of a thread is released by SIDH_drbg_thread_free(), or at thread exit when built with pthreads support (_PTHREADS_).
+CRYPTO_STATUS SIDH_curve_set_random_source(PCurveIsogenyStruct pCurveIsogeny, unsigned int source);
+
+// Select the sampling method (SIDH_SAMPLING_REJECTION or SIDH_SAMPLING_REDUCTION) of the private keys sampled with pCurveIsogeny. SIDH_curve_initialize() selects SIDH_SAMPLING_REJECTION.
+// Both methods output keys in the same ranges (see random_mod_order()), but sampling by reduction draws a fixed number of bytes and runs in constant time.
+CRYPTO_STATUS SIDH_curve_set_key_sampling(PCurveIsogenyStruct pCurveIsogeny, unsigned int sampling);
+
+// Predicted cost of the isogeny tree traversal of Alice (AliceOrBob = 0) or Bob (AliceOrBob = 1) with the tree and strategy currently set in pCurveIsogeny
+uint64_t SIDH_strategy_cost(PCurveIsogenyStruct pCurveIsogeny, unsigned int AliceOrBob, unsigned int mul_cost, unsigned int isog_cost);
+
 // Free memory for curve isogeny structure
 void SIDH_curve_free(PCurveIsogenyStruct pCurveIsogeny);
 
+// Dynamic allocation of a zeroed buffer of nbytes bytes aligned to SIDH_KEY_ALIGNMENT bytes, e.g., for keys received from or sent to the network.
+// Returns NULL on error.
+unsigned char* SIDH_key_buffer_allocate(unsigned int nbytes);
+
+// Clear and free a buffer of nbytes bytes allocated with SIDH_key_buffer_allocate()
+void SIDH_key_buffer_free(unsigned char* buffer, unsigned int nbytes);
+
+// Clear and free the DRBG state of the calling thread (see SIDH_curve_set_random_source()), e.g., before the thread exits in builds without pthreads support. 
+// The next sampling reseeds a new state.
+void SIDH_drbg_thread_free(void);
+
 // Output error/success message for a given CRYPTO_STATUS
 const char* SIDH_get_error_message(CRYPTO_STATUS Status);
 
 // Output random values in the range [1, order-1] in little endian format that can be used as private keys.
 CRYPTO_STATUS random_mod_order(digit_t* random_digits, unsigned int AliceOrBob, PCurveIsogenyStruct pCurveIsogeny);
 
+// Output nkeys private keys as above, stored consecutively in NWORDS_ORDER digits each, from a single request to the random source.
+// The keys are always sampled by reduction (see SIDH_curve_set_key_sampling()).
+CRYPTO_STATUS random_mod_order_batch(digit_t* random_digits, unsigned int nkeys, unsigned int AliceOrBob, PCurveIsogenyStruct pCurveIsogeny);
+
 // Output random values in the range [1, BigMont_order-1] in little endian format that can be used as private keys
 // to compute scalar multiplications using the elliptic curve BigMont.
 CRYPTO_STATUS random_BigMont_mod_order(digit_t* random_digits, PCurveIsogenyStruct pCurveIsogeny);
@@ -58,15 +58,49 @@ CRYPTO_STATUS EphemeralSecretAgreement_A(const unsigned char* pPrivateKeyA, cons
 // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
 CRYPTO_STATUS EphemeralSecretAgreement_B(const unsigned char* pPrivateKeyB, const unsigned char* pPublicKeyA, unsigned char* pSharedSecretB, PCurveIsogenyStruct CurveIsogeny);
 
+/*********************** Ephemeral key exchange API with packed keys ***********************/ 
+
+// Same as the functions above with public keys and shared secrets in the packed wire format (see below), i.e., 564 and 188 bytes. 
+// Packed buffers are accessed bytewise and need no particular alignment. 
+
+// Alice's ephemeral key-pair generation with a packed public key pPackedPublicKeyA
+CRYPTO_STATUS EphemeralKeyGeneration_Packed_A(unsigned char* pPrivateKeyA, unsigned char* pPackedPublicKeyA, PCurveIsogenyStruct CurveIsogeny);
+
+// Bob's ephemeral key-pair generation with a packed public key pPackedPublicKeyB
+CRYPTO_STATUS EphemeralKeyGeneration_Packed_B(unsigned char* pPrivateKeyB, unsigned char* pPackedPublicKeyB, PCurveIsogenyStruct CurveIsogeny);
+
+// Alice's ephemeral shared secret computation from Bob's packed public key pPackedPublicKeyB, with a packed output pPackedSharedSecretA
+// Returns CRYPTO_ERROR_PUBLIC_KEY_VALIDATION if an element of pPackedPublicKeyB is not fully reduced.
+CRYPTO_STATUS EphemeralSecretAgreement_Packed_A(const unsigned char* pPrivateKeyA, const unsigned char* pPackedPublicKeyB, unsigned char* pPackedSharedSecretA, PCurveIsogenyStruct CurveIsogeny);
+
+// Bob's ephemeral shared secret computation from Alice's packed public key pPackedPublicKeyA, with a packed output pPackedSharedSecretB
+// Returns CRYPTO_ERROR_PUBLIC_KEY_VALIDATION if an element of pPackedPublicKeyA is not fully reduced.
+CRYPTO_STATUS EphemeralSecretAgreement_Packed_B(const unsigned char* pPrivateKeyB, const unsigned char* pPackedPublicKeyA, unsigned char* pPackedSharedSecretB, PCurveIsogenyStruct CurveIsogeny);
+
 /*********************** Ephemeral key exchange API with compressed public keys ***********************/
 
 // Alice's public key compression
 // It produces a compressed output that consists of three elements in Z_orderB and one field element
 // Input : Alice's public key PublicKeyA, which consists of 3 elements in GF(p751^2).
 // Output: a compressed value CompressedPKA that consists of three elements in Z_orderB and one element in GF(p751^2). 
+//         The output is all zero if PublicKeyA is invalid; PublicKeyCompression_Checked_A() reports the error.
 // CurveIsogeny must be set up in advance using SIDH_curve_initialize(). 
 void PublicKeyCompression_A(const unsigned char* PublicKeyA, unsigned char* CompressedPKA, PCurveIsogenyStruct CurveIsogeny);
 
+// Alice's public key compression with validation of the public key
+// It produces the same compressed output as PublicKeyCompression_A(), i.e., three elements in Z_orderB and one element in GF(p751^2).
+// Returns CRYPTO_ERROR_PUBLIC_KEY_VALIDATION if a coordinate of PublicKeyA is not a valid wire encoding (see SIDH_curve_set_encoding()),
+// and CRYPTO_ERROR_NO_MEMORY if the lookup tables cannot be allocated. CompressedPKA is zeroed on failure.
+// CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+CRYPTO_STATUS PublicKeyCompression_Checked_A(const unsigned char* PublicKeyA, unsigned char* CompressedPKA, PCurveIsogenyStruct CurveIsogeny);
+
+// Alice's ephemeral key-pair generation with a compressed public key
+// It produces a private key PrivateKeyA and directly computes the compressed public key CompressedPKA, skipping the uncompressed public key.
+// The private key is an even integer in the range [2, oA-2], where oA = 2^372. 
+// The output is identical to PublicKeyCompression_A() applied to the public key of EphemeralKeyGeneration_A(), i.e., three elements in Z_orderB and one element in GF(p751^2).
+// CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+CRYPTO_STATUS EphemeralKeyGeneration_Compressed_A(unsigned char* PrivateKeyA, unsigned char* CompressedPKA, PCurveIsogenyStruct CurveIsogeny);
+
 // Alice's public key value decompression computed by Bob
 // Inputs: Bob's private key SecretKeyB, and
 //         Alice's compressed public key data CompressedPKA, which consists of three elements in Z_orderB and one element in GF(p751^2),
@@ -86,9 +120,24 @@ CRYPTO_STATUS EphemeralSecretAgreement_Compression_A(const unsigned char* Privat
 // It produces a compressed output that consists of three elements in Z_orderA and one field element
 // Input : Bob's public key PublicKeyB, which consists of 3 elements in GF(p751^2).
 // Output: a compressed value CompressedPKB that consists of three elements in Z_orderA and one element in GF(p751^2). 
+//         The output is all zero if PublicKeyB is invalid; PublicKeyCompression_Checked_B() reports the error.
 // CurveIsogeny must be set up in advance using SIDH_curve_initialize().       
 void PublicKeyCompression_B(const unsigned char* PublicKeyB, unsigned char* CompressedPKB, PCurveIsogenyStruct CurveIsogeny);
 
+// Bob's public key compression with validation of the public key
+// It produces the same compressed output as PublicKeyCompression_B(), i.e., three elements in Z_orderA and one element in GF(p751^2).
+// Returns CRYPTO_ERROR_PUBLIC_KEY_VALIDATION if a coordinate of PublicKeyB is not a valid wire encoding (see SIDH_curve_set_encoding()),
+// and CRYPTO_ERROR_NO_MEMORY if the lookup tables cannot be allocated. CompressedPKB is zeroed on failure.
+// CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+CRYPTO_STATUS PublicKeyCompression_Checked_B(const unsigned char* PublicKeyB, unsigned char* CompressedPKB, PCurveIsogenyStruct CurveIsogeny);
+
+// Bob's ephemeral key-pair generation with a compressed public key
+// It produces a private key PrivateKeyB and directly computes the compressed public key CompressedPKB, skipping the uncompressed public key.
+// The private key is an integer in the range [1, oB-1], where oB = 3^239. 
+// The output is identical to PublicKeyCompression_B() applied to the public key of EphemeralKeyGeneration_B(), i.e., three elements in Z_orderA and one element in GF(p751^2).
+// CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+CRYPTO_STATUS EphemeralKeyGeneration_Compressed_B(unsigned char* PrivateKeyB, unsigned char* CompressedPKB, PCurveIsogenyStruct CurveIsogeny);
+
 // Bob's public key value decompression computed by Alice
 // Inputs: Alice's private key SecretKeyA, and
 //         Bob's compressed public key data CompressedPKB, which consists of three elements in Z_orderA and one element in GF(p751^2).
@@ -104,6 +153,22 @@ void PublicKeyBDecompression_A(const unsigned char* SecretKeyA, const unsigned c
 // CurveIsogeny must be set up in advance using SIDH_curve_initialize().                       
 CRYPTO_STATUS EphemeralSecretAgreement_Compression_B(const unsigned char* PrivateKeyB, const unsigned char* point_R, const unsigned char* param_A, unsigned char* SharedSecretB, PCurveIsogenyStruct CurveIsogeny);
 
+// Alice's ephemeral shared secret computation straight from Bob's compressed public key
+// Same result as PublicKeyBDecompression_A followed by EphemeralSecretAgreement_Compression_A, without the intermediate point_R and param_A buffers.
+// Inputs: Alice's PrivateKeyA is an even integer in the range [2, oA-2], where oA = 2^372. 
+//         Bob's compressed public key data CompressedPKB, which consists of three elements in Z_orderA and one element in GF(p751^2).
+// Output: a shared secret SharedSecretA that consists of one element in GF(p751^2). 
+// CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+CRYPTO_STATUS EphemeralSecretAgreement_FromCompressed_A(const unsigned char* PrivateKeyA, const unsigned char* CompressedPKB, unsigned char* SharedSecretA, PCurveIsogenyStruct CurveIsogeny);
+
+// Bob's ephemeral shared secret computation straight from Alice's compressed public key
+// Same result as PublicKeyADecompression_B followed by EphemeralSecretAgreement_Compression_B, without the intermediate point_R and param_A buffers.
+// Inputs: Bob's PrivateKeyB is an integer in the range [1, oB-1], where oB = 3^239. 
+//         Alice's compressed public key data CompressedPKA, which consists of three elements in Z_orderB and one element in GF(p751^2).
+// Output: a shared secret SharedSecretB that consists of one element in GF(p751^2). 
+// CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+CRYPTO_STATUS EphemeralSecretAgreement_FromCompressed_B(const unsigned char* PrivateKeyB, const unsigned char* CompressedPKA, unsigned char* SharedSecretB, PCurveIsogenyStruct CurveIsogeny);
+
 /*********************** Scalar multiplication API using BigMont ***********************/ 
 
 // BigMont's scalar multiplication using the Montgomery ladder
@@ -113,6 +178,33 @@ CRYPTO_STATUS EphemeralSecretAgreement_Compression_B(const unsigned char* Privat
 // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
 CRYPTO_STATUS BigMont_ladder(unsigned char* x, digit_t* m, unsigned char* xout, PCurveIsogenyStruct CurveIsogeny);
 
+// Batch of BigMont's scalar multiplications using the Montgomery ladder, normalized with a single shared inversion
+// Inputs: x, the n affine x-coordinates of points P_i on BigMont (NWORDS_FIELD words each),
+//         m, the n scalars (BIGMONT_NWORDS_ORDER words each).
+// Output: xout, the n affine x-coordinates of m_i*(x_i:1). xout can be equal to x.
+// CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+CRYPTO_STATUS BigMont_ladder_batch(const unsigned char* x, const digit_t* m, unsigned char* xout, const unsigned int n, PCurveIsogenyStruct CurveIsogeny);
+
+// Precomputation of the comb tables for BigMont's fixed-base scalar multiplication
+// Input:  x, the affine x-coordinate of a base point G on BigMont. G must have order BigMont_order, otherwise CRYPTO_ERROR_INVALID_PARAMETER is returned.
+// Output: table, BIGMONT_FIXED_BASE_TABLE_BYTES bytes, to be used with BigMont_fixed_base() and BigMont_fixed_base_batch().
+// CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+CRYPTO_STATUS BigMont_fixed_base_precompute(const unsigned char* x, unsigned char* table, PCurveIsogenyStruct CurveIsogeny);
+
+// BigMont's fixed-base scalar multiplication using a comb, in constant time
+// Inputs: table, the tables of the base point G computed with BigMont_fixed_base_precompute(),
+//         scalar m in [1, BigMont_order-1].
+// Output: xout, the affine x-coordinate of m*G, as given by BigMont_ladder()
+// CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+CRYPTO_STATUS BigMont_fixed_base(const unsigned char* table, const digit_t* m, unsigned char* xout, PCurveIsogenyStruct CurveIsogeny);
+
+// Batch of BigMont's fixed-base scalar multiplications, normalized with a single shared inversion
+// Inputs: table, the tables of the base point G computed with BigMont_fixed_base_precompute(),
+//         m, the n scalars in [1, BigMont_order-1] (BIGMONT_NWORDS_ORDER words each).
+// Output: xout, the n affine x-coordinates of m_i*G (NWORDS_FIELD words each).
+// CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+CRYPTO_STATUS BigMont_fixed_base_batch(const unsigned char* table, const digit_t* m, unsigned char* xout, const unsigned int n, PCurveIsogenyStruct CurveIsogeny);
+
 
 // Encoding of keys for isogeny system "SIDHp751" (wire format):
 // ------------------------------------------------------------
@@ -126,6 +218,12 @@ CRYPTO_STATUS BigMont_ladder(unsigned char* x, digit_t* m, unsigned char* xout,
 // endian format. 
 // Shared keys pSharedSecretA and pSharedSecretB consist of one element in GF(p751^2). In the key exchange API, they are encoded in 192 octets in little
 // endian format. 
+// Public keys and shared keys can be located at any offset of a byte buffer. Buffers aligned to digits (see PublicKeyBuffer, SharedSecretBuffer and 
+// SIDH_key_buffer_allocate() in SIDH.h) are accessed in place; otherwise the elements are loaded and stored digit by digit, without an intermediate copy of the key.
+//
+// Packed wire format: elements over GF(p751) are encoded in NBYTES_PACKED_FIELD = 94 octets in little endian format, without padding, and must be 
+// fully reduced, i.e., in [0, p751-1]. Elements over GF(p751^2) take 188 octets, in the same coordinate order as above. Packed public keys take 564 octets
+// and packed shared keys 188 octets. The representation (standard or Montgomery) is selected by SIDH_curve_set_encoding().
 
 
 #ifdef __cplusplus
@@ -31,6 +31,49 @@ extern "C" {
 #define MAX_INT_POINTS_BOB    10 
 #define MAX_Alice             185   
 #define MAX_Bob               239
+#define MAX_Alice8            123      // Leaves of Alice's tree of 8-isogenies: 122 8-isogenies and a final 16-isogeny (two 4-isogenies)
+#define MAX_Bob9              120      // Leaves of Bob's tree of 9-isogenies: 119 9-isogenies and a final 3-isogeny
+#define NLIST_SQR             32       // Entries of the table of square Elligator constants used for entangled torsion bases
+#define MAX_CUBE_BATCH        8        // Maximum number of elements sharing one inversion in is_cube_Fp2_batch
+#define DRBG_BLOCK_BYTES      1024     // Bytes of ChaCha20 keystream per refill of the key-sampling DRBG, including the 32 bytes of the next key
+#define DRBG_RESEED_BYTES     (1 << 20)  // Bytes output by the key-sampling DRBG between two reseeds from the random_bytes function
+#define KEY_SAMPLE_EXTRA_BITS 64       // Random bits beyond the order drawn per private key sampled by reduction, the statistical distance is below 2^-64
+#define KEY_SAMPLE_NWORDS     (NWORDS_ORDER + NBITS_TO_NWORDS(KEY_SAMPLE_EXTRA_BITS))
+
+// Thread-local storage, for the state of the key-sampling DRBG
+#if (COMPILER == COMPILER_VC)
+    #define SIDH_THREAD_LOCAL    __declspec(thread)
+#else
+    #define SIDH_THREAD_LOCAL    __thread
+#endif
+
+// Pohlig-Hellman configuration for public key compression. The discrete logarithms are solved in digits of base ell^w at the leaves of a strategy,
+// corrections use a comb table of e*(ell^v-1) elements g^(-c*ell^t). Larger v trades table memory for fewer multiplications.
+// The leaf table has ell^w entries searched linearly, which bounds w; the comb table grows as ell^v, which bounds v.
+#define PH2_WINDOW            6        // Window width w of the 2-torsion Pohlig-Hellman, in [1, 12]
+#define PH3_WINDOW            4        // Window width w of the 3-torsion Pohlig-Hellman, in [1, 8]
+#define PH2_TABLE_WINDOW      1        // Comb table window v of the 2-torsion Pohlig-Hellman, in [1, 4]
+#define PH3_TABLE_WINDOW      1        // Comb table window v of the 3-torsion Pohlig-Hellman, in [1, 4]
+
+#if (PH2_WINDOW < 1 || PH2_WINDOW > 12)
+    #error -- "PH2_WINDOW must be in [1, 12]"
+#endif
+#if (PH3_WINDOW < 1 || PH3_WINDOW > 8)
+    #error -- "PH3_WINDOW must be in [1, 8]"
+#endif
+#if (PH2_TABLE_WINDOW < 1 || PH2_TABLE_WINDOW > 4 || PH3_TABLE_WINDOW < 1 || PH3_TABLE_WINDOW > 4)
+    #error -- "PH2_TABLE_WINDOW and PH3_TABLE_WINDOW must be in [1, 4]"
+#endif
+
+#define PH_POW3(k)            ((k) == 1 ? 3 : (k) == 2 ? 9 : (k) == 3 ? 27 : (k) == 4 ? 81 : (k) == 5 ? 243 : (k) == 6 ? 729 : (k) == 7 ? 2187 : 6561)    // 3^k for 1 <= k <= 8
+#define PH2_LEAVES            ((372 + PH2_WINDOW - 1)/PH2_WINDOW)
+#define PH3_LEAVES            ((239 + PH3_WINDOW - 1)/PH3_WINDOW)
+#define PH2_LEAF_SIZE         (1 << PH2_WINDOW)
+#define PH3_LEAF_SIZE         PH_POW3(PH3_WINDOW)
+#define PH2_TABLE_SIZE        (372*((1 << PH2_TABLE_WINDOW) - 1))
+#define PH3_TABLE_SIZE        (239*(PH_POW3(PH3_TABLE_WINDOW) - 1))
+#define PH_MAX_LEAVES         372      // Leaves of the largest Pohlig-Hellman strategy (w = 1)
+#define MAX_INT_VALUES_PH     8        // Intermediate values held by the Pohlig-Hellman strategies
    
 
 // SIDH's basic element definitions and point representations
@@ -57,8 +100,64 @@ typedef point_basefield_affine point_basefield_t[1];
         
 typedef struct { felm_t X; felm_t Z; } point_basefield_proj;          // Point representation in projective XZ Montgomery coordinates over the base field.
 typedef point_basefield_proj point_basefield_proj_t[1]; 
+
+typedef struct { felm_t X; felm_t Y; felm_t Z; felm_t T; } point_basefield_ext;   // Point representation in extended (X:Y:Z:T) coordinates, T = X*Y/Z, on the twisted Edwards curve over the base field.
+typedef point_basefield_ext point_basefield_ext_t[1]; 
+
+typedef struct { felm_t ypx; felm_t ymx; felm_t t2d; } point_basefield_precomp;    // Affine twisted Edwards point in the form (y+x, y-x, 2*d*x*y) used in the fixed-base tables.
+typedef point_basefield_precomp point_basefield_precomp_t[1]; 
+
+typedef struct {                                                      // Parameters of a Pohlig-Hellman computation in a cyclotomic subgroup of order ell^e
+    unsigned int        ell;                                          // Prime ell, 2 or 3
+    unsigned int        e;                                            // Exponent e of the group order
+    unsigned int        w;                                            // Window width: digits in base ell^w are solved at the leaves
+    unsigned int        v;                                            // Comb table window: the table holds g^(-c*ell^t) for 0 < c < ell^v
+    const unsigned int* splits;                                       // Strategy for the ceil(e/w) leaves (see optimal_strategy())
+} ph_params;
     
 
+#if defined(SIDH_BOUNDED_STACK)
+// Workspace holding the large temporaries of the API functions in bounded-stack mode. 
+// Buffers are shared by functions that never run nested within each other.
+typedef struct {
+    point_proj_t      pts[MAX_INT_POINTS_BOB];                        // Intermediate points of the isogeny trees
+    publickey_t       PK;                                             // Public key in Montgomery representation (compression)
+    point_proj_t      phiK[3];                                        // Projective public key images (key generation with compression)
+    point_full_proj_t P, Q, phP, phQ, phX;                            // Torsion basis and recovered public points (compression/decompression)
+    point_t           R1, R2, phiP, phiQ;                             // Normalized points (compression/decompression)
+    point_ext_proj_t  R[2];                                           // Points running through the Miller loops (pairings)
+    f2elm_t           nd[5];                                          // Miller loop values (pairings)
+    felm_t            norms[5], norm_invs[5];                         // Norms of the Miller loop values and their inverses (pairings)
+    f2elm_t           n[5];                                           // Pairing values (Pohlig-Hellman)
+} SIDH_workspace, *PSIDH_workspace;
+
+#define SIDH_WORKSPACE(CurveIsogeny)    ((PSIDH_workspace)(CurveIsogeny)->Workspace)
+#endif
+
+
+// Implementations of the point operations selected for each role in the isogeny computations (see SIDH_curve_select_models())
+// With the Edwards model, the points and curve constants in Alice's isogeny tree are kept in Edwards form (see mont_to_edwards()),
+// with the Montgomery model the tree carries the constants (A+2C, 4C) produced by get_4_isog_A24() (see mont_to_A24()).
+// Bob's isogeny tree carries the constants (A+2C, A-2C) produced by get_3_isog_coeff() with both models.
+typedef struct {
+    unsigned int model_DBL, model_TPL, model_ladder;                  // Selected curve models, SIDH_MODEL_MONTGOMERY or SIDH_MODEL_EDWARDS
+    unsigned int degree_Alice, degree_Bob;                            // Degree of the isogeny steps in the trees, 4 or 8 for Alice and 3 or 9 for Bob
+    unsigned int ph_workers;                                          // Threads computing the discrete logarithms of public key compression, 1, 2 or 4
+    void* ph_pool;                                                    // Persistent threads of workers 1, ..., ph_workers-1 (see ph_pool_create()), NULL with one worker
+    unsigned int encoding;                                            // Wire encoding of public keys and shared secrets, SIDH_ENCODING_STANDARD or SIDH_ENCODING_MONTGOMERY
+    unsigned int random_source;                                       // Source of the random values of private keys, SIDH_RANDOM_CALLBACK or SIDH_RANDOM_DRBG
+    unsigned int key_sampling;                                        // Sampling method of private keys, SIDH_SAMPLING_REJECTION or SIDH_SAMPLING_REDUCTION
+    void (*DBLe)(const point_proj_t P, point_proj_t Q, const f2elm_t A, const f2elm_t C, const int e);    // Doubling chain in Alice's isogeny tree
+    void (*get_4_isog)(const point_proj_t P, f2elm_t A, f2elm_t C, f2elm_t* coeff);                        // 4-isogeny computation in Alice's isogeny tree
+    void (*eval_4_isog)(point_proj_t P, f2elm_t* coeff);                                                   // 4-isogeny evaluation in Alice's isogeny tree
+    void (*TPLe)(const point_proj_t P, point_proj_t Q, const f2elm_t A24plus, const f2elm_t A24minus, const int e);    // Tripling chain in Bob's isogeny tree
+    void (*ladder_basefield)(const felm_t x, digit_t* m, point_basefield_proj_t P, point_basefield_proj_t Q, const felm_t A24, 
+                             const unsigned int order_bits, const unsigned int order_fullbits, PCurveIsogenyStruct CurveIsogeny);    // Base-field ladder in key generation
+} SIDH_dispatch, *PSIDH_dispatch;
+
+#define SIDH_DISPATCH(CurveIsogeny)     ((PSIDH_dispatch)(CurveIsogeny)->Dispatch)
+
+
 // Macro definitions
 
 #define NBITS_TO_NBYTES(nbits)      (((nbits)+7)/8)                                          // Conversion macro from number of bits to number of bytes
@@ -232,6 +331,12 @@ static __inline unsigned int is_digit_lessthan_ct(digit_t x, digit_t y)
 // Copy wordsize digits, c = a, where lng(a) = nwords
 void copy_words(const digit_t* a, digit_t* c, const unsigned int nwords);
 
+// Load wordsize digits from a byte buffer c with any alignment, a = c, where lng(a) = nwords
+void load_words(const unsigned char* c, digit_t* a, const unsigned int nwords);
+
+// Store wordsize digits to a byte buffer c with any alignment, c = a, where lng(a) = nwords
+void store_words(const digit_t* a, unsigned char* c, const unsigned int nwords);
+
 // Multiprecision addition, c = a+b, where lng(a) = lng(b) = nwords. Returns the carry bit 
 unsigned int mp_add(const digit_t* a, const digit_t* b, digit_t* c, const unsigned int nwords);
 
@@ -263,12 +368,19 @@ void mp_mul_comba(const digit_t* a, const digit_t* b, digit_t* c, const unsigned
 
 void multiply(const digit_t* a, const digit_t* b, digit_t* c, const unsigned int nwords); 
 
+// Multiprecision comba multiply returning the least significant half, c = a*b mod 2^(RADIX*nwords), where lng(a) = lng(b) = lng(c) = nwords
+void mp_mul_low(const digit_t* a, const digit_t* b, digit_t* c, const unsigned int nwords);
+
 // Montgomery multiplication modulo the group order, mc = ma*mb*r' mod order, where ma,mb,mc in [0, order-1]
 void Montgomery_multiply_mod_order(const digit_t* ma, const digit_t* mb, digit_t* mc, const digit_t* order, const digit_t* Montgomery_rprime);
+void mont_mul_order384_asm(const digit_t* ma, const digit_t* mb, digit_t* mc, const digit_t* order, const digit_t* Montgomery_rprime);
 
 // (Non-constant time) Montgomery inversion modulo the curve order using a^(-1) = a^(order-2) mod order
 void Montgomery_inversion_mod_order(const digit_t* ma, digit_t* mc, const digit_t* order, const digit_t* Montgomery_rprime);
 
+// Constant-time Montgomery inversion modulo Bob's order 3^239
+void Montgomery_inversion_mod_orderB(const digit_t* ma, digit_t* mc, const digit_t* order, const digit_t* Montgomery_rprime);
+
 void Montgomery_inversion_mod_order_bingcd(const digit_t* a, digit_t* c, const digit_t* order, const digit_t* Montgomery_rprime, const digit_t* Montgomery_R2);
 
 // Conversion of elements in Z_r to Montgomery representation, where the order r is up to 384 bits.
@@ -362,6 +474,9 @@ void fp2sqr751_mont(const f2elm_t a, f2elm_t c);
  
 // GF(p751^2) multiplication using Montgomery arithmetic, c = a*b in GF(p751^2)
 void fp2mul751_mont(const f2elm_t a, const f2elm_t b, f2elm_t c);
+
+// GF(p751^2) difference of products using Montgomery arithmetic with lazy reduction, e = a*b - c*d in GF(p751^2)
+void fp2muldiff751_mont(const f2elm_t a, const f2elm_t b, const f2elm_t c, const f2elm_t d, f2elm_t e);
     
 // Conversion of a GF(p751^2) element to Montgomery representation
 void to_fp2mont(const f2elm_t a, f2elm_t mc);
@@ -369,6 +484,21 @@ void to_fp2mont(const f2elm_t a, f2elm_t mc);
 // Conversion of a GF(p751^2) element from Montgomery representation to standard representation
 void from_fp2mont(const f2elm_t ma, f2elm_t c);
 
+// Encoding of a GF(p751^2) element in Montgomery representation for the wire, in the given encoding (SIDH_ENCODING_STANDARD or SIDH_ENCODING_MONTGOMERY)
+void fp2_encode(const f2elm_t ma, f2elm_t c, const unsigned int encoding);
+
+// Encoding of a GF(p751^2) element for the wire into a byte buffer c with any alignment
+void fp2_encode_bytes(const f2elm_t ma, unsigned char* c, const unsigned int encoding);
+
+// Decoding of a GF(p751^2) element from a byte buffer c with any alignment to Montgomery representation. Returns 0 if a Montgomery encoding is not fully reduced, 1 otherwise
+unsigned int fp2_decode_bytes(const unsigned char* c, f2elm_t ma, const unsigned int encoding);
+
+// Packing of a GF(p751^2) element in Montgomery representation into 2*NBYTES_PACKED_FIELD bytes in the given encoding
+void fp2_pack(const f2elm_t ma, unsigned char* c, const unsigned int encoding);
+
+// Unpacking of a GF(p751^2) element from 2*NBYTES_PACKED_FIELD bytes to Montgomery representation. Returns 0 if an element is not in [0, p751-1], 1 otherwise
+unsigned int fp2_unpack(const unsigned char* c, f2elm_t ma, const unsigned int encoding);
+
 // GF(p751^2) inversion using Montgomery arithmetic, a = (a0-i*a1)/(a0^2+a1^2)
 void fp2inv751_mont(f2elm_t a);
 
@@ -378,6 +508,9 @@ void fp2inv751_mont_bingcd(f2elm_t a);
 // n-way Montgomery inversion
 void mont_n_way_inv(const f2elm_t* vec, const int n, f2elm_t* out);
 
+// n-way Montgomery inversion in GF(p751)
+void mont_n_way_inv_fp(const felm_t* vec, const int n, felm_t* out);
+
 // Select either x or y depending on value of option 
 void select_f2elm(const f2elm_t x, const f2elm_t y, f2elm_t z, const digit_t option);
 
@@ -399,6 +532,12 @@ extern void inv_Fp2_cycl(f2elm_t a);
 // Check if GF(p751^2) element is cube
 bool is_cube_Fp2(f2elm_t u, PCurveIsogenyStruct CurveIsogeny);
 
+// Check which of the n GF(p751^2) elements in u are cubes, sharing the inversions
+void is_cube_Fp2_batch(const f2elm_t* u, bool* cubes, const unsigned int n, PCurveIsogenyStruct CurveIsogeny);
+
+// Check if GF(p751^2) element is square
+bool is_sqr_Fp2(const f2elm_t u);
+
 // Exponentiation y^t via square and multiply in the cyclotomic group. Exponent t is 6 bits at most
 void exp6_Fp2_cycl(const f2elm_t y, const uint64_t t, const felm_t one, f2elm_t res);
 
@@ -416,6 +555,12 @@ void exp_Fp2_cycl(const f2elm_t y, uint64_t* t, const felm_t one, f2elm_t res, i
 // Check if curve isogeny structure is NULL
 bool is_CurveIsogenyStruct_null(PCurveIsogenyStruct pCurveIsogeny);
 
+// Computes the optimal strategy for an isogeny tree with nleaves leaves using at most max_points intermediate points, given the costs of one multiplication step and one isogeny evaluation
+CRYPTO_STATUS optimal_strategy(unsigned int* splits, const unsigned int nleaves, const unsigned int max_points, const uint64_t mul_cost, const uint64_t isog_cost);
+
+// Cost of traversing an isogeny tree with nleaves leaves using the strategy given by splits
+uint64_t strategy_cost(const unsigned int* splits, const unsigned int nleaves, const uint64_t mul_cost, const uint64_t isog_cost);
+
 // Swap points over the base field 
 void swap_points_basefield(point_basefield_proj_t P, point_basefield_proj_t Q, const digit_t option);
 
@@ -428,6 +573,9 @@ void j_inv(const f2elm_t A, const f2elm_t C, f2elm_t jinv);
 // Simultaneous doubling and differential addition.
 void xDBLADD(point_proj_t P, point_proj_t Q, const f2elm_t xPQ, const f2elm_t A24);
 
+// Simultaneous doubling and differential addition with projective curve constants A24plus = A+2C and C24 = 4C.
+void xDBLADD_proj(point_proj_t P, point_proj_t Q, const f2elm_t xPQ, const f2elm_t A24plus, const f2elm_t C24);
+
 // Doubling of a Montgomery point in projective coordinates (X:Z).
 void xDBL(const point_proj_t P, point_proj_t Q, const f2elm_t A24, const f2elm_t C24);
 
@@ -439,6 +587,12 @@ void edDBLe(const point_proj_t P, point_proj_t Q, const f2elm_t A, const f2elm_t
 
 void xDBLe(const point_proj_t P, point_proj_t Q, const f2elm_t A, const f2elm_t C, const int e);
 
+// Computes [2^e](X:Z) on Montgomery curve given the constants A24plus = A+2C and C24 = 4C, via e repeated doublings.
+void xDBLe_A24(const point_proj_t P, point_proj_t Q, const f2elm_t A24plus, const f2elm_t C24, const int e);
+
+// Computes [2^e](Y:Z) on the Edwards curve with projective constants AE = A+2C and DE = A-2C via e repeated doublings, keeping the point in Edwards coordinates.
+void edDBLe_native(const point_proj_t P, point_proj_t Q, const f2elm_t AE, const f2elm_t DE, const int e);
+
 // Computes [2^e](X:Z) on Montgomery curve with projective constant via e repeated doublings and collects a few intermediate multiples.
 void xDBLe_collect(point_proj_t P, point_proj_t Q, f2elm_t A, f2elm_t C, unsigned int left_bound, const unsigned int right_bound, const unsigned int* col, point_proj_t* pts, unsigned int* pts_index, unsigned int *npts);
 
@@ -454,6 +608,12 @@ void edDBLADD_basefield(point_basefield_proj_t P, point_basefield_proj_t Q, cons
 // Simultaneous doubling and differential addition over the base field.
 void xDBLADD_basefield(point_basefield_proj_t P, point_basefield_proj_t Q, const felm_t xPQ, const felm_t A24);
 
+// Doubling of a point on the twisted Edwards curve -x^2+y^2=1+d*x^2*y^2 birationally equivalent to BigMont, in extended coordinates
+void edDBL_ext_basefield(const point_basefield_ext_t P, point_basefield_ext_t Q);
+
+// Mixed addition of a point in extended coordinates and a precomputed affine point on the twisted Edwards curve equivalent to BigMont
+void edMADD_ext_basefield(const point_basefield_ext_t P, const point_basefield_precomp_t Q, point_basefield_ext_t R);
+
 // The Montgomery ladder
 void ladderMT(const felm_t x, digit_t* m, point_basefield_proj_t P, point_basefield_proj_t Q, const felm_t A24, const unsigned int order_bits, const unsigned int order_fullbits, PCurveIsogenyStruct CurveIsogeny);
 
@@ -466,15 +626,52 @@ CRYPTO_STATUS secret_pt(const point_basefield_t P, const digit_t* m, const unsig
 // Computes P+[m]Q via x-only arithmetic.
 CRYPTO_STATUS ladder_3_pt(const f2elm_t xP, const f2elm_t xQ, const f2elm_t xPQ, const digit_t* m, const unsigned int AliceOrBob, point_proj_t W, const f2elm_t A, PCurveIsogenyStruct CurveIsogeny);
 
+// Computes P+[m]Q via x-only arithmetic, given the projective curve constant A/C.
+CRYPTO_STATUS ladder_3_pt_proj(const f2elm_t xP, const f2elm_t xQ, const f2elm_t xPQ, const digit_t* m, const unsigned int AliceOrBob, point_proj_t W, const f2elm_t A, const f2elm_t C, PCurveIsogenyStruct CurveIsogeny);
+
 // Computes the corresponding 4-isogeny of a projective Montgomery point (X4:Z4) of order 4.
+// Reference formulas with (A:C) output: every isogeny tree, including the ones run on decompressed keys, uses get_4_isog_A24() or get_4_isog_ed().
 void get_4_isog(const point_proj_t P, f2elm_t A, f2elm_t C, f2elm_t* coeff);
 
 // Evaluates the isogeny at the point (X:Z) in the domain of the isogeny
 void eval_4_isog(point_proj_t P, f2elm_t* coeff);
 
+// Computes the corresponding 4-isogeny of a projective Montgomery point (X4:Z4) of order 4, giving the codomain's constants A24plus and C24.
+void get_4_isog_A24(const point_proj_t P, f2elm_t A24plus, f2elm_t C24, f2elm_t* coeff);
+
+// Evaluates the isogeny at the point (X:Z), given the coefficients from get_4_isog_A24().
+void eval_4_isog_A24(point_proj_t P, f2elm_t* coeff);
+
+// Computes the corresponding 8-isogeny of a projective Montgomery point (X8:Z8) of order 8, as a 4-isogeny followed by a 2-isogeny.
+void get_8_isog(const point_proj_t P, f2elm_t A24plus, f2elm_t C24, f2elm_t* coeff);
+
+// Evaluates the 8-isogeny at the point (X:Z), given the coefficients from get_8_isog().
+void eval_8_isog(point_proj_t P, f2elm_t* coeff);
+
+// Converts the Montgomery curve constant A/C to the doubling constants A24plus = A+2C and C24 = 4C.
+void mont_to_A24(f2elm_t A, f2elm_t C);
+
+// Converts the doubling constants A24plus = A+2C and C24 = 4C back to a Montgomery curve constant.
+void A24_to_mont(f2elm_t A24plus, f2elm_t C24);
+
 // Computes first 4-isogeny computed by Alice.
 void first_4_isog(point_proj_t P, const f2elm_t A, f2elm_t Aout, f2elm_t Cout, PCurveIsogenyStruct CurveIsogeny);
 
+// Computes first 4-isogeny computed by Alice, given the projective curve constant A/C.
+void first_4_isog_proj(point_proj_t P, const f2elm_t A, const f2elm_t C, f2elm_t Aout, f2elm_t Cout);
+
+// Converts a Montgomery point (X:Z) to Edwards coordinates (Y:Z) = (X-Z:X+Z) and, if A is not NULL, the curve constant A/C to the Edwards constants (A+2C, A-2C).
+void mont_to_edwards(point_proj_t P, f2elm_t A, f2elm_t C);
+
+// Converts Edwards coordinates (Y:Z) back to a Montgomery point (X:Z) = (Y+Z:Z-Y) and, if AE is not NULL, the Edwards constants back to a Montgomery curve constant.
+void edwards_to_mont(point_proj_t P, f2elm_t AE, f2elm_t DE);
+
+// Computes the corresponding 4-isogeny of a point of order 4 in Edwards coordinates, giving the codomain's Edwards constants.
+void get_4_isog_ed(const point_proj_t P, f2elm_t AE, f2elm_t DE, f2elm_t* coeff);
+
+// Evaluates the isogeny at a point in Edwards coordinates, given the coefficients from get_4_isog_ed().
+void eval_4_isog_ed(point_proj_t P, f2elm_t* coeff);
+
 // Tripling of a Montgomery point in projective coordinates (X:Z).
 void xTPL(const point_proj_t P, point_proj_t Q, const f2elm_t A24, const f2elm_t C24);
 
@@ -487,6 +684,12 @@ void edTPLe(const point_proj_t P, point_proj_t Q, const f2elm_t A, const f2elm_t
 // Computes [3^e](X:Z) on Montgomery curve with projective constant via e repeated triplings.
 void xTPLe(const point_proj_t P, point_proj_t Q, const f2elm_t A, const f2elm_t C, const int e);
 
+// Computes [3^e](X:Z) on Montgomery curve given the constants A24plus = A+2C and A24minus = A-2C, via e repeated triplings.
+void xTPLe_A24(const point_proj_t P, point_proj_t Q, const f2elm_t A24plus, const f2elm_t A24minus, const int e);
+
+// Computes [3^e](X:Z) on Montgomery curve given the constants A24plus = A+2C and A24minus = A-2C, via e repeated Edwards-based triplings.
+void edTPLe_A24(const point_proj_t P, point_proj_t Q, const f2elm_t A24plus, const f2elm_t A24minus, const int e);
+
 // Computes [3^e](X:Z) on Montgomery curve with projective constant via e repeated triplings and collects a few intermediate multiples.    
 void xTPLe_collect(point_proj_t P, point_proj_t Q, f2elm_t A, f2elm_t C, unsigned int left_bound, const unsigned int right_bound, const unsigned int* col, point_proj_t* pts, unsigned int* pts_index, unsigned int *npts);
 
@@ -496,6 +699,18 @@ void get_3_isog(const point_proj_t P, f2elm_t A, f2elm_t C);
 // Computes the 3-isogeny R=phi(X:Z), given projective point (X3:Z3) of order 3 on a Montgomery curve and a point P = (X:Z).
 void eval_3_isog(const point_proj_t P, point_proj_t Q);
 
+// Computes the corresponding 3-isogeny of a projective Montgomery point (X3:Z3) of order 3, giving the codomain's constants A24plus and A24minus.
+void get_3_isog_coeff(const point_proj_t P, f2elm_t A24plus, f2elm_t A24minus, f2elm_t* coeff);
+
+// Evaluates the 3-isogeny at the point (X:Z), given the coefficients from get_3_isog_coeff().
+void eval_3_isog_coeff(point_proj_t Q, f2elm_t* coeff);
+
+// Computes the corresponding 9-isogeny of a projective Montgomery point (X9:Z9) of order 9, as two 3-isogenies.
+void get_9_isog(const point_proj_t P, f2elm_t A24plus, f2elm_t A24minus, f2elm_t* coeff);
+
+// Evaluates the 9-isogeny at the point (X:Z), given the coefficients from get_9_isog().
+void eval_9_isog(point_proj_t Q, f2elm_t* coeff);
+
 // 3-way simultaneous inversion
 void inv_3_way(f2elm_t z1, f2elm_t z2, f2elm_t z3);
 
@@ -505,6 +720,9 @@ void distort_and_diff(const felm_t xP, point_proj_t d, PCurveIsogenyStruct Curve
 // Given the x-coordinates of P, Q, and R, returns the value A corresponding to the Montgomery curve E_A: y^2=x^3+A*x^2+x such that R=Q-P on E_A.
 void get_A(const f2elm_t xP, const f2elm_t xQ, const f2elm_t xR, f2elm_t A, PCurveIsogenyStruct CurveIsogeny);
 
+// Given the x-coordinates of P, Q, and R, returns the projective value A/C corresponding to the Montgomery curve E_A/C: y^2=x^3+(A/C)*x^2+x such that R=Q-P on E_A/C.
+void get_A_proj(const f2elm_t xP, const f2elm_t xQ, const f2elm_t xR, f2elm_t A, f2elm_t C, PCurveIsogenyStruct CurveIsogeny);
+
 /************ Functions for compression *************/
 
 // Produces points R1 and R2 as basis for E[2^372]
@@ -513,6 +731,12 @@ void generate_2_torsion_basis(const f2elm_t A, point_full_proj_t R1, point_full_
 // Produces points R1 and R2 as basis for E[3^239]
 void generate_3_torsion_basis(f2elm_t A, point_full_proj_t R1, point_full_proj_t R2, PCurveIsogenyStruct CurveIsogeny);
 
+// Produces points R1 and R2 as basis for E[2^372] using an entangled basis, with the Elligator constants in LIST_SQR
+void generate_2_torsion_basis_entangled(const f2elm_t A, point_full_proj_t R1, point_full_proj_t R2, PCurveIsogenyStruct CurveIsogeny);
+
+// Produces points R1 and R2 as basis for E[3^239] using an entangled basis, with the Elligator constants in LIST_SQR
+void generate_3_torsion_basis_entangled(f2elm_t A, point_full_proj_t R1, point_full_proj_t R2, PCurveIsogenyStruct CurveIsogeny);
+
 // 2-torsion Tate pairing
 void Tate_pairings_2_torsion(const point_t R1, const point_t R2, const point_t P, const point_t Q, const f2elm_t A, f2elm_t* n, PCurveIsogenyStruct CurveIsogeny);
 
@@ -526,56 +750,44 @@ void Mont_ladder(const f2elm_t x, const digit_t* m, point_proj_t P, point_proj_t
 void ADD(const point_full_proj_t P, const f2elm_t QX, const f2elm_t QY, const f2elm_t QZ, const f2elm_t A, point_full_proj_t R);
 
 // 2-torsion Pohlig-Hellman function
-void ph2(const point_t phiP, const point_t phiQ, const point_t PS, const point_t QS, const f2elm_t A, uint64_t* a0, uint64_t* b0, uint64_t* a1, uint64_t* b1, PCurveIsogenyStruct CurveIsogeny);
+CRYPTO_STATUS ph2(const point_t phiP, const point_t phiQ, const point_t PS, const point_t QS, const f2elm_t A, uint64_t* a0, uint64_t* b0, uint64_t* a1, uint64_t* b1, PCurveIsogenyStruct CurveIsogeny);
 
-// Lookup table generation for 2-torsion PH
-void build_LUTs(const f2elm_t u, f2elm_t* t_ori, f2elm_t* LUT, f2elm_t* LUT_0, f2elm_t* LUT_1, f2elm_t* LUT_3, const felm_t one);
+// Lookup tables for the strategy-driven Pohlig-Hellman
+void ph_build_tables(const f2elm_t g, const ph_params* prm, f2elm_t* T, felm_t* leaf, const felm_t one);
 
-// Pohlig-Hellman for groups of 2-power order up to 2^6 
-void phn1(const f2elm_t q, const f2elm_t* LUT, const uint64_t a, const felm_t one, uint64_t* alpha_i);
+// Strategy-driven Pohlig-Hellman in a cyclotomic subgroup of order ell^e
+void ph_strategy(const f2elm_t h, const ph_params* prm, const f2elm_t* T, const felm_t* leaf, const felm_t one, digit_t* alpha);
 
-// Pohlig-Hellman for groups of 2-power order 2^21 
-void phn5(f2elm_t q, const f2elm_t* LUT, const f2elm_t* LUT_1, const felm_t one, uint64_t* alpha_k);
-
-// Pohlig-Hellman for groups of 2-power order 2^84 
-void phn21(f2elm_t q, const f2elm_t* LUT, const f2elm_t* LUT_0, const f2elm_t* LUT_1, const felm_t one, uint64_t* alpha_k);
-
-// Pohlig-Hellman for groups of 2-power order 2^372 
-void phn84(f2elm_t r, const f2elm_t* t_ori, const f2elm_t* LUT, const f2elm_t* LUT_0, const f2elm_t* LUT_1, const f2elm_t* LUT_3, const felm_t one, uint64_t* alpha);
+// Optimal strategy for the Pohlig-Hellman with window w and comb table window v
+CRYPTO_STATUS ph_optimal_strategy(unsigned int* splits, const unsigned int ell, const unsigned int e, const unsigned int w, const unsigned int v);
 
 // 3-torsion Pohlig-Hellman function       
-void ph3(point_t phiP, point_t phiQ, point_t PS, point_t QS, f2elm_t A, uint64_t* a0, uint64_t* b0, uint64_t* a1, uint64_t* b1, PCurveIsogenyStruct CurveIsogeny);
-
-// Lookup table generation for 3-torsion PH
-void build_LUTs_3(f2elm_t g, f2elm_t* t_ori, f2elm_t* LUT, f2elm_t* LUT_0, f2elm_t* LUT_1, const felm_t one);
-
-// Pohlig-Hellman for groups of 3-power order up to 3^2 or 3^3 
-void phn1_3(const f2elm_t q, const f2elm_t* LUT, const uint64_t a, const felm_t one, uint64_t* alpha_i);
-
-// Pohlig-Hellman for groups of 3-power order up 3^15
-void phn3(f2elm_t q, const f2elm_t* LUT, const f2elm_t* LUT_1, const felm_t one, uint64_t* alpha_k);
-
-// Pohlig-Hellman for groups of 3-power order up 3^56
-void phn15_1(f2elm_t q, const f2elm_t* LUT, const f2elm_t* LUT_0, const f2elm_t* LUT_1, const felm_t one, uint64_t* alpha_k);
-
-// Pohlig-Hellman for groups of 3-power order up 3^61
-void phn15(f2elm_t q, const f2elm_t* LUT, const f2elm_t* LUT_0, const f2elm_t* LUT_1, const felm_t one, uint64_t* alpha_k);
-
-// Pohlig-Hellman for groups of 3-power order up 3^239
-void phn61(f2elm_t r, f2elm_t* t_ori, const f2elm_t* LUT, const f2elm_t* LUT_0, const f2elm_t* LUT_1, const felm_t one, uint64_t* alpha);
+CRYPTO_STATUS ph3(point_t phiP, point_t phiQ, point_t PS, point_t QS, f2elm_t A, uint64_t* a0, uint64_t* b0, uint64_t* a1, uint64_t* b1, PCurveIsogenyStruct CurveIsogeny);
 
 // Recover the y-coordinates of the public key
 void recover_y(const publickey_t PK, point_full_proj_t phiP, point_full_proj_t phiQ, point_full_proj_t phiX, f2elm_t A, PCurveIsogenyStruct CurveIsogeny);
 
+// Recover the y-coordinates of a public key given in projective form, with the affine x-coordinate of Q-P and the curve constant A
+void recover_y_proj(const point_proj_t P, const point_proj_t Q, const f2elm_t xD, const f2elm_t A, point_full_proj_t phiP, point_full_proj_t phiQ, point_full_proj_t phiX, PCurveIsogenyStruct CurveIsogeny);
+
 // Computes the input modulo 3. The input is assumed to be NWORDS_ORDER long 
 unsigned int mod3(digit_t* a); 
 
-// Computes R+aS
-void mont_twodim_scalarmult(digit_t* a, const point_t R, const point_t S, const f2elm_t A, const f2elm_t A24, point_full_proj_t P, PCurveIsogenyStruct CurveIsogeny);
+// Computes R+aS, where a has at most order_bits bits
+void mont_twodim_scalarmult(digit_t* a, const point_t R, const point_t S, const f2elm_t A, const f2elm_t A24, const unsigned int order_bits, point_full_proj_t P, PCurveIsogenyStruct CurveIsogeny);
+
+// Computes x(R+aS), where a has at most order_bits bits, for a projective R and an affine S
+void mont_twodim_scalarmult_xz(digit_t* a, const point_full_proj_t R, const point_t S, const f2elm_t A, const f2elm_t A24, const unsigned int order_bits, point_proj_t P, PCurveIsogenyStruct CurveIsogeny);
+
+
+// Start the persistent threads running the Pohlig-Hellman workers 1, ..., workers-1 of public key compression, NULL if none can be started
+void* ph_pool_create(const unsigned int workers);
 
+// Stop the threads of a pool started by ph_pool_create() and free it
+void ph_pool_destroy(void* pool);
 
-void compress_2_torsion(const unsigned char* PublicKeyA, unsigned char* CompressedPKA, uint64_t* a0, uint64_t* b0, uint64_t* a1, uint64_t* b1, point_t R1, point_t R2, PCurveIsogenyStruct CurveIsogeny);
-void compress_3_torsion(const unsigned char* PublicKeyA, unsigned char* CompressedPKA, uint64_t* a0, uint64_t* b0, uint64_t* a1, uint64_t* b1, point_t R1, point_t R2, PCurveIsogenyStruct CurveIsogeny);
+CRYPTO_STATUS compress_2_torsion(const unsigned char* PublicKeyA, unsigned char* CompressedPKA, uint64_t* a0, uint64_t* b0, uint64_t* a1, uint64_t* b1, point_t R1, point_t R2, PCurveIsogenyStruct CurveIsogeny);
+CRYPTO_STATUS compress_3_torsion(const unsigned char* PublicKeyA, unsigned char* CompressedPKA, uint64_t* a0, uint64_t* b0, uint64_t* a1, uint64_t* b1, point_t R1, point_t R2, PCurveIsogenyStruct CurveIsogeny);
 void decompress_2_torsion(const unsigned char* SecretKey, const unsigned char* CompressedPKA, point_proj_t R, f2elm_t A, PCurveIsogenyStruct CurveIsogeny);
 void decompress_3_torsion(const unsigned char* SecretKey, const unsigned char* CompressedPKA, point_proj_t R, f2elm_t A, PCurveIsogenyStruct CurveIsogeny);
 
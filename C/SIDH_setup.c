@@ -11,13 +11,46 @@
 
 #include "SIDH_internal.h"
 #include <malloc.h>
+#include <time.h>
+#include <string.h>
+#if (OS_TARGET == OS_LINUX)
+    #include <sys/mman.h>
+    #include <unistd.h>
+    #define DRBG_GETPID()    (long)getpid()
+#else
+    #include <process.h>
+    #define DRBG_GETPID()    (long)_getpid()
+#endif
+#if defined(SIDH_PTHREADS)
+    #include <pthread.h>
+#endif
 //#include <inttypes.h>
 
+// Parameters of the curve model microbenchmark run by SIDH_curve_tune_models()
+#define TUNE_ROUNDS             3       // Number of alternating timing rounds per curve model
+#define TUNE_DBL_STEPS          64      // Number of doublings timed per round
+#define TUNE_EVALS              16      // Number of 4-isogeny evaluations timed per round
+#define TUNE_TPL_STEPS          40      // Number of triplings timed per round
+#define TUNE_LADDER_BITS        64      // Number of ladder steps timed per round
+
+// Default costs for the strategies of the trees of 8- and 9-isogenies, from their operation counts with M = 5 and S = 4
+#define STRATEGY_MUL_COST_8     84      // Three doublings, 3*(4M+2S)
+#define STRATEGY_ISOG_COST_8    58      // 8-isogeny evaluation, 10M+2S
+#define STRATEGY_MUL_COST_9     112     // Two triplings, 2*(8M+4S)
+#define STRATEGY_ISOG_COST_9    56      // 9-isogeny evaluation, 8M+4S
+#define PH_COST_SQR             8       // Cyclotomic squaring, 2 GF(p) squarings, in units where M = 15
+#define PH_COST_CUBE            14      // Cyclotomic cubing, 1 GF(p) squaring and 2 GF(p) multiplications
+#define PH_COST_MUL             15      // Multiplication by a comb table entry, 1M
+
+extern const unsigned int splits_Alice[MAX_Alice];
+extern const unsigned int splits_Bob[MAX_Bob];
+
 
 CRYPTO_STATUS SIDH_curve_initialize(PCurveIsogenyStruct pCurveIsogeny, RandomBytes RandomBytesFunction, PCurveIsogenyStaticData pCurveIsogenyData)
 { // Initialize curve isogeny structure pCurveIsogeny with static data extracted from pCurveIsogenyData.
   // This needs to be called after allocating memory for "pCurveIsogeny" using SIDH_curve_allocate().
     unsigned int i, pwords, owords;
+    CRYPTO_STATUS Status;
 
     if (is_CurveIsogenyStruct_null(pCurveIsogeny)) {
         return CRYPTO_ERROR_INVALID_PARAMETER;
@@ -48,11 +81,390 @@ CRYPTO_STATUS SIDH_curve_initialize(PCurveIsogenyStruct pCurveIsogeny, RandomByt
     copy_words((digit_t*)pCurveIsogenyData->Montgomery_R2, pCurveIsogeny->Montgomery_R2, pwords);
     copy_words((digit_t*)pCurveIsogenyData->Montgomery_pp, pCurveIsogeny->Montgomery_pp, pwords);
     copy_words((digit_t*)pCurveIsogenyData->Montgomery_one, pCurveIsogeny->Montgomery_one, pwords);
+
+    for (i = 0; i < MAX_Alice; i++) {    // Default strategies, computed offline
+        pCurveIsogeny->splits_Alice[i] = splits_Alice[i];
+    }
+    for (i = 0; i < MAX_Bob; i++) {
+        pCurveIsogeny->splits_Bob[i] = splits_Bob[i];
+    }
+    Status = optimal_strategy(pCurveIsogeny->splits_Alice8, MAX_Alice8, MAX_INT_POINTS_ALICE, STRATEGY_MUL_COST_8, STRATEGY_ISOG_COST_8);
+    if (Status != CRYPTO_SUCCESS) {
+        return Status;
+    }
+    Status = optimal_strategy(pCurveIsogeny->splits_Bob9, MAX_Bob9, MAX_INT_POINTS_BOB, STRATEGY_MUL_COST_9, STRATEGY_ISOG_COST_9);
+    if (Status != CRYPTO_SUCCESS) {
+        return Status;
+    }
+    Status = ph_optimal_strategy(pCurveIsogeny->splits_ph2, 2, pCurveIsogeny->oAbits, PH2_WINDOW, PH2_TABLE_WINDOW);
+    if (Status != CRYPTO_SUCCESS) {
+        return Status;
+    }
+    Status = ph_optimal_strategy(pCurveIsogeny->splits_ph3, 3, pCurveIsogeny->eB, PH3_WINDOW, PH3_TABLE_WINDOW);
+    if (Status != CRYPTO_SUCCESS) {
+        return Status;
+    }
+    SIDH_curve_set_isogeny_degrees(pCurveIsogeny, 4, 3);
+    SIDH_curve_set_ph_workers(pCurveIsogeny, 1);
+    SIDH_curve_set_encoding(pCurveIsogeny, SIDH_ENCODING_STANDARD);
+    SIDH_curve_set_random_source(pCurveIsogeny, SIDH_RANDOM_CALLBACK);
+    SIDH_curve_set_key_sampling(pCurveIsogeny, SIDH_SAMPLING_REJECTION);
+
+    // Defaults kept on tuning ties: Montgomery doublings and triplings, Edwards ladder. The Edwards pipeline of Alice's tree is slower (see SIDH_curve_select_models())
+    SIDH_curve_select_models(pCurveIsogeny, SIDH_MODEL_MONTGOMERY, SIDH_MODEL_MONTGOMERY, SIDH_MODEL_EDWARDS);
     
+    return SIDH_curve_tune_models(pCurveIsogeny);
+}
+
+
+CRYPTO_STATUS SIDH_curve_select_models(PCurveIsogenyStruct pCurveIsogeny, unsigned int DBL_model, unsigned int TPL_model, unsigned int ladder_model)
+{ // Select the curve model (SIDH_MODEL_MONTGOMERY or SIDH_MODEL_EDWARDS) used for the doubling chains in Alice's isogeny tree, 
+  // the tripling chains in Bob's isogeny tree and the base-field ladder in key generation.
+  // With the Edwards model, Alice's isogeny tree is computed entirely in Edwards coordinates, including the 4-isogenies. This saves the per-chain 
+  // conversions of edDBLe() (about 2% of Alice's shared key), but remains about 20% slower than the Montgomery (A+2C:4C) path.
+  // All models compute the same results, so the selection only affects performance.
+    PSIDH_dispatch Dispatch;
+
+    if (is_CurveIsogenyStruct_null(pCurveIsogeny) || DBL_model > SIDH_MODEL_EDWARDS || TPL_model > SIDH_MODEL_EDWARDS || ladder_model > SIDH_MODEL_EDWARDS) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    Dispatch = SIDH_DISPATCH(pCurveIsogeny);
+
+    Dispatch->model_DBL = DBL_model;
+    Dispatch->model_TPL = TPL_model;
+    Dispatch->model_ladder = ladder_model;
+    if (DBL_model == SIDH_MODEL_EDWARDS) {                     // Edwards pipeline for Alice's isogeny tree
+        Dispatch->DBLe = edDBLe_native;
+        Dispatch->get_4_isog = get_4_isog_ed;
+        Dispatch->eval_4_isog = eval_4_isog_ed;
+    } else {
+        Dispatch->DBLe = xDBLe_A24;
+        Dispatch->get_4_isog = get_4_isog_A24;
+        Dispatch->eval_4_isog = eval_4_isog_A24;
+    }
+    Dispatch->TPLe = (TPL_model == SIDH_MODEL_EDWARDS) ? edTPLe_A24 : xTPLe_A24;
+    Dispatch->ladder_basefield = (ladder_model == SIDH_MODEL_EDWARDS) ? ladder : ladderMT;
+
+    return CRYPTO_SUCCESS;
+}
+
+
+CRYPTO_STATUS SIDH_curve_tune_models(PCurveIsogenyStruct pCurveIsogeny)
+{ // Time both curve models for each point operation on the running machine and select the fastest ones.
+  // Each model is timed over TUNE_ROUNDS alternating rounds and its fastest round is kept. On ties (e.g., with a coarse timer) the current selection is kept.
+    unsigned int role, round, model, i, selected[3];
+    clock_t start, elapsed, best[3][2];
+    point_proj_t P;
+    point_basefield_proj_t S, T;
+    f2elm_t A, C, Aout, Cout, coeff[5];
+    felm_t A24 = {0};
+    digit_t scalar[NWORDS_ORDER];
+    PSIDH_dispatch Dispatch;
+
+    if (is_CurveIsogenyStruct_null(pCurveIsogeny)) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    Dispatch = SIDH_DISPATCH(pCurveIsogeny);
+
+    // Operands: the starting curve, a point with x-coordinate x(PA) and, for the ladder, the curve constant used in secret_pt()
+    fp2zero751(A);
+    fp2zero751(C);
+    to_mont(pCurveIsogeny->A, A[0]);
+    to_mont(pCurveIsogeny->C, C[0]);
+    A24[0] = 1;
+
+    for (role = 0; role < 3; role++) {
+        for (round = 0; round < TUNE_ROUNDS; round++) {
+            for (model = 0; model < 2; model++) {
+                fp2zero751(P->X);
+                fp2zero751(P->Z);
+                to_mont(pCurveIsogeny->PA, P->X[0]);
+                fpcopy751(pCurveIsogeny->Montgomery_one, P->Z[0]);
+                copy_words(pCurveIsogeny->Aorder, scalar, NWORDS_ORDER);
+
+                start = clock();
+                if (role == 0) {                               // A row of Alice's tree: doubling chain, 4-isogeny and a few evaluations
+                    if (model == SIDH_MODEL_EDWARDS) {
+                        edDBLe_native(P, P, A, C, TUNE_DBL_STEPS);
+                        get_4_isog_ed(P, Aout, Cout, coeff);
+                        for (i = 0; i < TUNE_EVALS; i++) eval_4_isog_ed(P, coeff);
+                    } else {
+                        xDBLe_A24(P, P, A, C, TUNE_DBL_STEPS);
+                        get_4_isog_A24(P, Aout, Cout, coeff);
+                        for (i = 0; i < TUNE_EVALS; i++) eval_4_isog_A24(P, coeff);
+                    }
+                } else if (role == 1) {
+                    if (model == SIDH_MODEL_EDWARDS) edTPLe_A24(P, P, A, C, TUNE_TPL_STEPS);
+                    else xTPLe_A24(P, P, A, C, TUNE_TPL_STEPS);
+                } else {
+                    if (model == SIDH_MODEL_EDWARDS) ladder(P->X[0], scalar, S, T, A24, TUNE_LADDER_BITS, pCurveIsogeny->owordbits, pCurveIsogeny);
+                    else ladderMT(P->X[0], scalar, S, T, A24, TUNE_LADDER_BITS, pCurveIsogeny->owordbits, pCurveIsogeny);
+                }
+                elapsed = clock() - start;
+                if (round == 0 || elapsed < best[role][model]) best[role][model] = elapsed;
+            }
+        }
+    }
+
+    selected[0] = Dispatch->model_DBL;
+    selected[1] = Dispatch->model_TPL;
+    selected[2] = Dispatch->model_ladder;
+    for (role = 0; role < 3; role++) {
+        if (best[role][SIDH_MODEL_EDWARDS] < best[role][SIDH_MODEL_MONTGOMERY]) {
+            selected[role] = SIDH_MODEL_EDWARDS;
+        } else if (best[role][SIDH_MODEL_MONTGOMERY] < best[role][SIDH_MODEL_EDWARDS]) {
+            selected[role] = SIDH_MODEL_MONTGOMERY;
+        }
+    }
+    clear_words((void*)scalar, NWORDS_ORDER);
+
+    return SIDH_curve_select_models(pCurveIsogeny, selected[0], selected[1], selected[2]);
+}
+
+
+CRYPTO_STATUS optimal_strategy(unsigned int* splits, const unsigned int nleaves, const unsigned int max_points, const uint64_t mul_cost, const uint64_t isog_cost)
+{ // Computes the optimal strategy for traversing an isogeny tree with nleaves leaves via dynamic programming.
+  // A subtree with L leaves is split by m multiplication steps into subtrees with L-m and m leaves, which costs
+  // C(L) = C(L-m) + C(m) + m*mul_cost + (L-m)*isog_cost. The split for a subtree with L leaves is stored in splits[L-1], splits[0] = 0.
+  // Among splits with equal cost, the one needing fewer intermediate points is chosen. The traversal in kex.c can only hold "max_points" 
+  // intermediate points, so if the optimal strategy needs more, the multiplication cost is gradually lowered, which favors recomputation over storage.
+    uint64_t *cost, c, mul = mul_cost, step = mul_cost/16 + 1;
+    unsigned int *depth, d, L, m;
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+
+    if (splits == NULL || nleaves == 0 || max_points == 0) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    cost = (uint64_t*)calloc(nleaves+1, sizeof(uint64_t));
+    depth = (unsigned int*)calloc(nleaves+1, sizeof(unsigned int));
+    if (cost == NULL || depth == NULL) {
+        Status = CRYPTO_ERROR_NO_MEMORY;
+        goto cleanup;
+    }
+
+    while (true) {
+        splits[0] = 0;
+        for (L = 2; L <= nleaves; L++) {
+            cost[L] = (uint64_t)-1;
+            for (m = 1; m < L; m++) {
+                c = cost[L-m] + cost[m] + m*mul + (L-m)*isog_cost;
+                d = depth[L-m] + 1;
+                if (d < depth[m]) d = depth[m];
+                if (c < cost[L] || (c == cost[L] && d < depth[L])) {
+                    cost[L] = c;
+                    depth[L] = d;
+                    splits[L-1] = m;
+                }
+            }
+        }
+        if (depth[nleaves] <= max_points) {
+            break;
+        }
+        if (mul == 0) {                                        // Unreachable: with mul = 0 the strategy uses a single intermediate point
+            Status = CRYPTO_ERROR;
+            break;
+        }
+        mul = (mul > step) ? (mul - step) : 0;
+    }
+
+cleanup:
+    if (cost != NULL) free(cost);
+    if (depth != NULL) free(depth);
+
+    return Status;
+}
+
+
+CRYPTO_STATUS ph_optimal_strategy(unsigned int* splits, const unsigned int ell, const unsigned int e, const unsigned int w, const unsigned int v)
+{ // Optimal strategy for the Pohlig-Hellman in a subgroup of order ell^e with window w and comb table window v (see ph_strategy()).
+  // The tree has ceil(e/w) leaves. A multiplication step costs w cyclotomic squarings or cubings, and correcting an intermediate 
+  // value costs one multiplication per nonzero base-ell^v chunk of a w-digit, i.e., ceil(w/v)*(1 - ell^-v) multiplications on average.
+    unsigned int B, chunks;
+
+    if ((ell != 2 && ell != 3) || w == 0 || v == 0 || w > e) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    B = (ell == 2) ? (1 << v) : (v == 1 ? 3 : v == 2 ? 9 : 27);
+    chunks = (w + v - 1)/v;
+
+    return optimal_strategy(splits, (e + w - 1)/w, MAX_INT_VALUES_PH, w*((ell == 2) ? PH_COST_SQR : PH_COST_CUBE), PH_COST_MUL*chunks*(B-1)/B);
+}
+
+
+uint64_t strategy_cost(const unsigned int* splits, const unsigned int nleaves, const uint64_t mul_cost, const uint64_t isog_cost)
+{ // Cost of traversing an isogeny tree with nleaves leaves using the strategy given by splits (see optimal_strategy()).
+  // Returns 0 if the strategy is invalid.
+    uint64_t *cost, total = 0;
+    unsigned int L, m;
+
+    if (splits == NULL || nleaves == 0) {
+        return 0;
+    }
+    cost = (uint64_t*)calloc(nleaves+1, sizeof(uint64_t));
+    if (cost == NULL) {
+        return 0;
+    }
+
+    for (L = 2; L <= nleaves; L++) {
+        m = splits[L-1];
+        if (m == 0 || m >= L) {
+            goto cleanup;
+        }
+        cost[L] = cost[L-m] + cost[m] + m*mul_cost + (L-m)*isog_cost;
+    }
+    total = cost[nleaves];
+
+cleanup:
+    free(cost);
+    return total;
+}
+
+
+CRYPTO_STATUS SIDH_curve_set_isogeny_degrees(PCurveIsogenyStruct pCurveIsogeny, unsigned int degree_Alice, unsigned int degree_Bob)
+{ // Select the degree of the isogeny steps in Alice's tree (4 or 8) and Bob's tree (3 or 9).
+  // Each tree has its own strategy, which SIDH_curve_set_strategies() replaces for the selected trees.
+
+    if (is_CurveIsogenyStruct_null(pCurveIsogeny) || (degree_Alice != 4 && degree_Alice != 8) || (degree_Bob != 3 && degree_Bob != 9)) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    SIDH_DISPATCH(pCurveIsogeny)->degree_Alice = degree_Alice;
+    SIDH_DISPATCH(pCurveIsogeny)->degree_Bob = degree_Bob;
+
+    return CRYPTO_SUCCESS;
+}
+
+
+CRYPTO_STATUS SIDH_curve_set_ph_workers(PCurveIsogenyStruct pCurveIsogeny, unsigned int workers)
+{ // Select the number of threads (1, 2 or 4) sharing the four discrete logarithms of public key compression.
+  // The workers only read the Pohlig-Hellman tables, so they need no copies of them. The threads are started here and reused by every compression.
+    void* pool = NULL;
+
+    if (is_CurveIsogenyStruct_null(pCurveIsogeny) || (workers != 1 && workers != 2 && workers != 4)) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    if (workers > SIDH_MAX_PH_WORKERS) {
+        return CRYPTO_ERROR_NOT_IMPLEMENTED;
+    }
+    if (workers > 1) {
+        pool = ph_pool_create(workers);
+        if (pool == NULL) {
+            return CRYPTO_ERROR_NO_MEMORY;
+        }
+    }
+    ph_pool_destroy(SIDH_DISPATCH(pCurveIsogeny)->ph_pool);
+    SIDH_DISPATCH(pCurveIsogeny)->ph_pool = pool;
+    SIDH_DISPATCH(pCurveIsogeny)->ph_workers = workers;
+
     return CRYPTO_SUCCESS;
 }
 
 
+CRYPTO_STATUS SIDH_curve_set_encoding(PCurveIsogenyStruct pCurveIsogeny, unsigned int encoding)
+{ // Select the wire encoding of the uncompressed public keys and the shared secrets.
+  // The Montgomery encoding skips one Montgomery multiplication per base-field element on output and on input.
+
+    if (is_CurveIsogenyStruct_null(pCurveIsogeny) || (encoding != SIDH_ENCODING_STANDARD && encoding != SIDH_ENCODING_MONTGOMERY)) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    SIDH_DISPATCH(pCurveIsogeny)->encoding = encoding;
+
+    return CRYPTO_SUCCESS;
+}
+
+
+CRYPTO_STATUS SIDH_curve_set_random_source(PCurveIsogenyStruct pCurveIsogeny, unsigned int source)
+{ // Select the source of the random values of private keys.
+  // The DRBG saves one call to the random_bytes function per sampling attempt, which is a system call for most operating system generators.
+
+    if (is_CurveIsogenyStruct_null(pCurveIsogeny) || (source != SIDH_RANDOM_CALLBACK && source != SIDH_RANDOM_DRBG)) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    SIDH_DISPATCH(pCurveIsogeny)->random_source = source;
+
+    return CRYPTO_SUCCESS;
+}
+
+
+CRYPTO_STATUS SIDH_curve_set_key_sampling(PCurveIsogenyStruct pCurveIsogeny, unsigned int sampling)
+{ // Select the sampling method of private keys.
+  // Sampling by reduction makes exactly one request to the random source and runs in constant time, rejection sampling keeps the outputs of earlier versions.
+
+    if (is_CurveIsogenyStruct_null(pCurveIsogeny) || (sampling != SIDH_SAMPLING_REJECTION && sampling != SIDH_SAMPLING_REDUCTION)) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    SIDH_DISPATCH(pCurveIsogeny)->key_sampling = sampling;
+
+    return CRYPTO_SUCCESS;
+}
+
+
+CRYPTO_STATUS SIDH_curve_set_strategies(PCurveIsogenyStruct pCurveIsogeny, unsigned int mul_cost_Alice, unsigned int isog_cost_Alice, unsigned int mul_cost_Bob, unsigned int isog_cost_Bob)
+{ // Replace the strategies of the isogeny trees currently selected in pCurveIsogeny by optimal ones for the given relative costs of one multiplication step 
+  // (two doublings for Alice, one tripling for Bob, or three doublings and two triplings with 8- and 9-isogenies) and one isogeny evaluation, 
+  // e.g., measured in cycles on the target machine.
+  // The strategies are only replaced if both computations succeed.
+    unsigned int tmp_Alice[MAX_Alice], tmp_Bob[MAX_Bob], i, nleaves_Alice, nleaves_Bob;
+    unsigned int *splits_Alice, *splits_Bob;
+    CRYPTO_STATUS Status;
+
+    if (is_CurveIsogenyStruct_null(pCurveIsogeny) || mul_cost_Alice == 0 || isog_cost_Alice == 0 || mul_cost_Bob == 0 || isog_cost_Bob == 0) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    if (SIDH_DISPATCH(pCurveIsogeny)->degree_Alice == 8) {
+        splits_Alice = pCurveIsogeny->splits_Alice8;
+        nleaves_Alice = MAX_Alice8;
+    } else {
+        splits_Alice = pCurveIsogeny->splits_Alice;
+        nleaves_Alice = MAX_Alice;
+    }
+    if (SIDH_DISPATCH(pCurveIsogeny)->degree_Bob == 9) {
+        splits_Bob = pCurveIsogeny->splits_Bob9;
+        nleaves_Bob = MAX_Bob9;
+    } else {
+        splits_Bob = pCurveIsogeny->splits_Bob;
+        nleaves_Bob = MAX_Bob;
+    }
+
+    Status = optimal_strategy(tmp_Alice, nleaves_Alice, MAX_INT_POINTS_ALICE, mul_cost_Alice, isog_cost_Alice);
+    if (Status != CRYPTO_SUCCESS) {
+        return Status;
+    }
+    Status = optimal_strategy(tmp_Bob, nleaves_Bob, MAX_INT_POINTS_BOB, mul_cost_Bob, isog_cost_Bob);
+    if (Status != CRYPTO_SUCCESS) {
+        return Status;
+    }
+
+    for (i = 0; i < nleaves_Alice; i++) {
+        splits_Alice[i] = tmp_Alice[i];
+    }
+    for (i = 0; i < nleaves_Bob; i++) {
+        splits_Bob[i] = tmp_Bob[i];
+    }
+    return CRYPTO_SUCCESS;
+}
+
+
+uint64_t SIDH_strategy_cost(PCurveIsogenyStruct pCurveIsogeny, unsigned int AliceOrBob, unsigned int mul_cost, unsigned int isog_cost)
+{ // Predicted cost of the isogeny tree traversal of Alice (AliceOrBob = 0) or Bob (AliceOrBob = 1) with the tree and strategy currently set in pCurveIsogeny,
+  // given the costs of one multiplication step and one isogeny evaluation. Returns 0 on error.
+
+    if (is_CurveIsogenyStruct_null(pCurveIsogeny) || AliceOrBob > 1) {
+        return 0;
+    }
+    if (AliceOrBob == ALICE) {
+        if (SIDH_DISPATCH(pCurveIsogeny)->degree_Alice == 8) {
+            return strategy_cost(pCurveIsogeny->splits_Alice8, MAX_Alice8, mul_cost, isog_cost);
+        }
+        return strategy_cost(pCurveIsogeny->splits_Alice, MAX_Alice, mul_cost, isog_cost);
+    } else {
+        if (SIDH_DISPATCH(pCurveIsogeny)->degree_Bob == 9) {
+            return strategy_cost(pCurveIsogeny->splits_Bob9, MAX_Bob9, mul_cost, isog_cost);
+        }
+        return strategy_cost(pCurveIsogeny->splits_Bob, MAX_Bob, mul_cost, isog_cost);
+    }
+}
+
+
 PCurveIsogenyStruct SIDH_curve_allocate(PCurveIsogenyStaticData CurveData)
 { // Dynamic allocation of memory for curve isogeny structure.
   // Returns NULL on error.
@@ -72,6 +484,16 @@ PCurveIsogenyStruct SIDH_curve_allocate(PCurveIsogenyStaticData CurveData)
     pCurveIsogeny->Montgomery_R2 = (digit_t*)calloc(1, pbytes);
     pCurveIsogeny->Montgomery_pp = (digit_t*)calloc(1, pbytes);
     pCurveIsogeny->Montgomery_one = (digit_t*)calloc(1, pbytes);
+    pCurveIsogeny->splits_Alice = (unsigned int*)calloc(MAX_Alice, sizeof(unsigned int));
+    pCurveIsogeny->splits_Bob = (unsigned int*)calloc(MAX_Bob, sizeof(unsigned int));
+    pCurveIsogeny->splits_Alice8 = (unsigned int*)calloc(MAX_Alice8, sizeof(unsigned int));
+    pCurveIsogeny->splits_Bob9 = (unsigned int*)calloc(MAX_Bob9, sizeof(unsigned int));
+    pCurveIsogeny->splits_ph2 = (unsigned int*)calloc(PH2_LEAVES, sizeof(unsigned int));
+    pCurveIsogeny->splits_ph3 = (unsigned int*)calloc(PH3_LEAVES, sizeof(unsigned int));
+    pCurveIsogeny->Dispatch = calloc(1, sizeof(SIDH_dispatch));
+#if defined(SIDH_BOUNDED_STACK)
+    pCurveIsogeny->Workspace = calloc(1, sizeof(SIDH_workspace));
+#endif
 
     if (is_CurveIsogenyStruct_null(pCurveIsogeny)) {
         return NULL;
@@ -107,21 +529,75 @@ void SIDH_curve_free(PCurveIsogenyStruct pCurveIsogeny)
              free(pCurveIsogeny->Montgomery_pp);
         if (pCurveIsogeny->Montgomery_one != NULL) 
              free(pCurveIsogeny->Montgomery_one);
+        if (pCurveIsogeny->splits_Alice != NULL) 
+             free(pCurveIsogeny->splits_Alice);
+        if (pCurveIsogeny->splits_Bob != NULL) 
+             free(pCurveIsogeny->splits_Bob);
+        if (pCurveIsogeny->splits_Alice8 != NULL) 
+             free(pCurveIsogeny->splits_Alice8);
+        if (pCurveIsogeny->splits_Bob9 != NULL) 
+             free(pCurveIsogeny->splits_Bob9);
+        if (pCurveIsogeny->splits_ph2 != NULL) 
+             free(pCurveIsogeny->splits_ph2);
+        if (pCurveIsogeny->splits_ph3 != NULL) 
+             free(pCurveIsogeny->splits_ph3);
+        if (pCurveIsogeny->Dispatch != NULL) {
+             ph_pool_destroy(SIDH_DISPATCH(pCurveIsogeny)->ph_pool);
+             free(pCurveIsogeny->Dispatch);
+        }
+        if (pCurveIsogeny->Workspace != NULL) 
+             free(pCurveIsogeny->Workspace);
 
         free(pCurveIsogeny);
     }
 }
 
 
+unsigned char* SIDH_key_buffer_allocate(unsigned int nbytes)
+{ // Dynamic allocation of a zeroed buffer of nbytes bytes aligned to SIDH_KEY_ALIGNMENT bytes.
+  // The distance to the start of the underlying allocation, in [1, SIDH_KEY_ALIGNMENT], is stored in the byte preceding the buffer.
+  // Returns NULL on error.
+    unsigned int nwords = (nbytes + sizeof(digit_t) - 1)/sizeof(digit_t);
+    unsigned char *base, *buffer;
+
+    base = (unsigned char*)calloc(1, nwords*sizeof(digit_t) + SIDH_KEY_ALIGNMENT);
+    if (base == NULL) {
+        return NULL;
+    }
+    buffer = base + SIDH_KEY_ALIGNMENT - ((uintptr_t)base % SIDH_KEY_ALIGNMENT);
+    buffer[-1] = (unsigned char)(buffer - base);
+
+    return buffer;
+}
+
+
+void SIDH_key_buffer_free(unsigned char* buffer, unsigned int nbytes)
+{ // Clear and free a buffer of nbytes bytes allocated with SIDH_key_buffer_allocate()
+
+    if (buffer != NULL)
+    {
+        clear_words((void*)buffer, (nbytes + sizeof(digit_t) - 1)/sizeof(digit_t));
+        free(buffer - buffer[-1]);
+    }
+}
+
+
 bool is_CurveIsogenyStruct_null(PCurveIsogenyStruct pCurveIsogeny)
 { // Check if curve isogeny structure is NULL
 
     if (pCurveIsogeny == NULL || pCurveIsogeny->prime == NULL || pCurveIsogeny->A == NULL || pCurveIsogeny->C == NULL || pCurveIsogeny->Aorder == NULL || pCurveIsogeny->Border == NULL || 
         pCurveIsogeny->PA == NULL || pCurveIsogeny->PB == NULL || pCurveIsogeny->BigMont_order == NULL || pCurveIsogeny->Montgomery_R2 == NULL || pCurveIsogeny->Montgomery_pp == NULL || 
-        pCurveIsogeny->Montgomery_one == NULL)
+        pCurveIsogeny->Montgomery_one == NULL || pCurveIsogeny->splits_Alice == NULL || pCurveIsogeny->splits_Bob == NULL || 
+        pCurveIsogeny->splits_Alice8 == NULL || pCurveIsogeny->splits_Bob9 == NULL || pCurveIsogeny->splits_ph2 == NULL || pCurveIsogeny->splits_ph3 == NULL || 
+        pCurveIsogeny->Dispatch == NULL)
     {
         return true;
     }
+#if defined(SIDH_BOUNDED_STACK)
+    if (pCurveIsogeny->Workspace == NULL) {
+        return true;
+    }
+#endif
     return false;
 }
 
@@ -152,9 +628,302 @@ const char* SIDH_get_error_message(CRYPTO_STATUS Status)
 };
 
 
+// Built-in DRBG for the sampling of private keys (see SIDH_curve_set_random_source())
+// Each thread owns its state, so no locking is needed. The state is refilled with DRBG_BLOCK_BYTES bytes of ChaCha20 keystream at a time, whose first 
+// 32 bytes replace the key (fast key erasure), and it is reseeded from the random_bytes function every DRBG_RESEED_BYTES output bytes.
+// On Linux the state lives in a page that is wiped in the child of a fork(), which forces a reseed; when the kernel lacks MADV_WIPEONFORK, and on other systems, 
+// the process id is checked instead. With pthreads support the state is also registered with a thread-specific key, whose destructor frees it at thread exit.
+
+typedef struct {
+    uint32_t      key[8];                                                 // ChaCha20 key
+    unsigned char buffer[DRBG_BLOCK_BYTES-32];                       // Keystream not yet output, the first "available" bytes are cleared
+    unsigned int  available;                                              // Number of unused bytes at the end of buffer
+    unsigned int  seeded;                                                 // 0 before the first seeding and in the child of a fork()
+    uint64_t      output_bytes;                                           // Number of bytes output since the last reseed
+    unsigned int  check_pid;                                              // Detect fork() through the process id
+    long          pid;                                                    // Process id at the last reseed
+} SIDH_drbg, *PSIDH_drbg;
+
+static SIDH_THREAD_LOCAL PSIDH_drbg drbg_state = NULL;
+#if defined(SIDH_PTHREADS)
+static pthread_key_t drbg_key;                                            // Runs drbg_free() on the state of an exiting thread
+static pthread_once_t drbg_key_once = PTHREAD_ONCE_INIT;
+static int drbg_key_created = 0;
+#endif
+
+#define ROTL32(a, n)    (((a) << (n)) | ((a) >> (32-(n))))
+#define QUARTERROUND(a, b, c, d)  \
+    a += b; d ^= a; d = ROTL32(d, 16); c += d; b ^= c; b = ROTL32(b, 12); \
+    a += b; d ^= a; d = ROTL32(d, 8);  c += d; b ^= c; b = ROTL32(b, 7);
+
+
+static void chacha20_block(const uint32_t* key, const uint32_t counter, unsigned char* out)
+{ // ChaCha20 block function with a zero nonce, out = 64 bytes of keystream
+    uint32_t in[16] = { 0x61707865, 0x3320646e, 0x79622d32, 0x6b206574 }, x[16];
+    unsigned int i;
+
+    for (i = 0; i < 8; i++) {
+        in[4+i] = key[i];
+    }
+    in[12] = counter;
+    for (i = 0; i < 16; i++) {
+        x[i] = in[i];
+    }
+    for (i = 0; i < 10; i++) {                                            // 20 rounds
+        QUARTERROUND(x[0], x[4], x[8],  x[12]);
+        QUARTERROUND(x[1], x[5], x[9],  x[13]);
+        QUARTERROUND(x[2], x[6], x[10], x[14]);
+        QUARTERROUND(x[3], x[7], x[11], x[15]);
+        QUARTERROUND(x[0], x[5], x[10], x[15]);
+        QUARTERROUND(x[1], x[6], x[11], x[12]);
+        QUARTERROUND(x[2], x[7], x[8],  x[13]);
+        QUARTERROUND(x[3], x[4], x[9],  x[14]);
+    }
+    for (i = 0; i < 16; i++) {
+        x[i] += in[i];
+        out[4*i]   = (unsigned char)x[i];
+        out[4*i+1] = (unsigned char)(x[i] >> 8);
+        out[4*i+2] = (unsigned char)(x[i] >> 16);
+        out[4*i+3] = (unsigned char)(x[i] >> 24);
+    }
+    clear_words((void*)x, sizeof(x)/sizeof(digit_t));
+}
+
+
+static void drbg_refill(PSIDH_drbg drbg)
+{ // Refill the buffer with fresh keystream and replace the key by the first 32 bytes of it
+    unsigned char block[64];
+    unsigned int i, j;
+
+    chacha20_block(drbg->key, 0, block);
+    memcpy(drbg->buffer, &block[32], 32);
+    for (j = 1; j < DRBG_BLOCK_BYTES/64; j++) {
+        chacha20_block(drbg->key, j, &drbg->buffer[64*j-32]);
+    }
+    for (i = 0; i < 8; i++) {
+        drbg->key[i] = (uint32_t)block[4*i] | ((uint32_t)block[4*i+1] << 8) | ((uint32_t)block[4*i+2] << 16) | ((uint32_t)block[4*i+3] << 24);
+    }
+    drbg->available = DRBG_BLOCK_BYTES-32;
+    clear_words((void*)block, sizeof(block)/sizeof(digit_t));
+}
+
+
+static CRYPTO_STATUS drbg_reseed(PSIDH_drbg drbg, RandomBytes RandomBytesFunction)
+{ // Mix 32 bytes from the random_bytes function into the key and discard the buffered keystream
+    unsigned char seed[32];
+    unsigned int i;
+    CRYPTO_STATUS Status;
+
+    Status = RandomBytesFunction(32, seed);
+    if (Status != CRYPTO_SUCCESS) {
+        return Status;
+    }
+    for (i = 0; i < 8; i++) {
+        drbg->key[i] ^= (uint32_t)seed[4*i] | ((uint32_t)seed[4*i+1] << 8) | ((uint32_t)seed[4*i+2] << 16) | ((uint32_t)seed[4*i+3] << 24);
+    }
+    clear_words((void*)seed, sizeof(seed)/sizeof(digit_t));
+    drbg_refill(drbg);
+    drbg->seeded = 1;
+    drbg->output_bytes = 0;
+    if (drbg->check_pid) {
+        drbg->pid = DRBG_GETPID();
+    }
+    return CRYPTO_SUCCESS;
+}
+
+
+static PSIDH_drbg drbg_allocate(void)
+{ // Allocate a zeroed DRBG state for the calling thread. Returns NULL on error.
+    PSIDH_drbg drbg;
+
+#if (OS_TARGET == OS_LINUX)
+    drbg = (PSIDH_drbg)mmap(NULL, sizeof(SIDH_drbg), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if ((void*)drbg == MAP_FAILED) {
+        return NULL;
+    }
+    drbg->check_pid = 1;
+  #if defined(MADV_WIPEONFORK)
+    if (madvise((void*)drbg, sizeof(SIDH_drbg), MADV_WIPEONFORK) == 0) {
+        drbg->check_pid = 0;
+    }
+  #endif
+#else
+    drbg = (PSIDH_drbg)calloc(1, sizeof(SIDH_drbg));
+    if (drbg == NULL) {
+        return NULL;
+    }
+    drbg->check_pid = 1;
+#endif
+    return drbg;
+}
+
+
+static void drbg_free(void* drbg)
+{ // Clear and free a DRBG state allocated with drbg_allocate()
+
+    clear_words(drbg, sizeof(SIDH_drbg)/sizeof(digit_t));
+#if (OS_TARGET == OS_LINUX)
+    munmap(drbg, sizeof(SIDH_drbg));
+#else
+    free(drbg);
+#endif
+}
+
+
+#if defined(SIDH_PTHREADS)
+static void drbg_key_create(void)
+{ // Create the thread-specific key whose destructor frees the DRBG state of an exiting thread
+
+    drbg_key_created = (pthread_key_create(&drbg_key, drbg_free) == 0);
+}
+#endif
+
+
+static CRYPTO_STATUS drbg_random_bytes(unsigned int nbytes, unsigned char* random_array, RandomBytes RandomBytesFunction)
+{ // Output "nbytes" bytes from the DRBG of the calling thread, allocating and seeding it on first use
+    PSIDH_drbg drbg = drbg_state;
+    unsigned int n;
+    CRYPTO_STATUS Status;
+
+    if (drbg == NULL) {
+        drbg = drbg_allocate();
+        if (drbg == NULL) {
+            return CRYPTO_ERROR_NO_MEMORY;
+        }
+#if defined(SIDH_PTHREADS)
+        pthread_once(&drbg_key_once, drbg_key_create);
+        if (!drbg_key_created || pthread_setspecific(drbg_key, (void*)drbg) != 0) {     // Never keep a state that would leak at thread exit
+            drbg_free((void*)drbg);
+            return CRYPTO_ERROR_NO_MEMORY;
+        }
+#endif
+        drbg_state = drbg;
+    }
+    if (drbg->check_pid && drbg->seeded && drbg->pid != DRBG_GETPID()) {
+        drbg->seeded = 0;
+    }
+    if (drbg->seeded == 0 || drbg->output_bytes >= DRBG_RESEED_BYTES) {
+        Status = drbg_reseed(drbg, RandomBytesFunction);
+        if (Status != CRYPTO_SUCCESS) {
+            return Status;
+        }
+    }
+
+    drbg->output_bytes += nbytes;
+    while (nbytes > 0) {
+        if (drbg->available == 0) {
+            drbg_refill(drbg);
+        }
+        n = (nbytes < drbg->available) ? nbytes : drbg->available;
+        memcpy(random_array, &drbg->buffer[sizeof(drbg->buffer) - drbg->available], n);
+        memset(&drbg->buffer[sizeof(drbg->buffer) - drbg->available], 0, n);     // Output keystream is never kept
+        drbg->available -= n;
+        random_array += n;
+        nbytes -= n;
+    }
+    return CRYPTO_SUCCESS;
+}
+
+
+void SIDH_drbg_thread_free(void)
+{ // Clear and free the DRBG state of the calling thread
+
+    if (drbg_state != NULL) {
+#if defined(SIDH_PTHREADS)
+        pthread_setspecific(drbg_key, NULL);
+#endif
+        drbg_free((void*)drbg_state);
+        drbg_state = NULL;
+    }
+}
+
+
+static CRYPTO_STATUS random_bytes(unsigned int nbytes, unsigned char* random_array, PCurveIsogenyStruct pCurveIsogeny)
+{ // Random bytes for private keys from the source selected in pCurveIsogeny
+
+    if (SIDH_DISPATCH(pCurveIsogeny)->random_source == SIDH_RANDOM_DRBG) {
+        return drbg_random_bytes(nbytes, random_array, pCurveIsogeny->RandomBytesFunction);
+    }
+    return (pCurveIsogeny->RandomBytesFunction)(nbytes, random_array);
+}
+
+
 const uint64_t Border_div3[NWORDS_ORDER] = { 0xEDCD718A828384F9, 0x733B35BFD4427A14, 0xF88229CF94D7CF38, 0x63C56C990C7C2AD6, 0xB858A87E8F4222C7, 0x254C9C6B525EAF5 }; 
 
 
+static void shiftr_sample(const digit_t* x, const unsigned int shift, digit_t* c)
+{ // c = floor(x/2^shift) for a key sample x of KEY_SAMPLE_NWORDS digits, where c has NWORDS_ORDER digits and shift is not a multiple of RADIX
+    unsigned int i, q = shift/RADIX, b = shift%RADIX;
+
+    for (i = 0; i < NWORDS_ORDER; i++) {
+        c[i] = (q+i < KEY_SAMPLE_NWORDS) ? (x[q+i] >> b) : 0;
+        if (q+i+1 < KEY_SAMPLE_NWORDS) {
+            c[i] |= x[q+i+1] << (RADIX-b);
+        }
+    }
+}
+
+
+static void reduce_once(digit_t* a, const digit_t* m)
+{ // a = a-m if a >= m, in constant time, for a in [0, 2*m-1] of NWORDS_ORDER digits
+    digit_t t[NWORDS_ORDER], mask;
+    unsigned int i;
+
+    mask = (digit_t)mp_sub(a, m, t, NWORDS_ORDER) - 1;     // mask = 0xFF..F if a >= m, 0 otherwise
+    for (i = 0; i < NWORDS_ORDER; i++) {
+        a[i] = (t[i] & mask) | (a[i] & ~mask);
+    }
+}
+
+
+static void key_from_sample(const digit_t* x, digit_t* random_digits, const unsigned int AliceOrBob, PCurveIsogenyStruct pCurveIsogeny)
+{ // Private key from a uniform sample x of KEY_SAMPLE_NWORDS digits, by reduction in constant time. The output has the range of random_mod_order().
+  // Alice: r = x mod (2^371-1) by folding the bits above 2^371, and the output is 2*(r+1) in [2, oA-2].
+  // Bob:   r = x mod 3^239 by one Montgomery multiplication by 2^378 mod 3^239, then r mod 3^238 by two conditional subtractions of oB/3, 
+  //        and the output is 3*r in [3, oB-3], where r = 0 (probability 3^-238) is replaced by 1.
+  // The statistical distance to the rejection sampling of random_mod_order() is below 2^-64.
+    uint64_t Montgomery_rprime[NWORDS64_ORDER] = {0x48062A91D3AB563D, 0x6CE572751303C2F5, 0x5D1319F3F160EC9D, 0xE35554E8C2D5623A, 0xCA29300232BC79A5, 0x8AAD843D646D78C5}; // Value -(3^239)^-1 mod 2^384
+    uint64_t Montgomery_2e378[NWORDS64_ORDER] = {0xFCA49F2C22FA8D58, 0x2E9796A550AD051E, 0x338207246A4488DD, 0x34B519F2FB9D6C44, 0x3717E4A0F5CDB6F4, 0x061FEC257F35DADE};  // Value 2^378 in Montgomery representation, 2^(378+384) mod 3^239
+    digit_t r[NWORDS_ORDER] = {0}, h[NWORDS_ORDER], m[NWORDS_ORDER] = {0}, one[NWORDS_ORDER] = {0}, zero;
+    unsigned int i, nbits = ((AliceOrBob == ALICE) ? pCurveIsogeny->oAbits : pCurveIsogeny->oBbits) - 1;   // 371 or 378 
+
+    for (i = 0; i < nbits/RADIX; i++) {                     // r = x mod 2^nbits, h = floor(x/2^nbits)
+        r[i] = x[i];
+    }
+    r[nbits/RADIX] = x[nbits/RADIX] & (((digit_t)1 << (nbits%RADIX)) - 1);
+    shiftr_sample(x, nbits, h);
+    one[0] = 1;
+
+    if (AliceOrBob == ALICE) {
+        for (i = 0; i < nbits/RADIX; i++) {                 // m = 2^371-1
+            m[i] = (digit_t)-1;
+        }
+        m[nbits/RADIX] = ((digit_t)1 << (nbits%RADIX)) - 1;
+        mp_add(r, h, r, NWORDS_ORDER);                      // r = x mod m, since 2^371 = 1 mod m and h < 2^(KEY_SAMPLE_EXTRA_BITS+13)
+        reduce_once(r, m);
+        mp_add(r, one, r, NWORDS_ORDER);                    // [1, 2^371-1]
+        copy_words(r, random_digits, NWORDS_ORDER);
+        mp_shiftl1(random_digits, NWORDS_ORDER);            // Alice's output in the range [2, order-2]
+    } else {
+        Montgomery_multiply_mod_order(h, (digit_t*)Montgomery_2e378, h, pCurveIsogeny->Border, (digit_t*)Montgomery_rprime);    // h = h*2^378 mod oB
+        mp_add(r, h, r, NWORDS_ORDER);                      
+        reduce_once(r, pCurveIsogeny->Border);              // r = x mod oB
+        reduce_once(r, (digit_t*)Border_div3);              
+        reduce_once(r, (digit_t*)Border_div3);              // r = x mod oB/3
+        zero = 0;
+        for (i = 0; i < NWORDS_ORDER; i++) {
+            zero |= r[i];
+        }
+        r[0] |= 1 ^ ((zero | (0-zero)) >> (RADIX-1));      // r = 1 if r = 0
+        copy_words(r, random_digits, NWORDS_ORDER);
+        mp_shiftl1(random_digits, NWORDS_ORDER);
+        mp_add(random_digits, r, random_digits, NWORDS_ORDER);      // Bob's output in the range [3, order-3]
+    }
+    clear_words((void*)r, NWORDS_ORDER);
+    clear_words((void*)h, NWORDS_ORDER);
+}
+
+
 CRYPTO_STATUS random_mod_order(digit_t* random_digits, unsigned int AliceOrBob, PCurveIsogenyStruct pCurveIsogeny)
 { // Output random values in the range [1, order-1] in little endian format that can be used as private keys.
   // It makes requests of random values with length "oAbits" (when AliceOrBob = 0) or "oBbits" (when AliceOrBob = 1) to the "random_bytes" function. 
@@ -162,8 +931,9 @@ CRYPTO_STATUS random_mod_order(digit_t* random_digits, unsigned int AliceOrBob,
   // If successful, the output is given in "random_digits" in the range [1, Aorder-1] ([1, Border-1], resp.).
   // The "random_bytes" function, which is passed through the curve isogeny structure PCurveIsogeny, should be set up in advance using SIDH_curve_initialize().
   // The caller is responsible of providing the "random_bytes" function passing random values as octets.
+  // With SIDH_SAMPLING_REDUCTION a single request of KEY_SAMPLE_NWORDS digits is reduced in constant time instead (see key_from_sample()).
     unsigned int ntry = 0, nbytes, nwords;    
-    digit_t t1[MAXWORDS_ORDER] = {0}, order2[MAXWORDS_ORDER] = {0};
+    digit_t t1[MAXWORDS_ORDER] = {0}, order2[MAXWORDS_ORDER] = {0}, sample[KEY_SAMPLE_NWORDS];
     unsigned char mask;
     CRYPTO_STATUS Status = CRYPTO_ERROR_UNKNOWN;
 	int i;
@@ -173,6 +943,15 @@ CRYPTO_STATUS random_mod_order(digit_t* random_digits, unsigned int AliceOrBob,
     }
 
     clear_words((void*)random_digits, MAXWORDS_ORDER);     
+    if (SIDH_DISPATCH(pCurveIsogeny)->key_sampling == SIDH_SAMPLING_REDUCTION) {
+        Status = random_bytes(sizeof(sample), (unsigned char*)sample, pCurveIsogeny);
+        if (Status == CRYPTO_SUCCESS) {
+            key_from_sample(sample, random_digits, AliceOrBob, pCurveIsogeny);
+        }
+        clear_words((void*)sample, KEY_SAMPLE_NWORDS);
+        return Status;
+    }
+
     t1[0] = 2;
     if (AliceOrBob == ALICE) {
         nbytes = (pCurveIsogeny->oAbits+7)/8;                  // Number of random bytes to be requested 
@@ -194,7 +973,7 @@ CRYPTO_STATUS random_mod_order(digit_t* random_digits, unsigned int AliceOrBob,
         if (ntry > 100) {                                      // Max. 100 iterations to obtain random value in [0, order-2] 
             return CRYPTO_ERROR_TOO_MANY_ITERATIONS;
         }
-        Status = (pCurveIsogeny->RandomBytesFunction)(nbytes, (unsigned char*)random_digits);
+        Status = random_bytes(nbytes, (unsigned char*)random_digits, pCurveIsogeny);
         if (Status != CRYPTO_SUCCESS) {
             return Status;
         }
@@ -240,6 +1019,34 @@ CRYPTO_STATUS random_mod_order(digit_t* random_digits, unsigned int AliceOrBob,
 }
 
 
+CRYPTO_STATUS random_mod_order_batch(digit_t* random_digits, unsigned int nkeys, unsigned int AliceOrBob, PCurveIsogenyStruct pCurveIsogeny)
+{ // Output nkeys private keys of Alice (AliceOrBob = 0) or Bob (AliceOrBob = 1), the i-th in random_digits[i*NWORDS_ORDER], ..., random_digits[(i+1)*NWORDS_ORDER-1].
+  // The keys are sampled by reduction as with SIDH_SAMPLING_REDUCTION, from a single request of nkeys*KEY_SAMPLE_NWORDS digits to the random source.
+    digit_t* samples;
+    unsigned int i;
+    CRYPTO_STATUS Status;
+
+    if (random_digits == NULL || nkeys == 0 || nkeys > 0xFFFFFFFF/(KEY_SAMPLE_NWORDS*sizeof(digit_t)) || is_CurveIsogenyStruct_null(pCurveIsogeny) || AliceOrBob > 1) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    samples = (digit_t*)calloc(nkeys, KEY_SAMPLE_NWORDS*sizeof(digit_t));
+    if (samples == NULL) {
+        return CRYPTO_ERROR_NO_MEMORY;
+    }
+
+    Status = random_bytes(nkeys*KEY_SAMPLE_NWORDS*sizeof(digit_t), (unsigned char*)samples, pCurveIsogeny);
+    if (Status == CRYPTO_SUCCESS) {
+        for (i = 0; i < nkeys; i++) {
+            key_from_sample(&samples[i*KEY_SAMPLE_NWORDS], &random_digits[i*NWORDS_ORDER], AliceOrBob, pCurveIsogeny);
+        }
+    }
+
+    clear_words((void*)samples, nkeys*KEY_SAMPLE_NWORDS);
+    free(samples);
+    return Status;
+}
+
+
 CRYPTO_STATUS random_BigMont_mod_order(digit_t* random_digits, PCurveIsogenyStruct pCurveIsogeny)
 { // Output random values in the range [1, BigMont_order-1] in little endian format that can be used as private keys to compute scalar multiplications 
   // using the elliptic curve BigMont.
@@ -268,7 +1075,7 @@ CRYPTO_STATUS random_BigMont_mod_order(digit_t* random_digits, PCurveIsogenyStru
         if (ntry > 100) {                                      // Max. 100 iterations to obtain random value in [0, order-2] 
             return CRYPTO_ERROR_TOO_MANY_ITERATIONS;
         }
-        Status = (pCurveIsogeny->RandomBytesFunction)(nbytes, (unsigned char*)random_digits);
+        Status = random_bytes(nbytes, (unsigned char*)random_digits, pCurveIsogeny);
         if (Status != CRYPTO_SUCCESS) {
             return Status;
         }
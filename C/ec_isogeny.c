@@ -11,8 +11,15 @@
 
 #include "SIDH_internal.h"
 #include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(SIDH_PTHREADS)
+    #include <pthread.h>
+#endif
 
 extern const uint64_t LIST[22][NWORDS64_FIELD];
+extern const uint64_t LIST_SQR[2*NLIST_SQR][NWORDS64_FIELD];
+extern const unsigned int LIST_SQR_R[NLIST_SQR];
 
 
 void j_inv(const f2elm_t A, const f2elm_t C, f2elm_t jinv)
@@ -67,6 +74,34 @@ void xDBLADD(point_proj_t P, point_proj_t Q, const f2elm_t xPQ, const f2elm_t A2
 }
 
 
+void xDBLADD_proj(point_proj_t P, point_proj_t Q, const f2elm_t xPQ, const f2elm_t A24plus, const f2elm_t C24)
+{ // Simultaneous doubling and differential addition with a projective curve constant.
+  // Input: projective Montgomery points P=(XP:ZP) and Q=(XQ:ZQ) such that xP=XP/ZP and xQ=XQ/ZQ, affine difference xPQ=x(P-Q) and Montgomery curve constants A24plus = A+2C and C24 = 4C.
+  // Output: projective Montgomery points P <- 2*P = (X2P:Z2P) such that x(2P)=X2P/Z2P, and Q <- P+Q = (XQP:ZQP) such that = x(Q+P)=XQP/ZQP. 
+    f2elm_t t0, t1, t2;
+
+    fp2add751(P->X, P->Z, t0);                         // t0 = XP+ZP
+    fp2sub751(P->X, P->Z, t1);                         // t1 = XP-ZP
+    fp2sqr751_mont(t0, P->X);                          // XP = (XP+ZP)^2
+    fp2sub751(Q->X, Q->Z, t2);                         // t2 = XQ-ZQ
+    fp2add751(Q->X, Q->Z, Q->X);                       // XQ = XQ+ZQ
+    fp2mul751_mont(t0, t2, t0);                        // t0 = (XP+ZP)*(XQ-ZQ)
+    fp2sqr751_mont(t1, P->Z);                          // ZP = (XP-ZP)^2
+    fp2mul751_mont(t1, Q->X, t1);                      // t1 = (XP-ZP)*(XQ+ZQ)
+    fp2sub751(P->X, P->Z, t2);                         // t2 = (XP+ZP)^2-(XP-ZP)^2
+    fp2mul751_mont(P->Z, C24, P->Z);                   // ZP = C24*(XP-ZP)^2
+    fp2mul751_mont(P->X, P->Z, P->X);                  // XP = C24*(XP+ZP)^2*(XP-ZP)^2
+    fp2mul751_mont(t2, A24plus, Q->X);                 // XQ = A24plus*[(XP+ZP)^2-(XP-ZP)^2]
+    fp2sub751(t0, t1, Q->Z);                           // ZQ = (XP+ZP)*(XQ-ZQ)-(XP-ZP)*(XQ+ZQ)
+    fp2add751(Q->X, P->Z, P->Z);                       // ZP = A24plus*[(XP+ZP)^2-(XP-ZP)^2]+C24*(XP-ZP)^2
+    fp2add751(t0, t1, Q->X);                           // XQ = (XP+ZP)*(XQ-ZQ)+(XP-ZP)*(XQ+ZQ)
+    fp2mul751_mont(P->Z, t2, P->Z);                    // ZP = [A24plus*[(XP+ZP)^2-(XP-ZP)^2]+C24*(XP-ZP)^2]*[(XP+ZP)^2-(XP-ZP)^2]
+    fp2sqr751_mont(Q->Z, Q->Z);                        // ZQ = [(XP+ZP)*(XQ-ZQ)-(XP-ZP)*(XQ+ZQ)]^2
+    fp2sqr751_mont(Q->X, Q->X);                        // XQ = [(XP+ZP)*(XQ-ZQ)+(XP-ZP)*(XQ+ZQ)]^2
+    fp2mul751_mont(Q->Z, xPQ, Q->Z);                   // ZQ = xPQ*[(XP+ZP)*(XQ-ZQ)-(XP-ZP)*(XQ+ZQ)]^2
+}
+
+
 // original version of xDBL
 void xDBL(const point_proj_t P, point_proj_t Q, const f2elm_t A24, const f2elm_t C24)
 { // Doubling of a Montgomery point in projective coordinates (X:Z).
@@ -134,6 +169,20 @@ void xDBLe(const point_proj_t P, point_proj_t Q, const f2elm_t A, const f2elm_t
 }
 
 
+void xDBLe_A24(const point_proj_t P, point_proj_t Q, const f2elm_t A24plus, const f2elm_t C24, const int e)
+{ // Computes [2^e](X:Z) on Montgomery curve given the constants A24plus = A+2C and C24 = 4C, via e repeated doublings.
+  // Input: projective Montgomery x-coordinates P = (XP:ZP), such that xP=XP/ZP and Montgomery curve constants A24plus and C24.
+  // Output: projective Montgomery x-coordinates Q <- (2^e)*P.
+    int i;
+    
+    copy_words((digit_t*)P, (digit_t*)Q, 2*2*NWORDS_FIELD);
+
+    for (i = 0; i < e; i++) {
+        xDBL(Q, Q, A24plus, C24);
+    }
+}
+
+
 // new version of xDBLe for the Edwards version of xDBL
 void edDBLe(const point_proj_t P, point_proj_t Q, const f2elm_t A, const f2elm_t C, const int e)
 { // Computes [2^e](X:Z) on Montgomery curve with projective constant via e repeated doublings.
@@ -166,6 +215,21 @@ void edDBLe(const point_proj_t P, point_proj_t Q, const f2elm_t A, const f2elm_t
 }
 
 
+void edDBLe_native(const point_proj_t P, point_proj_t Q, const f2elm_t AE, const f2elm_t DE, const int e)
+{ // Computes [2^e](Y:Z) on the Edwards curve via e repeated doublings, without converting from/to Montgomery coordinates.
+  // Input: projective Edwards coordinates P = (YP:ZP), stored in P->X and P->Z (see mont_to_edwards()), and Edwards curve constants AE = A+2C and DE = A-2C.
+  // Output: projective Edwards coordinates Q <- (2^e)*P.
+    int i;
+
+    if (P != Q) {
+        copy_words((digit_t*)P, (digit_t*)Q, 2*2*NWORDS_FIELD);
+    }
+    for (i = 0; i < e; i++) {
+        edDBL(Q, Q, AE, DE);
+    }
+}
+
+
 
 void xADD(point_proj_t P, const point_proj_t Q, const f2elm_t xPQ)
 { // Differential addition.
@@ -358,14 +422,401 @@ CRYPTO_STATUS BigMont_ladder(unsigned char* x, digit_t* m, unsigned char* xout,
 
     A24[0] = (digit_t)CurveIsogeny->BigMont_A24; 
     to_mont(A24, A24);                               // Conversion to Montgomery representation
-    to_mont((digit_t*)x, X);
+    load_words(x, X, NWORDS_FIELD);
+    to_mont(X, X);
     
     copy_words(m, scalar, BIGMONT_NWORDS_ORDER);
-    ladderMT(X, scalar, P1, P2, A24, BIGMONT_NBITS_ORDER, BIGMONT_MAXBITS_ORDER, CurveIsogeny);
+    ladderMT(X, scalar, P1, P2, A24, BIGMONT_NBITS_ORDER, BIGMONT_MAXBITS_ORDER, CurveIsogeny);   // Not dispatched: the Edwards ladder is fixed for A24 = 1
 
     fpinv751_mont(P1->Z);
-    fpmul751_mont(P1->X, P1->Z, (digit_t*)xout);
-    from_mont((digit_t*)xout, (digit_t*)xout);       // Conversion to standard representation
+    fpmul751_mont(P1->X, P1->Z, X);
+    from_mont(X, X);                                 // Conversion to standard representation
+    store_words(X, xout, NWORDS_FIELD);
+
+    return CRYPTO_SUCCESS;
+}
+
+void edDBL_ext_basefield(const point_basefield_ext_t P, point_basefield_ext_t Q)
+{ // Doubling of a point on the twisted Edwards curve -x^2+y^2=1+d*x^2*y^2 over the base field (dbl-2008-hwcd with a = -1)
+  // Input:  projective point P = (X:Y:Z), coordinate T is not used
+  // Output: Q = 2*P = (X:Y:Z:T) in extended coordinates. Q can be equal to P
+    felm_t t0, t1, t2, t3, t4;
+
+    fpsqr751_mont(P->X, t0);                         // t0 = X^2
+    fpsqr751_mont(P->Y, t1);                         // t1 = Y^2
+    fpsqr751_mont(P->Z, t2);                         
+    fpadd751(t2, t2, t2);                            // t2 = 2*Z^2
+    fpadd751(P->X, P->Y, t3);                        
+    fpsqr751_mont(t3, t3);                           
+    fpsub751(t3, t0, t3);                            
+    fpsub751(t3, t1, t3);                            // t3 = E = (X+Y)^2-X^2-Y^2
+    fpadd751(t0, t1, t4);                            
+    fpneg751(t4);                                    // t4 = H = -X^2-Y^2
+    fpsub751(t1, t0, t1);                            // t1 = G = Y^2-X^2
+    fpsub751(t1, t2, t2);                            // t2 = F = G-2*Z^2
+    fpmul751_mont(t3, t2, Q->X);                     // X = E*F
+    fpmul751_mont(t1, t4, Q->Y);                     // Y = G*H
+    fpmul751_mont(t3, t4, Q->T);                     // T = E*H
+    fpmul751_mont(t2, t1, Q->Z);                     // Z = F*G
+}
+
+
+void edMADD_ext_basefield(const point_basefield_ext_t P, const point_basefield_precomp_t Q, point_basefield_ext_t R)
+{ // Mixed addition on the twisted Edwards curve -x^2+y^2=1+d*x^2*y^2 over the base field (madd-2008-hwcd-3 with a = -1)
+  // Inputs: P = (X:Y:Z:T) in extended coordinates, 
+  //         Q = (y+x, y-x, 2*d*x*y) in affine precomputed form.
+  // Output: R = P+Q = (X:Y:Z:T). R can be equal to P
+  // The formulas are complete for points in the subgroup of odd order.
+    felm_t t0, t1, t2, t3, t4;
+
+    fpsub751(P->Y, P->X, t0);                        
+    fpmul751_mont(t0, Q->ymx, t0);                   // t0 = A = (Y-X)*(y-x)
+    fpadd751(P->Y, P->X, t1);                        
+    fpmul751_mont(t1, Q->ypx, t1);                   // t1 = B = (Y+X)*(y+x)
+    fpmul751_mont(P->T, Q->t2d, t2);                 // t2 = C = T*2*d*x*y
+    fpadd751(P->Z, P->Z, t3);                        // t3 = D = 2*Z
+    fpsub751(t1, t0, t4);                            // t4 = E = B-A
+    fpadd751(t1, t0, t1);                            // t1 = H = B+A
+    fpsub751(t3, t2, t0);                            // t0 = F = D-C
+    fpadd751(t3, t2, t3);                            // t3 = G = D+C
+    fpmul751_mont(t4, t0, R->X);                     // X = E*F
+    fpmul751_mont(t3, t1, R->Y);                     // Y = G*H
+    fpmul751_mont(t4, t1, R->T);                     // T = E*H
+    fpmul751_mont(t0, t3, R->Z);                     // Z = F*G
+}
+
+
+static void ext_to_precomp_batch(const point_basefield_ext* P, point_basefield_precomp* Q, felm_t* acc, const unsigned int n, const felm_t d2)
+{ // Converts n points from extended to affine precomputed coordinates (y+x, y-x, 2*d*x*y) using a single inversion
+  // Inputs: P, n points with nonzero Z, scratch space acc of n field elements and the curve constant d2 = 2*d
+  // Output: Q, the n converted points
+    unsigned int i;
+    felm_t inv, t0, x, y;
+
+    fpcopy751(P[0].Z, acc[0]);
+    for (i = 1; i < n; i++) {
+        fpmul751_mont(acc[i-1], P[i].Z, acc[i]);     // acc[i] = Z_0*...*Z_i
+    }
+    fpcopy751(acc[n-1], inv);
+    fpinv751_mont(inv);
+
+    for (i = n; i > 0; i--) {
+        if (i > 1) {
+            fpmul751_mont(inv, acc[i-2], t0);        // t0 = 1/Z_{i-1}
+            fpmul751_mont(inv, P[i-1].Z, inv);       // inv = 1/(Z_0*...*Z_{i-2})
+        } else {
+            fpcopy751(inv, t0);
+        }
+        fpmul751_mont(P[i-1].X, t0, x);
+        fpmul751_mont(P[i-1].Y, t0, y);
+        fpadd751(y, x, Q[i-1].ypx);
+        fpsub751(y, x, Q[i-1].ymx);
+        fpmul751_mont(x, y, t0);
+        fpmul751_mont(t0, d2, Q[i-1].t2d);
+    }
+}
+
+
+static void normalize_batch(felm_t* num, felm_t* den, felm_t* acc, const unsigned int n, const felm_t one)
+{ // Computes num_i/den_i for n fractions using a single inversion (Montgomery's simultaneous inversion), in constant time
+  // A zero denominator gives a zero quotient, as fpinv751_mont() does for a single inversion, without affecting the other quotients.
+  // Inputs: num and den, each one of n field elements, scratch space acc of n field elements, and Montgomery_one
+  // Output: num, the n quotients. den is overwritten
+    unsigned int i, j;
+    digit_t mask;
+    felm_t inv, t0;
+
+    for (i = 0; i < n; i++) {
+        fpcorrection751(den[i]);
+        mask = 0;
+        for (j = 0; j < NWORDS_FIELD; j++) {
+            mask |= den[i][j];
+        }
+        mask = 0 - ((mask | (0-mask)) >> (RADIX-1));                  // mask = all-ones if den_i != 0, 0 otherwise
+        for (j = 0; j < NWORDS_FIELD; j++) {                           // A zero denominator is replaced by 1 and its numerator by 0
+            num[i][j] &= mask;
+            den[i][j] = (den[i][j] & mask) | (one[j] & ~mask);
+        }
+        if (i == 0) {
+            fpcopy751(den[0], acc[0]);
+        } else {
+            fpmul751_mont(acc[i-1], den[i], acc[i]); // acc[i] = den_0*...*den_i
+        }
+    }
+    fpcopy751(acc[n-1], inv);
+    fpinv751_mont(inv);
+
+    for (i = n-1; i > 0; i--) {
+        fpmul751_mont(inv, acc[i-1], t0);            // t0 = 1/den_i
+        fpmul751_mont(inv, den[i], inv);             // inv = 1/(den_0*...*den_{i-1})
+        fpmul751_mont(num[i], t0, num[i]);
+    }
+    fpmul751_mont(num[0], inv, num[0]);
+}
+
+
+static void table_lookup_comb(const unsigned char* table, const unsigned int digit, point_basefield_precomp_t P)
+{ // Constant-time table lookup: every one of the 2^BIGMONT_COMB_TEETH entries is read and the one with index "digit" is extracted using masks.
+  // The entries are read from the caller's byte buffer one digit at a time with memcpy(), which accepts any alignment and compiles to plain loads.
+    unsigned int u, j;
+    digit_t mask, d, *p = (digit_t*)P;
+
+    for (j = 0; j < 3*NWORDS_FIELD; j++) {
+        p[j] = 0;
+    }
+    for (u = 0; u < (1 << BIGMONT_COMB_TEETH); u++) {
+        mask = 0 - (digit_t)(((u ^ digit) - 1) >> (8*sizeof(unsigned int)-1));   // mask = all-ones if u = digit, 0 otherwise
+        for (j = 0; j < 3*NWORDS_FIELD; j++) {                                    // Entries are (ypx, ymx, t2d), 3*NWORDS_FIELD digits each
+            memcpy(&d, &table[(u*3*NWORDS_FIELD + j)*sizeof(digit_t)], sizeof(digit_t));
+            p[j] |= d & mask;
+        }
+    }
+}
+
+
+static void comb_BigMont(const unsigned char* table, const digit_t* m, felm_t num, felm_t den, PCurveIsogenyStruct CurveIsogeny)
+{ // Lim-Lee comb evaluation of m*G on the twisted Edwards curve, using the tables computed by BigMont_fixed_base_precompute()
+  // Bit j+t*e+i*v*e of m, for tooth i, table t and column j, selects the multiple 2^(t*e+i*v*e)*G of entry t in column j. 
+  // Output: the x-coordinate of m*G on BigMont as the fraction num/den = (Z+Y)/(Z-Y)
+    unsigned int i, j, t, bit, digit;
+    point_basefield_ext_t R;
+    point_basefield_precomp_t S;
+
+    fpzero751(R->X);                                 // R = (0:1:1:0), the neutral element
+    fpcopy751(CurveIsogeny->Montgomery_one, R->Y);
+    fpcopy751(CurveIsogeny->Montgomery_one, R->Z);
+    fpzero751(R->T);
+
+    for (j = BIGMONT_COMB_SPACING; j > 0; j--) {
+        if (j != BIGMONT_COMB_SPACING) {
+            edDBL_ext_basefield(R, R);
+        }
+        for (t = 0; t < BIGMONT_COMB_TABLES; t++) {
+            digit = 0;
+            for (i = 0; i < BIGMONT_COMB_TEETH; i++) {
+                bit = (j-1) + t*BIGMONT_COMB_SPACING + i*BIGMONT_COMB_TABLES*BIGMONT_COMB_SPACING;
+                digit |= (unsigned int)((m[bit/RADIX] >> (bit%RADIX)) & 1) << i;
+            }
+            table_lookup_comb(&table[(t << BIGMONT_COMB_TEETH)*sizeof(point_basefield_precomp)], digit, S);
+            edMADD_ext_basefield(R, S, R);
+        }
+    }
+
+    fpadd751(R->Z, R->Y, num);                       // u = (1+y)/(1-y)
+    fpsub751(R->Z, R->Y, den);
+}
+
+
+CRYPTO_STATUS BigMont_fixed_base_precompute(const unsigned char* x, unsigned char* table, PCurveIsogenyStruct CurveIsogeny)
+{ // Precomputation of the comb tables for BigMont's fixed-base scalar multiplication
+  // BigMont: y^2 = u^3+A*u^2+u is birationally equivalent to the twisted Edwards curve -x^2+y^2 = 1+d*x^2*y^2 with d = -(A-2)/(A+2), 
+  // via x = s*u/v and y = (u-1)/(u+1), where s^2 = -(A+2). Table t holds the 2^w sums of the multiples 2^(t*e+i*v*e)*G, 0 <= i < w, 
+  // in the affine form (y+x, y-x, 2*d*x*y), where w = BIGMONT_COMB_TEETH, v = BIGMONT_COMB_TABLES and e = BIGMONT_COMB_SPACING.
+  // Input:  x, the affine x-coordinate of a point G of order BigMont_order on BigMont
+  // Output: table, BIGMONT_FIXED_BASE_TABLE_BYTES bytes
+  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+    unsigned int i, k, t, u, hi, nbase = BIGMONT_COMB_TEETH*BIGMONT_COMB_TABLES, nentries = BIGMONT_COMB_TABLES << BIGMONT_COMB_TEETH;
+    point_basefield_precomp *T, *B;
+    point_basefield_ext* P;
+    point_basefield_proj_t R1, R2;
+    digit_t order[BIGMONT_MAXWORDS_ORDER];
+    felm_t U, V, A, A24 = {0}, d2, s, t0, t1, zero = {0};
+    felm_t* acc;
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+
+    A24[0] = (digit_t)CurveIsogeny->BigMont_A24; 
+    to_mont(A24, A24);                               // Conversion to Montgomery representation
+    load_words(x, U, NWORDS_FIELD);
+    to_mont(U, U);
+    fpadd751(A24, A24, A);
+    fpadd751(A, A, A);
+    fpsub751(A, CurveIsogeny->Montgomery_one, A);
+    fpsub751(A, CurveIsogeny->Montgomery_one, A);   // A = 4*A24-2
+
+    // Validation: G = (u,v) must be on BigMont and BigMont_order*G must be the point at infinity
+    fpadd751(U, A, t0);
+    fpmul751_mont(t0, U, t0);
+    fpadd751(t0, CurveIsogeny->Montgomery_one, t0);
+    fpmul751_mont(t0, U, t0);                        // t0 = u^3+A*u^2+u
+    fpcopy751(t0, V);
+    fpinv751_chain_mont(V);                          
+    fpmul751_mont(V, t0, V);                         // v = t0^((p+1)/4)
+    fpsqr751_mont(V, t1);
+    fpcorrection751(t0);
+    fpcorrection751(t1);
+    if (fpequal751_non_constant_time(t0, t1) == false || fpequal751_non_constant_time(t0, zero) == true) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    copy_words(CurveIsogeny->BigMont_order, order, BIGMONT_MAXWORDS_ORDER);
+    ladderMT(U, order, R1, R2, A24, BIGMONT_NBITS_ORDER, BIGMONT_MAXBITS_ORDER, CurveIsogeny);
+    fpcorrection751(R1->Z);
+    if (fpequal751_non_constant_time(R1->Z, zero) == false) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+
+    P = (point_basefield_ext*)calloc(nentries + nbase, sizeof(point_basefield_ext));   // Table entries and multiples 2^(k*e)*G in extended coordinates
+    B = (point_basefield_precomp*)calloc(nbase, sizeof(point_basefield_precomp));
+    T = (point_basefield_precomp*)calloc(nentries, sizeof(point_basefield_precomp));    // Table entries, stored to the caller's byte buffer at the end
+    acc = (felm_t*)calloc(nentries, sizeof(felm_t));
+    if (P == NULL || B == NULL || T == NULL || acc == NULL) {
+        Status = CRYPTO_ERROR_NO_MEMORY;
+        goto cleanup;
+    }
+
+    // Curve constants s = sqrt(-(A+2)) and d2 = 2*d = 2*(2-A)/(A+2)
+    fpadd751(A, CurveIsogeny->Montgomery_one, t0);
+    fpadd751(t0, CurveIsogeny->Montgomery_one, t0);  // t0 = A+2
+    fpcopy751(t0, s);
+    fpneg751(s);
+    fpcopy751(s, t1);
+    fpinv751_chain_mont(t1);
+    fpmul751_mont(s, t1, s);                         // s = (-(A+2))^((p+1)/4)
+    fpinv751_mont(t0);
+    fpneg751(A);
+    fpadd751(A, CurveIsogeny->Montgomery_one, A);
+    fpadd751(A, CurveIsogeny->Montgomery_one, A);    // A = 2-A
+    fpmul751_mont(A, t0, d2);
+    fpadd751(d2, d2, d2);
+
+    // G on the twisted Edwards curve: x = s*u/v, y = (u-1)/(u+1)
+    fpadd751(U, CurveIsogeny->Montgomery_one, t0);
+    fpmul751_mont(V, t0, t1);
+    fpinv751_mont(t1);                               // t1 = 1/(v*(u+1))
+    fpmul751_mont(t1, t0, t0);
+    fpmul751_mont(t0, U, t0);
+    fpmul751_mont(t0, s, P[nentries].X);             // x = s*u/v
+    fpsub751(U, CurveIsogeny->Montgomery_one, t0);
+    fpmul751_mont(t0, V, t0);
+    fpmul751_mont(t0, t1, P[nentries].Y);            // y = (u-1)/(u+1)
+    fpcopy751(CurveIsogeny->Montgomery_one, P[nentries].Z);
+
+    // Multiples 2^(k*e)*G, 0 <= k < w*v, where k = i*v+t for tooth i and table t
+    for (k = 1; k < nbase; k++) {
+        edDBL_ext_basefield(&P[nentries+k-1], &P[nentries+k]);
+        for (i = 1; i < BIGMONT_COMB_SPACING; i++) {
+            edDBL_ext_basefield(&P[nentries+k], &P[nentries+k]);
+        }
+    }
+    ext_to_precomp_batch(&P[nentries], B, acc, nbase, d2);
+
+    // Entry u of table t is the sum of 2^(t*e+i*v*e)*G over the bits i of u, built from the entry without the top bit of u
+    for (t = 0; t < BIGMONT_COMB_TABLES; t++) {
+        fpzero751(P[t << BIGMONT_COMB_TEETH].X);
+        fpcopy751(CurveIsogeny->Montgomery_one, P[t << BIGMONT_COMB_TEETH].Y);
+        fpcopy751(CurveIsogeny->Montgomery_one, P[t << BIGMONT_COMB_TEETH].Z);
+        fpzero751(P[t << BIGMONT_COMB_TEETH].T);
+        for (u = 1; u < (1 << BIGMONT_COMB_TEETH); u++) {
+            for (hi = 0; (u >> (hi+1)) != 0; hi++);
+            edMADD_ext_basefield(&P[(t << BIGMONT_COMB_TEETH) + (u ^ (1 << hi))], &B[hi*BIGMONT_COMB_TABLES + t], &P[(t << BIGMONT_COMB_TEETH) + u]);
+        }
+    }
+    ext_to_precomp_batch(P, T, acc, nentries, d2);
+    store_words((digit_t*)T, table, nentries*3*NWORDS_FIELD);
+
+cleanup:
+    if (P != NULL) clear_words((void*)P, (nentries + nbase)*sizeof(point_basefield_ext)/sizeof(digit_t));
+    free(P);
+    free(B);
+    free(T);
+    free(acc);
+
+    return Status;
+}
+
+
+CRYPTO_STATUS BigMont_fixed_base(const unsigned char* table, const digit_t* m, unsigned char* xout, PCurveIsogenyStruct CurveIsogeny)
+{ // BigMont's fixed-base scalar multiplication using a comb, in constant time
+  // Inputs: table, computed for the base point G with BigMont_fixed_base_precompute(),
+  //         scalar m in [1, BigMont_order-1].
+  // Output: xout, the affine x-coordinate of m*G
+  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+    felm_t num, den;
+
+    comb_BigMont(table, m, num, den, CurveIsogeny);
+
+    fpinv751_mont(den);
+    fpmul751_mont(num, den, num);
+    from_mont(num, num);                             // Conversion to standard representation
+    store_words(num, xout, NWORDS_FIELD);
+
+    return CRYPTO_SUCCESS;
+}
+
+
+CRYPTO_STATUS BigMont_fixed_base_batch(const unsigned char* table, const digit_t* m, unsigned char* xout, const unsigned int n, PCurveIsogenyStruct CurveIsogeny)
+{ // Batch of BigMont's fixed-base scalar multiplications using a comb, normalized with a single shared inversion
+  // Inputs: table, computed for the base point G with BigMont_fixed_base_precompute(),
+  //         m, the n scalars in [1, BigMont_order-1] (BIGMONT_NWORDS_ORDER words each).
+  // Output: xout, the n affine x-coordinates of m_i*G (NWORDS_FIELD words each)
+  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+    unsigned int i;
+    felm_t *out, *den;
+
+    if (n == 0) {
+        return CRYPTO_SUCCESS;
+    }
+    out = (felm_t*)calloc(3*n, sizeof(felm_t));      // Numerators, denominators and prefix products
+    if (out == NULL) {
+        return CRYPTO_ERROR_NO_MEMORY;
+    }
+    den = &out[n];
+
+    for (i = 0; i < n; i++) {
+        comb_BigMont(table, &m[i*BIGMONT_NWORDS_ORDER], out[i], den[i], CurveIsogeny);
+    }
+    normalize_batch(out, den, &den[n], n, CurveIsogeny->Montgomery_one);
+    for (i = 0; i < n; i++) {
+        from_mont(out[i], out[i]);                   // Conversion to standard representation
+        store_words(out[i], &xout[i*NWORDS_FIELD*sizeof(digit_t)], NWORDS_FIELD);
+    }
+
+    clear_words((void*)out, 3*n*NWORDS_FIELD);
+    free(out);
+
+    return CRYPTO_SUCCESS;
+}
+
+
+CRYPTO_STATUS BigMont_ladder_batch(const unsigned char* x, const digit_t* m, unsigned char* xout, const unsigned int n, PCurveIsogenyStruct CurveIsogeny)
+{ // Batch of BigMont's scalar multiplications using the Montgomery ladder, normalized with a single shared inversion
+  // Inputs: x, the n affine x-coordinates of points P_i on BigMont (NWORDS_FIELD words each),
+  //         m, the n scalars (BIGMONT_NWORDS_ORDER words each).
+  // Output: xout, the n affine x-coordinates of m_i*(x_i:1). xout can be equal to x
+  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+    unsigned int i;
+    point_basefield_proj_t P1, P2;
+    digit_t scalar[BIGMONT_NWORDS_ORDER];
+    felm_t X, A24 = {0};
+    felm_t *out, *den;
+
+    if (n == 0) {
+        return CRYPTO_SUCCESS;
+    }
+    out = (felm_t*)calloc(3*n, sizeof(felm_t));      // Numerators, denominators and prefix products
+    if (out == NULL) {
+        return CRYPTO_ERROR_NO_MEMORY;
+    }
+    den = &out[n];
+
+    A24[0] = (digit_t)CurveIsogeny->BigMont_A24; 
+    to_mont(A24, A24);                               // Conversion to Montgomery representation
+
+    for (i = 0; i < n; i++) {
+        load_words(&x[i*NWORDS_FIELD*sizeof(digit_t)], X, NWORDS_FIELD);
+        to_mont(X, X);
+        copy_words(&m[i*BIGMONT_NWORDS_ORDER], scalar, BIGMONT_NWORDS_ORDER);
+        ladderMT(X, scalar, P1, P2, A24, BIGMONT_NBITS_ORDER, BIGMONT_MAXBITS_ORDER, CurveIsogeny);
+        fpcopy751(P1->X, out[i]);
+        fpcopy751(P1->Z, den[i]);
+    }
+    normalize_batch(out, den, &den[n], n, CurveIsogeny->Montgomery_one);
+    for (i = 0; i < n; i++) {
+        from_mont(out[i], out[i]);                   // Conversion to standard representation
+        store_words(out[i], &xout[i*NWORDS_FIELD*sizeof(digit_t)], NWORDS_FIELD);
+    }
+
+    clear_words((void*)out, 3*n*NWORDS_FIELD);
+    free(out);
 
     return CRYPTO_SUCCESS;
 }
@@ -401,7 +852,7 @@ CRYPTO_STATUS secret_pt(const point_basefield_t P, const digit_t* m, const unsig
     // Setting curve constant to one (in standard representation), used in xDBLADD_basefield() in the ladder computation
     A24[0] = 1;
     copy_words(m, scalar, NWORDS_ORDER);
-    ladder(Q->x, scalar, S, T, A24, nbits, CurveIsogeny->owordbits, CurveIsogeny);
+    SIDH_DISPATCH(CurveIsogeny)->ladder_basefield(Q->x, scalar, S, T, A24, nbits, CurveIsogeny->owordbits, CurveIsogeny);
     
     //RX0 = (2*y*y1*Z0^2*Z1 + Z1*(X0*x1+Z0)*(X0+x1*Z0) - X1*(X0-x1*Z0)^2)*(2*y*y1*Z0^2*Z1 - Z1*(X0*x1+Z0)*(X0+x1*Z0) + X1*(X0-x1*Z0)^2) - 4*y1^2*Z0*Z1^2*(X0+x*Z0)*(X0-x*Z0)^2;
     //RX1 = 4*y*y1*Z0^2*Z1*(Z1*(X0*x1+Z0)*(X0+x1*Z0) - X1*(X0-x1*Z0)^2);
@@ -500,6 +951,61 @@ CRYPTO_STATUS ladder_3_pt(const f2elm_t xP, const f2elm_t xQ, const f2elm_t xPQ,
 }
 
 
+CRYPTO_STATUS ladder_3_pt_proj(const f2elm_t xP, const f2elm_t xQ, const f2elm_t xPQ, const digit_t* m, const unsigned int AliceOrBob, point_proj_t W, const f2elm_t A, const f2elm_t C, PCurveIsogenyStruct CurveIsogeny)
+{ // Computes P+[m]Q via x-only arithmetic, as in ladder_3_pt() but with a projective curve constant so that no inversion is needed to get it.
+  // Input:  three affine points xP,xQ,xPQ and Montgomery constant A/C.
+  // Output: projective Montgomery x-coordinates of x(P+[m]Q)=WX/WZ
+    point_proj_t U = {0}, V = {0};
+    f2elm_t A24plus, C24, constant1 = {0}, constant2;
+    felm_t temp_scalar;
+    unsigned int bit = 0, nbits, fullbits = CurveIsogeny->owordbits;
+    digit_t mask;
+    int i;
+
+    if (AliceOrBob == ALICE) {
+        nbits = CurveIsogeny->oAbits;
+    } else if (AliceOrBob == BOB) {
+        nbits = CurveIsogeny->oBbits;
+    } else {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+   
+    fp2add751(C, C, C24);                                        // C24 = 2C
+    fp2add751(A, C24, A24plus);                                  // A24plus = A+2C
+    fp2add751(C24, C24, C24);                                    // C24 = 4C
+    
+    // Initializing with the points (1:0), (xQ:1) and (xP:1)
+    fpcopy751(CurveIsogeny->Montgomery_one, (digit_t*)U->X);
+    fp2copy751(xQ, V->X);
+    fpcopy751(CurveIsogeny->Montgomery_one, (digit_t*)V->Z);
+    fp2copy751(xP, W->X);
+    fpcopy751(CurveIsogeny->Montgomery_one, (digit_t*)W->Z);
+    fpzero751(W->Z[1]);
+    copy_words(m, temp_scalar, NWORDS_ORDER);
+    
+    for (i = fullbits-nbits; i > 0; i--) {
+        mp_shiftl1(temp_scalar, NWORDS_ORDER);
+    }
+    
+    for (i = nbits; i > 0; i--) {
+        bit = (unsigned int)(temp_scalar[NWORDS_ORDER-1] >> (RADIX-1));
+        mp_shiftl1(temp_scalar, NWORDS_ORDER);
+        mask = 0 - (digit_t)bit;
+
+        swap_points(W, U, mask);
+        swap_points(U, V, mask);
+        select_f2elm(xP, xQ, constant1, mask);
+        select_f2elm(xQ, xPQ, constant2, mask);
+        xADD(W, U, constant1);                     // If bit=0 then W <- W+U, U <- 2*U and V <- U+V, 
+        xDBLADD_proj(U, V, constant2, A24plus, C24);   // else if bit=1 then U <- U+V, V <- 2*V and W <- V+W
+        swap_points(U, V, mask);
+        swap_points(W, U, mask);
+    }
+
+    return CRYPTO_SUCCESS;
+}
+
+
 void get_4_isog(const point_proj_t P, f2elm_t A, f2elm_t C, f2elm_t* coeff)
 { // Computes the corresponding 4-isogeny of a projective Montgomery point (X4:Z4) of order 4.
   // Input:  projective point of order four P = (X4:Z4).
@@ -548,6 +1054,108 @@ void eval_4_isog(point_proj_t P, f2elm_t* coeff)
 }
 
 
+void get_4_isog_A24(const point_proj_t P, f2elm_t A24plus, f2elm_t C24, f2elm_t* coeff)
+{ // Computes the corresponding 4-isogeny of a projective Montgomery point (X4:Z4) of order 4, giving the codomain's doubling constants.
+  // Input:  projective point of order four P = (X4:Z4).
+  // Output: the 4-isogenous Montgomery curve with constants A24plus = A+2C and C24 = 4C (as used by xDBLe_A24()), 
+  //         and the 3 coefficients that are used to evaluate the isogeny at a point in eval_4_isog_A24().
+
+    fp2sub751(P->X, P->Z, coeff[1]);                   // coeff[1] = X4-Z4
+    fp2add751(P->X, P->Z, coeff[2]);                   // coeff[2] = X4+Z4
+    fp2sqr751_mont(P->Z, coeff[0]);                    // coeff[0] = Z4^2
+    fp2add751(coeff[0], coeff[0], coeff[0]);           // coeff[0] = 2*Z4^2
+    fp2sqr751_mont(coeff[0], C24);                     // C24 = 4*Z4^4
+    fp2add751(coeff[0], coeff[0], coeff[0]);           // coeff[0] = 4*Z4^2
+    fp2sqr751_mont(P->X, A24plus);                     // A24plus = X4^2
+    fp2add751(A24plus, A24plus, A24plus);              // A24plus = 2*X4^2
+    fp2sqr751_mont(A24plus, A24plus);                  // A24plus = 4*X4^4
+}
+
+
+void eval_4_isog_A24(point_proj_t P, f2elm_t* coeff)
+{ // Evaluates the isogeny at the point (X:Z) in the domain of the isogeny, given a 4-isogeny phi defined 
+  // by the 3 coefficients in coeff (computed in the function get_4_isog_A24()).
+  // Inputs: the coefficients defining the isogeny, and the projective point P = (X:Z).
+  // Output: the projective point P = phi(P) = (X:Z) in the codomain, at a cost of 6M+2S compared to 9M+1S for eval_4_isog(). 
+    f2elm_t t0, t1;
+
+    fp2add751(P->X, P->Z, t0);                         // t0 = X+Z
+    fp2sub751(P->X, P->Z, t1);                         // t1 = X-Z
+    fp2mul751_mont(t0, coeff[1], P->X);                // X = (X+Z)*coeff[1]
+    fp2mul751_mont(t1, coeff[2], P->Z);                // Z = (X-Z)*coeff[2]
+    fp2mul751_mont(t0, t1, t0);                        // t0 = (X+Z)*(X-Z)
+    fp2mul751_mont(t0, coeff[0], t0);                  // t0 = coeff[0]*(X+Z)*(X-Z)
+    fp2add751(P->X, P->Z, t1);                         // t1 = (X-Z)*coeff[2] + (X+Z)*coeff[1]
+    fp2sub751(P->X, P->Z, P->Z);                       // Z = (X+Z)*coeff[1] - (X-Z)*coeff[2]
+    fp2sqr751_mont(t1, t1);                            // t1 = [(X-Z)*coeff[2] + (X+Z)*coeff[1]]^2
+    fp2sqr751_mont(P->Z, P->Z);                        // Z = [(X+Z)*coeff[1] - (X-Z)*coeff[2]]^2
+    fp2add751(t1, t0, P->X);                           // X = coeff[0]*(X+Z)*(X-Z) + t1
+    fp2sub751(P->Z, t0, t0);                           // t0 = Z - coeff[0]*(X+Z)*(X-Z)
+    fp2mul751_mont(P->X, t1, P->X);                    // X = X*t1
+    fp2mul751_mont(P->Z, t0, P->Z);                    // Z = Z*t0
+}
+
+
+void get_8_isog(const point_proj_t P, f2elm_t A24plus, f2elm_t C24, f2elm_t* coeff)
+{ // Computes the corresponding 8-isogeny of a projective Montgomery point (X8:Z8) of order 8, as a 4-isogeny with kernel <2*P> followed 
+  // by a 2-isogeny with kernel <phi4(P)>.
+  // Input:  projective point of order eight P = (X8:Z8) and constants A24plus = A+2C and C24 = 4C of its curve.
+  // Output: the 8-isogenous Montgomery curve with constants A24plus and C24 (as used by xDBLe_A24()), 
+  //         and the 5 coefficients that are used to evaluate the isogeny at a point in eval_8_isog().
+    point_proj_t T;
+
+    xDBL(P, T, A24plus, C24);                          // T = 2*P, of order 4
+    get_4_isog_A24(T, A24plus, C24, coeff);
+    fp2copy751(P->X, T->X);
+    fp2copy751(P->Z, T->Z);
+    eval_4_isog_A24(T, coeff);                         // T = phi4(P) = (X2:Z2), of order 2
+    fp2add751(T->X, T->Z, coeff[3]);                   // coeff[3] = X2+Z2
+    fp2sub751(T->X, T->Z, coeff[4]);                   // coeff[4] = X2-Z2
+    fp2sqr751_mont(T->X, A24plus);                     // A24plus = X2^2
+    fp2sqr751_mont(T->Z, C24);                         // C24 = Z2^2
+    fp2sub751(C24, A24plus, A24plus);                  // A24plus = Z2^2-X2^2
+}
+
+
+void eval_8_isog(point_proj_t P, f2elm_t* coeff)
+{ // Evaluates the isogeny at the point (X:Z) in the domain of the isogeny, given an 8-isogeny phi defined 
+  // by the 5 coefficients in coeff (computed in the function get_8_isog()).
+  // Inputs: the coefficients defining the isogeny, and the projective point P = (X:Z).
+  // Output: the projective point P = phi(P) = (X:Z) in the codomain, at a cost of 10M+2S. 
+    f2elm_t t0, t1, t2;
+
+    eval_4_isog_A24(P, coeff);
+    fp2sub751(P->X, P->Z, t0);                         // t0 = X-Z
+    fp2add751(P->X, P->Z, t1);                         // t1 = X+Z
+    fp2mul751_mont(coeff[3], t0, t0);                  // t0 = (X2+Z2)*(X-Z)
+    fp2mul751_mont(coeff[4], t1, t1);                  // t1 = (X2-Z2)*(X+Z)
+    fp2add751(t0, t1, t2);                             // t2 = t0+t1
+    fp2sub751(t0, t1, t0);                             // t0 = t0-t1
+    fp2mul751_mont(P->X, t2, P->X);                    // X = X*t2
+    fp2mul751_mont(P->Z, t0, P->Z);                    // Z = Z*t0
+}
+
+
+void mont_to_A24(f2elm_t A, f2elm_t C)
+{ // Converts the Montgomery curve constant A/C to the doubling constants A24plus = A+2C and C24 = 4C, stored in A and C.
+    f2elm_t t0;
+
+    fp2add751(C, C, t0);                               // t0 = 2*C
+    fp2add751(A, t0, A);                               // A24plus = A+2C
+    fp2add751(t0, t0, C);                              // C24 = 4C
+}
+
+
+void A24_to_mont(f2elm_t A24plus, f2elm_t C24)
+{ // Converts the doubling constants A24plus = A+2C and C24 = 4C back to a Montgomery curve constant A/C = (4*A24plus-2*C24)/C24, stored in A24plus and C24.
+    f2elm_t t0;
+
+    fp2add751(A24plus, A24plus, A24plus);              // A = 2*A24plus
+    fp2sub751(A24plus, C24, t0);                       // t0 = 2*A24plus-C24
+    fp2add751(t0, t0, A24plus);                        // A = 4*A24plus-2*C24
+}
+
+
 void first_4_isog(point_proj_t P, const f2elm_t A, f2elm_t Aout, f2elm_t Cout, PCurveIsogenyStruct CurveIsogeny)
 { // Computes first 4-isogeny computed by Alice.
   // Inputs: projective point P = (X4:Z4) and curve constant A.
@@ -574,6 +1182,123 @@ void first_4_isog(point_proj_t P, const f2elm_t A, f2elm_t Aout, f2elm_t Cout, P
 }
 
 
+void first_4_isog_proj(point_proj_t P, const f2elm_t A, const f2elm_t C, f2elm_t Aout, f2elm_t Cout)
+{ // Computes first 4-isogeny computed by Alice, given a projective curve constant.
+  // Inputs: projective point P = (X4:Z4) and curve constant A/C.
+  // Output: the projective point P = (X4:Z4) in the codomain and isogenous curve constant Aout/Cout. Aout and Cout can alias A and C.
+    f2elm_t t0, t1, t2, t3;
+    
+    fp2add751(C, C, t0);                               // t0 = 2C
+    fp2sub751(A, t0, t3);                              // t3 = A-2C
+    fp2add751(t0, t0, t1);                             // t1 = 4C
+    fp2add751(t0, t1, t0);                             // t0 = 6C
+    fp2add751(A, t0, t0);                              // t0 = A+6C
+    fp2add751(P->X, P->Z, t1);                         // t1 = X+Z
+    fp2sub751(P->X, P->Z, t2);                         // t2 = X-Z
+    fp2sqr751_mont(t1, t1);                            // t1 = (X+Z)^2
+    fp2mul751_mont(P->X, P->Z, P->Z);                  // Z = X*Z
+    fp2neg751(P->Z);                                   // Z = -X*Z
+    fp2sqr751_mont(t2, t2);                            // t2 = (X-Z)^2
+    fp2mul751_mont(P->Z, t3, P->Z);                    // Z = -(A-2C)*X*Z
+    fp2mul751_mont(C, t1, P->X);                       // X = C*(X+Z)^2
+    fp2sub751(P->X, P->Z, P->X);                       // X = C*(X+Z)^2+(A-2C)*X*Z
+    fp2mul751_mont(P->Z, t2, P->Z);                    // Z = -(A-2C)*X*Z*(X-Z)^2
+    fp2mul751_mont(P->X, t1, P->X);                    // X = (X+Z)^2*[C*(X+Z)^2+(A-2C)*X*Z]
+    fp2add751(t0, t0, Aout);                           // Aout = 2*A+12C
+    fp2copy751(t3, Cout);                              // Cout = A-2C
+}
+
+
+void mont_to_edwards(point_proj_t P, f2elm_t A, f2elm_t C)
+{ // Converts, if P is not NULL, a Montgomery point (X:Z) to the Edwards coordinates (Y:Z) = (X-Z:X+Z), stored in P->X and P->Z, 
+  // and, if A is not NULL, the Montgomery curve constant A/C to the Edwards curve constants AE = A+2C and DE = A-2C, stored in A and C.
+    f2elm_t t0;
+
+    if (P != NULL) {
+        fp2add751(P->X, P->Z, P->Z);                   // Z = X+Z
+        fp2add751(P->X, P->X, P->X);                   // X = 2*X
+        fp2sub751(P->X, P->Z, P->X);                   // Y = 2*X-(X+Z) = X-Z
+    }
+    if (A != NULL) {
+        fp2add751(C, C, t0);                           // t0 = 2*C
+        fp2sub751(A, t0, C);                           // DE = A-2C
+        fp2add751(A, t0, A);                           // AE = A+2C
+    }
+}
+
+
+void edwards_to_mont(point_proj_t P, f2elm_t AE, f2elm_t DE)
+{ // Converts, if P is not NULL, Edwards coordinates (Y:Z), stored in P->X and P->Z, back to the Montgomery point (X:Z) = (Y+Z:Z-Y),
+  // and, if AE is not NULL, the Edwards curve constants AE and DE back to a Montgomery curve constant A/C = 2*(AE+DE)/(AE-DE), stored in AE and DE.
+  // The outputs are projectively equivalent to the inputs of mont_to_edwards().
+    f2elm_t t0;
+
+    if (P != NULL) {
+        fp2sub751(P->Z, P->X, P->Z);                   // Z = Z-Y
+        fp2add751(P->X, P->X, P->X);                   // X = 2*Y
+        fp2add751(P->X, P->Z, P->X);                   // X = 2*Y+(Z-Y) = Y+Z
+    }
+    if (AE != NULL) {
+        fp2add751(AE, DE, t0);                         // t0 = AE+DE
+        fp2sub751(AE, DE, DE);                         // C = AE-DE
+        fp2add751(t0, t0, AE);                         // A = 2*(AE+DE)
+    }
+}
+
+
+void get_4_isog_ed(const point_proj_t P, f2elm_t AE, f2elm_t DE, f2elm_t* coeff)
+{ // Computes the corresponding 4-isogeny of a point of order 4 in Edwards coordinates (Y4:Z4), i.e., of the Montgomery point (Y4+Z4:Z4-Y4).
+  // Input:  projective point of order four P = (Y4:Z4), stored in P->X and P->Z.
+  // Output: the Edwards curve constants AE and DE of the 4-isogenous curve and the 5 coefficients 
+  //         that are used to evaluate the isogeny at a point in eval_4_isog_ed().
+    f2elm_t t0;
+
+    fp2sqr751_mont(P->Z, coeff[0]);                    // coeff[0] = Z4^2
+    fp2sqr751_mont(P->X, coeff[1]);                    // coeff[1] = Y4^2
+    fp2add751(P->X, P->Z, t0);                         // t0 = Y4+Z4
+    fp2sqr751_mont(t0, coeff[3]);                      // coeff[3] = (Y4+Z4)^2
+    fp2add751(coeff[0], coeff[1], t0);                 // t0 = Y4^2+Z4^2
+    fp2sub751(coeff[3], t0, coeff[2]);                 // coeff[2] = 2*Y4*Z4 = (Y4+Z4)^2-(Y4^2+Z4^2)
+    fp2sub751(t0, coeff[2], coeff[4]);                 // coeff[4] = (Z4-Y4)^2
+    fp2add751(coeff[0], coeff[0], coeff[0]);           // coeff[0] = 2*Z4^2
+    fp2add751(coeff[1], coeff[1], coeff[1]);           // coeff[1] = 2*Y4^2
+    fp2sqr751_mont(coeff[3], AE);                      // AE = (Y4+Z4)^4
+    fp2sqr751_mont(coeff[4], coeff[4]);                // coeff[4] = (Z4-Y4)^4
+    fp2copy751(AE, coeff[3]);                          // coeff[3] = (Y4+Z4)^4
+    fp2sub751(AE, coeff[4], DE);                       // DE = (Y4+Z4)^4-(Z4-Y4)^4
+}
+
+
+void eval_4_isog_ed(point_proj_t P, f2elm_t* coeff)
+{ // Evaluates the isogeny at a point in Edwards coordinates (Y:Z) in the domain of the isogeny, given a 4-isogeny phi defined 
+  // by the 5 coefficients in coeff (computed in the function get_4_isog_ed()).
+  // With X' = coeff[0]*Y-coeff[1]*Z, Z' = coeff[2]*(Z-Y), S = X'+Z' and D = X'-Z', the image is 
+  // (coeff[4]*D^4-coeff[3]*S^4 : coeff[4]*D^2*(2*S^2-D^2)-coeff[3]*S^4), at a cost of 7M+3S compared to 9M+1S for eval_4_isog().
+  // Inputs: the coefficients defining the isogeny, and the projective point P = (Y:Z), stored in P->X and P->Z.
+  // Output: the projective point P = phi(P) = (Y:Z) in the codomain, in Edwards coordinates. 
+    f2elm_t t0, t1, t2;
+
+    fp2mul751_mont(P->X, coeff[0], t0);                // t0 = coeff[0]*Y
+    fp2mul751_mont(P->Z, coeff[1], t1);                // t1 = coeff[1]*Z
+    fp2sub751(P->Z, P->X, P->Z);                       // Z = Z-Y
+    fp2sub751(t0, t1, t0);                             // t0 = X' = coeff[0]*Y-coeff[1]*Z
+    fp2mul751_mont(P->Z, coeff[2], t1);                // t1 = Z' = coeff[2]*(Z-Y)
+    fp2add751(t0, t1, t2);                             // t2 = S = X'+Z'
+    fp2sub751(t0, t1, t0);                             // t0 = D = X'-Z'
+    fp2sqr751_mont(t2, t2);                            // t2 = S^2
+    fp2sqr751_mont(t0, t0);                            // t0 = D^2
+    fp2mul751_mont(t0, coeff[4], t1);                  // t1 = coeff[4]*D^2
+    fp2add751(t2, t2, P->Z);                           // Z = 2*S^2
+    fp2sub751(P->Z, t0, P->Z);                         // Z = 2*S^2-D^2
+    fp2mul751_mont(t1, P->Z, P->Z);                    // Z = coeff[4]*D^2*(2*S^2-D^2)
+    fp2mul751_mont(t1, t0, t0);                        // t0 = coeff[4]*D^4
+    fp2sqr751_mont(t2, t2);                            // t2 = S^4
+    fp2mul751_mont(t2, coeff[3], t2);                  // t2 = coeff[3]*S^4
+    fp2sub751(t0, t2, P->X);                           // Y = coeff[4]*D^4-coeff[3]*S^4
+    fp2sub751(P->Z, t2, P->Z);                         // Z = coeff[4]*D^2*(2*S^2-D^2)-coeff[3]*S^4
+}
+
+
 // original xTPL
 void xTPL(const point_proj_t P, point_proj_t Q, const f2elm_t A24, const f2elm_t C24)
 { // Tripling of a Montgomery point in projective coordinates (X:Z).
@@ -674,6 +1399,37 @@ void edTPLe(const point_proj_t P, point_proj_t Q, const f2elm_t A24minus, const
     }
 }
 
+
+void xTPLe_A24(const point_proj_t P, point_proj_t Q, const f2elm_t A24plus, const f2elm_t A24minus, const int e)
+{ // Computes [3^e](X:Z) on Montgomery curve given the constants A24plus = A+2C and A24minus = A-2C, via e repeated triplings.
+  // Input: projective Montgomery x-coordinates P = (XP:ZP), such that xP=XP/ZP and Montgomery curve constants A24plus and A24minus.
+  // Output: projective Montgomery x-coordinates Q <- (3^e)*P.
+    f2elm_t C24;
+    int i;
+    
+    fp2sub751(A24plus, A24minus, C24);                // C24 = 4*C
+    copy_words((digit_t*)P, (digit_t*)Q, 2*2*NWORDS_FIELD);
+
+    for (i = 0; i < e; i++) {
+        xTPL(Q, Q, A24plus, C24);
+    }
+}
+
+
+void edTPLe_A24(const point_proj_t P, point_proj_t Q, const f2elm_t A24plus, const f2elm_t A24minus, const int e)
+{ // Computes [3^e](X:Z) on Montgomery curve given the constants A24plus = A+2C and A24minus = A-2C, via e repeated Edwards-based triplings.
+  // These constants are the Edwards coefficients used by edTPL(), so no conversion is needed.
+  // Input: projective Montgomery x-coordinates P = (XP:ZP), such that xP=XP/ZP and Montgomery curve constants A24plus and A24minus.
+  // Output: projective Montgomery x-coordinates Q <- (3^e)*P.
+    int i;
+    
+    copy_words((digit_t*)P, (digit_t*)Q, 2*2*NWORDS_FIELD);
+
+    for (i = 0; i < e; i++) {
+        edTPL(Q, Q, A24plus, A24minus);
+    }
+}
+
 void get_3_isog(const point_proj_t P, f2elm_t A, f2elm_t C)
 { // Computes the corresponding 3-isogeny of a projective Montgomery point (X3:Z3) of order 3.
   // Input:  projective point of order three P = (X3:Z3).
@@ -716,7 +1472,81 @@ void eval_3_isog(const point_proj_t P, point_proj_t Q)
 }
 
 
-void inv_3_way(f2elm_t z1, f2elm_t z2, f2elm_t z3)
+void get_3_isog_coeff(const point_proj_t P, f2elm_t A24plus, f2elm_t A24minus, f2elm_t* coeff)
+{ // Computes the corresponding 3-isogeny of a projective Montgomery point (X3:Z3) of order 3, giving the codomain's tripling constants.
+  // Input:  projective point of order three P = (X3:Z3).
+  // Output: the 3-isogenous Montgomery curve with constants A24plus = A+2C and A24minus = A-2C (as used by xTPLe_A24() and edTPLe_A24()), 
+  //         and the 2 coefficients coeff = (X3-Z3, X3+Z3) that are used to evaluate the isogeny at a point in eval_3_isog_coeff().
+    f2elm_t t0, t1, t2, t3, t4;
+
+    fp2sub751(P->X, P->Z, coeff[0]);                   // coeff[0] = X3-Z3
+    fp2sqr751_mont(coeff[0], t0);                      // t0 = coeff[0]^2
+    fp2add751(P->X, P->Z, coeff[1]);                   // coeff[1] = X3+Z3
+    fp2sqr751_mont(coeff[1], t1);                      // t1 = coeff[1]^2
+    fp2add751(t0, t1, t2);                             // t2 = t0+t1
+    fp2add751(coeff[0], coeff[1], t3);                 // t3 = coeff[0]+coeff[1] = 2*X3
+    fp2sqr751_mont(t3, t3);                            // t3 = t3^2
+    fp2sub751(t3, t2, t3);                             // t3 = t3-t2
+    fp2add751(t1, t3, t2);                             // t2 = t1+t3
+    fp2add751(t3, t0, t3);                             // t3 = t3+t0
+    fp2add751(t3, t0, t4);                             // t4 = t3+t0
+    fp2add751(t4, t4, t4);                             // t4 = 2*t4
+    fp2add751(t1, t4, t4);                             // t4 = t1+t4
+    fp2mul751_mont(t2, t4, A24minus);                  // A24minus = t2*t4
+    fp2add751(t1, t2, t4);                             // t4 = t1+t2
+    fp2add751(t4, t4, t4);                             // t4 = 2*t4
+    fp2add751(t0, t4, t4);                             // t4 = t0+t4
+    fp2mul751_mont(t3, t4, A24plus);                   // A24plus = t3*t4
+}
+
+
+void eval_3_isog_coeff(point_proj_t Q, f2elm_t* coeff)
+{ // Computes the 3-isogeny R=phi(X:Z) at a point Q = (X:Z), given the 2 coefficients in coeff (computed in the function get_3_isog_coeff()).
+  // Inputs: the coefficients coeff and projective point Q = (X:Z).
+  // Output: the projective point Q <- phi(Q) = (XX:ZZ), at a cost of 4M+2S compared to 6M+2S for eval_3_isog(). 
+    f2elm_t t0, t1, t2;
+
+    fp2add751(Q->X, Q->Z, t0);                       // t0 = X+Z
+    fp2sub751(Q->X, Q->Z, t1);                       // t1 = X-Z
+    fp2mul751_mont(coeff[0], t0, t0);                // t0 = coeff[0]*t0
+    fp2mul751_mont(coeff[1], t1, t1);                // t1 = coeff[1]*t1
+    fp2add751(t0, t1, t2);                           // t2 = t0+t1
+    fp2sub751(t1, t0, t0);                           // t0 = t1-t0
+    fp2sqr751_mont(t2, t2);                          // t2 = t2^2
+    fp2sqr751_mont(t0, t0);                          // t0 = t0^2
+    fp2mul751_mont(Q->X, t2, Q->X);                  // X = X*t2
+    fp2mul751_mont(Q->Z, t0, Q->Z);                  // Z = Z*t0
+}
+
+
+void get_9_isog(const point_proj_t P, f2elm_t A24plus, f2elm_t A24minus, f2elm_t* coeff)
+{ // Computes the corresponding 9-isogeny of a projective Montgomery point (X9:Z9) of order 9, as a 3-isogeny with kernel <3*P> followed 
+  // by a 3-isogeny with kernel <phi3(P)>.
+  // Input:  projective point of order nine P = (X9:Z9) and constants A24plus = A+2C and A24minus = A-2C of its curve.
+  // Output: the 9-isogenous Montgomery curve with constants A24plus and A24minus (as used by xTPLe_A24() and edTPLe_A24()), 
+  //         and the 4 coefficients that are used to evaluate the isogeny at a point in eval_9_isog().
+    point_proj_t T;
+
+    xTPLe_A24(P, T, A24plus, A24minus, 1);             // T = 3*P, of order 3
+    get_3_isog_coeff(T, A24plus, A24minus, coeff);
+    fp2copy751(P->X, T->X);
+    fp2copy751(P->Z, T->Z);
+    eval_3_isog_coeff(T, coeff);                       // T = phi3(P), of order 3
+    get_3_isog_coeff(T, A24plus, A24minus, coeff+2);
+}
+
+
+void eval_9_isog(point_proj_t Q, f2elm_t* coeff)
+{ // Evaluates the 9-isogeny at a point Q = (X:Z), given the 4 coefficients in coeff (computed in the function get_9_isog()).
+  // Inputs: the coefficients coeff and projective point Q = (X:Z).
+  // Output: the projective point Q <- phi(Q) = (XX:ZZ), at a cost of 8M+4S. 
+
+    eval_3_isog_coeff(Q, coeff);
+    eval_3_isog_coeff(Q, coeff+2);
+}
+
+
+void inv_3_way(f2elm_t z1, f2elm_t z2, f2elm_t z3)
 { // 3-way simultaneous inversion
   // Input:  z1,z2,z3
   // Output: 1/z1,1/z2,1/z3 (override inputs).
@@ -771,6 +1601,29 @@ void get_A(const f2elm_t xP, const f2elm_t xQ, const f2elm_t xR, f2elm_t A, PCur
 }
 
 
+void get_A_proj(const f2elm_t xP, const f2elm_t xQ, const f2elm_t xR, f2elm_t A, f2elm_t C, PCurveIsogenyStruct CurveIsogeny)
+{ // Given the x-coordinates of P, Q, and R, returns the projective value A/C corresponding to the Montgomery curve E_A/C: y^2=x^3+(A/C)*x^2+x such that R=Q-P on E_A/C.
+  // Same as get_A() without the inversion.
+  // Input:  the x-coordinates xP, xQ, and xR of the points P, Q and R.
+  // Output: the coefficients A and C corresponding to the curve E_A/C: y^2=x^3+(A/C)*x^2+x.
+    f2elm_t t0, t1, one = {0};
+    
+    fpcopy751(CurveIsogeny->Montgomery_one, one[0]);
+    fp2add751(xP, xQ, t1);                           // t1 = xP+xQ
+    fp2mul751_mont(xP, xQ, t0);                      // t0 = xP*xQ
+    fp2mul751_mont(xR, t1, A);                       // A = xR*t1
+    fp2add751(t0, A, A);                             // A = A+t0
+    fp2mul751_mont(t0, xR, t0);                      // t0 = t0*xR
+    fp2sub751(A, one, A);                            // A = A-1
+    fp2add751(t0, t0, t0);                           // t0 = t0+t0
+    fp2add751(t1, xR, t1);                           // t1 = t1+xR
+    fp2add751(t0, t0, C);                            // C = 4*xP*xQ*xR
+    fp2sqr751_mont(A, A);                            // A = A^2
+    fp2mul751_mont(t1, C, t1);                       // t1 = t1*C
+    fp2sub751(A, t1, A);                             // Afinal = A-t1
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////////
 ///////////////              FUNCTIONS FOR COMPRESSION              ///////////////
 
@@ -918,14 +1771,13 @@ void generate_2_torsion_basis(const f2elm_t A, point_full_proj_t R1, point_full_
 static uint64_t sqrt17[NWORDS64_FIELD] = { 0x89127CDB8966913D, 0xF788014C8C8401A0, 0x1A16F73884F3E3E8, 0x2E67382B560FA195, 0xDD5EE869B7F4FD81, 0x16A0849EF695EFEB,
 	                                       0x3675244609DE1963, 0x36F02976EF2EB241, 0x92D09F939A20637F, 0x41496905F2B0112C, 0xA94C09B1F7242495, 0x0000297652D36A97 };
 
-static void get_X_on_curve(f2elm_t A, unsigned int* r, f2elm_t x, felm_t t1, felm_t a, felm_t b) 
-{ // Elligator2 for X
-    felm_t v0, v1, r0, r1, t0, t2, t3, rsq = {0};
+static bool elligator_X(const f2elm_t A, const felm_t r0, const felm_t r1, const unsigned int r, f2elm_t x, felm_t t1, felm_t a, felm_t b) 
+{ // Elligator2 for X with constant r0+r1*i = -1/(1+u*r^2), u = 4+i.
+  // Returns true if x = A*(r0+r1*i), and false if x = u*r^2*A*(r0+r1*i).
+    felm_t v0, v1, t0, t2, t3, rsq = {0};
     unsigned int i;
 
-    fpcopy751(((felm_t*)&LIST)[(*r << 1)-2], r1);    // r1 = list[2*r-1]
-    fpcopy751(((felm_t*)&LIST)[(*r << 1)-1], r0);    // r0 = list[2*r]
-    rsq[0] = (*r)*(*r);                              // rsp = r^2
+    rsq[0] = r*r;                                    // rsp = r^2
     to_mont(rsq, rsq);                               // Converting to Montgomery representation 
     fpmul751_mont(A[1], r1, t0);                     // t0 = A1*r1
 	fpmul751_mont(A[0], r0, v0);                     // v0 = A0*r0
@@ -989,18 +1841,30 @@ static void get_X_on_curve(f2elm_t A, unsigned int* r, f2elm_t x, felm_t t1, fel
         fpmul751_mont(rsq, b, b);                    // b = rsq*b
         fpmul751_mont(rsq, t1, t1);                  // t1 = t1*rsq
         fpmul751_mont(t1, (digit_t*)sqrt17, t1);     // t1 = t1*sqrt17
+        return false;
     } else {
         fpcopy751(v0, x[0]);                         // x0 = v0
         fpcopy751(v1, x[1]);                         // x1 = v1
+        return true;
     }
 }
 
 
-static void get_pt_on_curve(f2elm_t A, unsigned int* r, f2elm_t x, f2elm_t y)
-{ // Elligator2
+static void get_X_on_curve(f2elm_t A, unsigned int* r, f2elm_t x, felm_t t1, felm_t a, felm_t b) 
+{ // Elligator2 for X
+    felm_t r0, r1;
+
+    fpcopy751(((felm_t*)&LIST)[(*r << 1)-2], r1);    // r1 = list[2*r-1]
+    fpcopy751(((felm_t*)&LIST)[(*r << 1)-1], r0);    // r0 = list[2*r]
+    elligator_X(A, r0, r1, *r, x, t1, a, b);
+}
+
+
+static void elligator_pt(const f2elm_t A, const felm_t r0, const felm_t r1, const unsigned int r, f2elm_t x, f2elm_t y)
+{ // Elligator2 with constant r0+r1*i = -1/(1+u*r^2), u = 4+i
     felm_t t0, t1, t2, t3, a, b;
 
-    get_X_on_curve(A, r, x, t1, a, b);
+    elligator_X(A, r0, r1, r, x, t1, a, b);
     fpadd751(a, t1, t0);                             // t0 = a+t1
     fpdiv2_751(t0, t0);                              // t0 = t0/2
     fpcopy751(t0, t1);
@@ -1023,6 +1887,16 @@ static void get_pt_on_curve(f2elm_t A, unsigned int* r, f2elm_t x, f2elm_t y)
   }
 
 
+static void get_pt_on_curve(f2elm_t A, unsigned int* r, f2elm_t x, f2elm_t y)
+{ // Elligator2
+    felm_t r0, r1;
+
+    fpcopy751(((felm_t*)&LIST)[(*r << 1)-2], r1);    // r1 = list[2*r-1]
+    fpcopy751(((felm_t*)&LIST)[(*r << 1)-1], r0);    // r0 = list[2*r]
+    elligator_pt(A, r0, r1, *r, x, y);
+}
+
+
 static void get_3_torsion_elt(f2elm_t A, unsigned int* r, point_proj_t P, point_proj_t P3, unsigned int* triples, PCurveIsogenyStruct CurveIsogeny)
 {
     point_proj_t PP;
@@ -1166,6 +2040,189 @@ void generate_3_torsion_basis(f2elm_t A, point_full_proj_t R1, point_full_proj_t
 }
 
 
+void generate_2_torsion_basis_entangled(const f2elm_t A, point_full_proj_t R1, point_full_proj_t R2, PCurveIsogenyStruct CurveIsogeny)
+{ // Produces points R1 and R2 such that {R1, R2} is a basis for E[2^372] using an entangled basis.
+  // The class in E/[2]E of a point with x-coordinate x is given by the quadratic characters of x and x-alpha, where alpha is a root of x^2+A*x+1.
+  // Candidates are taken from Elligator2 with the square constants in LIST_SQR, so that the character of x follows from that of A.
+  // Two points P and Q in distinct nonzero classes give the basis R1 = [3^239]P and R2 = [3^239]Q without checking the orders.
+  // Input:   curve constant A.
+  // Outputs: R1 = (X1:Y1:Z1) and R2 = (X2:Y2:Z2).
+    point_proj_t P1 = {0}, P2 = {0};
+    felm_t *X1 = (felm_t*)P1->X, *Z1 = (felm_t*)P1->Z;
+    felm_t *X2 = (felm_t*)P2->X, *Z2 = (felm_t*)P2->Z;
+    felm_t *Y1 = (felm_t*)R1->Y, *Y2 = (felm_t*)R2->Y;
+    f2elm_t x, alpha, t0, t1, one = {0};
+    felm_t s, a, b;
+    unsigned int k, pt_class, class1 = 0, pts_found = 0;
+    bool sqr_A, sqr_x;
+
+    fpcopy751(CurveIsogeny->Montgomery_one, one[0]);
+    fp2sqr751_mont(A, t0);                           // t0 = A^2
+    fpadd751(one[0], one[0], s);
+    fpadd751(s, s, s);                               // s = 4
+    fpsub751(t0[0], s, t0[0]);                       // t0 = A^2-4
+    sqrt_Fp2(t0, alpha);                             // alpha = sqrt(A^2-4)
+    fp2sub751(alpha, A, alpha);                      
+    fp2div2_751(alpha, alpha);                       // alpha = (-A+sqrt(A^2-4))/2
+    sqr_A = is_sqr_Fp2(A);
+
+    for (k = 0; k < NLIST_SQR && pts_found < 2; k++) {
+        // chi(x) = chi(A) if x = A*L_r, and chi(x) = -chi(A) if x = u*r^2*A*L_r, since L_r is a square and u is not
+        sqr_x = (elligator_X(A, ((felm_t*)&LIST_SQR)[2*k], ((felm_t*)&LIST_SQR)[2*k+1], LIST_SQR_R[k], x, s, a, b) == sqr_A);
+        fp2sub751(x, alpha, t0);                     // t0 = x-alpha
+        pt_class = (unsigned int)(sqr_x == false) | ((unsigned int)(is_sqr_Fp2(t0) == false) << 1);
+
+        if (pt_class != 0 && pt_class != class1) {
+            if (pts_found == 0) {
+                fp2copy751(x, X1);                   // X1 = x
+                class1 = pt_class;
+            } else {
+                fp2copy751(x, X2);                   // X2 = x
+            }
+            pts_found++;
+        }
+    }
+    if (pts_found < 2) {                             // The table was exhausted, this happens with negligible probability
+        generate_2_torsion_basis(A, R1, R2, CurveIsogeny);
+        return;
+    }
+
+    fp2copy751(one, Z1);                             // Z1 = 1 
+    fp2copy751(one, Z2);                             // Z2 = 1 
+    xTPLe(P1, P1, A, one, 239);                      
+    xTPLe(P2, P2, A, one, 239);
+    
+    fp2copy751(X1, R1->X);
+    fp2copy751(Z1, R1->Z);
+    fp2copy751(X2, R2->X);
+    fp2copy751(Z2, R2->Z);
+
+    // Recover the y-coordinates.
+    fp2sqr751_mont(Z1, t0);                          // t0 = Z1^2
+    fp2mul751_mont(A, Z1, Y1);                       // Y1 = A*Z1
+    fp2add751(X1, Y1, Y1);                           // Y1 = X1+Y1
+    fp2mul751_mont(X1, Y1, Y1);                      // Y1 = Y1*X1
+    fp2add751(t0, Y1, Y1);                           // Y1 = Y1+t0
+    fp2mul751_mont(X1, Y1, Y1);                      // Y1 = Y1*X1
+    fp2mul751_mont(t0, Z1, t0);                      // t0 = t0*Z1
+    sqrt_Fp2_frac(Y1, t0, t1);                       // t1 = sqrt(Y1/t0)
+    
+    fp2sqr751_mont(Z2, t0);                          // t0 = Z2^2
+    fp2mul751_mont(A, Z2, Y2);                       // Y2 = A*Z2
+    fp2add751(X2, Y2, Y2);                           // Y2 = X2+Y2
+    fp2mul751_mont(Y2, X2, Y2);                      // Y2 = Y2*X2
+    fp2add751(t0, Y2, Y2);                           // Y2 = Y2+t0
+    fp2mul751_mont(Y2, X2, Y2);                      // Y2 = Y2*X2
+    fp2mul751_mont(t0, Z2, t0);                      // t0 = t0*Z2
+    fp2mul751_mont(t1, Z1, Y1);                      // Y1 = t1*Z1
+    sqrt_Fp2_frac(Y2, t0, t1);                       // t1 = sqrt(Y2/t0)    
+    fp2mul751_mont(Z2, t1, Y2);                      // Y2 = t1*Z2
+}
+
+
+void generate_3_torsion_basis_entangled(f2elm_t A, point_full_proj_t R1, point_full_proj_t R2, PCurveIsogenyStruct CurveIsogeny)
+{ // Produces points R1 and R2 such that {R1, R2} is a basis for E[3^239] using an entangled basis.
+  // R1 = [2^372]P has full order iff R3 = [3^238]R1 is not zero. The Frobenius acts as [-p], so the Tate pairing t3(R3,R1) is trivial, i.e., 
+  // the tangent line at R3 evaluates to a cube at R1. Then, any Q at which it is not a cube gives R2 = [2^372]Q independent of R1.
+  // Candidates are taken from Elligator2 with the constants in LIST_SQR.
+  // Input:   curve constant A.
+  // Outputs: R1 = (X1:Y1:Z1) and R2 = (X2:Y2:Z2).
+    point_proj_t R, R3;
+    felm_t *X  = (felm_t*)R->X,  *Z  = (felm_t*)R->Z;
+    felm_t *X3 = (felm_t*)R3->X, *Z3 = (felm_t*)R3->Z;
+    felm_t *X1 = (felm_t*)R1->X, *Y1 = (felm_t*)R1->Y, *Z1 = (felm_t*)R1->Z;
+    felm_t *X2 = (felm_t*)R2->X, *Y2 = (felm_t*)R2->Y, *Z2 = (felm_t*)R2->Z;
+    f2elm_t u, v, c, f, t0, f0, fX, fY, Y, Y3, one = {0};
+    felm_t t1, a, b, zero = {0};
+    unsigned int k = 0;
+
+    fpcopy751(CurveIsogeny->Montgomery_one, one[0]);
+
+    do {
+        if (k == NLIST_SQR) {                        // The table was exhausted, this happens with negligible probability
+            generate_3_torsion_basis(A, R1, R2, CurveIsogeny);
+            return;
+        }
+        elligator_X(A, ((felm_t*)&LIST_SQR)[2*k], ((felm_t*)&LIST_SQR)[2*k+1], LIST_SQR_R[k], X, t1, a, b);
+        fp2copy751(one, Z);                          // Z = 1
+        xDBLe(R, R, A, one, 372);
+        xTPLe(R, R3, A, one, 238);
+        fp2correction751(Z3);
+        k++;
+    } while (fpequal751_non_constant_time(Z3[0], zero) == true && fpequal751_non_constant_time(Z3[1], zero) == true);
+
+    fp2copy751(X, X1);                               // X1 = X
+    fp2copy751(Z, Z1);                               // Z1 = Z 
+    fp2mul751_mont(A, Z1, u);                        // u = A*Z1
+    fp2add751(u, X1, u);                             // u = u+X1
+    fp2mul751_mont(u, X1, u);                        // u = u*X1
+    fp2sqr751_mont(Z1, v);                           // v = Z1^2
+    fp2add751(u, v, u);                              // u = u+v
+    fp2mul751_mont(u, X1, u);                        // u = u*X1
+    fp2mul751_mont(v, Z1, v);                        // v = v*Z1
+    sqrt_Fp2_frac(u, v, Y1);                         // Y1 = sqrt(u/v)
+    fp2mul751_mont(Y1, Z1, Y1);                      // Y1 = Y1*Z1
+
+    fp2mul751_mont(A, Z3, u);                        // u = A*Z3
+    fp2add751(u, X3, u);                             // u = u+X3
+    fp2mul751_mont(u, X3, u);                        // u = u*X3
+    fp2sqr751_mont(Z3, v);                           // v = Z3^2
+    fp2add751(u, v, u);                              // u = u+v
+    fp2mul751_mont(u, X3, u);                        // u = u*X3
+    fp2mul751_mont(v, Z3, v);                        // v = v*Z3
+    sqrt_Fp2_frac(u, v, Y3);                         // Y3 = sqrt(u/v)
+    fp2mul751_mont(Y3, Z3, Y3);                      // Y3 = Y3*Z3
+    fp2sqr751_mont(X3, f0);                          // f0 = X3^2
+    fp2sqr751_mont(Z3, t0);                          // t0 = Z3^2
+    fp2mul751_mont(X3, Z3, fX);                      // fX = X3*Z3
+    fp2mul751_mont(A, fX, fX);                       // fX = A*fX
+    fp2add751(fX, fX, fX);                           // fX = fX+fX
+    fp2add751(fX, t0, fX);                           // fX = fX+t0
+    fp2add751(fX, f0, fX);                           // fX = fX+f0
+    fp2add751(fX, f0, fX);                           // fX = fX+f0
+    fp2add751(fX, f0, fX);                           // fX = fX+f0
+    fp2sub751(t0, f0, f0);                           // f0 = t0-f0
+    fp2mul751_mont(fX, Z3, fX);                      // fX = fX*Z3
+    fp2mul751_mont(Y3, Z3, fY);                      // fY = Y3*Z3
+    fp2add751(fY, fY, fY);                           // fY = fY+fY
+    fp2neg751(fY);                                   // fY = -fY
+    fp2add751(fY, fY, c);                            // c = fY+fY
+    fp2mul751_mont(fY, Z3, fY);                      // fY = fY*Z3
+    fp2mul751_mont(f0, X3, f0);                      // f0 = f0*X3
+    fp2mul751_mont(c, Y3, c);                        // c = c*Y3
+    fp2mul751_mont(fX, c, fX);                       // fX = c*fX
+    fp2mul751_mont(fY, c, fY);                       // fY = c*fY
+    fp2mul751_mont(f0, c, f0);                       // f0 = c*f0
+
+    do {
+        if (k == NLIST_SQR) {                        // The table was exhausted, this happens with negligible probability
+            generate_3_torsion_basis(A, R1, R2, CurveIsogeny);
+            return;
+        }
+        elligator_pt(A, ((felm_t*)&LIST_SQR)[2*k], ((felm_t*)&LIST_SQR)[2*k+1], LIST_SQR_R[k], X, Y);
+        fp2mul751_mont(fX, X, f);                    // f = fX*X
+        fp2mul751_mont(fY, Y, t0);                   // t0 = fY*Y
+        fp2add751(f, t0, f);                         // f = f+t0
+        fp2add751(f, f0, f);                         // f = f+f0
+        k++;
+    } while (is_cube_Fp2(f, CurveIsogeny) == true);
+
+    fp2copy751(one, Z);                              // Z = 1
+    xDBLe(R, R, A, one, 372);
+    fp2copy751(X, X2);                               // X2 = X
+    fp2copy751(Z, Z2);                               // Z2 = Z
+    fp2mul751_mont(A, Z2, u);                        // u = A*Z2
+    fp2add751(u, X2, u);                             // u = u+X2
+    fp2mul751_mont(u, X2, u);                        // u = u*X2
+    fp2sqr751_mont(Z2, v);                           // v = Z2^2
+    fp2add751(u, v, u);                              // u = u+v
+    fp2mul751_mont(u, X2, u);                        // u = u*X2
+    fp2mul751_mont(v, Z2, v);                        // v = v*Z2
+    sqrt_Fp2_frac(u, v, Y2);                         // Y2 = sqrt(u/v)
+    fp2mul751_mont(Y2, Z2, Y2);                      // Y2 = Y2*Z2
+}
+
+
 static void dbl_and_line(const point_ext_proj_t P, const f2elm_t A, f2elm_t lx, f2elm_t ly, f2elm_t l0, f2elm_t v0)
 { // Doubling step for computing the Tate pairing using Miller's algorithm.
   // This function computes a point doubling of P and returns the corresponding line coefficients for the pairing doubling step.
@@ -1201,110 +2258,135 @@ static void dbl_and_line(const point_ext_proj_t P, const f2elm_t A, f2elm_t lx,
 	fp2copy751(t0, XZ);
 }
 
-static void absorb_line(const f2elm_t lx, const f2elm_t ly, const f2elm_t l0, const f2elm_t v0, const point_t P, f2elm_t n, f2elm_t d)
-{ // Absorbing line function values during Miller's algorithm.
-  // Evaluate the line functions at the point P and multiply values into the running value n/d of the pairing value, keeping numerator n
-  // and denominator d separate.
-	felm_t *x = (felm_t*)P->x, *y = (felm_t*)P->y;
-	f2elm_t l, v;
+static const unsigned int pairing_lanes[5] = {0, 0, 0, 1, 1};      // Miller function (R1 or R2) used by each of the five pairings
 
-	fp2mul751_mont(lx, x, l);                        // l = lx*x
-	fp2mul751_mont(ly, y, v);                        // v = ly*y
-	fp2sub751(v, l, l);                              // l = v-l
-	fp2add751(l0, l, l);                             // l = l+l0
-	fp2mul751_mont(ly, x, v);                        // v = ly*x
-	fp2sub751(v, v0, v);                             // v = v+v0
-	fp2mul751_mont(n, l, n);                         // n = n*l
-	fp2mul751_mont(d, v, d);                         // d = d*v
-}
 
+static void square_and_absorb_lines(const f2elm_t (*lines)[4], const point_affine** pts, f2elm_t* f)
+{ // Square the running values of the five pairings in Miller's algorithm and absorb the line function values of the current Miller step.
+  // Lane k evaluates the line (lx, ly, l0, v0) = lines[pairing_lanes[k]] at the point pts[k]. Each running value f[k] = n*conj(d) carries 
+  // numerator n and denominator d of the pairing value at once, which the final exponentiation turns into (n/d)^(p-1).
+	unsigned int k;
+	const felm_t *lx, *ly, *l0, *v0, *x, *y;
+	f2elm_t l, v;
 
-static void square_and_absorb_line(const f2elm_t lx, const f2elm_t ly, const f2elm_t l0, const f2elm_t v0, const point_t P, f2elm_t n, f2elm_t d)
-{ // Square the running pairing value in Miller's algorithm and absorb line function values of the current Miller step.
-	fp2sqr751_mont(n, n);                            // n = n^2
-	fp2sqr751_mont(d, d);                            // d = d^2
-	absorb_line(lx, ly, l0, v0, P, n, d);
+	for (k = 0; k < 5; k++) {
+		lx = lines[pairing_lanes[k]][0]; ly = lines[pairing_lanes[k]][1]; l0 = lines[pairing_lanes[k]][2]; v0 = lines[pairing_lanes[k]][3];
+		x = pts[k]->x; y = pts[k]->y;
+		fp2muldiff751_mont(ly, y, lx, x, l);         // l = ly*y-lx*x
+		fp2add751(l0, l, l);                         // l = l+l0
+		fp2mul751_mont(ly, x, v);                    // v = ly*x
+		fp2sub751(v, v0, v);                         // v = v-v0
+		inv_Fp2_cycl(v);                             // v = conj(v)
+		fp2mul751_mont(l, v, l);                     // l = l*v
+		fp2sqr751_mont(f[k], f[k]);                  // f = f^2
+		fp2mul751_mont(f[k], l, f[k]);               // f = f*l
+	}
 }
 
 
-static void final_dbl_iteration(const point_ext_proj_t P, const f2elm_t x, f2elm_t n, f2elm_t d)
+static void final_dbl_iterations(const point_ext_proj_t* R, const point_affine** pts, f2elm_t* f)
 { // Special iteration for the final doubling step in Miller's algorithm. This is necessary since the doubling 
   // at the end of the Miller loop is an exceptional case (doubling a point of order 2).
-	felm_t *X = (felm_t*)P->XZ, *Z = (felm_t*)P->Z2;
-	f2elm_t l;
+	unsigned int k;
+	const felm_t *X, *Z;
+	f2elm_t l, v;
 
-	fp2sqr751_mont(n, n);                            // n = n^2
-	fp2sqr751_mont(d, d);                            // d = d^2
-	fp2mul751_mont(Z, d, d);                         // d = d*Z
-	fp2mul751_mont(Z, x, l);                         // l = Z*x
-	fp2sub751(l, X, l);                              // l = l-X
-	fp2mul751_mont(n, l, n);                         // n = n*l
+	for (k = 0; k < 5; k++) {
+		X = (felm_t*)R[pairing_lanes[k]]->XZ; Z = (felm_t*)R[pairing_lanes[k]]->Z2;
+		fp2mul751_mont(Z, pts[k]->x, l);             // l = Z*x
+		fp2sub751(l, X, l);                          // l = l-X
+		fp2copy751(Z, v);
+		inv_Fp2_cycl(v);                             // v = conj(Z)
+		fp2mul751_mont(l, v, l);                     // l = l*v
+		fp2sqr751_mont(f[k], f[k]);                  // f = f^2
+		fp2mul751_mont(f[k], l, f[k]);               // f = f*l
+	}
 }
 
 
-static void final_exponentiation_2_torsion(f2elm_t n, f2elm_t d, const f2elm_t n_inv, const f2elm_t d_inv, f2elm_t nout, PCurveIsogenyStruct CurveIsogeny)
-{ // The final exponentiation for pairings in the 2-torsion group. Raising the value n/d to the power (p^2-1)/2^eA.
-    felm_t one = {0};
-    unsigned int i; 
+static void final_exponentiations(const f2elm_t* f, f2elm_t* nout, const unsigned int ell, PCurveIsogenyStruct CurveIsogeny)
+{ // The final exponentiation of the five pairings computed by Tate_pairings_2_torsion() (ell = 2) or Tate_pairings_3_torsion() (ell = 3). 
+  // Raises the values f = n*conj(d) to the power (p^2-1)/ell^e, which equals (n/d)^((p^2-1)/ell^e) since f^(p-1) = (n/d)^(p-1).
+  // The (p-1) part uses the Frobenius f^p = conj(f): f^(p-1) = conj(f)^2/N(f) with the norm N(f) = f0^2+f1^2 in GF(p751), so the five 
+  // values share a single inversion in GF(p751). The remaining exponent (p+1)/ell^e is 3^239 for ell = 2 and 2^372 for ell = 3, so its 
+  // addition chain consists of cyclotomic cubings or squarings only.
+#if defined(SIDH_BOUNDED_STACK)
+	felm_t *norms = SIDH_WORKSPACE(CurveIsogeny)->norms, *norm_invs = SIDH_WORKSPACE(CurveIsogeny)->norm_invs;
+#else
+	felm_t norms[5], norm_invs[5];
+#endif
+	felm_t t0, t1, one = {0};
+	unsigned int i, k;
 
-    fpcopy751(CurveIsogeny->Montgomery_one, one);
-    fp2mul751_mont(n, d_inv, n);                     // n = n*d_inv
-    //n = n^p, just call conjugation function
-    inv_Fp2_cycl(n);
-    fp2mul751_mont(d, n_inv, d);                     // d = d*n_inv
-    fp2mul751_mont(n, d, n);                         // n = n*d
-
-    for (i = 0; i < 239; i++) {
-        cube_Fp2_cycl(n, one);
-    }
-    fp2copy751(n, nout);
+	fpcopy751(CurveIsogeny->Montgomery_one, one);
+	for (k = 0; k < 5; k++) {
+		fpsqr751_mont(f[k][0], t0);                  // t0 = f0^2
+		fpsqr751_mont(f[k][1], t1);                  // t1 = f1^2
+		fpadd751(t0, t1, norms[k]);                  // N = f0^2+f1^2
+		fpsub751(t0, t1, nout[k][0]);                // nout0 = f0^2-f1^2
+		fpadd751(f[k][0], f[k][1], t0);
+		fpsqr751_mont(t0, t0);                       // t0 = (f0+f1)^2
+		fpsub751(norms[k], t0, nout[k][1]);          // nout1 = -2*f0*f1, i.e., nout = conj(f)^2
+	}
+	mont_n_way_inv_fp((const felm_t*)norms, 5, norm_invs);
+
+	for (k = 0; k < 5; k++) {
+		fpmul751_mont(nout[k][0], norm_invs[k], nout[k][0]);
+		fpmul751_mont(nout[k][1], norm_invs[k], nout[k][1]);    // nout = conj(f)^2/N(f) = f^(p-1)
+		if (ell == 2) {
+			for (i = 0; i < 239; i++) {
+				cube_Fp2_cycl(nout[k], one);
+			}
+		} else {
+			for (i = 0; i < 372; i++) {
+				sqr_Fp2_cycl(nout[k], one);
+			}
+		}
+	}
 }
 
 
 void Tate_pairings_2_torsion(const point_t R1, const point_t R2, const point_t P, const point_t Q, const f2elm_t A, f2elm_t* n, PCurveIsogenyStruct CurveIsogeny)
 { // The doubling only 2-torsion Tate pairing of order 2^eA, consisting of the doubling only Miller loop and the final exponentiation.]
   // Computes 5 pairings at once: e(R1, R2), e(R1, P), e(R1, Q), e(R2, P), e(R2,Q).
-	point_ext_proj_t P1 = { 0 }, P2 = { 0 };
-	f2elm_t lx1, ly1, l01, v01, lx2, ly2, l02, v02;
-	f2elm_t invs[10], nd[10] = { 0 };
+  // The five Miller loops share the doublings of R1 and R2 and run in lanes over arrays of line values, points and running values.
+	f2elm_t lines[2][4];
+	const point_affine* pts[5] = { R2, P, Q, P, Q };
+#if defined(SIDH_BOUNDED_STACK)
+	point_ext_proj_t *R = SIDH_WORKSPACE(CurveIsogeny)->R;
+	f2elm_t *nd = SIDH_WORKSPACE(CurveIsogeny)->nd;
+#else
+	point_ext_proj_t R[2];
+	f2elm_t nd[5];
+#endif
 	felm_t one = { 0 };
 	unsigned int i;
 
 	fpcopy751(CurveIsogeny->Montgomery_one, one);
-	fp2copy751(R1->x, P1->XZ);
-	fp2sqr751_mont(P1->XZ, P1->X2);
-	fp2copy751(R1->y, P1->YZ);
-	fpcopy751(one, P1->Z2[0]);                       // P1 = (x1^2,x1,1,y1)    
-	fp2copy751(R2->x, P2->XZ);
-	fp2sqr751_mont(P2->XZ, P2->X2);
-	fp2copy751(R2->y, P2->YZ);
-	fpcopy751(one, P2->Z2[0]);                       // P2 = (x2^2,x2,1,y2)
-
-	for (i = 0; i < 10; i++) {                       // nd[i] = 1
+	fp2copy751(R1->x, R[0]->XZ);
+	fp2sqr751_mont(R[0]->XZ, R[0]->X2);
+	fp2copy751(R1->y, R[0]->YZ);
+	fp2zero751(R[0]->Z2);
+	fpcopy751(one, R[0]->Z2[0]);                     // R[0] = (x1^2,x1,1,y1)    
+	fp2copy751(R2->x, R[1]->XZ);
+	fp2sqr751_mont(R[1]->XZ, R[1]->X2);
+	fp2copy751(R2->y, R[1]->YZ);
+	fp2zero751(R[1]->Z2);
+	fpcopy751(one, R[1]->Z2[0]);                     // R[1] = (x2^2,x2,1,y2)
+
+	for (i = 0; i < 5; i++) {                        // nd[i] = 1
+		fp2zero751(nd[i]);
 		fpcopy751(one, nd[i][0]);
 	}
 
 	for (i = 0; i < 371; i++) {
-		dbl_and_line(P1, A, lx1, ly1, l01, v01); // vx = ly
-		dbl_and_line(P2, A, lx2, ly2, l02, v02); // vx = ly
-		square_and_absorb_line(lx1, ly1, l01, v01, R2, nd[0], nd[5]);
-		square_and_absorb_line(lx1, ly1, l01, v01, P, nd[1], nd[6]);
-		square_and_absorb_line(lx1, ly1, l01, v01, Q, nd[2], nd[7]);
-		square_and_absorb_line(lx2, ly2, l02, v02, P, nd[3], nd[8]);
-		square_and_absorb_line(lx2, ly2, l02, v02, Q, nd[4], nd[9]);
+		dbl_and_line(R[0], A, lines[0][0], lines[0][1], lines[0][2], lines[0][3]); // vx = ly
+		dbl_and_line(R[1], A, lines[1][0], lines[1][1], lines[1][2], lines[1][3]); // vx = ly
+		square_and_absorb_lines((const f2elm_t(*)[4])lines, pts, nd);
 	}
 
-	final_dbl_iteration(P1, R2->x, nd[0], nd[5]);
-	final_dbl_iteration(P1, P->x, nd[1], nd[6]);
-	final_dbl_iteration(P1, Q->x, nd[2], nd[7]);
-	final_dbl_iteration(P2, P->x, nd[3], nd[8]);
-	final_dbl_iteration(P2, Q->x, nd[4], nd[9]);
-	mont_n_way_inv(nd, 10, invs);
-	final_exponentiation_2_torsion(nd[0], nd[5], invs[0], invs[5], n[0], CurveIsogeny);
-	final_exponentiation_2_torsion(nd[1], nd[6], invs[1], invs[6], n[1], CurveIsogeny);
-	final_exponentiation_2_torsion(nd[2], nd[7], invs[2], invs[7], n[2], CurveIsogeny);
-	final_exponentiation_2_torsion(nd[3], nd[8], invs[3], invs[8], n[3], CurveIsogeny);
-	final_exponentiation_2_torsion(nd[4], nd[9], invs[4], invs[9], n[4], CurveIsogeny);
+	final_dbl_iterations((const point_ext_proj_t*)R, pts, nd);
+	final_exponentiations((const f2elm_t*)nd, n, 2, CurveIsogeny);
 }
 
 
@@ -1368,37 +2450,36 @@ static void tpl_and_parabola(point_ext_proj_t P, const f2elm_t A, f2elm_t ly, f2
 }
 
 
-static void absorb_parab(const f2elm_t ly, const f2elm_t lx2, const f2elm_t lx1, const f2elm_t lx0, const f2elm_t vx, const f2elm_t v0, const point_t P, f2elm_t n, f2elm_t d)
-{ // Absorbing parabola function values in Miller's algorithm.
-  // Evaluate the parabola at P and absorb the values into the running pairing value n/d, keeping numerator n and denominator d separate.
-	felm_t *x = (felm_t*)P->x, *y = (felm_t*)P->y;
-	f2elm_t ln, ld;
-
-	fp2mul751_mont(lx0, x, ln);           // ln = lx0*x
-	fp2mul751_mont(v0, x, ld);            // ld = v0*x
-	fp2add751(vx, ld, ld);                // ld = vx + ld
-	fp2mul751_mont(ld, ln, ld);           // ld = ld*ln
-	fp2mul751_mont(d, ld, d);			  // d = d*ld
+static void cube_and_absorb_parabs(const f2elm_t (*parabs)[6], const point_affine** pts, f2elm_t* f)
+{ // Cube the running values of the five pairings in Miller's algorithm and absorb the parabola function values of the current Miller step.
+  // Lane k evaluates the parabola (ly, lx2, lx1, lx0, vx, v0) = parabs[pairing_lanes[k]] at the point pts[k], and absorbs numerator ln 
+  // and denominator ld into the running value f[k] = n*conj(d) (see square_and_absorb_lines()).
+	unsigned int k;
+	const felm_t *ly, *lx2, *lx1, *lx0, *vx, *v0, *x, *y;
+	f2elm_t ln, ld, t;
 
-	fp2add751(lx1, ln, ln);               // ln = lx1 + ln
-	fp2mul751_mont(x, ln, ln);            // ln = x*ln
-	fp2mul751_mont(ly, y, ld);            // t = ly*y
-	fp2add751(lx2, ln, ln);               // ln = lx2 + ln
-	fp2add751(ld, ln, ln);                // ln = t + ln
-	fp2mul751_mont(ln, v0, ln);           // ln = ln*v0
-	fp2mul751_mont(n, ln, n);             // n = n*ln
+	for (k = 0; k < 5; k++) {
+		ly = parabs[pairing_lanes[k]][0]; lx2 = parabs[pairing_lanes[k]][1]; lx1 = parabs[pairing_lanes[k]][2]; 
+		lx0 = parabs[pairing_lanes[k]][3]; vx = parabs[pairing_lanes[k]][4]; v0 = parabs[pairing_lanes[k]][5];
+		x = pts[k]->x; y = pts[k]->y;
+		fp2mul751_mont(lx0, x, ln);                  // ln = lx0*x
+		fp2mul751_mont(v0, x, ld);                   // ld = v0*x
+		fp2add751(vx, ld, ld);                       // ld = vx + ld
+		fp2mul751_mont(ld, ln, ld);                  // ld = ld*ln
+		fp2add751(lx1, ln, ln);                      // ln = lx1 + ln
+		fp2mul751_mont(x, ln, ln);                   // ln = x*ln
+		fp2mul751_mont(ly, y, t);                    // t = ly*y
+		fp2add751(lx2, ln, ln);                      // ln = lx2 + ln
+		fp2add751(t, ln, ln);                        // ln = t + ln
+		fp2mul751_mont(ln, v0, ln);                  // ln = ln*v0
+		inv_Fp2_cycl(ld);                            // ld = conj(ld)
+		fp2mul751_mont(ln, ld, ln);                  // ln = ln*ld
+		fp2sqr751_mont(f[k], t);                     // t = f^2
+		fp2mul751_mont(f[k], t, f[k]);               // f = f*t
+		fp2mul751_mont(f[k], ln, f[k]);              // f = f*ln
+	}
 }
 
-static void cube_and_absorb_parab(const f2elm_t ly, const f2elm_t lx2, const f2elm_t lx1, const f2elm_t lx0, const f2elm_t vx, const f2elm_t v0, const point_t P, f2elm_t n, f2elm_t d)
-{ // Cube the running pairing value in Miller's algorithm and absorb parabola function values of the current Miller step.
-	f2elm_t ln, ld;
-
-	fp2sqr751_mont(n, ln);             // ln = n ^ 2
-	fp2mul751_mont(n, ln, n);          // n = n*ln
-	fp2sqr751_mont(d, ld);             // ld = d ^ 2
-	fp2mul751_mont(d, ld, d);          // d = d*ld
-	absorb_parab(ly, lx2, lx1, lx0, vx, v0, P, n, d);
-}
 
 static void final_tpl(point_ext_proj_t P, const f2elm_t A, f2elm_t lam, f2elm_t mu, f2elm_t D)
 { // Special iteration for the final tripling step in Miller's algorithm. This is necessary since the tripling 
@@ -1429,291 +2510,467 @@ static void final_tpl(point_ext_proj_t P, const f2elm_t A, f2elm_t lam, f2elm_t
 	fp2add751(YZ, YZ, D);              // D = YZ + YZ
 }
 
-static void final_tpl_iteration(const f2elm_t x, const f2elm_t y, const f2elm_t lam, const f2elm_t mu, const f2elm_t D, f2elm_t n, f2elm_t d)
+static void final_tpl_iteration(const f2elm_t x, const f2elm_t y, const f2elm_t lam, const f2elm_t mu, const f2elm_t D, f2elm_t f)
 { // Special iteration for the final tripling step in Miller's algorithm. This is necessary since the tripling 
   // at the end of the Miller loop is an exceptional case (tripling a point of order 3). 
-  // Cubes the running pairing value n/d and absorbs the line function values. 
+  // Cubes the running pairing value f = n*conj(d) and absorbs the line function values. 
 	f2elm_t ln, ld, t;
 
-	fp2sqr751_mont(n, ln);             // ln = n ^ 2
-	fp2mul751_mont(n, ln, n);          // n = n*ln
-	fp2sqr751_mont(d, ld);             // ld = d ^ 2
-	fp2mul751_mont(d, ld, d);          // d = d*ld
 	fp2sqr751_mont(x, ld);             // ld = x ^ 2
 	fp2mul751_mont(mu, ld, ld);        // ld = mu*ld
 	fp2mul751_mont(lam, x, t);         // t = lambda*x
 	fp2add751(t, ld, ln);              // ln = t + ld
 	fp2mul751_mont(D, y, t);           // t = D*y
 	fp2add751(t, ln, ln);              // ln = t + ln
-	fp2mul751_mont(n, ln, n);          // n = n*ln
-	fp2mul751_mont(d, ld, d);          // d = d*ld
-}
-
-
-static void final_exponentiation_3_torsion(f2elm_t n, f2elm_t d, const f2elm_t n_inv, const f2elm_t d_inv, f2elm_t nout, PCurveIsogenyStruct CurveIsogeny)
-{ // The final exponentiation for pairings in the 3-torsion group. Raising the value n/d to the power (p^2-1)/3^eB.
-	felm_t one = {0};
-	unsigned int i;
-
-	fpcopy751(CurveIsogeny->Montgomery_one, one);
-	fp2mul751_mont(n, d_inv, n);                     // n = n*d_inv
-													 // n = n^p. Just call conjugation function
-	inv_Fp2_cycl(n);
-	fp2mul751_mont(d, n_inv, d);                     // d = d*n_inv
-	fp2mul751_mont(n, d, n);                         // n = n*d
-
-	for (i = 0; i < 372; i++) {
-		sqr_Fp2_cycl(n, one);
-	}
-	fp2copy751(n, nout);
+	inv_Fp2_cycl(ld);                  // ld = conj(ld)
+	fp2mul751_mont(ln, ld, ln);        // ln = ln*ld
+	fp2sqr751_mont(f, t);              // t = f ^ 2
+	fp2mul751_mont(f, t, f);           // f = f*t
+	fp2mul751_mont(f, ln, f);          // f = f*ln
 }
 
 
 void Tate_pairings_3_torsion(const point_t R1, const point_t R2, const point_t P, const point_t Q, const f2elm_t A, f2elm_t* n, PCurveIsogenyStruct CurveIsogeny)
 { // The tripling only 3-torsion Tate pairing of order 3^eB, consisting of the tripling only Miller loop and the final exponentiation. 
   // Computes 5 pairings at once: e(R1, R2), e(R1, P), e(R1, Q), e(R2, P), e(R2,Q).
-	point_ext_proj_t P1 = {0}, P2 = {0};
-	f2elm_t ly, lx2, lx1, lx0, vx, v0, lam, mu, d;
-	f2elm_t invs[10], nd[10] = {0};
+  // The five Miller loops share the triplings of R1 and R2 and run in lanes over arrays of parabola values, points and running values.
+	f2elm_t parabs[2][6], lam, mu, d;
+	const point_affine* pts[5] = { R2, P, Q, P, Q };
+#if defined(SIDH_BOUNDED_STACK)
+	point_ext_proj_t *R = SIDH_WORKSPACE(CurveIsogeny)->R;
+	f2elm_t *nd = SIDH_WORKSPACE(CurveIsogeny)->nd;
+#else
+	point_ext_proj_t R[2];
+	f2elm_t nd[5];
+#endif
 	felm_t one = {0};
-	unsigned int i;
+	unsigned int i, k;
 
 	fpcopy751(CurveIsogeny->Montgomery_one, one);
-	fp2copy751(R1->x, P1->XZ);
-	fp2sqr751_mont(P1->XZ, P1->X2);
-	fp2copy751(R1->y, P1->YZ);
-	fpcopy751(one, P1->Z2[0]);                       // P1 = (x1^2,x1,1,y1)    
-	fp2copy751(R2->x, P2->XZ);
-	fp2sqr751_mont(P2->XZ, P2->X2);
-	fp2copy751(R2->y, P2->YZ);
-	fpcopy751(one, P2->Z2[0]);                       // P2 = (x2^2,x2,1,y2)
-
-	for (i = 0; i < 10; i++) {                       // nd[i] = 1
+	fp2copy751(R1->x, R[0]->XZ);
+	fp2sqr751_mont(R[0]->XZ, R[0]->X2);
+	fp2copy751(R1->y, R[0]->YZ);
+	fp2zero751(R[0]->Z2);
+	fpcopy751(one, R[0]->Z2[0]);                     // R[0] = (x1^2,x1,1,y1)    
+	fp2copy751(R2->x, R[1]->XZ);
+	fp2sqr751_mont(R[1]->XZ, R[1]->X2);
+	fp2copy751(R2->y, R[1]->YZ);
+	fp2zero751(R[1]->Z2);
+	fpcopy751(one, R[1]->Z2[0]);                     // R[1] = (x2^2,x2,1,y2)
+
+	for (i = 0; i < 5; i++) {                        // nd[i] = 1
+		fp2zero751(nd[i]);
 		fpcopy751(one, nd[i][0]);
 	}
 
 	for (i = 239; i >= 2; i--) {
-		tpl_and_parabola(P1, A, ly, lx2, lx1, lx0, vx, v0);
-		cube_and_absorb_parab(ly, lx2, lx1, lx0, vx, v0, R2, nd[0], nd[5]);
-		cube_and_absorb_parab(ly, lx2, lx1, lx0, vx, v0, P, nd[1], nd[6]);
-		cube_and_absorb_parab(ly, lx2, lx1, lx0, vx, v0, Q, nd[2], nd[7]);
-		tpl_and_parabola(P2, A, ly, lx2, lx1, lx0, vx, v0);
-		cube_and_absorb_parab(ly, lx2, lx1, lx0, vx, v0, P, nd[3], nd[8]);
-		cube_and_absorb_parab(ly, lx2, lx1, lx0, vx, v0, Q, nd[4], nd[9]);
+		for (k = 0; k < 2; k++) {
+			tpl_and_parabola(R[k], A, parabs[k][0], parabs[k][1], parabs[k][2], parabs[k][3], parabs[k][4], parabs[k][5]);
+		}
+		cube_and_absorb_parabs((const f2elm_t(*)[6])parabs, pts, nd);
+	}
+
+	for (k = 0; k < 5; k++) {
+		if (k == 0 || k == 3) {
+			final_tpl(R[pairing_lanes[k]], A, lam, mu, d);
+		}
+		final_tpl_iteration(pts[k]->x, pts[k]->y, lam, mu, d, nd[k]);
 	}
 
-	final_tpl(P1, A, lam, mu, d);
-	final_tpl_iteration(R2->x, R2->y, lam, mu, d, nd[0], nd[5]);
-	final_tpl_iteration(P->x, P->y, lam, mu, d, nd[1], nd[6]);
-	final_tpl_iteration(Q->x, Q->y, lam, mu, d, nd[2], nd[7]);
-	final_tpl(P2, A, lam, mu, d);
-	final_tpl_iteration(P->x, P->y, lam, mu, d, nd[3], nd[8]);
-	final_tpl_iteration(Q->x, Q->y, lam, mu, d, nd[4], nd[9]);
-
-	mont_n_way_inv(nd, 10, invs);
-	final_exponentiation_3_torsion(nd[0], nd[5], invs[0], invs[5], n[0], CurveIsogeny);
-	final_exponentiation_3_torsion(nd[1], nd[6], invs[1], invs[6], n[1], CurveIsogeny);
-	final_exponentiation_3_torsion(nd[2], nd[7], invs[2], invs[7], n[2], CurveIsogeny);
-	final_exponentiation_3_torsion(nd[3], nd[8], invs[3], invs[8], n[3], CurveIsogeny);
-	final_exponentiation_3_torsion(nd[4], nd[9], invs[4], invs[9], n[4], CurveIsogeny);
-}
-
-
-void phn1(const f2elm_t q, const f2elm_t* LUT, const uint64_t a, const felm_t one, uint64_t* alpha_i)
-{ // Pohlig-Hellman for groups of 2-power order up to 2^6
-  // This function solves the DLP in a subgroup of Fp2* of order 2^a, where a <= 6.
-  // The DL is returned in alpha which only needs a bits to store the result.
-    f2elm_t u, v, tmp;
-    felm_t zero = {0};
-    uint64_t l, h;
-
-    fp2copy751(q, u);                     // u = q
-    *alpha_i = 0;
-    for (l = 0; l < a-1; l++) {  
-        fp2copy751(u, v);                 // v = u
-        for (h = 1; h < (a-l); h++) { 
-            sqr_Fp2_cycl(v, one); 
+	final_exponentiations((const f2elm_t*)nd, n, 3, CurveIsogeny);
+}
+
+
+static unsigned int ph_ell_power(const unsigned int ell, const unsigned int k)
+{ // Returns ell^k for small ell and k
+    unsigned int i, r = 1;
+
+    for (i = 0; i < k; i++) {
+        r *= ell;
+    }
+    return r;
+}
+
+
+static void ph_pow(f2elm_t u, const unsigned int ell, const unsigned int k, const felm_t one)
+{ // Cyclotomic exponentiation u = u^(ell^k), ell = 2 or 3
+    unsigned int i;
+
+    if (ell == 2) {
+        for (i = 0; i < k; i++) sqr_Fp2_cycl(u, one);
+    } else {
+        for (i = 0; i < k; i++) cube_Fp2_cycl(u, one);
+    }
+}
+
+
+static void ph_correct(f2elm_t u, const ph_params* prm, const f2elm_t* T, unsigned int pos, unsigned int d)
+{ // Removes a solved digit d at ell-adic position pos from u, i.e., u = u*g^(-d*ell^pos), using the comb table T
+    unsigned int c, B = ph_ell_power(prm->ell, prm->v);
+
+    while (d != 0 && pos < prm->e) {
+        c = d % B;
+        if (c != 0) {
+            fp2mul751_mont(u, T[pos*(B-1) + c-1], u);
         }
-		fp2correction751(v);
-        if (fpequal751_non_constant_time(v[0], one) == false || fpequal751_non_constant_time(v[1], zero) == false) {
-            *alpha_i += ((uint64_t)1 << l);
-            fp2copy751(LUT[6-a+l], tmp);  // tmp = LUT[6-a+l];
-            fp2mul751_mont(u, tmp, u); 
+        d /= B;
+        pos += prm->v;
+    }
+}
+
+
+static void ph_leaf_key(f2elm_t u, felm_t key)
+{ // Leaf table key of a norm-1 element u = u0+u1*i, one base field element: the canonical u0, with the parity  
+  // of the canonical u1 in the top bit, which is unused since p751 < 2^751. Norm 1 fixes u1 up to sign given u0, and u1 and p751-u1 have  
+  // different parities for u1 != 0, so the key identifies u. Keys are only compared, never multiplied: all other Pohlig-Hellman values are full GF(p751^2) elements.
+    fp2correction751(u);
+    fpcopy751(u[0], key);
+    key[NWORDS_FIELD-1] |= (u[1][0] & 1) << (RADIX-1);
+}
+
+
+static unsigned int ph_leaf_digit(f2elm_t u, const felm_t* leaf, const unsigned int L)
+{ // Returns k in [0, L) such that u = gamma^k, with leaf holding the keys of the L powers gamma^(-k) of an element gamma of order L (see ph_leaf_key())
+    unsigned int k;
+    felm_t key;
+
+    ph_leaf_key(u, key);
+    for (k = 0; k < L; k++) {
+        if (fpequal751_non_constant_time(key, leaf[k])) {
+            break;
         }
     }
-	fp2correction751(u);
-	if (fpequal751_non_constant_time(u[0], one) == false || fpequal751_non_constant_time(u[1], zero) == false) {
-		*alpha_i += ((uint64_t)1 << (a-1));
-	}
+    return (L - k) % L;
 }
 
 
-void phn5(f2elm_t q, const f2elm_t* LUT, const f2elm_t* LUT_1, const felm_t one, uint64_t* alpha_k)
-{ // Pohlig-Hellman for groups of 2-power order 2^21
-    f2elm_t u, v, tmp;
-    felm_t zero = {0};
-    uint64_t alpha_i;
-    uint64_t i, j;
+static void mp_mul_add_small(digit_t* a, const digit_t m, const digit_t d, const unsigned int nwords)
+{ // Multiply-accumulate with single-digit operands, a = a*m + d, discarding the carry out of nwords digits
+    digit_t UV[2], carry = d;
+    unsigned int i, c;
 
-    *alpha_k = 0;
-	fp2copy751(q, u); 
-	for (i = 0; i < 4; i++) {
-		fp2copy751(u, v);
-		sqr_Fp2_cycl(v, one);
-		for (j = 0; j < (5 * (3 - i)); j++) { 
-			sqr_Fp2_cycl(v, one);
-		}
-		phn1(v, LUT, 5, one, &alpha_i);      // u order 2^5
-		*alpha_k += (alpha_i << (5 * i));
-		exp6_Fp2_cycl(LUT_1[i], alpha_i, one, tmp);       
-		fp2mul751_mont(u, tmp, u);
-	}
-	fp2correction751(u);
-    // Do the last part
-	if (fpequal751_non_constant_time(u[0], one) == false || fpequal751_non_constant_time(u[1], zero) == false) { // q order 2
-		*alpha_k += ((uint64_t)1 << 20);
-	} 
+    for (i = 0; i < nwords; i++) {
+        MUL(a[i], m, UV+1, UV[0]);
+        ADDC(0, UV[0], carry, c, a[i]);
+        carry = UV[1] + c;
+    }
 }
 
 
-void phn21(f2elm_t q, const f2elm_t* LUT, const f2elm_t* LUT_0, const f2elm_t* LUT_1, const felm_t one, uint64_t* alpha_k)
-{ // Pohlig-Hellman for groups of 2-power order 2^84 
-    f2elm_t u, v, tmp;
-    uint64_t alpha_i;
-    uint64_t i, j;
+void ph_build_tables(const f2elm_t g, const ph_params* prm, f2elm_t* T, felm_t* leaf, const felm_t one)
+{ // Lookup tables for ph_strategy() from a generator g of a cyclotomic subgroup of order ell^e.
+  // The comb table T holds g^(-c*ell^t) at T[t*(ell^v-1) + c-1], for 0 <= t < e and 0 < c < ell^v, which takes e*(ell^v-1) entries.
+  // The leaf table holds the keys of gamma^(-k) for gamma = g^(ell^(e-w)) and 0 <= k < ell^w (see ph_leaf_key()).
+  // It is built from the comb table powers rather than by conjugation, since conjugating a zero coordinate gives 2*p751, which fp2correction751() does not reduce.
+    unsigned int t, c, B = ph_ell_power(prm->ell, prm->v), L = ph_ell_power(prm->ell, prm->w);
+    f2elm_t b, gamma_inv, u;
 
+    fp2copy751(g, b);
+    inv_Fp2_cycl(b);                                       // b = g^(-ell^t)
+    for (t = 0; t < prm->e; t++) {
+        fp2copy751(b, T[t*(B-1)]);
+        for (c = 2; c < B; c++) {
+            fp2mul751_mont(T[t*(B-1) + c-2], b, T[t*(B-1) + c-1]);
+        }
+        if (t == prm->e - prm->w) {
+            fp2copy751(b, gamma_inv);                      // gamma_inv = gamma^(-1)
+        }
+        ph_pow(b, prm->ell, 1, one);
+    }
+
+    fp2zero751(u);
+    fpcopy751(one, u[0]);
+    for (c = 0; c < L; c++) {
+        ph_leaf_key(u, leaf[c]);                           // leaf[c] = key(gamma^(-c))
+        fp2mul751_mont(u, gamma_inv, u);
+    }
+}
 
-    alpha_k[0] = 0;
-	alpha_k[1] = 0;
-	fp2copy751(q, u);
-    for (i = 0; i < 3; i++) {
-        fp2copy751(u, v);
-        for (j = 0; j < 21*(3-i); j++) {          
-            sqr_Fp2_cycl(v, one); 
+
+void ph_strategy(const f2elm_t h, const ph_params* prm, const f2elm_t* T, const felm_t* leaf, const felm_t one, digit_t* alpha)
+{ // Pohlig-Hellman in a cyclotomic subgroup of order ell^e, driven by a strategy as in the isogeny trees.
+  // Returns alpha in [0, ell^e) such that h = g^alpha, where T and leaf are the tables of g built by ph_build_tables().
+  // alpha = d_0 + d_1*ell^r + d_2*ell^(r+w) + ... is split into nleaves = ceil(e/w) digits, where the least significant one has r = e-(nleaves-1)*w 
+  // ell-adic digits and all others have w. Each multiplication step of the strategy raises to ell^w, and the digit at each leaf is read from the leaf table. 
+  // Every intermediate value kept by the strategy is then corrected with the comb table.
+  // The intermediates and the comb table stay full GF(p751^2) elements. On projective torus coordinates (A:B), u = (A+B*i)/(A-B*i), a table entry is one  
+  // GF(p751) element and a correction costs 2 GF(p751) multiplications, but a leaf has no canonical key without an inversion, so the lookup costs a 
+  // multiplication per candidate, and cubing costs 2S+2M instead of 1S+2M. Measured at -O3 with x64 assembly over w <= 4, v <= 4: at best 1.15M cycles 
+  // for 2-torsion (w = 3, v = 3) and 1.38M for 3-torsion (w = 3, v = 3), against 0.93M (w = 8, v = 3) and 0.89M (w = 4, v = 2) here.
+    unsigned int nleaves = (prm->e + prm->w - 1)/prm->w, r = prm->e - (nleaves-1)*prm->w, L = ph_ell_power(prm->ell, prm->w);
+    unsigned int i, j, row, m, pos, index = 0, npts = 0, pts_index[MAX_INT_VALUES_PH];
+    unsigned int digits[PH_MAX_LEAVES];
+    f2elm_t u, pts[MAX_INT_VALUES_PH];
+
+    fp2copy751(h, u);
+    for (row = 1; row < nleaves; row++) {
+        while (index < nleaves-row) {
+            fp2copy751(u, pts[npts]);
+            pts_index[npts] = index;
+            npts += 1;
+            m = prm->splits[nleaves-index-row];
+            ph_pow(u, prm->ell, m*prm->w, one);
+            index += m;
+        }
+        j = row - 1;
+        digits[j] = ph_leaf_digit(u, leaf, L);
+        pos = 0;
+        if (j == 0) {
+            digits[0] /= ph_ell_power(prm->ell, prm->w - r);
+        } else {
+            pos = r + (j-1)*prm->w;
+        }
+        for (i = 0; i < npts; i++) {
+            ph_correct(pts[i], prm, T, pos + pts_index[i]*prm->w, digits[j]);
         }
-        phn5(v, LUT, LUT_1, one, &alpha_i);      // u order 2^21
-        alpha_k[0] += (alpha_i << (21*i));
-        exp21_Fp2_cycl(LUT_0[i], alpha_i, one, tmp); 
-        fp2mul751_mont(u, tmp, u);
+        fp2copy751(pts[npts-1], u);
+        index = pts_index[npts-1];
+        npts -= 1;
+    }
+    digits[nleaves-1] = ph_leaf_digit(u, leaf, L);
+    if (nleaves == 1) {
+        digits[0] /= ph_ell_power(prm->ell, prm->w - r);
+    }
+
+    clear_words((void*)alpha, NWORDS_ORDER);              // alpha = ((d_(nleaves-1)*ell^w + d_(nleaves-2))*ell^w + ... + d_1)*ell^r + d_0
+    for (j = nleaves-1; j > 0; j--) {
+        mp_mul_add_small(alpha, (j == nleaves-1) ? 0 : L, digits[j], NWORDS_ORDER);
     }
-	phn5(u, LUT, LUT_1, one, &alpha_i);      // u order 2^21
-	alpha_k[0] += (alpha_i << 63);
-	alpha_k[1] = (alpha_i >> 1);
+    mp_mul_add_small(alpha, ph_ell_power(prm->ell, r), digits[0], NWORDS_ORDER);
 }
 
 
-void phn84(f2elm_t r, const f2elm_t* t_ori, const f2elm_t* LUT, const f2elm_t* LUT_0, const f2elm_t* LUT_1, const f2elm_t* LUT_3, const felm_t one, uint64_t* alpha)
-{ // Pohlig-Hellman for groups of 2-power order 2^372                                                                                                                                                                                 
-    f2elm_t u, q, t, tmp;
-    uint64_t alpha_k[2], alpha_i, mask;
-    uint64_t i, j, k;
+typedef struct {                                               // Discrete logarithms assigned to one Pohlig-Hellman worker
+    const ph_params* prm;
+    const f2elm_t*   T;
+    const felm_t*    leaf;
+    const digit_t*   one;
+    const felm_t*    h[4];
+    digit_t*         alpha[4];
+    unsigned int     first, stride;
+} ph_job;
+
+
+static void* ph_worker(void* arg)
+{ // Solves the discrete logarithms first, first+stride, ... of a job
+    ph_job* job = (ph_job*)arg;
+    unsigned int i;
+
+    for (i = job->first; i < 4; i += job->stride) {
+        ph_strategy(job->h[i], job->prm, job->T, job->leaf, job->one, job->alpha[i]);
+    }
+    return NULL;
+}
+
+
+#if defined(SIDH_PTHREADS)
+typedef struct ph_pool ph_pool;
+
+typedef struct {                                               // Argument of a pool thread: its pool and the index of the worker it runs
+    ph_pool*         pool;
+    unsigned int     index;
+} ph_pool_arg;
+
+struct ph_pool {                                               // Persistent threads running the Pohlig-Hellman workers 1, ..., nthreads of a compression
+    pthread_mutex_t  lock;
+    pthread_cond_t   start, done;
+    pthread_mutex_t  busy;                                     // Held by the compression using the pool: concurrent compressions solve on their own thread
+    pthread_t        threads[SIDH_MAX_PH_WORKERS];
+    ph_pool_arg      args[SIDH_MAX_PH_WORKERS];
+    unsigned int     nthreads, pending, generation;
+    bool             shutdown;
+    const ph_job*    jobs;
+};
 
-	for (i = 0; i < NWORDS64_ORDER; i++) alpha[i] = 0;
-    fp2copy751(r, t);
-    for (k = 0; k < 4; k++) {
-		fp2copy751(t, q);
-        for (j = 0; j < 36; j++) {
-            sqr_Fp2_cycl(q, one); 
+
+static void* ph_pool_thread(void* arg)
+{ // Runs worker "index" of every batch of jobs posted to the pool, until the pool is shut down
+    ph_pool_arg* a = (ph_pool_arg*)arg;
+    ph_pool* pool = a->pool;
+    unsigned int seen = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (pool->generation == seen && !pool->shutdown) {
+            pthread_cond_wait(&pool->start, &pool->lock);
         }
-        for (j = 0; j < 84*(3-k); j++) { 
-            sqr_Fp2_cycl(q, one);
+        if (pool->shutdown) {
+            break;
         }
-        phn21(q, LUT, LUT_0, LUT_1, one, alpha_k);  // q order 2^84 
-        alpha[k] += (alpha_k[0] << (k*20));
-	    mask = ((uint64_t)1 << (k * 20))-1;
-		alpha[k + 1] += ((alpha_k[0] >> (64 - k * 20)) & mask);
-		alpha[k + 1] += (alpha_k[1] << (k * 20));
-        exp84_Fp2_cycl(t_ori[k], alpha_k, one, tmp); 
-        fp2mul751_mont(t, tmp, t); 
-    }
-	alpha[5] = (alpha_k[1] >> 4);
-    // Do the last part
-    for (i = 0; i < 6; i++) {
-        fp2copy751(t, u);
-        for (j = 0; j < 6*(5-i); j++) {                 
-            sqr_Fp2_cycl(u, one); 
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+        ph_worker((void*)&pool->jobs[a->index]);
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->pending == 0) {
+            pthread_cond_signal(&pool->done);
         }
-        phn1(u, LUT, 6, one, &alpha_i);      // u order 2^6
-        alpha[5] += (alpha_i << (16 + 6*i));
-        exp6_Fp2_cycl(LUT_3[i], alpha_i, one, tmp);      
-        fp2mul751_mont(t, tmp, t);
     }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
 }
+#endif
 
 
-void build_LUTs(const f2elm_t g, f2elm_t* t_ori, f2elm_t* LUT, f2elm_t* LUT_0, f2elm_t* LUT_1, f2elm_t* LUT_3, const felm_t one)
-{ // Lookup table generation for 2-torsion PH in a group of order 2^372
-	f2elm_t tmp;
-	unsigned int i, j; 
+void* ph_pool_create(const unsigned int workers)
+{ // Starts the persistent threads running the Pohlig-Hellman workers 1, ..., workers-1; worker 0 runs on the calling thread.
+  // Returns NULL if no thread can be started, or without pthreads support.
+#if defined(SIDH_PTHREADS)
+    ph_pool* pool;
+    unsigned int k;
 
-	fp2copy751(g, tmp);                                    // tmp = g
-	inv_Fp2_cycl(tmp);
-	fp2copy751(tmp, t_ori[0]);                             // t_ori[0] = g^(-1), order 2^372
-	for (i = 0; i < 3; i++) {
-		for (j = 0; j < 84; j++) sqr_Fp2_cycl(tmp, one);
-		fp2copy751(tmp, t_ori[i+1]);                       // order 2^288 & 2^204 & 2^120 
-	}
-	for (i = 0; i < 36; i++) sqr_Fp2_cycl(tmp, one);
-	fp2copy751(tmp, t_ori[4]);                             // t_ori[4], order 2^84
-	                                                       // t_ori done.
-	fp2copy751(tmp, LUT_0[0]);                             // LUT_0[0] = t_ori[4], order 2^84
-	for (i = 0; i < 2; i++) {
-		for (j = 0; j < 21; j++) sqr_Fp2_cycl(tmp, one);
-		fp2copy751(tmp, LUT_0[i+1]);                       // order 2^63 & 2^42 
-	}
-	for (j = 0; j < 6; j++) sqr_Fp2_cycl(tmp, one);
-	fp2copy751(tmp, LUT_3[0]);                             // LUT_3[0] = tmp, order 2^36
-	for (j = 0; j < 6; j++) sqr_Fp2_cycl(tmp, one);
-	fp2copy751(tmp, LUT_3[1]);                             // LUT_3[1] = tmp, order 2^30
-	for (j = 0; j < 6; j++) sqr_Fp2_cycl(tmp, one);
-	fp2copy751(tmp, LUT_3[2]);                             // LUT_3[2] = tmp, order 2^24
-	for (j = 0; j < 3; j++) sqr_Fp2_cycl(tmp, one);
-	fp2copy751(tmp, LUT_0[3]);                             // LUT_0[3] = tmp, order 2^21 
-	                                                       // LUT_0 done.
-	fp2copy751(tmp, LUT_1[0]);                             // LUT_1[0] = LUT_0[3], order 2^21
-	for (i = 0; i < 3; i++) sqr_Fp2_cycl(tmp, one);
-	fp2copy751(tmp, LUT_3[3]);                             // LUT_3[3] = tmp, order 2^18
-	for (i = 0; i < 2; i++) sqr_Fp2_cycl(tmp, one);
-	fp2copy751(tmp, LUT_1[1]);                             // LUT_1[1] = tmp, order 2^16
-	for (i = 0; i < 4; i++) sqr_Fp2_cycl(tmp, one);
-	fp2copy751(tmp, LUT_3[4]);                             // LUT_3[4] = tmp, order 2^12
-	sqr_Fp2_cycl(tmp, one);
-	fp2copy751(tmp, LUT_1[2]);                             // LUT_1[2] = tmp, order 2^11
-	for (i = 0; i < 5; i++) sqr_Fp2_cycl(tmp, one);
-	fp2copy751(tmp, LUT_1[3]);                             // LUT_1[3] = tmp, order 2^16 & 2^11 & 2^6    
-	fp2copy751(tmp, LUT_3[5]);                             // LUT_3[5] = tmp
-	                                                       // LUT_1, LUT_3 done
-	fp2copy751(tmp, LUT[0]);                               // LUT = LUT_3[5]
-	for (i = 0; i < 4; i++) {
-		fp2copy751(LUT[i], LUT[i+1]);
-		sqr_Fp2_cycl(LUT[i+1], one);                       // order 2^5 -- 2^1
-	}
+    if (workers < 2 || workers > SIDH_MAX_PH_WORKERS) {
+        return NULL;
+    }
+    pool = (ph_pool*)calloc(1, sizeof(ph_pool));
+    if (pool == NULL) {
+        return NULL;
+    }
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_mutex_init(&pool->busy, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->done, NULL);
+
+    for (k = 1; k < workers; k++) {                            // The pool keeps the threads that could be started
+        pool->args[pool->nthreads].pool = pool;
+        pool->args[pool->nthreads].index = pool->nthreads + 1;
+        if (pthread_create(&pool->threads[pool->nthreads], NULL, ph_pool_thread, &pool->args[pool->nthreads]) != 0) {
+            break;
+        }
+        pool->nthreads++;
+    }
+    if (pool->nthreads == 0) {
+        ph_pool_destroy(pool);
+        return NULL;
+    }
+    return pool;
+#else
+    (void)workers;
+    return NULL;
+#endif
 }
 
 
-void ph2(const point_t phiP, const point_t phiQ, const point_t PS, const point_t QS, const f2elm_t A, uint64_t* a0, uint64_t* b0, uint64_t* a1, uint64_t* b1, PCurveIsogenyStruct CurveIsogeny)
+void ph_pool_destroy(void* pool)
+{ // Stops the threads of a pool started by ph_pool_create() and frees it
+#if defined(SIDH_PTHREADS)
+    ph_pool* p = (ph_pool*)pool;
+    unsigned int k;
+
+    if (p == NULL) {
+        return;
+    }
+    pthread_mutex_lock(&p->lock);
+    p->shutdown = true;
+    pthread_cond_broadcast(&p->start);
+    pthread_mutex_unlock(&p->lock);
+    for (k = 0; k < p->nthreads; k++) {
+        pthread_join(p->threads[k], NULL);
+    }
+    pthread_mutex_destroy(&p->lock);
+    pthread_mutex_destroy(&p->busy);
+    pthread_cond_destroy(&p->start);
+    pthread_cond_destroy(&p->done);
+    free(p);
+#else
+    (void)pool;
+#endif
+}
+
+
+static void ph_solve(const f2elm_t* n, const ph_params* prm, const f2elm_t* T, const felm_t* leaf, const felm_t one, digit_t** alpha, void* pool)
+{ // Discrete logarithms of n[1], n[3], n[2] and n[4] to the base n[0], output in alpha[0..3], shared by the threads of "pool" and the calling thread.
+  // The tables are only read, so all workers use the same ones. Without a pool, or if another compression is using it, the calling thread solves all four.
+    ph_job jobs[SIDH_MAX_PH_WORKERS];
+    unsigned int i, k, workers = 1;
+#if defined(SIDH_PTHREADS)
+    ph_pool* p = (ph_pool*)pool;
+
+    if (p != NULL && pthread_mutex_trylock(&p->busy) == 0) {
+        workers = p->nthreads + 1;
+    } else {
+        p = NULL;
+    }
+#else
+    (void)pool;
+#endif
+
+    for (k = 0; k < workers; k++) {
+        jobs[k].prm = prm;
+        jobs[k].T = T;
+        jobs[k].leaf = leaf;
+        jobs[k].one = one;
+        jobs[k].h[0] = n[1];
+        jobs[k].h[1] = n[3];
+        jobs[k].h[2] = n[2];
+        jobs[k].h[3] = n[4];
+        for (i = 0; i < 4; i++) {
+            jobs[k].alpha[i] = alpha[i];
+        }
+        jobs[k].first = k;
+        jobs[k].stride = workers;
+    }
+
+#if defined(SIDH_PTHREADS)
+    if (p != NULL) {
+        pthread_mutex_lock(&p->lock);                          // Post the jobs to the pool threads
+        p->jobs = jobs;
+        p->pending = p->nthreads;
+        p->generation++;
+        pthread_cond_broadcast(&p->start);
+        pthread_mutex_unlock(&p->lock);
+
+        ph_worker(&jobs[0]);
+
+        pthread_mutex_lock(&p->lock);                          // Wait for the pool threads
+        while (p->pending != 0) {
+            pthread_cond_wait(&p->done, &p->lock);
+        }
+        pthread_mutex_unlock(&p->lock);
+        pthread_mutex_unlock(&p->busy);
+        return;
+    }
+#endif
+    ph_worker(&jobs[0]);
+}
+
+
+CRYPTO_STATUS ph2(const point_t phiP, const point_t phiQ, const point_t PS, const point_t QS, const f2elm_t A, uint64_t* a0, uint64_t* b0, uint64_t* a1, uint64_t* b1, PCurveIsogenyStruct CurveIsogeny)
 { // Pohlig-Hellman function. 
   // This function computes the five pairings e(QS, PS), e(QS, phiP), e(QS, phiQ), e(PS, phiP), e(PS,phiQ),
   // computes the lookup tables for the Pohlig-Hellman functions,
   // and then computes the discrete logarithms of the last four pairing values to the base of the first pairing value.                                                                    
-    f2elm_t t_ori[5], n[5], LUT[5], LUT_0[4], LUT_1[4], LUT_3[6];
+#if defined(SIDH_BOUNDED_STACK)
+    f2elm_t *n = SIDH_WORKSPACE(CurveIsogeny)->n;
+#else
+    f2elm_t n[5];
+#endif
+    f2elm_t* T = (f2elm_t*)calloc(PH2_TABLE_SIZE, sizeof(f2elm_t));              // Lookup tables, kept on the heap in every build
+    felm_t* leaf = (felm_t*)calloc(PH2_LEAF_SIZE, sizeof(felm_t));
+    ph_params prm = {2, CurveIsogeny->oAbits, PH2_WINDOW, PH2_TABLE_WINDOW, CurveIsogeny->splits_ph2};
+    digit_t* alpha[4] = {(digit_t*)a0, (digit_t*)b0, (digit_t*)a1, (digit_t*)b1};
     felm_t one = {0};
     
     fpcopy751(CurveIsogeny->Montgomery_one, one);
+    if (T == NULL || leaf == NULL) {
+        free(T);
+        free(leaf);
+        return CRYPTO_ERROR_NO_MEMORY;
+    }
 	
 	// Compute the pairings.
     Tate_pairings_2_torsion(QS, PS, phiP, phiQ, A, n, CurveIsogeny);
 
 	// Build the lookup tables from element n[0] of order 2^372.
-	build_LUTs(n[0], t_ori, LUT, LUT_0, LUT_1, LUT_3, one);
+	ph_build_tables(n[0], &prm, T, leaf, one);
 
     // Finish computation
-    phn84(n[1], t_ori, LUT, LUT_0, LUT_1, LUT_3, one, a0);
-    phn84(n[3], t_ori, LUT, LUT_0, LUT_1, LUT_3, one, b0);
+    ph_solve(n, &prm, T, leaf, one, alpha, SIDH_DISPATCH(CurveIsogeny)->ph_pool);
 	mp_sub(CurveIsogeny->Aorder, (digit_t*)b0, (digit_t*)b0, NWORDS_ORDER);
-    phn84(n[2], t_ori, LUT, LUT_0, LUT_1, LUT_3, one, a1);
-    phn84(n[4], t_ori, LUT, LUT_0, LUT_1, LUT_3, one, b1);
 	mp_sub(CurveIsogeny->Aorder, (digit_t*)b1, (digit_t*)b1, NWORDS_ORDER);
+
+    free(T);
+    free(leaf);
+    return CRYPTO_SUCCESS;
 }
 
 
@@ -1748,45 +3005,60 @@ static void recover_os(const f2elm_t X1, const f2elm_t Z1, const f2elm_t X2, con
 }
 
 
-void recover_y(const publickey_t PK, point_full_proj_t phiP, point_full_proj_t phiQ, point_full_proj_t phiX, f2elm_t A, PCurveIsogenyStruct CurveIsogeny)
-{ // Recover the y-coordinates of the public key
+void recover_y_proj(const point_proj_t P, const point_proj_t Q, const f2elm_t xD, const f2elm_t A, point_full_proj_t phiP, point_full_proj_t phiQ, point_full_proj_t phiX, PCurveIsogenyStruct CurveIsogeny)
+{ // Recover the y-coordinates of a public key given as the projective points P and Q, the affine x-coordinate xD of Q-P and the curve constant A
   // The three resulting points are (simultaneously) correct up to sign
     f2elm_t tmp, phiXY, one = {0};
 
     fpcopy751(CurveIsogeny->Montgomery_one, one[0]);
-    get_A(PK[0], PK[1], PK[2], A, CurveIsogeny);  // NOTE: don't have to compress this, can output in keygen
 
-    fp2add751(PK[2], A, tmp);
-    fp2mul751_mont(PK[2], tmp, tmp);
+    fp2add751(xD, A, tmp);
+    fp2mul751_mont(xD, tmp, tmp);
     fp2add751(tmp, one, tmp);                 
-    fp2mul751_mont(PK[2], tmp, tmp);              // tmp = PK[2]^3+A*PK[2]^2+PK[2];
+    fp2mul751_mont(xD, tmp, tmp);                 // tmp = xD^3+A*xD^2+xD;
     sqrt_Fp2(tmp, phiXY);
-    fp2copy751(PK[2], phiX->X);
+    fp2copy751(xD, phiX->X);
     fp2copy751(phiXY, phiX->Y);
-    fp2copy751(one, phiX->Z);                     // phiX = [PK[2],phiXY,1];
+    fp2copy751(one, phiX->Z);                     // phiX = [xD,phiXY,1];
     
-    recover_os(PK[1], one, PK[0], one, PK[2], phiXY, A, phiQ->X, phiQ->Y, phiQ->Z);      
+    recover_os(Q->X, Q->Z, P->X, P->Z, xD, phiXY, A, phiQ->X, phiQ->Y, phiQ->Z);      
     fp2neg751(phiXY);
-    recover_os(PK[0], one, PK[1], one, PK[2], phiXY, A, phiP->X, phiP->Y, phiP->Z);
+    recover_os(P->X, P->Z, Q->X, Q->Z, xD, phiXY, A, phiP->X, phiP->Y, phiP->Z);
+}
+
+
+void recover_y(const publickey_t PK, point_full_proj_t phiP, point_full_proj_t phiQ, point_full_proj_t phiX, f2elm_t A, PCurveIsogenyStruct CurveIsogeny)
+{ // Recover the y-coordinates of the public key
+  // The three resulting points are (simultaneously) correct up to sign
+    point_proj_t P = {0}, Q = {0};
+
+    get_A(PK[0], PK[1], PK[2], A, CurveIsogeny); 
+
+    fp2copy751(PK[0], P->X);
+    fpcopy751(CurveIsogeny->Montgomery_one, P->Z[0]);  // P = (PK[0]:1)
+    fp2copy751(PK[1], Q->X);
+    fpcopy751(CurveIsogeny->Montgomery_one, Q->Z[0]);  // Q = (PK[1]:1)
+    recover_y_proj(P, Q, PK[2], A, phiP, phiQ, phiX, CurveIsogeny);
 }
 
 
-void compress_2_torsion(const unsigned char* PublicKeyA, unsigned char* CompressedPKA, uint64_t* a0, uint64_t* b0, uint64_t* a1, uint64_t* b1, point_t R1, point_t R2, PCurveIsogenyStruct CurveIsogeny)
+CRYPTO_STATUS compress_2_torsion(const unsigned char* PublicKeyA, unsigned char* CompressedPKA, uint64_t* a0, uint64_t* b0, uint64_t* a1, uint64_t* b1, point_t R1, point_t R2, PCurveIsogenyStruct CurveIsogeny)
 { // 2-torsion compression                                                                          
     point_full_proj_t P, Q, phP, phQ, phX;
     point_t phiP, phiQ;
     publickey_t PK;
-    digit_t* comp = (digit_t*)CompressedPKA;
+    digit_t comp[3*NWORDS_ORDER];
 	digit_t inv[NWORDS_ORDER];
     f2elm_t A, vec[4], Zinv[4];
-    digit_t tmp[2*NWORDS_ORDER];
+    CRYPTO_STATUS Status;
 
-    to_fp2mont(((f2elm_t*)PublicKeyA)[0], ((f2elm_t*)&PK)[0]);    // Converting to Montgomery representation
-    to_fp2mont(((f2elm_t*)PublicKeyA)[1], ((f2elm_t*)&PK)[1]); 
-    to_fp2mont(((f2elm_t*)PublicKeyA)[2], ((f2elm_t*)&PK)[2]); 
+    load_words(PublicKeyA, (digit_t*)PK, 3*2*NWORDS_FIELD);          // The caller's buffers are only accessed with memcpy (see load_words())
+    to_fp2mont(((f2elm_t*)&PK)[0], ((f2elm_t*)&PK)[0]);    // Converting to Montgomery representation
+    to_fp2mont(((f2elm_t*)&PK)[1], ((f2elm_t*)&PK)[1]); 
+    to_fp2mont(((f2elm_t*)&PK)[2], ((f2elm_t*)&PK)[2]); 
 
     recover_y(PK, phP, phQ, phX, A, CurveIsogeny);
-    generate_2_torsion_basis(A, P, Q, CurveIsogeny);
+    generate_2_torsion_basis_entangled(A, P, Q, CurveIsogeny);
     fp2copy751(P->Z, vec[0]);
     fp2copy751(Q->Z, vec[1]);
     fp2copy751(phP->Z, vec[2]);
@@ -1802,333 +3074,75 @@ void compress_2_torsion(const unsigned char* PublicKeyA, unsigned char* Compress
     fp2mul751_mont(phQ->X, Zinv[3], phiQ->x);
     fp2mul751_mont(phQ->Y, Zinv[3], phiQ->y);
 
-    ph2(phiP, phiQ, R1, R2, A, a0, b0, a1, b1, CurveIsogeny);
+    Status = ph2(phiP, phiQ, R1, R2, A, a0, b0, a1, b1, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        return Status;
+    }
 
     if ((a0[0] & 1) == 1) {  // Storing [b1*a0inv, a1*a0inv, b0*a0inv] and setting bit384 to 0
         inv_mod_orderA((digit_t*)a0, inv);        
-		multiply((digit_t*)b0, inv, tmp, NWORDS_ORDER);
-		copy_words(tmp, &comp[0], NWORDS_ORDER);
+		mp_mul_low((digit_t*)b0, inv, &comp[0], NWORDS_ORDER);
 		comp[NWORDS_ORDER-1] &= (digit_t)(-1) >> 12;       // Hardcoded value
-		multiply((digit_t*)a1, inv, tmp, NWORDS_ORDER);
-		copy_words(tmp, &comp[NWORDS_ORDER], NWORDS_ORDER);
+		mp_mul_low((digit_t*)a1, inv, &comp[NWORDS_ORDER], NWORDS_ORDER);
 		comp[2*NWORDS_ORDER-1] &= (digit_t)(-1) >> 12;
-		multiply((digit_t*)b1, inv, tmp, NWORDS_ORDER);
-		copy_words(tmp, &comp[2 * NWORDS_ORDER], NWORDS_ORDER);
+		mp_mul_low((digit_t*)b1, inv, &comp[2*NWORDS_ORDER], NWORDS_ORDER);
 		comp[3*NWORDS_ORDER-1] &= (digit_t)(-1) >> 12;
     } else {  // Storing [b1*b0inv, a1*b0inv, a0*b0inv] and setting bit384 to 1
 		inv_mod_orderA((digit_t*)b0, inv);
-		multiply((digit_t*)a0, inv, tmp, NWORDS_ORDER);
-		copy_words(tmp, &comp[0], NWORDS_ORDER);
+		mp_mul_low((digit_t*)a0, inv, &comp[0], NWORDS_ORDER);
 		comp[NWORDS_ORDER - 1] &= (digit_t)(-1) >> 12;     // Hardcoded value
-		multiply((digit_t*)a1, inv, tmp, NWORDS_ORDER);
-		copy_words(tmp, &comp[NWORDS_ORDER], NWORDS_ORDER);
+		mp_mul_low((digit_t*)a1, inv, &comp[NWORDS_ORDER], NWORDS_ORDER);
 		comp[2*NWORDS_ORDER-1] &= (digit_t)(-1) >> 12;
-		multiply((digit_t*)b1, inv, tmp, NWORDS_ORDER);
-		copy_words(tmp, &comp[2 * NWORDS_ORDER], NWORDS_ORDER);
+		mp_mul_low((digit_t*)b1, inv, &comp[2*NWORDS_ORDER], NWORDS_ORDER);
 		comp[3*NWORDS_ORDER-1] &= (digit_t)(-1) >> 12;
 		comp[3*NWORDS_ORDER-1] |= (digit_t)1 << (sizeof(digit_t)*8 - 1);
     }
     
-    from_fp2mont(A, (felm_t*)&comp[3*NWORDS_ORDER]);  // Converting back from Montgomery representation
-}
-
-
-void phn1_3(const f2elm_t q, const f2elm_t* LUT, const uint64_t a, const felm_t one, uint64_t* alpha_i)
-{
-    f2elm_t u, v, tmp;
-    felm_t zero = {0};
-    uint64_t l, h;
-	// Hardcoded powers of 3, 3^0 = 1, 3^1 = 3, 3^2 = 9
-	uint64_t pow3[3] = {0x0000000000000001, 0x0000000000000003, 0x0000000000000009}; 
-
-    fp2copy751(q, u);                     // u = q
-    *alpha_i = 0;
-    for (l = 0; l < a-1; l++) {  
-        fp2copy751(u, v);                 // v = u
-        for (h = 1; h < (a-l); h++) { 
-            cube_Fp2_cycl(v, one); 
-        }
-		fp2correction751(v);
-        if (fpequal751_non_constant_time(v[0], LUT[3][0]) == true && fpequal751_non_constant_time(v[1], LUT[3][1]) == true) {
-            *alpha_i += pow3[l];
-            fp2copy751(LUT[3-a+l], tmp);  // tmp = LUT[3-a+l];
-            fp2mul751_mont(u, tmp, u); 
-        } else if (fpequal751_non_constant_time(v[0], one) == false || fpequal751_non_constant_time(v[1], zero) == false) {
-			*alpha_i += pow3[l] << 1;
-            fp2copy751(LUT[3-a+l], tmp);  // tmp = LUT[3-a+l];
-			sqr_Fp2_cycl(tmp, one);
-            fp2mul751_mont(u, tmp, u); 
-        }
-    }
-	fp2correction751(u);
-	if (fpequal751_non_constant_time(u[0], LUT[3][0]) == true && fpequal751_non_constant_time(u[1], LUT[3][1]) == true) {
-		*alpha_i += pow3[a-1];
-	} else if (fpequal751_non_constant_time(u[0], one) == false || fpequal751_non_constant_time(u[1], zero) == false) {
-		*alpha_i += pow3[a-1] << 1;
-	}
-}
-
-
-void phn3(f2elm_t q, const f2elm_t* LUT, const f2elm_t* LUT_1, const felm_t one, uint64_t* alpha_k)
-{
-    f2elm_t u, v, tmp;
-    uint64_t alpha_i;
-    uint64_t i, j;
-	// Powers of 3: 3^0 = 1, 3^3 = 27, 3^6 = 729, 3^9, 3^12
-	uint64_t pow3[5] = {0x0000000000000001, 0x000000000000001B,
-	                    0x00000000000002D9, 0x0000000000004CE3,
-	                    0x0000000000081BF1 };
-
-    *alpha_k = 0;
-	fp2copy751(q, u);
-    for (i = 0; i < 4; i++) {
-        fp2copy751(u, v);
-        for (j = 0; j < 3*(4-i); j++) {       
-			cube_Fp2_cycl(v, one);
-        }
-        phn1_3(v, LUT, 3, one, &alpha_i);      // u order 3^3
-        *alpha_k += alpha_i * pow3[i];
-        exp6_Fp2_cycl(LUT_1[i], alpha_i, one, tmp);   
-        fp2mul751_mont(u, tmp, u); 
-    }
-	phn1_3(u, LUT, 3, one, &alpha_i);      // u order 3^3
-	*alpha_k += alpha_i * pow3[4];
-}
-
-
-void phn15_1(f2elm_t q, const f2elm_t* LUT, const f2elm_t* LUT_0, const f2elm_t* LUT_1, const felm_t one, uint64_t* alpha_k)
-{
-    f2elm_t u, v, tmp;
-	uint64_t alpha_i, alpha_n[2], alpha_tmp[4];   // alpha_tmp[4] is overkill, only taking 4 since it is the result of a mp_mul with 2-word inputs.
-    uint64_t i, j;
-	// Powers of 3: 3^0 = 1, 3^15, 3^30
-	uint64_t pow3_15[3] = { 0x0000000000000001, 0x0000000000DAF26B, 0x0000BB41C3CA78B9 };
-	// Powers of 3: 3^0 = 1, 3^3 = 27, 3^6
-	uint64_t pow3_3[4] = { 0x0000000000000001, 0x000000000000001B, 0x00000000000002D9, 0x0000000000004CE3 };
-	// Powers of 3: 3^45 split up into two words.
-	uint64_t pow3_45[2] = { 0x275329FD09495753,  0x00000000000000A0 };
-
-    alpha_k[0] = 0;
-	alpha_k[1] = 0;
-	for (i = 0; i < 4; i++) alpha_tmp[i] = 0;
-	fp2copy751(q, u);
-	for (i = 0; i < 3; i++) {
-        fp2copy751(u, v);
-        for (j = 0; j < 11; j++) {           
-            cube_Fp2_cycl(v, one); 
-        }
-        for (j = 0; j < 15*(2-i); j++) {  
-            cube_Fp2_cycl(v, one); 
-        }
-        phn3(v, LUT, LUT_1, one, &alpha_i);      // v order 3^15
-		multiply((digit_t*)&alpha_i, (digit_t*)&pow3_15[i], (digit_t*)alpha_tmp, 64/RADIX);
-		mp_add((digit_t*)alpha_k, (digit_t*)alpha_tmp, (digit_t*)alpha_k, 2*64/RADIX);
-
-        fp2copy751(LUT_0[i], v);
-        for (j = 0; j < 5; j++) {           
-            cube_Fp2_cycl(v, one); 
-        }
-		
-        exp_Fp2_cycl(v, &alpha_i, one, tmp, 24);   
-        fp2mul751_mont(u, tmp, u);
-    }
-
-    // Do the last part
-    alpha_n[0] = 0;
-	alpha_n[1] = 0;
-	for (i = 0; i < 3; i++) {
-        fp2copy751(u, v);
-        for (j = 0; j < 2; j++) {           
-            cube_Fp2_cycl(v, one); 
-        }
-        for (j = 0; j < 3*(2-i); j++) {       
-            cube_Fp2_cycl(v, one); 
-        }
-        phn1_3(v, LUT, 3, one, &alpha_i);      // v order 3^15
-		alpha_n[0] += alpha_i * pow3_3[i];
-
-        fp2copy751(LUT_1[i], v);
-        for (j = 0; j < 4; j++) {           
-            cube_Fp2_cycl(v, one); 
-        }
-        exp_Fp2_cycl(v, &alpha_i, one, tmp, 5);   
-        fp2mul751_mont(u, tmp, u);
-    }
-        
-    phn1_3(u, LUT, 2, one, &alpha_i);
-	alpha_n[0] += alpha_i * pow3_3[3];
-	multiply((digit_t*)alpha_n, (digit_t*)pow3_45, (digit_t*)alpha_tmp, 2*64/RADIX);  // Can be optimized because alpha_n is only single precision and pow3_45 is only slightly larger than 64 bits.
-	mp_add((digit_t*)alpha_k, (digit_t*)alpha_tmp, (digit_t*)alpha_k, 2*64/RADIX);
-}
-
-
-void phn15(f2elm_t q, const f2elm_t* LUT, const f2elm_t* LUT_0, const f2elm_t* LUT_1, const felm_t one, uint64_t* alpha_k)
-{
-	felm_t zero = {0};
-	f2elm_t u, v, tmp;
-	uint64_t alpha_i, alpha_n[2], alpha_tmp[4];
-	uint64_t i, j;
-	// Powers of 3: 3^0 = 1, 3^15, 3^30
-	uint64_t pow3_15[3] = { 0x0000000000000001, 0x0000000000DAF26B, 0x0000BB41C3CA78B9 };
-	// Powers of 3: 3^45 split up into two words.
-	uint64_t pow3_45[2] = { 0x275329FD09495753,  0x00000000000000A0 };
-	// Powers of 3: 3^60 split up into two words.
-	uint64_t pow3_60[2] = { 0xCEEDA7FE92E1F5B1,  0x0000000088F924EE };
-	uint64_t pow3_60_2[2] = { 0x9DDB4FFD25C3EB62,  0x0000000111F249DD };
-
-	alpha_k[0] = 0;
-	alpha_k[1] = 0;
-	alpha_n[0] = 0;
-	alpha_n[1] = 0;
-	for (i = 0; i < 4; i++) alpha_tmp[i] = 0;
-	fp2copy751(q, u);
-	for (i = 0; i < 3; i++) {
-		fp2copy751(u, v);
-		cube_Fp2_cycl(v, one);
-		for (j = 0; j < 15*(3-i); j++) {
-			cube_Fp2_cycl(v, one);
-		}
-		phn3(v, LUT, LUT_1, one, &alpha_i);      // u order 3^15
-
-		multiply((digit_t*)&alpha_i, (digit_t*)&pow3_15[i], (digit_t*)alpha_tmp, 64/RADIX);    
-		mp_add((digit_t*)alpha_k, (digit_t*)alpha_tmp, (digit_t*)alpha_k, 2*64/RADIX);
-
-		exp_Fp2_cycl(LUT_0[i], &alpha_i, one, tmp, 24);
-		fp2mul751_mont(u, tmp, u);
-	}
-
-	fp2copy751(u, v);
-	cube_Fp2_cycl(v, one);
-	phn3(v, LUT, LUT_1, one, &alpha_n[0]);      // u order 3^15
-
-	multiply((digit_t*)alpha_n, (digit_t*)pow3_45, (digit_t*)alpha_tmp, 2*64/RADIX);    
-	mp_add((digit_t*)alpha_k, (digit_t*)alpha_tmp, (digit_t*)alpha_k, 2*64/RADIX);
-
-	exp_Fp2_cycl(LUT_0[3], &alpha_n[0], one, tmp, 24);
-	fp2mul751_mont(u, tmp, u);
-	fp2correction751(u);
-	if (fpequal751_non_constant_time(u[0], LUT[3][0]) == true && fpequal751_non_constant_time(u[1], LUT[3][1]) == true) {
-		mp_add((digit_t*)alpha_k, (digit_t*)pow3_60, (digit_t*)alpha_k, 2*64/RADIX);
-	} else if (fpequal751_non_constant_time(u[0], one) == false || fpequal751_non_constant_time(u[1], zero) == false) {
-		mp_add((digit_t*)alpha_k, (digit_t*)pow3_60_2, (digit_t*)alpha_k, 2*64/RADIX);
-	}
-}
-
-
-void phn61(f2elm_t r, f2elm_t* t_ori, const f2elm_t* LUT, const f2elm_t* LUT_0, const f2elm_t* LUT_1, const felm_t one, uint64_t* alpha)
-{                                                                                                                                                                                 
-    f2elm_t u, v, tmp;
-    uint64_t alpha_k[5] = {0}, alpha_tmp[10] = {0};
-    uint64_t i, k;
-
-	uint64_t pow3_61[13] = { 0x0000000000000001, 0x0000000000000000,     // 3^0 = 1
-		                     0x6CC8F7FBB8A5E113, 0x000000019AEB6ECC,     // 3^61
-		                     0x6878E44938606769, 0xD73A1059B8013933,     // 3^(2*61)
-	                         0x9396F76B67B7C403, 0x0000000000000002,
-		                     0x25A79F6508B7F5CB, 0x05515FED4D025D6F,     // 3^(3*61)
-		                     0x37E2AD6FF9936EA9, 0xB69B5308880B15B6, 
-		                     0x0000000422BE6150 };
-
-	for (i = 0; i < NWORDS64_ORDER; i++) alpha[i] = 0;
-
-    fp2copy751(r, u);
-    for (k = 0; k < 2; k++) {
-        fp2copy751(u, v);
-        for (i = 0; i < 56; i++) {
-            cube_Fp2_cycl(v, one); 
-        }
-        for (i = 0; i < 61*(2-k); i++) {          
-            cube_Fp2_cycl(v, one);
-        }
-        phn15(v, LUT, LUT_0, LUT_1, one, alpha_k);  // q order 3^61
-		multiply((digit_t*)alpha_k, (digit_t*)&pow3_61[2*k], (digit_t*)alpha_tmp, 2*64/RADIX);    
-		mp_add((digit_t*)alpha, (digit_t*)alpha_tmp, (digit_t*)alpha, 4*64/RADIX);
-
-        exp_Fp2_cycl(t_ori[k], alpha_k, one, tmp, 97);                            
-        fp2mul751_mont(u, tmp, u); 
-    }
-	fp2copy751(u, v);
-	for (i = 0; i < 56; i++) {
-		cube_Fp2_cycl(v, one);
-	}
-	phn15(v, LUT, LUT_0, LUT_1, one, alpha_k);  // q order 3^61
-	multiply((digit_t*)alpha_k, (digit_t*)&pow3_61[4], (digit_t*)alpha_tmp, 4*64/RADIX);    
-	mp_add((digit_t*)alpha, (digit_t*)alpha_tmp, (digit_t*)alpha, NWORDS_ORDER);
-
-	exp_Fp2_cycl(t_ori[2], alpha_k, one, tmp, 97);
-	fp2mul751_mont(u, tmp, u);
-    phn15_1(u, LUT, LUT_0, LUT_1, one, alpha_k);  // q order 3^56
-	multiply((digit_t*)alpha_k, (digit_t*)&pow3_61[8], (digit_t*)alpha_tmp, 5*64/RADIX);    
-	mp_add((digit_t*)alpha, (digit_t*)alpha_tmp, (digit_t*)alpha, NWORDS_ORDER);    
-}
-
-
-void build_LUTs_3(f2elm_t g, f2elm_t* t_ori, f2elm_t* LUT, f2elm_t* LUT_0, f2elm_t* LUT_1, const felm_t one)
-{ // Lookup table generation for 3-torsion PH
-	f2elm_t tmp;
-	unsigned int i, j;
-
-	// Build (small) tables
-	fp2copy751(g, tmp);
-	inv_Fp2_cycl(tmp);
-	fp2copy751(tmp, t_ori[0]);                              // t_ori[0] = g^(-1)
-	for (i = 0; i < 2; i++) {
-		for (j = 0; j < 61; j++) cube_Fp2_cycl(tmp, one);
-		fp2copy751(tmp, t_ori[i + 1]);
-	}
-	for (i = 0; i < 56; i++) cube_Fp2_cycl(tmp, one);
-	fp2copy751(tmp, t_ori[3]);                                            
-	fp2copy751(tmp, LUT_0[0]);
-	for (i = 0; i < 5; i++) cube_Fp2_cycl(tmp, one);
-	fp2copy751(tmp, t_ori[4]);                              // t_ori done.
-
-	for (i = 0; i < 10; i++) cube_Fp2_cycl(tmp, one);
-    fp2copy751(tmp, LUT_0[1]);
-	for (i = 1; i < 3; i++) {
-		for (j = 0; j < 15; j++) cube_Fp2_cycl(tmp, one);
-        fp2copy751(tmp, LUT_0[i+1]);
-	}
-	cube_Fp2_cycl(tmp, one);
-	fp2copy751(tmp, LUT_1[0]);
+    from_fp2mont(A, A);                               // Converting back from Montgomery representation
+    store_words(comp, CompressedPKA, 3*NWORDS_ORDER);
+    store_words((digit_t*)A, &CompressedPKA[3*NWORDS_ORDER*sizeof(digit_t)], 2*NWORDS_FIELD);
 
-	for (i = 0; i < 4; i++) {
-		for (j = 0; j < 3; j++) cube_Fp2_cycl(tmp, one);
-		fp2copy751(tmp, LUT_1[i+1]);
-	}
-	fp2copy751(tmp, LUT[0]);
-	for (i = 0; i < 2; i++) {
-		fp2copy751(LUT[i], LUT[i+1]);
-		cube_Fp2_cycl(LUT[i+1], one);
-	}
-	fp2copy751(LUT[2], LUT[3]);
-	inv_Fp2_cycl(LUT[3]);
-	fp2correction751(LUT[3]);
+    return CRYPTO_SUCCESS;
 }
 
 
-void ph3(point_t phiP, point_t phiQ, point_t PS, point_t QS, f2elm_t A, uint64_t* a0, uint64_t* b0, uint64_t* a1, uint64_t* b1, PCurveIsogenyStruct CurveIsogeny)
+CRYPTO_STATUS ph3(point_t phiP, point_t phiQ, point_t PS, point_t QS, f2elm_t A, uint64_t* a0, uint64_t* b0, uint64_t* a1, uint64_t* b1, PCurveIsogenyStruct CurveIsogeny)
 { // 3-torsion Pohlig-Hellman function
   // This function computes the five pairings e(QS, PS), e(QS, phiP), e(QS, phiQ), e(PS, phiP), e(PS,phiQ),
   // computes the lookup tables for the Pohlig-Hellman functions,
   // and then computes the discrete logarithms of the last four pairing values to the base of the first pairing value.                                                                 
-    f2elm_t t_ori[5], n[5], LUT[4], LUT_0[4], LUT_1[5];
+#if defined(SIDH_BOUNDED_STACK)
+    f2elm_t *n = SIDH_WORKSPACE(CurveIsogeny)->n;
+#else
+    f2elm_t n[5];
+#endif
+    f2elm_t* T = (f2elm_t*)calloc(PH3_TABLE_SIZE, sizeof(f2elm_t));              // Lookup tables, kept on the heap in every build
+    felm_t* leaf = (felm_t*)calloc(PH3_LEAF_SIZE, sizeof(felm_t));
+    ph_params prm = {3, CurveIsogeny->eB, PH3_WINDOW, PH3_TABLE_WINDOW, CurveIsogeny->splits_ph3};
+    digit_t* alpha[4] = {(digit_t*)a0, (digit_t*)b0, (digit_t*)a1, (digit_t*)b1};
     felm_t one = {0};
 
     fpcopy751(CurveIsogeny->Montgomery_one, one);
+    if (T == NULL || leaf == NULL) {
+        free(T);
+        free(leaf);
+        return CRYPTO_ERROR_NO_MEMORY;
+    }
 
 	// Compute the pairings
     Tate_pairings_3_torsion(QS, PS, phiP, phiQ, A, n, CurveIsogeny);
 
 	// Build the look-up tables
-	build_LUTs_3(n[0], t_ori, LUT, LUT_0, LUT_1, one);
+	ph_build_tables(n[0], &prm, T, leaf, one);
 
     // Finish computation
-    phn61(n[1], t_ori, LUT, LUT_0, LUT_1, one, a0);
-    phn61(n[3], t_ori, LUT, LUT_0, LUT_1, one, b0);
+    ph_solve(n, &prm, T, leaf, one, alpha, SIDH_DISPATCH(CurveIsogeny)->ph_pool);
 	mp_sub(CurveIsogeny->Border, (digit_t*)b0, (digit_t*)b0, NWORDS_ORDER);
-    phn61(n[2], t_ori, LUT, LUT_0, LUT_1, one, a1);
-    phn61(n[4], t_ori, LUT, LUT_0, LUT_1, one, b1);
 	mp_sub(CurveIsogeny->Border, (digit_t*)b1, (digit_t*)b1, NWORDS_ORDER);
+
+    free(T);
+    free(leaf);
+    return CRYPTO_SUCCESS;
 }
 
 
@@ -2148,24 +3162,26 @@ unsigned int mod3(digit_t* a)
 }
 
 
-void compress_3_torsion(const unsigned char* pPublicKeyB, unsigned char* CompressedPKB, uint64_t* a0, uint64_t* b0, uint64_t* a1, uint64_t* b1, point_t R1, point_t R2, PCurveIsogenyStruct CurveIsogeny)
+CRYPTO_STATUS compress_3_torsion(const unsigned char* pPublicKeyB, unsigned char* CompressedPKB, uint64_t* a0, uint64_t* b0, uint64_t* a1, uint64_t* b1, point_t R1, point_t R2, PCurveIsogenyStruct CurveIsogeny)
 { // 3-torsion compression function                                                                          
     point_full_proj_t P, Q, phP, phQ, phX;
     point_t phiP, phiQ;
     publickey_t PK;
-    digit_t* comp = (digit_t*)CompressedPKB;
+    digit_t comp[3*NWORDS_ORDER];
 	digit_t inv[NWORDS_ORDER];
     f2elm_t A, vec[4], Zinv[4];
     uint64_t Montgomery_Rprime[NWORDS64_ORDER] = {0x1A55482318541298, 0x070A6370DFA12A03, 0xCB1658E0E3823A40, 0xB3B7384EB5DEF3F9, 0xCBCA952F7006EA33, 0x00569EF8EC94864C}; // Value (2^384)^2 mod 3^239
     uint64_t Montgomery_rprime[NWORDS64_ORDER] = {0x48062A91D3AB563D, 0x6CE572751303C2F5, 0x5D1319F3F160EC9D, 0xE35554E8C2D5623A, 0xCA29300232BC79A5, 0x8AAD843D646D78C5}; // Value -(3^239)^-1 mod 2^384
     unsigned int bit;
+    CRYPTO_STATUS Status;
 
-    to_fp2mont(((f2elm_t*)pPublicKeyB)[0], ((f2elm_t*)&PK)[0]);    // Converting to Montgomery representation
-    to_fp2mont(((f2elm_t*)pPublicKeyB)[1], ((f2elm_t*)&PK)[1]); 
-    to_fp2mont(((f2elm_t*)pPublicKeyB)[2], ((f2elm_t*)&PK)[2]); 
+    load_words(pPublicKeyB, (digit_t*)PK, 3*2*NWORDS_FIELD);         // The caller's buffers are only accessed with memcpy (see load_words())
+    to_fp2mont(((f2elm_t*)&PK)[0], ((f2elm_t*)&PK)[0]);    // Converting to Montgomery representation
+    to_fp2mont(((f2elm_t*)&PK)[1], ((f2elm_t*)&PK)[1]); 
+    to_fp2mont(((f2elm_t*)&PK)[2], ((f2elm_t*)&PK)[2]); 
 
     recover_y(PK, phP, phQ, phX, A, CurveIsogeny);
-    generate_3_torsion_basis(A, P, Q, CurveIsogeny);
+    generate_3_torsion_basis_entangled(A, P, Q, CurveIsogeny);
     fp2copy751(P->Z, vec[0]);
     fp2copy751(Q->Z, vec[1]);
     fp2copy751(phP->Z, vec[2]);
@@ -2181,7 +3197,10 @@ void compress_3_torsion(const unsigned char* pPublicKeyB, unsigned char* Compres
     fp2mul751_mont(phQ->X, Zinv[3], phiQ->x);
     fp2mul751_mont(phQ->Y, Zinv[3], phiQ->y);
 
-    ph3(phiP, phiQ, R1, R2, A, a0, b0, a1, b1, CurveIsogeny);
+    Status = ph3(phiP, phiQ, R1, R2, A, a0, b0, a1, b1, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        return Status;
+    }
     
     bit = mod3((digit_t*)a0);
     to_Montgomery_mod_order((digit_t*)a0, (digit_t*)a0, CurveIsogeny->Border, (digit_t*)&Montgomery_rprime, (digit_t*)&Montgomery_Rprime);    // Converting to Montgomery representation
@@ -2209,7 +3228,11 @@ void compress_3_torsion(const unsigned char* pPublicKeyB, unsigned char* Compres
         comp[3*NWORDS_ORDER-1] |= (digit_t)1 << (sizeof(digit_t)*8 - 1);
     }
     
-    from_fp2mont(A, (felm_t*)&comp[3*NWORDS_ORDER]);
+    from_fp2mont(A, A);
+    store_words(comp, CompressedPKB, 3*NWORDS_ORDER);
+    store_words((digit_t*)A, &CompressedPKB[3*NWORDS_ORDER*sizeof(digit_t)], 2*NWORDS_FIELD);
+
+    return CRYPTO_SUCCESS;
 }
 
 
@@ -2306,33 +3329,79 @@ void Mont_ladder(const f2elm_t x, const digit_t* m, point_proj_t P, point_proj_t
 }
 
 
-void mont_twodim_scalarmult(digit_t* a, const point_t R, const point_t S, const f2elm_t A, const f2elm_t A24, point_full_proj_t P, PCurveIsogenyStruct CurveIsogeny)
-{ // Computes R+aS
+void mont_twodim_scalarmult(digit_t* a, const point_t R, const point_t S, const f2elm_t A, const f2elm_t A24, const unsigned int order_bits, point_full_proj_t P, PCurveIsogenyStruct CurveIsogeny)
+{ // Computes R+aS, where a has at most order_bits bits.
+  // Decompression keeps this Montgomery ladder with y-recovery rather than an x-only three-point ladder from x(R-S): the right-to-left three-point 
+  // ladder (ladder_3_pt_rl() in the arithmetic tests) costs one more multiplication per bit, which outweighs the normalization inversion, recover_os() 
+  // and ADD() it saves. Measured at -O3: 3.69M vs 3.21M cycles for R+aS with x64 assembly, and 2-3% slower PublicKeyADecompression_B() and 
+  // PublicKeyBDecompression_A() with both the x64 and the generic field arithmetic.
     point_proj_t P0, P1;
     point_full_proj_t P2;
     f2elm_t one = {0};
 
     fpcopy751(CurveIsogeny->Montgomery_one, one[0]);
-    Mont_ladder(S->x, a, P0, P1, A24, CurveIsogeny->oBbits, CurveIsogeny->owordbits, CurveIsogeny);  // Hardwired to oBbits
+    Mont_ladder(S->x, a, P0, P1, A24, order_bits, CurveIsogeny->owordbits, CurveIsogeny);
     recover_os(P0->X, P0->Z, P1->X, P1->Z, S->x, S->y, A, P2->X, P2->Y, P2->Z); 
     ADD(P2, R->x, R->y, one, A, P);
 }
 
 
+static void ADD_XZ(const point_full_proj_t P, const f2elm_t QX, const f2elm_t QY, const f2elm_t QZ, const f2elm_t A, point_proj_t R)
+{ // General addition without the y-coordinate of the sum, i.e., the X and Z outputs of ADD().
+  // Input: projective Montgomery points P=(XP:YP:ZP) and Q=(XQ:YQ:ZQ).
+  // Output: projective Montgomery point R <- P+Q = (XQP:ZQP). 
+    f2elm_t t0, t1, t2, t3, t4, t5;
+
+	fp2mul751_mont(QX, P->Z, t0);            // t0 = x2*Z1    
+	fp2mul751_mont(P->X, QZ, t1);            // t1 = X1*z2    
+	fp2add751(t0, t1, t2);                   // t2 = t0 + t1
+	fp2sub751(t1, t0, t3);                   // t3 = t1 - t0
+	fp2mul751_mont(QX, P->X, t0);            // t0 = x2*X1    
+	fp2mul751_mont(P->Z, QZ, t1);            // t1 = Z1*z2
+	fp2add751(t0, t1, t4);                   // t4 = t0 + t1
+	fp2mul751_mont(t0, A, t0);               // t0 = t0*A
+	fp2mul751_mont(QY, P->Y, t5);            // t5 = y2*Y1
+	fp2sub751(t0, t5, t0);                   // t0 = t0 - t5
+	fp2mul751_mont(t0, t1, t0);              // t0 = t0*t1
+	fp2add751(t0, t0, t0);                   // t0 = t0 + t0
+	fp2mul751_mont(t2, t4, t5);              // t5 = t2*t4
+	fp2add751(t5, t0, t5);                   // t5 = t5 + t0
+	fp2mul751_mont(t5, t3, R->X);            // X3 = t5*t3
+	fp2sqr751_mont(t3, t0);                  // t0 = t3 ^ 2
+	fp2mul751_mont(t3, t0, R->Z);            // Z3 = t3*t0
+}
+
+
+void mont_twodim_scalarmult_xz(digit_t* a, const point_full_proj_t R, const point_t S, const f2elm_t A, const f2elm_t A24, const unsigned int order_bits, point_proj_t P, PCurveIsogenyStruct CurveIsogeny)
+{ // Computes x(R+aS) = (X:Z), where a has at most order_bits bits, for a projective R and an affine S.
+  // Decompression only needs the kernel point in (X:Z) coordinates, so R is not normalized and the y-coordinate of the sum is skipped.
+  // S has to be affine: a projective difference costs one more multiplication per ladder step, far more than its normalization.
+    point_proj_t P0, P1;
+    point_full_proj_t P2;
+
+    Mont_ladder(S->x, a, P0, P1, A24, order_bits, CurveIsogeny->owordbits, CurveIsogeny);
+    recover_os(P0->X, P0->Z, P1->X, P1->Z, S->x, S->y, A, P2->X, P2->Y, P2->Z); 
+    ADD_XZ(P2, R->X, R->Y, R->Z, A, P);
+}
+
+
 void decompress_2_torsion(const unsigned char* SecretKey, const unsigned char* CompressedPKB, point_proj_t R, f2elm_t A, PCurveIsogenyStruct CurveIsogeny)
 { // 2-torsion decompression function                                                                          
     point_t R1, R2;
     point_full_proj_t P, Q;
-    digit_t* comp = (digit_t*)CompressedPKB;
+    digit_t comp[3*NWORDS_ORDER], SKin[NWORDS_ORDER];
     f2elm_t A24, vec[2], invs[2], one = {0};
-    digit_t tmp1[2*NWORDS_ORDER], tmp2[2*NWORDS_ORDER], vone[2*NWORDS_ORDER] = {0}, mask = (digit_t)(-1);
+    digit_t tmp1[NWORDS_ORDER], tmp2[NWORDS_ORDER], vone[NWORDS_ORDER] = {0}, mask = (digit_t)(-1);
     unsigned int bit;
 
     mask >>= (CurveIsogeny->owordbits - CurveIsogeny->oAbits);  
     vone[0] = 1;
     fpcopy751(CurveIsogeny->Montgomery_one, one[0]);
-    to_fp2mont((felm_t*)&comp[3*NWORDS_ORDER], A);    // Converting to Montgomery representation
-    generate_2_torsion_basis(A, P, Q, CurveIsogeny);
+    load_words(CompressedPKB, comp, 3*NWORDS_ORDER);                        // The caller's buffers are only read with memcpy (see load_words())
+    load_words(SecretKey, SKin, NWORDS_ORDER);
+    load_words(&CompressedPKB[3*NWORDS_ORDER*sizeof(digit_t)], (digit_t*)A, 2*NWORDS_FIELD);
+    to_fp2mont(A, A);                                 // Converting to Montgomery representation
+    generate_2_torsion_basis_entangled(A, P, Q, CurveIsogeny);
 
     // normalize basis points
     fp2copy751(P->Z, vec[0]);
@@ -2352,29 +3421,30 @@ void decompress_2_torsion(const unsigned char* SecretKey, const unsigned char* C
     comp[3*NWORDS_ORDER-1] &= (digit_t)(-1) >> 1;
 
     if (bit == 0) {
-		multiply((digit_t*)SecretKey, &comp[NWORDS_ORDER], tmp1, NWORDS_ORDER);
+		mp_mul_low(SKin, &comp[NWORDS_ORDER], tmp1, NWORDS_ORDER);
         mp_add(tmp1, vone, tmp1, NWORDS_ORDER);
 		tmp1[NWORDS_ORDER-1] &= mask;
         inv_mod_orderA(tmp1, tmp2);  
-		multiply((digit_t*)SecretKey, &comp[2*NWORDS_ORDER], tmp1, NWORDS_ORDER);
+		mp_mul_low(SKin, &comp[2*NWORDS_ORDER], tmp1, NWORDS_ORDER);
         mp_add(&comp[0], tmp1, tmp1, NWORDS_ORDER);  
-		multiply(tmp1, tmp2, vone, NWORDS_ORDER);  
+		mp_mul_low(tmp1, tmp2, vone, NWORDS_ORDER);  
 		vone[NWORDS_ORDER-1] &= mask;  
-        mont_twodim_scalarmult(vone, R1, R2, A, A24, P, CurveIsogeny);
+        mont_twodim_scalarmult(vone, R1, R2, A, A24, CurveIsogeny->oAbits, P, CurveIsogeny);
     } else {
-		multiply((digit_t*)SecretKey, &comp[2*NWORDS_ORDER], tmp1, NWORDS_ORDER);
+		mp_mul_low(SKin, &comp[2*NWORDS_ORDER], tmp1, NWORDS_ORDER);
         mp_add(tmp1, vone, tmp1, NWORDS_ORDER);
 		tmp1[NWORDS_ORDER-1] &= mask;
         inv_mod_orderA(tmp1, tmp2);  
-		multiply((digit_t*)SecretKey, &comp[NWORDS_ORDER], tmp1, NWORDS_ORDER);
+		mp_mul_low(SKin, &comp[NWORDS_ORDER], tmp1, NWORDS_ORDER);
         mp_add(&comp[0], tmp1, tmp1, NWORDS_ORDER);  
-		multiply(tmp1, tmp2, vone, NWORDS_ORDER);  
+		mp_mul_low(tmp1, tmp2, vone, NWORDS_ORDER);  
 		vone[NWORDS_ORDER-1] &= mask;   
-        mont_twodim_scalarmult(vone, R2, R1, A, A24, P, CurveIsogeny);
+        mont_twodim_scalarmult(vone, R2, R1, A, A24, CurveIsogeny->oAbits, P, CurveIsogeny);
     }
 
     fp2copy751(P->X, R->X);               
     fp2copy751(P->Z, R->Z);
+    clear_words((void*)SKin, NWORDS_ORDER);
 }
 
 
@@ -2382,8 +3452,7 @@ void decompress_3_torsion(const unsigned char* SecretKey, const unsigned char* C
 { // 3-torsion decompression function                                                                          
     point_t R1, R2;
     point_full_proj_t P, Q;
-    digit_t* comp = (digit_t*)CompressedPKA;
-    digit_t* SKin = (digit_t*)SecretKey;
+    digit_t comp[3*NWORDS_ORDER], SKin[NWORDS_ORDER];
     f2elm_t A24, vec[2], invs[2], one = {0};
     digit_t t1[NWORDS_ORDER], t2[NWORDS_ORDER], t3[NWORDS_ORDER], t4[NWORDS_ORDER], vone[NWORDS_ORDER] = {0};
     uint64_t Montgomery_Rprime[NWORDS64_ORDER] = {0x1A55482318541298, 0x070A6370DFA12A03, 0xCB1658E0E3823A40, 0xB3B7384EB5DEF3F9, 0xCBCA952F7006EA33, 0x00569EF8EC94864C}; // Value (2^384)^2 mod 3^239
@@ -2393,8 +3462,11 @@ void decompress_3_torsion(const unsigned char* SecretKey, const unsigned char* C
     vone[0] = 1;
     to_Montgomery_mod_order(vone, vone, CurveIsogeny->Border, (digit_t*)&Montgomery_rprime, (digit_t*)&Montgomery_Rprime);  // Converting to Montgomery representation
     fpcopy751(CurveIsogeny->Montgomery_one, one[0]);
-    to_fp2mont((felm_t*)&comp[3*NWORDS_ORDER], A);    // Converting to Montgomery representation
-    generate_3_torsion_basis(A, P, Q, CurveIsogeny);
+    load_words(CompressedPKA, comp, 3*NWORDS_ORDER);                        // The caller's buffers are only read with memcpy (see load_words())
+    load_words(SecretKey, SKin, NWORDS_ORDER);
+    load_words(&CompressedPKA[3*NWORDS_ORDER*sizeof(digit_t)], (digit_t*)A, 2*NWORDS_FIELD);
+    to_fp2mont(A, A);                                 // Converting to Montgomery representation
+    generate_3_torsion_basis_entangled(A, P, Q, CurveIsogeny);
 
     // normalize basis points
     fp2copy751(P->Z, vec[0]);
@@ -2420,23 +3492,24 @@ void decompress_3_torsion(const unsigned char* SecretKey, const unsigned char* C
     if (bit == 0) {    
         Montgomery_multiply_mod_order(t1, t3, t3, CurveIsogeny->Border, (digit_t*)&Montgomery_rprime); 
         mp_add(t3, vone, t3, NWORDS_ORDER);   
-        Montgomery_inversion_mod_order_bingcd(t3, t3, CurveIsogeny->Border, (digit_t*)&Montgomery_rprime, (digit_t*)&Montgomery_Rprime);
+        Montgomery_inversion_mod_orderB(t3, t3, CurveIsogeny->Border, (digit_t*)&Montgomery_rprime);    // Constant time, since t3 depends on the secret key
         Montgomery_multiply_mod_order(t1, t4, t4, CurveIsogeny->Border, (digit_t*)&Montgomery_rprime); 
         mp_add(t2, t4, t4, NWORDS_ORDER);   
         Montgomery_multiply_mod_order(t3, t4, t3, CurveIsogeny->Border, (digit_t*)&Montgomery_rprime); 
         from_Montgomery_mod_order(t3, t3, CurveIsogeny->Border, (digit_t*)&Montgomery_rprime);    // Converting back from Montgomery representation
-        mont_twodim_scalarmult(t3, R1, R2, A, A24, P, CurveIsogeny);
+        mont_twodim_scalarmult(t3, R1, R2, A, A24, CurveIsogeny->oBbits, P, CurveIsogeny);
     } else {   
         Montgomery_multiply_mod_order(t1, t4, t4, CurveIsogeny->Border, (digit_t*)&Montgomery_rprime); 
         mp_add(t4, vone, t4, NWORDS_ORDER);   
-        Montgomery_inversion_mod_order_bingcd(t4, t4, CurveIsogeny->Border, (digit_t*)&Montgomery_rprime, (digit_t*)&Montgomery_Rprime);
+        Montgomery_inversion_mod_orderB(t4, t4, CurveIsogeny->Border, (digit_t*)&Montgomery_rprime);    // Constant time, since t4 depends on the secret key
         Montgomery_multiply_mod_order(t1, t3, t3, CurveIsogeny->Border, (digit_t*)&Montgomery_rprime); 
         mp_add(t2, t3, t3, NWORDS_ORDER);   
         Montgomery_multiply_mod_order(t3, t4, t3, CurveIsogeny->Border, (digit_t*)&Montgomery_rprime); 
         from_Montgomery_mod_order(t3, t3, CurveIsogeny->Border, (digit_t*)&Montgomery_rprime);    // Converting back from Montgomery representation
-        mont_twodim_scalarmult(t3, R2, R1, A, A24, P, CurveIsogeny);
+        mont_twodim_scalarmult(t3, R2, R1, A, A24, CurveIsogeny->oBbits, P, CurveIsogeny);
     }
 
     fp2copy751(P->X, R->X);               
     fp2copy751(P->Z, R->Z);
+    clear_words((void*)SKin, NWORDS_ORDER);
 }
@@ -121,6 +121,21 @@ void copy_words(const digit_t* a, digit_t* c, const unsigned int nwords)
 }
 
 
+void load_words(const unsigned char* c, digit_t* a, const unsigned int nwords)
+{ // Load wordsize digits from a byte buffer c with any alignment, a = c, where lng(a) = nwords.
+  // Caller buffers are only read through memcpy, never through a digit_t pointer cast, which avoids misaligned loads and aliasing issues.
+    
+    memcpy(a, c, nwords*sizeof(digit_t));
+}
+
+
+void store_words(const digit_t* a, unsigned char* c, const unsigned int nwords)
+{ // Store wordsize digits to a byte buffer c with any alignment, c = a, where lng(a) = nwords.
+    
+    memcpy(c, a, nwords*sizeof(digit_t));
+}
+
+
 __inline unsigned int mp_sub(const digit_t* a, const digit_t* b, digit_t* c, const unsigned int nwords)
 { // Multiprecision subtraction, c = a-b, where lng(a) = lng(b) = nwords. Returns the borrow bit.
     unsigned int i, borrow = 0;
@@ -582,6 +597,50 @@ void fp2mul751_mont(const f2elm_t a, const f2elm_t b, f2elm_t c)
 }
 
 
+void fp2muldiff751_mont(const f2elm_t a, const f2elm_t b, const f2elm_t c, const f2elm_t d, f2elm_t e)
+{ // GF(p751^2) difference of products using Montgomery arithmetic with lazy reduction, e = a*b - c*d in GF(p751^2).
+  // Both Karatsuba products are accumulated in double precision, so each output coordinate needs a single reduction.
+  // Inputs: a, b, c, d with coordinates in [0, 2*p751-1] 
+  // Output: e = e0+e1*i, where e0, e1 are in [0, 2*p751-1] 
+    felm_t t1, t2;
+    dfelm_t tt1, tt2, tt3, tt4, tt5, tt6;
+    digit_t mask;
+    unsigned int i, borrow;
+
+    mp_mul(a[0], b[0], tt1, NWORDS_FIELD);           // tt1 = a0*b0
+    mp_mul(a[1], b[1], tt2, NWORDS_FIELD);           // tt2 = a1*b1
+    mp_mul(c[0], d[0], tt3, NWORDS_FIELD);           // tt3 = c0*d0
+    mp_mul(c[1], d[1], tt4, NWORDS_FIELD);           // tt4 = c1*d1
+    mp_add751x2(tt1, tt4, tt5);                      // tt5 = a0*b0 + c1*d1
+    mp_add751x2(tt2, tt3, tt6);                      // tt6 = a1*b1 + c0*d0
+    borrow = mp_sub(tt5, tt6, tt5, 2*NWORDS_FIELD);  // tt5 = a0*b0 - a1*b1 - (c0*d0 - c1*d1), in (-8*p751^2, 8*p751^2)
+    mask = 0 - (digit_t)borrow;                      // if tt5 < 0 then mask = 0xFF..F, else if tt5 >= 0 then mask = 0x00..0
+    borrow = 0;
+    for (i = 0; i < NWORDS_FIELD; i++) {
+        ADDC(borrow, tt5[NWORDS_FIELD+i], ((digit_t*)p751)[i] & mask, borrow, tt5[NWORDS_FIELD+i]);
+    }
+    rdc_mont(tt5, e[0]);                             // e[0] = a0*b0 - a1*b1 - (c0*d0 - c1*d1)
+
+    mp_add751x2(tt1, tt2, tt1);                      // tt1 = a0*b0 + a1*b1
+    mp_add751x2(tt3, tt4, tt3);                      // tt3 = c0*d0 + c1*d1
+    mp_add751(a[0], a[1], t1);                       // t1 = a0+a1
+    mp_add751(b[0], b[1], t2);                       // t2 = b0+b1
+    mp_mul(t1, t2, tt2, NWORDS_FIELD);               // tt2 = (a0+a1)*(b0+b1)
+    mp_add751x2(tt2, tt3, tt2);                      // tt2 = (a0+a1)*(b0+b1) + c0*d0 + c1*d1
+    mp_add751(c[0], c[1], t1);                       // t1 = c0+c1
+    mp_add751(d[0], d[1], t2);                       // t2 = d0+d1
+    mp_mul(t1, t2, tt4, NWORDS_FIELD);               // tt4 = (c0+c1)*(d0+d1)
+    mp_add751x2(tt4, tt1, tt4);                      // tt4 = (c0+c1)*(d0+d1) + a0*b0 + a1*b1
+    borrow = mp_sub(tt2, tt4, tt2, 2*NWORDS_FIELD);  // tt2 = a0*b1 + a1*b0 - (c0*d1 + c1*d0), in (-24*p751^2, 24*p751^2)
+    mask = 0 - (digit_t)borrow;
+    borrow = 0;
+    for (i = 0; i < NWORDS_FIELD; i++) {
+        ADDC(borrow, tt2[NWORDS_FIELD+i], ((digit_t*)p751)[i] & mask, borrow, tt2[NWORDS_FIELD+i]);
+    }
+    rdc_mont(tt2, e[1]);                             // e[1] = a0*b1 + a1*b0 - (c0*d1 + c1*d0)
+}
+
+
 void to_fp2mont(const f2elm_t a, f2elm_t mc)
 { // Conversion of a GF(p751^2) element to Montgomery representation,
   // mc_i = a_i*R^2*R^(-1) = a_i*R in GF(p751^2). 
@@ -600,6 +659,114 @@ void from_fp2mont(const f2elm_t ma, f2elm_t c)
 }
 
 
+void fp2_encode(const f2elm_t ma, f2elm_t c, const unsigned int encoding)
+{ // Encoding of a GF(p751^2) element for the wire, where ma is in Montgomery representation.
+  // With SIDH_ENCODING_MONTGOMERY the output c = ma is only fully reduced to [0, p751-1], otherwise it is converted to standard representation.
+
+    if (encoding == SIDH_ENCODING_MONTGOMERY) {
+        fp2copy751(ma, c);
+        fp2correction751(c);
+    } else {
+        from_fp2mont(ma, c);
+    }
+}
+
+
+static __inline digit_t load_digit(const unsigned char* c)
+{ // Load a digit from sizeof(digit_t) bytes of c, with any alignment. 
+  // The fixed-size copy compiles to a single unaligned load on the supported (little endian) targets and avoids the aliasing issues of a pointer cast.
+    digit_t d;
+
+    memcpy(&d, c, sizeof(digit_t));
+    return d;
+}
+
+
+static __inline void store_digit(const digit_t d, unsigned char* c)
+{ // Store a digit to sizeof(digit_t) bytes of c, with any alignment
+    
+    memcpy(c, &d, sizeof(digit_t));
+}
+
+
+void fp2_encode_bytes(const f2elm_t ma, unsigned char* c, const unsigned int encoding)
+{ // Encoding of a GF(p751^2) element for the wire into 2*NWORDS_FIELD digits of c, with any alignment, where ma is in Montgomery representation.
+  // The encoding is computed in a local element and stored digit by digit, so c is never accessed through a digit_t pointer.
+    f2elm_t t;
+    unsigned int i, j;
+
+    fp2_encode(ma, t, encoding);
+    for (i = 0; i < 2; i++) {
+        for (j = 0; j < NWORDS_FIELD; j++) {
+            store_digit(t[i][j], &c[(i*NWORDS_FIELD + j)*sizeof(digit_t)]);
+        }
+    }
+}
+
+
+unsigned int fp2_decode_bytes(const unsigned char* c, f2elm_t ma, const unsigned int encoding)
+{ // Decoding of a GF(p751^2) element from 2*NWORDS_FIELD digits of c, with any alignment, to Montgomery representation ma.
+  // Each digit is loaded straight from c into ma, which is then converted in place, so that a key at any offset of a receive buffer 
+  // is decoded without an intermediate copy and c is never accessed through a digit_t pointer.
+  // Returns 0 if a Montgomery encoding is not fully reduced, 1 otherwise.
+    felm_t t;
+    unsigned int i, j, valid = 1;
+
+    for (i = 0; i < 2; i++) {
+        for (j = 0; j < NWORDS_FIELD; j++) {
+            ma[i][j] = load_digit(&c[(i*NWORDS_FIELD + j)*sizeof(digit_t)]);
+        }
+        if (encoding == SIDH_ENCODING_MONTGOMERY) {
+            valid &= mp_sub(ma[i], (digit_t*)&p751, t, NWORDS_FIELD);    // Borrow iff ma_i < p751
+        } else {
+            to_mont(ma[i], ma[i]);
+        }
+    }
+    return valid;
+}
+
+
+void fp2_pack(const f2elm_t ma, unsigned char* c, const unsigned int encoding)
+{ // Packing of a GF(p751^2) element for the wire, where ma is in Montgomery representation.
+  // Each coordinate is converted to the given encoding, fully reduced and written to NBYTES_PACKED_FIELD bytes of c in little endian format.
+    felm_t t;
+    unsigned int i, j;
+
+    for (i = 0; i < 2; i++) {
+        if (encoding == SIDH_ENCODING_MONTGOMERY) {
+            fpcopy751(ma[i], t);
+            fpcorrection751(t);
+        } else {
+            from_mont(ma[i], t);
+        }
+        for (j = 0; j < NBYTES_PACKED_FIELD; j++) {
+            c[i*NBYTES_PACKED_FIELD + j] = (unsigned char)(t[j/sizeof(digit_t)] >> (8*(j%sizeof(digit_t))));
+        }
+    }
+}
+
+
+unsigned int fp2_unpack(const unsigned char* c, f2elm_t ma, const unsigned int encoding)
+{ // Unpacking of a GF(p751^2) element from the wire to Montgomery representation ma.
+  // Each coordinate is read from NBYTES_PACKED_FIELD bytes of c in little endian format and must be in [0, p751-1], the canonical encoding. 
+  // Returns 0 if the check fails, 1 otherwise.
+    felm_t t;
+    unsigned int i, j, valid = 1;
+
+    for (i = 0; i < 2; i++) {
+        fpzero751(ma[i]);
+        for (j = 0; j < NBYTES_PACKED_FIELD; j++) {
+            ma[i][j/sizeof(digit_t)] |= (digit_t)c[i*NBYTES_PACKED_FIELD + j] << (8*(j%sizeof(digit_t)));
+        }
+        valid &= mp_sub(ma[i], (digit_t*)&p751, t, NWORDS_FIELD);    // Borrow iff ma_i < p751
+        if (encoding != SIDH_ENCODING_MONTGOMERY) {
+            to_mont(ma[i], ma[i]);
+        }
+    }
+    return valid;
+}
+
+
 void fp2inv751_mont(f2elm_t a)
 {// GF(p751^2) inversion using Montgomery arithmetic, a = (a0-i*a1)/(a0^2+a1^2).
     f2elm_t t1;
@@ -704,6 +871,29 @@ void mont_n_way_inv(const f2elm_t* vec, const int n, f2elm_t* out)
 }
 
 
+void mont_n_way_inv_fp(const felm_t* vec, const int n, felm_t* out)
+{ // n-way simultaneous inversion in GF(p751) using Montgomery's trick.
+  // SECURITY NOTE: This function does not run in constant time.
+  // Also, vec and out CANNOT be the same variable!
+	felm_t t1;
+	int i;
+
+    fpcopy751(vec[0], out[0]);                       // out[0] = vec[0]
+    for (i = 1; i < n; i++) {
+        fpmul751_mont(out[i-1], vec[i], out[i]);     // out[i] = out[i-1]*vec[i]
+    }
+
+    fpcopy751(out[n-1], t1);                         // t1 = 1/out[n-1]
+    fpinv751_mont_bingcd(t1);
+    
+    for (i = n-1; i >= 1; i--) {
+		fpmul751_mont(out[i-1], t1, out[i]);         // out[i] = t1*out[i-1]
+        fpmul751_mont(t1, vec[i], t1);               // t1 = t1*vec[i]
+    }
+    fpcopy751(t1, out[0]);                           // out[0] = t1
+}
+
+
 void sqrt_Fp2_frac(const f2elm_t u, const f2elm_t v, f2elm_t y)
 { // Computes square roots of elements in (Fp2)^2 using Hamburg's trick. 
     felm_t t0, t1, t2, t3, t4, t;
@@ -940,39 +1130,109 @@ void exp84_Fp2_cycl(const f2elm_t y, uint64_t* t, const felm_t one, f2elm_t res)
 }
 
 
+static bool is_cube_trace(felm_t a, const felm_t one)
+{ // Cubic residuosity test on the trace of a norm-1 element w = a+b*i, i.e., checks whether w^((p+1)/3) = 1.
+  // Uses the Chebyshev relations Re(w^2) = 2*a^2-1 and Re(w^3) = 4*a^3-3*a, so the exponentiation is done entirely in GF(p751).
+    felm_t t0, three;
+    unsigned int e;
+
+    fpadd751(one, one, three);
+    fpadd751(three, one, three);            // three = 3
+
+    for (e = 0; e < 372; e++) {  
+        fpsqr751_mont(a, a);                // a = a^2
+        fpadd751(a, a, a);                  // a = 2*a
+        fpsub751(a, one, a);                // a = a-1
+    }
+    for (e = 0; e < 238; e++) {
+        fpsqr751_mont(a, t0);               // t0 = a^2
+        fpadd751(t0, t0, t0);
+        fpadd751(t0, t0, t0);               // t0 = 4*t0
+        fpsub751(t0, three, t0);            // t0 = t0-3
+        fpmul751_mont(a, t0, a);            // a = a*t0
+    }
+    fpcorrection751(a);
+
+    return fpequal751_non_constant_time(a, one);   // The trace of a cube root of unity different from 1 is -1/2
+}
+
+
 bool is_cube_Fp2(f2elm_t u, PCurveIsogenyStruct CurveIsogeny)
 { // Check if a GF(p751^2) element is a cube.
-    f2elm_t v;
-    felm_t t0, zero = {0}, one = {0};
-    unsigned int e;
+  // Since every element of GF(p751) is a cube, u is a cube iff the norm-1 element w = u^(p-1) = conj(u)/u satisfies w^((p+1)/3) = 1.
+  // Only the trace Re(w) = (u0^2-u1^2)/(u0^2+u1^2) is needed for this test.
+    felm_t t0, t1, a, one = {0};
 
     fpcopy751(CurveIsogeny->Montgomery_one, one);
-	fpsqr751_mont(u[0], v[0]);              // v0 = u0^2
-    fpsqr751_mont(u[1], v[1]);              // v1 = u1^2
-    fpadd751(v[0], v[1], t0);               // t0 = v0+v1
+    fpsqr751_mont(u[0], t0);                // t0 = u0^2
+    fpsqr751_mont(u[1], t1);                // t1 = u1^2
+    fpsub751(t0, t1, a);                    // a = t0-t1
+    fpadd751(t0, t1, t0);                   // t0 = t0+t1
     fpinv751_mont_bingcd(t0);               // Fp inversion with binary Euclid
-    fpsub751(v[0], v[1], v[0]);             // v0 = v0-v1
-    fpmul751_mont(u[0], u[1], v[1]);        // v1 = u0*u1
-    fpadd751(v[1], v[1], v[1]);             // v1 = 2*v1
-    fpneg751(v[1]);                         // v1 = -v1
-    fpmul751_mont(v[0], t0, v[0]);          // v0 = v0*t0
-    fpmul751_mont(v[1], t0, v[1]);          // v1 = v1*t0
+    fpmul751_mont(a, t0, a);                // a = a*t0
 
-    for (e = 0; e < 372; e++) {  
-        sqr_Fp2_cycl(v, one);
-    }
+    return is_cube_trace(a, one);
+}
 
-    for (e = 0; e < 238; e++) {
-        cube_Fp2_cycl(v, one);
+
+void is_cube_Fp2_batch(const f2elm_t* u, bool* cubes, const unsigned int n, PCurveIsogenyStruct CurveIsogeny)
+{ // Check which of the n GF(p751^2) elements u[0],...,u[n-1] are cubes, setting cubes[j] accordingly.
+  // The n base field inversions of is_cube_Fp2 are shared using Montgomery's simultaneous inversion, in chunks of MAX_CUBE_BATCH elements.
+  // The elements must be nonzero.
+    felm_t a[MAX_CUBE_BATCH], t[MAX_CUBE_BATCH], t0, t1, one = {0};
+    unsigned int j, k, m;
+
+    fpcopy751(CurveIsogeny->Montgomery_one, one);
+
+    for (k = 0; k < n; k += m) {
+        m = (n-k < MAX_CUBE_BATCH) ? n-k : MAX_CUBE_BATCH;
+
+        for (j = 0; j < m; j++) {
+            fpsqr751_mont(u[k+j][0], t0);   // t0 = u0^2
+            fpsqr751_mont(u[k+j][1], t1);   // t1 = u1^2
+            fpsub751(t0, t1, a[j]);         // a[j] = t0-t1
+            fpadd751(t0, t1, t[j]);         // t[j] = t0+t1
+        }
+        fpcopy751(t[0], t0);
+        for (j = 1; j < m; j++) {           // t0 = t[0]*...*t[m-1]
+            fpmul751_mont(a[j], t0, a[j]);  // a[j] = a[j]*t[0]*...*t[j-1]
+            fpmul751_mont(t0, t[j], t0);
+        }
+        fpinv751_mont_bingcd(t0);           // t0 = (t[0]*...*t[m-1])^-1
+        for (j = m-1; j > 0; j--) {
+            fpmul751_mont(a[j], t0, a[j]);  // a[j] = a[j]/t[j]
+            fpmul751_mont(t0, t[j], t0);    // t0 = (t[0]*...*t[j-1])^-1
+        }
+        fpmul751_mont(a[0], t0, a[0]);      // a[0] = a[0]/t[0]
+
+        for (j = 0; j < m; j++) {
+            cubes[k+j] = is_cube_trace(a[j], one);
+        }
     }
+}
 
-	fp2correction751(v);
 
-	if (fpequal751_non_constant_time(v[0], one) == true && fpequal751_non_constant_time(v[1], zero) == true) {  // v == 1?
-        return true;
-    } else {
-        return false;
+bool is_sqr_Fp2(const f2elm_t u)
+{ // Check if a GF(p751^2) element is a square, i.e., if its norm u0^2+u1^2 is a square in GF(p751).
+    felm_t t0, t1, t2;
+    unsigned int i;
+
+    fpsqr751_mont(u[0], t0);                // t0 = u0^2
+    fpsqr751_mont(u[1], t1);                // t1 = u1^2
+    fpadd751(t0, t1, t0);                   // t0 = t0+t1
+    fpcopy751(t0, t1);
+    for (i = 0; i < 370; i++) {             // t1 = t0^((p+1)/4)
+        fpsqr751_mont(t1, t1);
     }
+    for (i = 0; i < 239; i++) {
+        fpsqr751_mont(t1, t2);
+        fpmul751_mont(t1, t2, t1);
+    }
+    fpsqr751_mont(t1, t1);                  // t1 = t0^((p+1)/2) = t0*(t0|p)
+    fpcorrection751(t0);
+    fpcorrection751(t1);
+
+    return fpequal751_non_constant_time(t0, t1);
 }
 
 
@@ -1012,49 +1272,137 @@ void multiply(const digit_t* a, const digit_t* b, digit_t* c, const unsigned int
 }
 
 
+void mp_mul_low(const digit_t* a, const digit_t* b, digit_t* c, const unsigned int nwords)
+{ // Multiprecision comba multiply returning the least significant half, c = a*b mod 2^(RADIX*nwords), where lng(a) = lng(b) = lng(c) = nwords.
+  // NOTE: a and b CANNOT be the same variable as c!
+    unsigned int i, j;
+    digit_t t = 0, u = 0, v = 0, UV[2];
+    unsigned int carry = 0;
+    
+    for (i = 0; i < nwords; i++) {
+        for (j = 0; j <= i; j++) {
+            MUL(a[j], b[i-j], UV+1, UV[0]); 
+            ADDC(0, UV[0], v, carry, v); 
+            ADDC(carry, UV[1], u, carry, u); 
+            t += carry;
+        }
+        c[i] = v;
+        v = u; 
+        u = t;
+        t = 0;
+    }
+}
+
+
+#if (NWORDS_ORDER != 6) && (NWORDS_ORDER != 12)
+    #error -- "Montgomery_multiply_mod_order() is unrolled for 6 or 12 words"
+#endif
+
+// One word of a CIOS row of Montgomery_multiply_mod_order(): t[j] = t[j] + ma[j]*b + u, carry out in u
+#define ORDER_MULADD_WORD(j, b)                                                                   \
+    { MUL(ma[j], (b), UV+1, UV[0]);                                                               \
+    ADDC(0, UV[0], u, carry, UV[0]);                                                              \
+    UV[1] += carry;                                                                               \
+    ADDC(0, t[j], UV[0], carry, t[j]);                                                            \
+    u = UV[1] + carry; }
+
+// One word of a CIOS reduction of Montgomery_multiply_mod_order(): t[j-1] = t[j] + order[j]*m + u, carry out in u
+#define ORDER_REDUCE_WORD(j)                                                                      \
+    { MUL(m, order[j], UV+1, UV[0]);                                                              \
+    ADDC(0, UV[0], u, carry, UV[0]);                                                              \
+    UV[1] += carry;                                                                               \
+    ADDC(0, t[j], UV[0], carry, t[(j)-1]);                                                        \
+    u = UV[1] + carry; }
+
+// One CIOS step of Montgomery_multiply_mod_order(): t = (t + ma*mb[i] + m*order)/2^RADIX, where m = (t + ma*mb[i])*r' mod 2^RADIX
+#if (NWORDS_ORDER == 6)
+#define ORDER_CIOS_STEP(i)                                                                        \
+    { u = 0;                                                                                      \
+    ORDER_MULADD_WORD(0, mb[i]); ORDER_MULADD_WORD(1, mb[i]); ORDER_MULADD_WORD(2, mb[i]);        \
+    ORDER_MULADD_WORD(3, mb[i]); ORDER_MULADD_WORD(4, mb[i]); ORDER_MULADD_WORD(5, mb[i]);        \
+    t[6] += u;                                                                                    \
+    m = t[0]*Montgomery_rprime[0];                                                                \
+    MUL(m, order[0], UV+1, UV[0]);                                                                \
+    ADDC(0, t[0], UV[0], carry, UV[0]);                                                           \
+    u = UV[1] + carry;                                                                            \
+    ORDER_REDUCE_WORD(1); ORDER_REDUCE_WORD(2); ORDER_REDUCE_WORD(3);                             \
+    ORDER_REDUCE_WORD(4); ORDER_REDUCE_WORD(5);                                                   \
+    ADDC(0, t[6], u, carry, t[5]);                                                                \
+    t[6] = (digit_t)carry; }
+#else
+#define ORDER_CIOS_STEP(i)                                                                        \
+    { u = 0;                                                                                      \
+    ORDER_MULADD_WORD(0, mb[i]); ORDER_MULADD_WORD(1, mb[i]); ORDER_MULADD_WORD(2, mb[i]);        \
+    ORDER_MULADD_WORD(3, mb[i]); ORDER_MULADD_WORD(4, mb[i]); ORDER_MULADD_WORD(5, mb[i]);        \
+    ORDER_MULADD_WORD(6, mb[i]); ORDER_MULADD_WORD(7, mb[i]); ORDER_MULADD_WORD(8, mb[i]);        \
+    ORDER_MULADD_WORD(9, mb[i]); ORDER_MULADD_WORD(10, mb[i]); ORDER_MULADD_WORD(11, mb[i]);      \
+    t[12] += u;                                                                                   \
+    m = t[0]*Montgomery_rprime[0];                                                                \
+    MUL(m, order[0], UV+1, UV[0]);                                                                \
+    ADDC(0, t[0], UV[0], carry, UV[0]);                                                           \
+    u = UV[1] + carry;                                                                            \
+    ORDER_REDUCE_WORD(1); ORDER_REDUCE_WORD(2); ORDER_REDUCE_WORD(3); ORDER_REDUCE_WORD(4);       \
+    ORDER_REDUCE_WORD(5); ORDER_REDUCE_WORD(6); ORDER_REDUCE_WORD(7); ORDER_REDUCE_WORD(8);       \
+    ORDER_REDUCE_WORD(9); ORDER_REDUCE_WORD(10); ORDER_REDUCE_WORD(11);                           \
+    ADDC(0, t[12], u, carry, t[11]);                                                              \
+    t[12] = (digit_t)carry; }
+#endif
+
+
 void Montgomery_multiply_mod_order(const digit_t* ma, const digit_t* mb, digit_t* mc, const digit_t* order, const digit_t* Montgomery_rprime)
 { // Montgomery multiplication modulo the group order, mc = ma*mb*r' mod order, where ma,mb,mc in [0, order-1].
   // ma, mb and mc are assumed to be in Montgomery representation.
   // The Montgomery constant r' = -r^(-1) mod 2^(log_2(r)) is the value "Montgomery_rprime", where r is the order.   
-	unsigned int i, cout = 0, bout = 0;
-	digit_t mask, P[2*NWORDS_ORDER], Q[2*NWORDS_ORDER], temp[2*NWORDS_ORDER];
-
-	multiply(ma, mb, P, NWORDS_ORDER);                 // P = ma * mb
-	multiply(P, Montgomery_rprime, Q, NWORDS_ORDER);   // Q = P * r' mod 2^(log_2(r))
-	multiply(Q, order, temp, NWORDS_ORDER);            // temp = Q * r
-	cout = mp_add(P, temp, temp, 2*NWORDS_ORDER);      // (cout, temp) = P + Q * r     
-
-	for (i = 0; i < NWORDS_ORDER; i++) {               // (cout, mc) = (P + Q * r)/2^(log_2(r))
-		mc[i] = temp[NWORDS_ORDER+i];
-	}
+  // Multiplication and reduction are interleaved word by word (CIOS), which only reads the least significant word of r'.
+  // Requires order < 2^382, and also accepts ma, mb in [0, 2*order-1]. Runs in constant time.
+#if (TARGET == TARGET_AMD64) && (OS_TARGET == OS_LINUX) && !defined(GENERIC_IMPLEMENTATION)
+
+    mont_mul_order384_asm(ma, mb, mc, order, Montgomery_rprime);
+
+#else
+	unsigned int i, carry, bout;
+	digit_t mask, m, u, UV[2], t[NWORDS_ORDER+1] = {0}, temp[NWORDS_ORDER];
+
+	ORDER_CIOS_STEP(0);                                 // The word loops are unrolled explicitly (see ORDER_CIOS_STEP()), so t stays in registers
+	ORDER_CIOS_STEP(1);
+	ORDER_CIOS_STEP(2);
+	ORDER_CIOS_STEP(3);
+	ORDER_CIOS_STEP(4);
+	ORDER_CIOS_STEP(5);
+#if (NWORDS_ORDER == 12)
+	ORDER_CIOS_STEP(6);
+	ORDER_CIOS_STEP(7);
+	ORDER_CIOS_STEP(8);
+	ORDER_CIOS_STEP(9);
+	ORDER_CIOS_STEP(10);
+	ORDER_CIOS_STEP(11);
+#endif
 
 	// Final, constant-time subtraction     
-	bout = mp_sub(mc, order, mc, NWORDS_ORDER);        // (cout, mc) = (cout, mc) - r
-	mask = (digit_t)cout - (digit_t)bout;              // if (cout, mc) >= 0 then mask = 0x00..0, else if (cout, mc) < 0 then mask = 0xFF..F
+	bout = mp_sub(t, order, mc, NWORDS_ORDER);         // (t[n], mc) = t - r
+	mask = t[NWORDS_ORDER] - (digit_t)bout;            // if (t[n], mc) >= 0 then mask = 0x00..0, else if (t[n], mc) < 0 then mask = 0xFF..F
 
 	for (i = 0; i < NWORDS_ORDER; i++) {               // temp = mask & r
 		temp[i] = (order[i] & mask);
 	}
 	mp_add(mc, temp, mc, NWORDS_ORDER);                //  mc = mc + (mask & r)
+#endif
 }
 
 
-void Montgomery_inversion_mod_order(const digit_t* ma, digit_t* mc, const digit_t* order, const digit_t* Montgomery_rprime)
-{ // (Non-constant time) Montgomery inversion modulo the curve order using a^(-1) = a^(order-2) mod order
-  // This function uses the sliding-window method.
+static void Montgomery_exponentiation_mod_order(const digit_t* ma, const digit_t* exponent, digit_t* mc, const digit_t* order, const digit_t* Montgomery_rprime)
+{ // Montgomery exponentiation modulo the curve order, mc = ma^exponent, for a nonzero exponent of up to 384 bits.
+  // This function uses the sliding-window method. The sequence of operations only depends on the exponent.
 	sdigit_t i = 384;
 	unsigned int j, nwords = NWORDS_ORDER, nbytes = (unsigned int)i/8;
 	digit_t temp, bit = 0, count, mod2, k_EXPON = 5;       // Fixing parameter k to 5 for the sliding windows method
-	digit_t modulus2[NWORDS_ORDER] = {0}, npoints = 16;
+	digit_t modulus2[NWORDS_ORDER], npoints = 16;
 	digit_t input_a[NWORDS_ORDER];
 	digit_t table[16][NWORDS_ORDER];                       // Fixing the number of precomputed elements to 16 (assuming k = 5)
 	digit_t mask = (digit_t)1 << (sizeof(digit_t)*8 - 1);  // 0x800...000
 	digit_t mask2 = ~((digit_t)(-1) >> k_EXPON);           // 0xF800...000, assuming k = 5
 
-	// SECURITY NOTE: this function does not run in constant time.
-
-	modulus2[0] = 2;
-	mp_sub(order, modulus2, modulus2, nwords);             // modulus-2
+	copy_words(exponent, modulus2, nwords);
 
 	// Precomputation stage
 	memmove((unsigned char*)&table[0], (unsigned char*)ma, nbytes);                               // table[0] = ma 
@@ -1063,7 +1411,7 @@ void Montgomery_inversion_mod_order(const digit_t* ma, digit_t* mc, const digit_
 		Montgomery_multiply_mod_order(table[j], input_a, table[j+1], order, Montgomery_rprime);   // table[j+1] = table[j] * ma^2
 	}
 
-	while (bit != 1) {                                     // Shift (modulus-2) to the left until getting first bit 1
+	while (bit != 1) {                                     // Shift the exponent to the left until getting first bit 1
 		i--;
 		temp = 0;
 		for (j = 0; j < nwords; j++) {
@@ -1077,7 +1425,7 @@ void Montgomery_inversion_mod_order(const digit_t* ma, digit_t* mc, const digit_
 	memmove((unsigned char*)mc, (unsigned char*)ma, nbytes);
 	bit = (modulus2[nwords-1] & mask) >> (sizeof(digit_t)*8 - 1);
 	while (i > 0) {
-		if (bit == 0) {                                                            // Square accumulated value because bit = 0 and shift (modulus-2) one bit to the left
+		if (bit == 0) {                                                            // Square accumulated value because bit = 0 and shift the exponent one bit to the left
 			Montgomery_multiply_mod_order(mc, mc, mc, order, Montgomery_rprime);   // mc = mc^2
 			i--;
 			for (j = (nwords - 1); j > 0; j--) {
@@ -1099,7 +1447,7 @@ void Montgomery_inversion_mod_order(const digit_t* ma, digit_t* mc, const digit_
 			Montgomery_multiply_mod_order(mc, table[(temp-1) >> 1], mc, order, Montgomery_rprime);   // mc = mc * table[(temp-1)/2] 
 			i = i - count;
 
-			for (j = (nwords-1); j > 0; j--) {                                     // Shift (modulus-2) "count" bits to the left
+			for (j = (nwords-1); j > 0; j--) {                                     // Shift the exponent "count" bits to the left
 				SHIFTL(modulus2[j], modulus2[j-1], count, modulus2[j], RADIX);
 			}
 			modulus2[0] = modulus2[0] << count;
@@ -1109,6 +1457,26 @@ void Montgomery_inversion_mod_order(const digit_t* ma, digit_t* mc, const digit_
 }
 
 
+void Montgomery_inversion_mod_order(const digit_t* ma, digit_t* mc, const digit_t* order, const digit_t* Montgomery_rprime)
+{ // (Non-constant time) Montgomery inversion modulo the curve order using a^(-1) = a^(order-2) mod order
+	digit_t modulus2[NWORDS_ORDER] = {0};
+
+	modulus2[0] = 2;
+	mp_sub(order, modulus2, modulus2, NWORDS_ORDER);       // modulus-2
+	Montgomery_exponentiation_mod_order(ma, modulus2, mc, order, Montgomery_rprime);
+}
+
+
+void Montgomery_inversion_mod_orderB(const digit_t* ma, digit_t* mc, const digit_t* order, const digit_t* Montgomery_rprime)
+{ // Constant-time Montgomery inversion modulo Bob's order 3^239, for ma coprime to 3.
+  // Uses a^(-1) = a^(phi(3^239)-1) = a^(2*3^238-1) mod 3^239. The exponent is fixed, so the operations do not depend on ma.
+  // NOTE: This function is hardwired for the current parameters using 3^239.
+	uint64_t exponent[NWORDS64_ORDER] = {0xDB9AE315050709F1, 0xE6766B7FA884F429, 0xF104539F29AF9E70, 0xC78AD93218F855AD, 0x70B150FD1E84458E, 0x04A9938D6A4BD5EB}; // Value 2*3^238-1
+
+	Montgomery_exponentiation_mod_order(ma, (digit_t*)exponent, mc, order, Montgomery_rprime);
+}
+
+
 static __inline unsigned int is_zero_mod_order(const digit_t* x)
 { // Is x = 0? return 1 (TRUE) if condition is true, 0 (FALSE) otherwise
   // SECURITY NOTE: This function does not run in constant time.
@@ -1235,47 +1603,27 @@ void from_Montgomery_mod_order(const digit_t* ma, digit_t* c, const digit_t* ord
 
 
 void inv_mod_orderA(const digit_t* a, digit_t* c)
-{ // Inversion modulo an even integer of the form 2^m.
-  // Algorithm 3: Explicit Quadratic Modular inverse modulo 2^m from Dumas '12: http://arxiv.org/pdf/1209.6626.pdf
+{ // Inversion modulo Alice's order 2^372, c = a^(-1) mod 2^372 for odd a.
+  // Newton iteration x = x*(2 - a*x), which doubles the number of correct bits of x. It starts on single digits from x = 3*a XOR 2, 
+  // which is correct modulo 2^5, and then doubles the number of digits using half products. Runs in constant time.
   // NOTE: This function is hardwired for the current parameters using 2^372.
-	unsigned int i, f, s = 0;
-	digit_t am1[NWORDS_ORDER] = {0};
-	digit_t tmp1[NWORDS_ORDER] = {0};
-	digit_t tmp2[2*NWORDS_ORDER] = {0};
-	digit_t one[NWORDS_ORDER] = {0};
-	digit_t order[NWORDS_ORDER] = {0};
-    digit_t mask = (digit_t)(-1) >> 12;
-	bool equal = true;
+	unsigned int i, k, nw;
+	digit_t x, t[NWORDS_ORDER], e[NWORDS_ORDER], two[NWORDS_ORDER] = {0};
 
-	order[NWORDS_ORDER-1] = (digit_t)1 << (sizeof(digit_t)*8 - 12);  // Load most significant digit of Alice's order
-	one[0] = 1;
-
-	for (i = 0; i < NWORDS_ORDER; i++) {
-		if (a[i] != one[0]) equal = false;
+	x = (3*a[0]) ^ 2;                                  // x = a^(-1) mod 2^5
+	for (i = 0; i < 4; i++) {
+		x = x*(2 - a[0]*x);                            // x = a^(-1) mod 2^(5*2^(i+1))
 	}
-	if (equal) {
-		copy_words(a, c, NWORDS_ORDER);
-	} else {
-		mp_sub(a, one, am1, NWORDS_ORDER);               // am1 = a-1
-		mp_sub(order, am1, c, NWORDS_ORDER);
-		mp_add(c, one, c, NWORDS_ORDER);                 // c = 2^m - a + 2
-
-		copy_words(am1, tmp1, NWORDS_ORDER);
-		while ((tmp1[0] & (digit_t)1) == 0) {
-			s += 1;
-			mp_shiftr1(tmp1, NWORDS_ORDER);
-		}
-
-		f = 372 / s;
-		for (i = 1; i < f; i <<= 1) {
-			multiply(am1, am1, tmp2, NWORDS_ORDER);            // tmp2 = am1^2  
-			copy_words(tmp2, am1, NWORDS_ORDER);
-			am1[NWORDS_ORDER-1] &= mask;                       // am1 = tmp2 mod 2^e
-			mp_add(am1, one, tmp1, NWORDS_ORDER);              // tmp1 = am1 + 1
-			tmp1[NWORDS_ORDER-1] &= mask;                      // mod 2^e
-			multiply(c, tmp1, tmp2, NWORDS_ORDER);             // c = c*tmp1
-			copy_words(tmp2, c, NWORDS_ORDER);
-			c[NWORDS_ORDER-1] &= mask;                         // mod 2^e
-		}
+	clear_words((void*)c, NWORDS_ORDER);
+	c[0] = x;
+	two[0] = 2;
+
+	for (k = 1; k < NWORDS_ORDER; k = nw) {            // c = a^(-1) mod 2^(RADIX*k)
+		nw = (2*k < NWORDS_ORDER) ? 2*k : NWORDS_ORDER;
+		mp_mul_low(a, c, t, nw);                       // t = a*c
+		mp_sub(two, t, e, nw);                         // e = 2 - a*c
+		mp_mul_low(c, e, t, nw);                       // c = c*(2 - a*c)
+		copy_words(t, c, nw);
 	}
+	c[NWORDS_ORDER-1] &= (digit_t)(-1) >> 12;          // Hardcoded value
 }
@@ -11,51 +11,239 @@
 
 #include "SIDH_internal.h"
 #include <stdio.h>
+#include <string.h>
 
-extern const unsigned int splits_Alice[MAX_Alice];
-extern const unsigned int splits_Bob[MAX_Bob];
 //TEST
 
-CRYPTO_STATUS EphemeralKeyGeneration_A(unsigned char* PrivateKeyA, unsigned char* PublicKeyA, PCurveIsogenyStruct CurveIsogeny)
-{ // Alice's ephemeral key-pair generation
-  // It produces a private key PrivateKeyA and computes the public key PublicKeyA.
-  // The private key is an even integer in the range [2, oA-2], where oA = 2^372. 
-  // The public key consists of 3 elements in GF(p751^2).
-  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
-    unsigned int owords = NBITS_TO_NWORDS(CurveIsogeny->owordbits), pwords = NBITS_TO_NWORDS(CurveIsogeny->pwordbits);
-    point_basefield_t P;
-    point_proj_t R, TEST, phiP = {0}, phiQ = {0}, phiD = {0}, pts[MAX_INT_POINTS_ALICE];
-    publickey_t* PublicKey = (publickey_t*)PublicKeyA;
+static void isogeny_tree_A(point_proj_t R, f2elm_t A, f2elm_t C, point_proj_t phiP, point_proj_t phiQ, point_proj_t phiD, PCurveIsogenyStruct CurveIsogeny)
+{ // Traversal of Alice's isogeny tree after the first 4-isogeny, using the isogeny degree, strategy and curve model selected in CurveIsogeny.
+  // Inputs: the point R = (X:Z) generating the rest of the kernel, the constant A/C of its curve and, if phiP is not NULL, the points phiP, phiQ and phiD.
+  // Output: the constant A/C of the codomain curve and, if phiP is not NULL, the images of phiP, phiQ and phiD. R is overwritten.
+    unsigned int pwords = NBITS_TO_NWORDS(CurveIsogeny->pwordbits);
     unsigned int i, row, m, index = 0, pts_index[MAX_INT_POINTS_ALICE], npts = 0; 
-    f2elm_t coeff[5], A = {0}, C = {0}, Aout, Cout, Aa, Ca, RaX;
-    CRYPTO_STATUS Status = CRYPTO_ERROR_UNKNOWN; 
+#if defined(SIDH_BOUNDED_STACK)
+    point_proj_t* pts = SIDH_WORKSPACE(CurveIsogeny)->pts;
+#else
+    point_proj_t pts[MAX_INT_POINTS_ALICE];
+#endif
+    f2elm_t coeff[5];
+
+    if (SIDH_DISPATCH(CurveIsogeny)->degree_Alice == 8) {      // Tree of 8-isogenies with Montgomery formulas and constants (A+2C, 4C)
+        // The point at index i > 0 of the tree is 2^(3i+1)*R, so the leaves have order 8 and R is left with order 16
+        mont_to_A24(A, C);
+        for (row = 1; row < MAX_Alice8; row++) {
+            while (index < MAX_Alice8-row) {
+                fp2copy751(R->X, pts[npts]->X);
+                fp2copy751(R->Z, pts[npts]->Z);
+                pts_index[npts] = index;
+                npts += 1;
+                m = CurveIsogeny->splits_Alice8[MAX_Alice8-index-row];
+                xDBLe_A24(R, R, A, C, (int)(3*m + (index == 0)));
+                index += m;
+            }
+            get_8_isog(R, A, C, coeff);        
+
+            for (i = 0; i < npts; i++) {
+                eval_8_isog(pts[i], coeff);
+            }
+            if (phiP != NULL) {
+                eval_8_isog(phiP, coeff);
+                eval_8_isog(phiQ, coeff);
+                eval_8_isog(phiD, coeff);
+            }
+
+            fp2copy751(pts[npts-1]->X, R->X); 
+            fp2copy751(pts[npts-1]->Z, R->Z);
+            index = pts_index[npts-1];
+            npts -= 1;
+        }
 
+        xDBLe_A24(R, pts[0], A, C, 2);                        // R has order 16: the last step is a 4-isogeny with kernel <4*R> followed by another one
+        get_4_isog_A24(pts[0], A, C, coeff); 
+        eval_4_isog_A24(R, coeff);
+        if (phiP != NULL) {
+            eval_4_isog_A24(phiP, coeff);
+            eval_4_isog_A24(phiQ, coeff);
+            eval_4_isog_A24(phiD, coeff);
+        }
+        get_4_isog_A24(R, A, C, coeff); 
+        if (phiP != NULL) {
+            eval_4_isog_A24(phiP, coeff);
+            eval_4_isog_A24(phiQ, coeff);
+            eval_4_isog_A24(phiD, coeff);
+        }
+        A24_to_mont(A, C);
+    } else {
+        if (SIDH_DISPATCH(CurveIsogeny)->model_DBL == SIDH_MODEL_EDWARDS) {            // Edwards pipeline: the tree points and curve constants stay in Edwards form
+            mont_to_edwards(phiP, NULL, NULL);
+            mont_to_edwards(phiQ, NULL, NULL);
+            mont_to_edwards(phiD, NULL, NULL);
+            mont_to_edwards(R, A, C);
+        } else {
+            mont_to_A24(A, C);
+        }
 
-    if (PrivateKeyA == NULL || PublicKey == NULL || is_CurveIsogenyStruct_null(CurveIsogeny)) {
-        return CRYPTO_ERROR_INVALID_PARAMETER;
-    }  
+        for (row = 1; row < MAX_Alice; row++) {
+            while (index < MAX_Alice-row) {
+                fp2copy751(R->X, pts[npts]->X);
+                fp2copy751(R->Z, pts[npts]->Z);
+                pts_index[npts] = index;
+                npts += 1;
+                m = CurveIsogeny->splits_Alice[MAX_Alice-index-row];
+                SIDH_DISPATCH(CurveIsogeny)->DBLe(R, R, A, C, (int)(2*m));
+                index += m;
+            }
+            SIDH_DISPATCH(CurveIsogeny)->get_4_isog(R, A, C, coeff);        
+
+            for (i = 0; i < npts; i++) {
+                SIDH_DISPATCH(CurveIsogeny)->eval_4_isog(pts[i], coeff);
+            }
+            if (phiP != NULL) {
+                SIDH_DISPATCH(CurveIsogeny)->eval_4_isog(phiP, coeff);
+                SIDH_DISPATCH(CurveIsogeny)->eval_4_isog(phiQ, coeff);
+                SIDH_DISPATCH(CurveIsogeny)->eval_4_isog(phiD, coeff);
+            }
+
+            fp2copy751(pts[npts-1]->X, R->X); 
+            fp2copy751(pts[npts-1]->Z, R->Z);
+            index = pts_index[npts-1];
+            npts -= 1;
+        }
+
+        SIDH_DISPATCH(CurveIsogeny)->get_4_isog(R, A, C, coeff); 
+        if (phiP != NULL) {
+            SIDH_DISPATCH(CurveIsogeny)->eval_4_isog(phiP, coeff);
+            SIDH_DISPATCH(CurveIsogeny)->eval_4_isog(phiQ, coeff);
+            SIDH_DISPATCH(CurveIsogeny)->eval_4_isog(phiD, coeff);
+        }
+        if (SIDH_DISPATCH(CurveIsogeny)->model_DBL == SIDH_MODEL_EDWARDS) {
+            edwards_to_mont(phiP, NULL, NULL);
+            edwards_to_mont(phiQ, NULL, NULL);
+            edwards_to_mont(phiD, NULL, NULL);
+            edwards_to_mont(NULL, A, C);
+        } else {
+            A24_to_mont(A, C);
+        }
+    }
+
+// Cleanup:
+    clear_words((void*)pts, MAX_INT_POINTS_ALICE*2*2*pwords);
+    clear_words((void*)coeff, 5*2*pwords);
+}
 
 
+static void isogeny_tree_B(point_proj_t R, f2elm_t A, f2elm_t C, point_proj_t phiP, point_proj_t phiQ, point_proj_t phiD, PCurveIsogenyStruct CurveIsogeny)
+{ // Traversal of Bob's isogeny tree, using the isogeny degree, strategy and curve model selected in CurveIsogeny.
+  // Inputs: the point R = (X:Z) generating the kernel, the constant A/C of its curve and, if phiP is not NULL, the points phiP, phiQ and phiD.
+  // Output: the constant A/C of the codomain curve and, if phiP is not NULL, the images of phiP, phiQ and phiD. R is overwritten.
+    unsigned int pwords = NBITS_TO_NWORDS(CurveIsogeny->pwordbits);
+    unsigned int i, row, m, index = 0, pts_index[MAX_INT_POINTS_BOB], npts = 0; 
+#if defined(SIDH_BOUNDED_STACK)
+    point_proj_t* pts = SIDH_WORKSPACE(CurveIsogeny)->pts;
+#else
+    point_proj_t pts[MAX_INT_POINTS_BOB];
+#endif
+    f2elm_t coeff[4];
+
+    mont_to_edwards(NULL, A, C);                      // Bob's tree uses the tripling constants (A+2C, A-2C)
+    if (SIDH_DISPATCH(CurveIsogeny)->degree_Bob == 9) {        // Tree of 9-isogenies
+        // The point at index i > 0 of the tree is 3^(2i-1)*R, so the leaves have order 9 and the last step is a 3-isogeny
+        for (row = 1; row < MAX_Bob9; row++) {
+            while (index < MAX_Bob9-row) {
+                fp2copy751(R->X, pts[npts]->X);
+                fp2copy751(R->Z, pts[npts]->Z);
+                pts_index[npts] = index;
+                npts += 1;
+                m = CurveIsogeny->splits_Bob9[MAX_Bob9-index-row];
+                SIDH_DISPATCH(CurveIsogeny)->TPLe(R, R, A, C, (int)(2*m - (index == 0)));
+                index += m;
+            }
+            get_9_isog(R, A, C, coeff);        
+
+            for (i = 0; i < npts; i++) {
+                eval_9_isog(pts[i], coeff);
+            }
+            if (phiP != NULL) {
+                eval_9_isog(phiP, coeff);
+                eval_9_isog(phiQ, coeff);
+                eval_9_isog(phiD, coeff);
+            }
+
+            fp2copy751(pts[npts-1]->X, R->X); 
+            fp2copy751(pts[npts-1]->Z, R->Z);
+            index = pts_index[npts-1];
+            npts -= 1;
+        }
+    } else {
+        for (row = 1; row < MAX_Bob; row++) {
+            while (index < MAX_Bob-row) {
+                fp2copy751(R->X, pts[npts]->X);
+                fp2copy751(R->Z, pts[npts]->Z);
+                pts_index[npts] = index;
+                npts += 1;
+                m = CurveIsogeny->splits_Bob[MAX_Bob-index-row];
+                SIDH_DISPATCH(CurveIsogeny)->TPLe(R, R, A, C, (int)m);
+                index += m;
+            }
+            get_3_isog_coeff(R, A, C, coeff);        
+
+            for (i = 0; i < npts; i++) {
+                eval_3_isog_coeff(pts[i], coeff);
+            }
+            if (phiP != NULL) {
+                eval_3_isog_coeff(phiP, coeff);
+                eval_3_isog_coeff(phiQ, coeff);
+                eval_3_isog_coeff(phiD, coeff);
+            }
+
+            fp2copy751(pts[npts-1]->X, R->X); 
+            fp2copy751(pts[npts-1]->Z, R->Z);
+            index = pts_index[npts-1];
+            npts -= 1;
+        }
+    }
+
+    get_3_isog_coeff(R, A, C, coeff);    
+    if (phiP != NULL) {
+        eval_3_isog_coeff(phiP, coeff);
+        eval_3_isog_coeff(phiQ, coeff);
+        eval_3_isog_coeff(phiD, coeff);
+    }
+    edwards_to_mont(NULL, A, C);
+
+// Cleanup:
+    clear_words((void*)pts, MAX_INT_POINTS_BOB*2*2*pwords);
+    clear_words((void*)coeff, 4*2*pwords);
+}
+
+
+static CRYPTO_STATUS keygen_A(unsigned char* PrivateKeyA, point_proj_t phiP, point_proj_t phiQ, point_proj_t phiD, f2elm_t A, f2elm_t C, PCurveIsogenyStruct CurveIsogeny)
+{ // Core of Alice's ephemeral key-pair generation
+  // It produces a private key PrivateKeyA and leaves the public key as the projective points phiP, phiQ and phiD, in Montgomery representation, 
+  // together with the constant A/C of their curve.
+    unsigned int owords = NBITS_TO_NWORDS(CurveIsogeny->owordbits), pwords = NBITS_TO_NWORDS(CurveIsogeny->pwordbits);
+    point_basefield_t P;
+    point_proj_t R;
+    f2elm_t Aout, Cout;
+    digit_t SecretKey[NWORDS_ORDER];
+    CRYPTO_STATUS Status = CRYPTO_ERROR_UNKNOWN; 
+
     // Choose a random even number in the range [2, oA-2] as secret key for Alice
-    Status = random_mod_order((digit_t*)PrivateKeyA, ALICE, CurveIsogeny);    
+    Status = random_mod_order(SecretKey, ALICE, CurveIsogeny);    
     if (Status != CRYPTO_SUCCESS) {
-        clear_words((void*)PrivateKeyA, owords);
+        clear_words((void*)SecretKey, owords);
+        store_words(SecretKey, PrivateKeyA, owords);
         return Status;
     }
-
-     //printf("CurveIsogeny->PA: ");
-     //for (i = 0; i < 11; i++) {
-     //   printf("%lu", (digit_t*)CurveIsogeny->PA[i]);
-     //}
-     //printf("\n");
+    store_words(SecretKey, PrivateKeyA, owords);                                    // The key is sampled into digits and then written to the byte buffer
 
     to_mont((digit_t*)CurveIsogeny->PA, (digit_t*)P);                               // Conversion of Alice's generators to Montgomery representation
     to_mont(((digit_t*)CurveIsogeny->PA)+NWORDS_FIELD, ((digit_t*)P)+NWORDS_FIELD); 
-  
 
-    Status = secret_pt(P, (digit_t*)PrivateKeyA, ALICE, R, CurveIsogeny);
+    Status = secret_pt(P, SecretKey, ALICE, R, CurveIsogeny);
     if (Status != CRYPTO_SUCCESS) {
-        clear_words((void*)PrivateKeyA, owords);
+        clear_words((void*)SecretKey, owords);
+        store_words(SecretKey, PrivateKeyA, owords);
         return Status;
     }
 
@@ -67,6 +255,8 @@ CRYPTO_STATUS EphemeralKeyGeneration_A(unsigned char* PrivateKeyA, unsigned char
     fpcopy751((digit_t*)CurveIsogeny->Montgomery_one, (digit_t*)phiQ->Z); 
     distort_and_diff(phiP->X[0], phiD, CurveIsogeny);                               // DB = (x(QB-PB),z(QB-PB))
 
+    fp2zero751(A);
+    fp2zero751(C);
     fpcopy751(CurveIsogeny->A, A[0]);                                               // Extracting curve parameters A and C
     fpcopy751(CurveIsogeny->C, C[0]);
     to_mont(A[0], A[0]);
@@ -76,96 +266,82 @@ CRYPTO_STATUS EphemeralKeyGeneration_A(unsigned char* PrivateKeyA, unsigned char
     first_4_isog(phiQ, A, Aout, Cout, CurveIsogeny);
     first_4_isog(phiD, A, Aout, Cout, CurveIsogeny);
     first_4_isog(R, A, A, C, CurveIsogeny);
-    
-    index = 0;        
-    for (row = 1; row < MAX_Alice; row++) {
-        while (index < MAX_Alice-row) {
-            fp2copy751(R->X, pts[npts]->X);
-            fp2copy751(R->Z, pts[npts]->Z);
+    isogeny_tree_A(R, A, C, phiP, phiQ, phiD, CurveIsogeny);
 
-            pts_index[npts] = index;
-            npts += 1;
-            m = splits_Alice[MAX_Alice-index-row];
+// Cleanup:
+    clear_words((void*)R, 2*2*pwords);
+    clear_words((void*)SecretKey, owords);
 
+    return Status;
+}
 
-        	edDBLe(R, R, A, C, (int)(2*m));
 
-		 index += m;
-        }
-        get_4_isog(R, A, C, coeff);        
+CRYPTO_STATUS EphemeralKeyGeneration_A(unsigned char* PrivateKeyA, unsigned char* PublicKeyA, PCurveIsogenyStruct CurveIsogeny)
+{ // Alice's ephemeral key-pair generation
+  // It produces a private key PrivateKeyA and computes the public key PublicKeyA.
+  // The private key is an even integer in the range [2, oA-2], where oA = 2^372. 
+  // The public key consists of 3 elements in GF(p751^2).
+  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+    unsigned int pwords = NBITS_TO_NWORDS(CurveIsogeny->pwordbits);
+    point_proj_t phiP = {0}, phiQ = {0}, phiD = {0};
+    f2elm_t A = {0}, C = {0};
+    CRYPTO_STATUS Status = CRYPTO_ERROR_UNKNOWN; 
 
-        for (i = 0; i < npts; i++) {
-            eval_4_isog(pts[i], coeff);
-        }
-        eval_4_isog(phiP, coeff);
-        eval_4_isog(phiQ, coeff);
-        eval_4_isog(phiD, coeff);
+    if (PrivateKeyA == NULL || PublicKeyA == NULL || is_CurveIsogenyStruct_null(CurveIsogeny)) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }  
 
-        fp2copy751(pts[npts-1]->X, R->X); 
-        fp2copy751(pts[npts-1]->Z, R->Z);
-        index = pts_index[npts-1];
-        npts -= 1;
+    Status = keygen_A(PrivateKeyA, phiP, phiQ, phiD, A, C, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        return Status;
     }
 
-    get_4_isog(R, A, C, coeff); 
-    eval_4_isog(phiP, coeff);
-    eval_4_isog(phiQ, coeff);
-    eval_4_isog(phiD, coeff);
-
     inv_3_way(phiP->Z, phiQ->Z, phiD->Z);
     fp2mul751_mont(phiP->X, phiP->Z, phiP->X);
     fp2mul751_mont(phiQ->X, phiQ->Z, phiQ->X);
     fp2mul751_mont(phiD->X, phiD->Z, phiD->X);
                                    
-    from_fp2mont(phiP->X, ((f2elm_t*)PublicKey)[0]);                               // Converting back to standard representation
-    from_fp2mont(phiQ->X, ((f2elm_t*)PublicKey)[1]);
-    from_fp2mont(phiD->X, ((f2elm_t*)PublicKey)[2]);
+    fp2_encode_bytes(phiP->X, &PublicKeyA[0], SIDH_DISPATCH(CurveIsogeny)->encoding);                  // Converting to the wire encoding
+    fp2_encode_bytes(phiQ->X, &PublicKeyA[sizeof(f2elm_t)], SIDH_DISPATCH(CurveIsogeny)->encoding);
+    fp2_encode_bytes(phiD->X, &PublicKeyA[2*sizeof(f2elm_t)], SIDH_DISPATCH(CurveIsogeny)->encoding);
 
 // Cleanup:
-    clear_words((void*)R, 2*2*pwords);
     clear_words((void*)phiP, 2*2*pwords);
     clear_words((void*)phiQ, 2*2*pwords);
     clear_words((void*)phiD, 2*2*pwords);
-    clear_words((void*)pts, MAX_INT_POINTS_ALICE*2*2*pwords);
     clear_words((void*)A, 2*pwords);
     clear_words((void*)C, 2*pwords);
-    clear_words((void*)coeff, 5*2*pwords);
-    //printf("HIER!!!\n");  
+
     return Status;
 }
 
 
-CRYPTO_STATUS EphemeralKeyGeneration_B(unsigned char* PrivateKeyB, unsigned char* PublicKeyB, PCurveIsogenyStruct CurveIsogeny)
-{ // Bob's ephemeral key-pair generation
-  // It produces a private key PrivateKeyB and computes the public key PublicKeyB.
-  // The private key is an integer in the range [1, oB-1], where oA = 3^239. 
-  // The public key consists of 3 elements in GF(p751^2).
-  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+static CRYPTO_STATUS keygen_B(unsigned char* PrivateKeyB, point_proj_t phiP, point_proj_t phiQ, point_proj_t phiD, f2elm_t A, f2elm_t C, PCurveIsogenyStruct CurveIsogeny)
+{ // Core of Bob's ephemeral key-pair generation
+  // It produces a private key PrivateKeyB and leaves the public key as the projective points phiP, phiQ and phiD, in Montgomery representation, 
+  // together with the constant A/C of their curve.
     unsigned int owords = NBITS_TO_NWORDS(CurveIsogeny->owordbits), pwords = NBITS_TO_NWORDS(CurveIsogeny->pwordbits);
     point_basefield_t P;
-    point_proj_t R, phiP = {0}, phiQ = {0}, phiD = {0}, pts[MAX_INT_POINTS_BOB];
-    publickey_t* PublicKey = (publickey_t*)PublicKeyB;
-    unsigned int i, row, m, index = 0, pts_index[MAX_INT_POINTS_BOB], npts = 0; 
-    f2elm_t A = {0}, C = {0};
+    point_proj_t R;
+    digit_t SecretKey[NWORDS_ORDER];
     CRYPTO_STATUS Status = CRYPTO_ERROR_UNKNOWN;  
 
-    if (PrivateKeyB == NULL || PublicKey == NULL || is_CurveIsogenyStruct_null(CurveIsogeny)) {
-        return CRYPTO_ERROR_INVALID_PARAMETER;
-    }  
-
     // Choose a random number equivalent to 0 (mod 3) in the range [3, oB-3] as secret key for Bob
-    Status = random_mod_order((digit_t*)PrivateKeyB, BOB, CurveIsogeny);
+    Status = random_mod_order(SecretKey, BOB, CurveIsogeny);
     if (Status != CRYPTO_SUCCESS) {
-        clear_words((void*)PrivateKeyB, owords);
+        clear_words((void*)SecretKey, owords);
+        store_words(SecretKey, PrivateKeyB, owords);
         return Status;
     }
+    store_words(SecretKey, PrivateKeyB, owords);                                    // The key is sampled into digits and then written to the byte buffer
 
     to_mont((digit_t*)CurveIsogeny->PB, (digit_t*)P);                               // Conversion of Bob's generators to Montgomery representation
     to_mont(((digit_t*)CurveIsogeny->PB)+NWORDS_FIELD, ((digit_t*)P)+NWORDS_FIELD); 
 
-    Status = secret_pt(P, (digit_t*)PrivateKeyB, BOB, R, CurveIsogeny);
+    Status = secret_pt(P, SecretKey, BOB, R, CurveIsogeny);
     if (Status != CRYPTO_SUCCESS) {
-        clear_words((void*)PrivateKeyB, owords);
+        clear_words((void*)SecretKey, owords);
+        store_words(SecretKey, PrivateKeyB, owords);
         return Status;
     }
 
@@ -177,57 +353,85 @@ CRYPTO_STATUS EphemeralKeyGeneration_B(unsigned char* PrivateKeyB, unsigned char
     fpcopy751((digit_t*)CurveIsogeny->Montgomery_one, (digit_t*)phiQ->Z);  
     distort_and_diff(phiP->X[0], phiD, CurveIsogeny);                               // DA = (x(QA-PA),z(QA-PA))
 
+    fp2zero751(A);
+    fp2zero751(C);
     fpcopy751(CurveIsogeny->A, A[0]);                                               // Extracting curve parameters A and C
     fpcopy751(CurveIsogeny->C, C[0]);
     to_mont(A[0], A[0]);
     to_mont(C[0], C[0]);
     
-    index = 0;  
-    for (row = 1; row < MAX_Bob; row++) {
-        while (index < MAX_Bob-row) {
-            fp2copy751(R->X, pts[npts]->X);
-            fp2copy751(R->Z, pts[npts]->Z);
-            pts_index[npts] = index;
-            npts += 1;
-            m = splits_Bob[MAX_Bob-index-row];
-            xTPLe(R, R, A, C, (int)m);
-            index += m;
-        }
-        get_3_isog(R, A, C);        
+    isogeny_tree_B(R, A, C, phiP, phiQ, phiD, CurveIsogeny);
+
+// Cleanup:
+    clear_words((void*)R, 2*2*pwords);
+    clear_words((void*)SecretKey, owords);
+
+    return Status;
+}
+
+
+CRYPTO_STATUS EphemeralKeyGeneration_B(unsigned char* PrivateKeyB, unsigned char* PublicKeyB, PCurveIsogenyStruct CurveIsogeny)
+{ // Bob's ephemeral key-pair generation
+  // It produces a private key PrivateKeyB and computes the public key PublicKeyB.
+  // The private key is an integer in the range [1, oB-1], where oA = 3^239. 
+  // The public key consists of 3 elements in GF(p751^2).
+  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+    unsigned int pwords = NBITS_TO_NWORDS(CurveIsogeny->pwordbits);
+    point_proj_t phiP = {0}, phiQ = {0}, phiD = {0};
+    f2elm_t A = {0}, C = {0};
+    CRYPTO_STATUS Status = CRYPTO_ERROR_UNKNOWN;  
 
-        for (i = 0; i < npts; i++) {
-            eval_3_isog(R, pts[i]);
-        }     
-        eval_3_isog(R, phiP);
-        eval_3_isog(R, phiQ);
-        eval_3_isog(R, phiD);
+    if (PrivateKeyB == NULL || PublicKeyB == NULL || is_CurveIsogenyStruct_null(CurveIsogeny)) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }  
 
-        fp2copy751(pts[npts-1]->X, R->X); 
-        fp2copy751(pts[npts-1]->Z, R->Z);
-        index = pts_index[npts-1];
-        npts -= 1;
+    Status = keygen_B(PrivateKeyB, phiP, phiQ, phiD, A, C, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        return Status;
     }
-    
-    get_3_isog(R, A, C);    
-    eval_3_isog(R, phiP);
-    eval_3_isog(R, phiQ);
-    eval_3_isog(R, phiD);
 
     inv_3_way(phiP->Z, phiQ->Z, phiD->Z);
     fp2mul751_mont(phiP->X, phiP->Z, phiP->X);
     fp2mul751_mont(phiQ->X, phiQ->Z, phiQ->X);
     fp2mul751_mont(phiD->X, phiD->Z, phiD->X);
                                    
-    from_fp2mont(phiP->X, ((f2elm_t*)PublicKey)[0]);                               // Converting back to standard representation
-    from_fp2mont(phiQ->X, ((f2elm_t*)PublicKey)[1]);
-    from_fp2mont(phiD->X, ((f2elm_t*)PublicKey)[2]);
+    fp2_encode_bytes(phiP->X, &PublicKeyB[0], SIDH_DISPATCH(CurveIsogeny)->encoding);                  // Converting to the wire encoding
+    fp2_encode_bytes(phiQ->X, &PublicKeyB[sizeof(f2elm_t)], SIDH_DISPATCH(CurveIsogeny)->encoding);
+    fp2_encode_bytes(phiD->X, &PublicKeyB[2*sizeof(f2elm_t)], SIDH_DISPATCH(CurveIsogeny)->encoding);
 
 // Cleanup:
-    clear_words((void*)R, 2*2*pwords);
     clear_words((void*)phiP, 2*2*pwords);
     clear_words((void*)phiQ, 2*2*pwords);
     clear_words((void*)phiD, 2*2*pwords);
-    clear_words((void*)pts, MAX_INT_POINTS_BOB*2*2*pwords);
+    clear_words((void*)A, 2*pwords);
+    clear_words((void*)C, 2*pwords);
+      
+    return Status;
+}
+
+
+static CRYPTO_STATUS secret_agreement_A(const unsigned char* PrivateKeyA, const f2elm_t* PKB, f2elm_t jinv, PCurveIsogenyStruct CurveIsogeny)
+{ // Core of Alice's ephemeral shared secret computation
+  // It computes the j-invariant jinv of the shared curve from Bob's public key PKB, both in Montgomery representation.
+    unsigned int pwords = NBITS_TO_NWORDS(CurveIsogeny->pwordbits);
+    point_proj_t R;
+    f2elm_t A, C;
+    digit_t SecretKey[NWORDS_ORDER];
+    CRYPTO_STATUS Status = CRYPTO_ERROR_UNKNOWN; 
+
+    get_A_proj(PKB[0], PKB[1], PKB[2], A, C, CurveIsogeny);
+    load_words(PrivateKeyA, SecretKey, NWORDS_ORDER);
+    Status = ladder_3_pt_proj(PKB[0], PKB[1], PKB[2], SecretKey, ALICE, R, A, C, CurveIsogeny);
+    clear_words((void*)SecretKey, NWORDS_ORDER);
+    if (Status != CRYPTO_SUCCESS) {
+        return Status;
+    }
+    first_4_isog_proj(R, A, C, A, C); 
+    isogeny_tree_A(R, A, C, NULL, NULL, NULL, CurveIsogeny);
+    j_inv(A, C, jinv);
+
+// Cleanup:
+    clear_words((void*)R, 2*2*pwords);
     clear_words((void*)A, 2*pwords);
     clear_words((void*)C, 2*pwords);
       
@@ -243,64 +447,59 @@ CRYPTO_STATUS EphemeralSecretAgreement_A(const unsigned char* PrivateKeyA, const
   // Output: a shared secret SharedSecretA that consists of one element in GF(p751^2). 
   // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
     unsigned int pwords = NBITS_TO_NWORDS(CurveIsogeny->pwordbits);
-    unsigned int i, row, m, index = 0, pts_index[MAX_INT_POINTS_ALICE], npts = 0; 
-    point_proj_t R, pts[MAX_INT_POINTS_ALICE];
-    publickey_t* PublicKey = (publickey_t*)PublicKeyB;
-    f2elm_t jinv, coeff[5], PKB[3], A, C = {0};
+    f2elm_t jinv, PKB[3];
+    unsigned int valid, encoding;
     CRYPTO_STATUS Status = CRYPTO_ERROR_UNKNOWN; 
 
-    if (PrivateKeyA == NULL || PublicKey == NULL || SharedSecretA == NULL || is_CurveIsogenyStruct_null(CurveIsogeny)) {
+    if (PrivateKeyA == NULL || PublicKeyB == NULL || SharedSecretA == NULL || is_CurveIsogenyStruct_null(CurveIsogeny)) {
         return CRYPTO_ERROR_INVALID_PARAMETER;
     }
+    encoding = SIDH_DISPATCH(CurveIsogeny)->encoding;
       
-    to_fp2mont(((f2elm_t*)PublicKey)[0], PKB[0]);    // Extracting and converting Bob's public curve parameters to Montgomery representation
-    to_fp2mont(((f2elm_t*)PublicKey)[1], PKB[1]);        
-    to_fp2mont(((f2elm_t*)PublicKey)[2], PKB[2]);
-
-    get_A(PKB[0], PKB[1], PKB[2], A, CurveIsogeny);
-    fpcopy751(CurveIsogeny->C, C[0]);
-    to_mont(C[0], C[0]);
+    valid  = fp2_decode_bytes(&PublicKeyB[0], PKB[0], encoding);                    // Extracting and converting Bob's public curve parameters to Montgomery representation
+    valid &= fp2_decode_bytes(&PublicKeyB[sizeof(f2elm_t)], PKB[1], encoding);
+    valid &= fp2_decode_bytes(&PublicKeyB[2*sizeof(f2elm_t)], PKB[2], encoding);
+    if (valid == 0) {
+        return CRYPTO_ERROR_PUBLIC_KEY_VALIDATION;
+    }
 
-    Status = ladder_3_pt(PKB[0], PKB[1], PKB[2], (digit_t*)PrivateKeyA, ALICE, R, A, CurveIsogeny);
+    Status = secret_agreement_A(PrivateKeyA, PKB, jinv, CurveIsogeny);
     if (Status != CRYPTO_SUCCESS) {
         return Status;
     }
-    first_4_isog(R, A, A, C, CurveIsogeny); 
-        
-    index = 0;  
-    for (row = 1; row < MAX_Alice; row++) {
-        while (index < MAX_Alice-row) {
-            fp2copy751(R->X, pts[npts]->X);
-            fp2copy751(R->Z, pts[npts]->Z);
-            pts_index[npts] = index;
-            npts += 1;
-            m = splits_Alice[MAX_Alice-index-row];
-            edDBLe(R, R, A, C, (int)(2*m));
-            index += m;
-        }
-        get_4_isog(R, A, C, coeff);        
+    fp2_encode_bytes(jinv, SharedSecretA, encoding);         // Converting to the wire encoding
+
+// Cleanup:
+    clear_words((void*)jinv, 2*pwords);
+      
+    return Status;
+}
 
-        for (i = 0; i < npts; i++) {
-            eval_4_isog(pts[i], coeff);
-        }
 
-        fp2copy751(pts[npts-1]->X, R->X); 
-        fp2copy751(pts[npts-1]->Z, R->Z);
-        index = pts_index[npts-1];
-        npts -= 1;
+static CRYPTO_STATUS secret_agreement_B(const unsigned char* PrivateKeyB, const f2elm_t* PKA, f2elm_t jinv, PCurveIsogenyStruct CurveIsogeny)
+{ // Core of Bob's ephemeral shared secret computation
+  // It computes the j-invariant jinv of the shared curve from Alice's public key PKA, both in Montgomery representation.
+    unsigned int pwords = NBITS_TO_NWORDS(CurveIsogeny->pwordbits);
+    point_proj_t R;
+    f2elm_t A, C;
+    digit_t SecretKey[NWORDS_ORDER];
+    CRYPTO_STATUS Status = CRYPTO_ERROR_UNKNOWN;  
+    
+    get_A_proj(PKA[0], PKA[1], PKA[2], A, C, CurveIsogeny);
+    load_words(PrivateKeyB, SecretKey, NWORDS_ORDER);
+    Status = ladder_3_pt_proj(PKA[0], PKA[1], PKA[2], SecretKey, BOB, R, A, C, CurveIsogeny);
+    clear_words((void*)SecretKey, NWORDS_ORDER);
+    if (Status != CRYPTO_SUCCESS) {
+        return Status;
     }
     
-    get_4_isog(R, A, C, coeff); 
+    isogeny_tree_B(R, A, C, NULL, NULL, NULL, CurveIsogeny);
     j_inv(A, C, jinv);
-    from_fp2mont(jinv, (felm_t*)SharedSecretA);      // Converting back to standard representation
 
 // Cleanup:
     clear_words((void*)R, 2*2*pwords);
-    clear_words((void*)pts, MAX_INT_POINTS_ALICE*2*2*pwords);
     clear_words((void*)A, 2*pwords);
     clear_words((void*)C, 2*pwords);
-    clear_words((void*)jinv, 2*pwords);
-    clear_words((void*)coeff, 5*2*pwords);
       
     return Status;
 }
@@ -314,61 +513,181 @@ CRYPTO_STATUS EphemeralSecretAgreement_B(const unsigned char* PrivateKeyB, const
   // Output: a shared secret SharedSecretB that consists of one element in GF(p751^2). 
   // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
     unsigned int pwords = NBITS_TO_NWORDS(CurveIsogeny->pwordbits);
-    unsigned int i, row, m, index = 0, pts_index[MAX_INT_POINTS_BOB], npts = 0; 
-    point_proj_t R, pts[MAX_INT_POINTS_BOB];
-    publickey_t* PublicKey = (publickey_t*)PublicKeyA;
-    f2elm_t jinv, A, PKA[3], C = {0};
+    f2elm_t jinv, PKA[3];
+    unsigned int valid, encoding;
     CRYPTO_STATUS Status = CRYPTO_ERROR_UNKNOWN;  
 
-    if (PrivateKeyB == NULL || PublicKey == NULL || SharedSecretB == NULL || is_CurveIsogenyStruct_null(CurveIsogeny)) {
+    if (PrivateKeyB == NULL || PublicKeyA == NULL || SharedSecretB == NULL || is_CurveIsogenyStruct_null(CurveIsogeny)) {
         return CRYPTO_ERROR_INVALID_PARAMETER;
     }
+    encoding = SIDH_DISPATCH(CurveIsogeny)->encoding;
        
-    to_fp2mont(((f2elm_t*)PublicKey)[0], PKA[0]);    // Extracting and converting Alice's public curve parameters to Montgomery representation
-    to_fp2mont(((f2elm_t*)PublicKey)[1], PKA[1]);       
-    to_fp2mont(((f2elm_t*)PublicKey)[2], PKA[2]);
+    valid  = fp2_decode_bytes(&PublicKeyA[0], PKA[0], encoding);                    // Extracting and converting Alice's public curve parameters to Montgomery representation
+    valid &= fp2_decode_bytes(&PublicKeyA[sizeof(f2elm_t)], PKA[1], encoding);
+    valid &= fp2_decode_bytes(&PublicKeyA[2*sizeof(f2elm_t)], PKA[2], encoding);
+    if (valid == 0) {
+        return CRYPTO_ERROR_PUBLIC_KEY_VALIDATION;
+    }
     
-    get_A(PKA[0], PKA[1], PKA[2], A, CurveIsogeny);
-    fpcopy751(CurveIsogeny->C, C[0]);
-    to_mont(C[0], C[0]);
+    Status = secret_agreement_B(PrivateKeyB, PKA, jinv, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        return Status;
+    }
+    fp2_encode_bytes(jinv, SharedSecretB, encoding);         // Converting to the wire encoding
+
+// Cleanup:
+    clear_words((void*)jinv, 2*pwords);
+      
+    return Status;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////
+///////////////          KEY EXCHANGE USING PACKED KEYS             ///////////////
+
+// The packed wire format stores each GF(p751) element in NBYTES_PACKED_FIELD = 94 bytes, in the encoding selected by SIDH_curve_set_encoding().
+// Packed buffers are only accessed bytewise, so they have no alignment requirements.
+
+CRYPTO_STATUS EphemeralKeyGeneration_Packed_A(unsigned char* PrivateKeyA, unsigned char* PackedPublicKeyA, PCurveIsogenyStruct CurveIsogeny)
+{ // Alice's ephemeral key-pair generation with a packed public key
+  // It produces a private key PrivateKeyA and computes the public key PackedPublicKeyA, which consists of 3 elements in GF(p751^2) in 6*94 bytes.
+  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+    unsigned int pwords = NBITS_TO_NWORDS(CurveIsogeny->pwordbits);
+    point_proj_t phiP = {0}, phiQ = {0}, phiD = {0};
+    f2elm_t A = {0}, C = {0};
+    CRYPTO_STATUS Status = CRYPTO_ERROR_UNKNOWN; 
+
+    if (PrivateKeyA == NULL || PackedPublicKeyA == NULL || is_CurveIsogenyStruct_null(CurveIsogeny)) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }  
 
-    Status = ladder_3_pt(PKA[0], PKA[1], PKA[2], (digit_t*)PrivateKeyB, BOB, R, A, CurveIsogeny);
+    Status = keygen_A(PrivateKeyA, phiP, phiQ, phiD, A, C, CurveIsogeny);
     if (Status != CRYPTO_SUCCESS) {
         return Status;
     }
-    
-    index = 0;  
-    for (row = 1; row < MAX_Bob; row++) {
-        while (index < MAX_Bob-row) {
-            fp2copy751(R->X, pts[npts]->X);
-            fp2copy751(R->Z, pts[npts]->Z);
-            pts_index[npts] = index;
-            npts += 1;
-            m = splits_Bob[MAX_Bob-index-row];
-            xTPLe(R, R, A, C, (int)m);
-            index += m;
-        }
-        get_3_isog(R, A, C);        
 
-        for (i = 0; i < npts; i++) {
-            eval_3_isog(R, pts[i]);
-        } 
+    inv_3_way(phiP->Z, phiQ->Z, phiD->Z);
+    fp2mul751_mont(phiP->X, phiP->Z, phiP->X);
+    fp2mul751_mont(phiQ->X, phiQ->Z, phiQ->X);
+    fp2mul751_mont(phiD->X, phiD->Z, phiD->X);
+                                   
+    fp2_pack(phiP->X, &PackedPublicKeyA[0], SIDH_DISPATCH(CurveIsogeny)->encoding);                          // Packing in the wire encoding
+    fp2_pack(phiQ->X, &PackedPublicKeyA[2*NBYTES_PACKED_FIELD], SIDH_DISPATCH(CurveIsogeny)->encoding);
+    fp2_pack(phiD->X, &PackedPublicKeyA[4*NBYTES_PACKED_FIELD], SIDH_DISPATCH(CurveIsogeny)->encoding);
+
+// Cleanup:
+    clear_words((void*)phiP, 2*2*pwords);
+    clear_words((void*)phiQ, 2*2*pwords);
+    clear_words((void*)phiD, 2*2*pwords);
+    clear_words((void*)A, 2*pwords);
+    clear_words((void*)C, 2*pwords);
+
+    return Status;
+}
+
+
+CRYPTO_STATUS EphemeralKeyGeneration_Packed_B(unsigned char* PrivateKeyB, unsigned char* PackedPublicKeyB, PCurveIsogenyStruct CurveIsogeny)
+{ // Bob's ephemeral key-pair generation with a packed public key
+  // It produces a private key PrivateKeyB and computes the public key PackedPublicKeyB, which consists of 3 elements in GF(p751^2) in 6*94 bytes.
+  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+    unsigned int pwords = NBITS_TO_NWORDS(CurveIsogeny->pwordbits);
+    point_proj_t phiP = {0}, phiQ = {0}, phiD = {0};
+    f2elm_t A = {0}, C = {0};
+    CRYPTO_STATUS Status = CRYPTO_ERROR_UNKNOWN;  
+
+    if (PrivateKeyB == NULL || PackedPublicKeyB == NULL || is_CurveIsogenyStruct_null(CurveIsogeny)) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }  
 
-        fp2copy751(pts[npts-1]->X, R->X); 
-        fp2copy751(pts[npts-1]->Z, R->Z);
-        index = pts_index[npts-1];
-        npts -= 1;
+    Status = keygen_B(PrivateKeyB, phiP, phiQ, phiD, A, C, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        return Status;
     }
-    
-    get_3_isog(R, A, C);    
-    j_inv(A, C, jinv);
-    from_fp2mont(jinv, (felm_t*)SharedSecretB);      // Converting back to standard representation
+
+    inv_3_way(phiP->Z, phiQ->Z, phiD->Z);
+    fp2mul751_mont(phiP->X, phiP->Z, phiP->X);
+    fp2mul751_mont(phiQ->X, phiQ->Z, phiQ->X);
+    fp2mul751_mont(phiD->X, phiD->Z, phiD->X);
+                                   
+    fp2_pack(phiP->X, &PackedPublicKeyB[0], SIDH_DISPATCH(CurveIsogeny)->encoding);                          // Packing in the wire encoding
+    fp2_pack(phiQ->X, &PackedPublicKeyB[2*NBYTES_PACKED_FIELD], SIDH_DISPATCH(CurveIsogeny)->encoding);
+    fp2_pack(phiD->X, &PackedPublicKeyB[4*NBYTES_PACKED_FIELD], SIDH_DISPATCH(CurveIsogeny)->encoding);
 
 // Cleanup:
-    clear_words((void*)R, 2*2*pwords);
-    clear_words((void*)pts, MAX_INT_POINTS_BOB*2*2*pwords);
+    clear_words((void*)phiP, 2*2*pwords);
+    clear_words((void*)phiQ, 2*2*pwords);
+    clear_words((void*)phiD, 2*2*pwords);
     clear_words((void*)A, 2*pwords);
     clear_words((void*)C, 2*pwords);
+      
+    return Status;
+}
+
+
+CRYPTO_STATUS EphemeralSecretAgreement_Packed_A(const unsigned char* PrivateKeyA, const unsigned char* PackedPublicKeyB, unsigned char* PackedSharedSecretA, PCurveIsogenyStruct CurveIsogeny)
+{ // Alice's ephemeral shared secret computation with packed keys
+  // It produces a shared secret key PackedSharedSecretA, one element in GF(p751^2) in 2*94 bytes, using her secret key PrivateKeyA and Bob's packed public key PackedPublicKeyB.
+  // Returns CRYPTO_ERROR_PUBLIC_KEY_VALIDATION if an element of PackedPublicKeyB is not in [0, p751-1].
+  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+    unsigned int pwords = NBITS_TO_NWORDS(CurveIsogeny->pwordbits);
+    f2elm_t jinv, PKB[3];
+    unsigned int valid, encoding;
+    CRYPTO_STATUS Status = CRYPTO_ERROR_UNKNOWN; 
+
+    if (PrivateKeyA == NULL || PackedPublicKeyB == NULL || PackedSharedSecretA == NULL || is_CurveIsogenyStruct_null(CurveIsogeny)) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    encoding = SIDH_DISPATCH(CurveIsogeny)->encoding;
+      
+    valid  = fp2_unpack(&PackedPublicKeyB[0], PKB[0], encoding);                          // Unpacking Bob's public curve parameters to Montgomery representation
+    valid &= fp2_unpack(&PackedPublicKeyB[2*NBYTES_PACKED_FIELD], PKB[1], encoding);
+    valid &= fp2_unpack(&PackedPublicKeyB[4*NBYTES_PACKED_FIELD], PKB[2], encoding);
+    if (valid == 0) {
+        return CRYPTO_ERROR_PUBLIC_KEY_VALIDATION;
+    }
+
+    Status = secret_agreement_A(PrivateKeyA, PKB, jinv, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        return Status;
+    }
+    fp2_pack(jinv, PackedSharedSecretA, encoding);                                         // Packing in the wire encoding
+
+// Cleanup:
+    clear_words((void*)jinv, 2*pwords);
+      
+    return Status;
+}
+
+
+CRYPTO_STATUS EphemeralSecretAgreement_Packed_B(const unsigned char* PrivateKeyB, const unsigned char* PackedPublicKeyA, unsigned char* PackedSharedSecretB, PCurveIsogenyStruct CurveIsogeny)
+{ // Bob's ephemeral shared secret computation with packed keys
+  // It produces a shared secret key PackedSharedSecretB, one element in GF(p751^2) in 2*94 bytes, using his secret key PrivateKeyB and Alice's packed public key PackedPublicKeyA.
+  // Returns CRYPTO_ERROR_PUBLIC_KEY_VALIDATION if an element of PackedPublicKeyA is not in [0, p751-1].
+  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+    unsigned int pwords = NBITS_TO_NWORDS(CurveIsogeny->pwordbits);
+    f2elm_t jinv, PKA[3];
+    unsigned int valid, encoding;
+    CRYPTO_STATUS Status = CRYPTO_ERROR_UNKNOWN;  
+
+    if (PrivateKeyB == NULL || PackedPublicKeyA == NULL || PackedSharedSecretB == NULL || is_CurveIsogenyStruct_null(CurveIsogeny)) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    encoding = SIDH_DISPATCH(CurveIsogeny)->encoding;
+       
+    valid  = fp2_unpack(&PackedPublicKeyA[0], PKA[0], encoding);                          // Unpacking Alice's public curve parameters to Montgomery representation
+    valid &= fp2_unpack(&PackedPublicKeyA[2*NBYTES_PACKED_FIELD], PKA[1], encoding);
+    valid &= fp2_unpack(&PackedPublicKeyA[4*NBYTES_PACKED_FIELD], PKA[2], encoding);
+    if (valid == 0) {
+        return CRYPTO_ERROR_PUBLIC_KEY_VALIDATION;
+    }
+    
+    Status = secret_agreement_B(PrivateKeyB, PKA, jinv, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        return Status;
+    }
+    fp2_pack(jinv, PackedSharedSecretB, encoding);                                         // Packing in the wire encoding
+
+// Cleanup:
     clear_words((void*)jinv, 2*pwords);
       
     return Status;
@@ -378,29 +697,28 @@ CRYPTO_STATUS EphemeralSecretAgreement_B(const unsigned char* PrivateKeyB, const
 ///////////////////////////////////////////////////////////////////////////////////
 ///////////////          KEY EXCHANGE USING DECOMPRESSION           ///////////////
 
-void PublicKeyCompression_A(const unsigned char* PublicKeyA, unsigned char* CompressedPKA, PCurveIsogenyStruct CurveIsogeny)
-{ // Alice's public key compression
-  // It produces a compressed output that consists of three elements in Z_orderB and one field element
-  // Input : Alice's public key PublicKeyA, which consists of 3 elements in GF(p751^2).
-  // Output: a compressed value CompressedPKA that consists of three elements in Z_orderB and one element in GF(p751^2). 
-  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().                                                                        
-    point_full_proj_t P, Q, phP, phQ, phX;
+static CRYPTO_STATUS compress_A(const point_full_proj_t phP, const point_full_proj_t phQ, f2elm_t A, unsigned char* CompressedPKA, PCurveIsogenyStruct CurveIsogeny)
+{ // Core of Alice's public key compression
+  // Input : the points phP and phQ of the public key with recovered y-coordinates, and the constant A of their curve, all in Montgomery representation.
+  // Output: the compressed value CompressedPKA. A is overwritten.
+#if defined(SIDH_BOUNDED_STACK)
+    PSIDH_workspace ws = SIDH_WORKSPACE(CurveIsogeny);
+    point_full_proj *P = ws->P, *Q = ws->Q;
+    point_affine *R1 = ws->R1, *R2 = ws->R2, *phiP = ws->phiP, *phiQ = ws->phiQ;
+#else
+    point_full_proj_t P, Q;
     point_t R1, R2, phiP, phiQ;
-    publickey_t PK;
-    digit_t* comp = (digit_t*)CompressedPKA;
+#endif
+    digit_t comp[3*NWORDS_ORDER];
 	digit_t inv[NWORDS_ORDER];
-    f2elm_t A, vec[4], Zinv[4];
+    f2elm_t vec[4], Zinv[4];
     digit_t a0[NWORDS_ORDER], b0[NWORDS_ORDER], a1[NWORDS_ORDER], b1[NWORDS_ORDER];
     uint64_t Montgomery_Rprime[NWORDS64_ORDER] = {0x1A55482318541298, 0x070A6370DFA12A03, 0xCB1658E0E3823A40, 0xB3B7384EB5DEF3F9, 0xCBCA952F7006EA33, 0x00569EF8EC94864C}; // Value (2^384)^2 mod 3^239
     uint64_t Montgomery_rprime[NWORDS64_ORDER] = {0x48062A91D3AB563D, 0x6CE572751303C2F5, 0x5D1319F3F160EC9D, 0xE35554E8C2D5623A, 0xCA29300232BC79A5, 0x8AAD843D646D78C5}; // Value -(3^239)^-1 mod 2^384
     unsigned int bit;
+    CRYPTO_STATUS Status;
 
-    to_fp2mont(((f2elm_t*)PublicKeyA)[0], ((f2elm_t*)&PK)[0]);    // Converting to Montgomery representation
-    to_fp2mont(((f2elm_t*)PublicKeyA)[1], ((f2elm_t*)&PK)[1]); 
-    to_fp2mont(((f2elm_t*)PublicKeyA)[2], ((f2elm_t*)&PK)[2]); 
-
-    recover_y(PK, phP, phQ, phX, A, CurveIsogeny);
-    generate_3_torsion_basis(A, P, Q, CurveIsogeny);
+    generate_3_torsion_basis_entangled(A, P, Q, CurveIsogeny);
     fp2copy751(P->Z, vec[0]);
     fp2copy751(Q->Z, vec[1]);
     fp2copy751(phP->Z, vec[2]);
@@ -416,7 +734,10 @@ void PublicKeyCompression_A(const unsigned char* PublicKeyA, unsigned char* Comp
     fp2mul751_mont(phQ->X, Zinv[3], phiQ->x);
     fp2mul751_mont(phQ->Y, Zinv[3], phiQ->y);
 
-    ph3(phiP, phiQ, R1, R2, A, (uint64_t*)a0, (uint64_t*)b0, (uint64_t*)a1, (uint64_t*)b1, CurveIsogeny);
+    Status = ph3(phiP, phiQ, R1, R2, A, (uint64_t*)a0, (uint64_t*)b0, (uint64_t*)a1, (uint64_t*)b1, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        return Status;
+    }
     
     bit = mod3(a0);
     to_Montgomery_mod_order(a0, a0, CurveIsogeny->Border, (digit_t*)&Montgomery_rprime, (digit_t*)&Montgomery_Rprime);    // Converting to Montgomery representation
@@ -444,77 +765,213 @@ void PublicKeyCompression_A(const unsigned char* PublicKeyA, unsigned char* Comp
         comp[3*NWORDS_ORDER-1] |= (digit_t)1 << (sizeof(digit_t)*8 - 1);
     }
     
-    from_fp2mont(A, (felm_t*)&comp[3*NWORDS_ORDER]);
+    from_fp2mont(A, A);
+    store_words(comp, CompressedPKA, 3*NWORDS_ORDER);                                     // The caller's buffer is only written with memcpy (see store_words())
+    store_words((digit_t*)A, &CompressedPKA[3*NWORDS_ORDER*sizeof(digit_t)], 2*NWORDS_FIELD);
+
+    return CRYPTO_SUCCESS;
 }
 
 
-void PublicKeyADecompression_B(const unsigned char* SecretKeyB, const unsigned char* CompressedPKA, unsigned char* point_R, unsigned char* param_A, PCurveIsogenyStruct CurveIsogeny)
-{ // Alice's public key value decompression computed by Bob
-  // Inputs: Bob's private key SecretKeyB, and
-  //         Alice's compressed public key data CompressedPKA, which consists of three elements in Z_orderB and one element in GF(p751^2),
-  // Output: a point point_R in coordinates (X:Z) and the curve parameter param_A in GF(p751^2). Outputs are stored in Montgomery representation.
-  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().                                                                                                                             
-    point_t R1, R2;
-    point_proj_t* R = (point_proj_t*)point_R;
+CRYPTO_STATUS PublicKeyCompression_Checked_A(const unsigned char* PublicKeyA, unsigned char* CompressedPKA, PCurveIsogenyStruct CurveIsogeny)
+{ // Alice's public key compression with validation of the public key
+  // It produces the same compressed output as PublicKeyCompression_A(), i.e., three elements in Z_orderB and one element in GF(p751^2).
+  // Returns CRYPTO_ERROR_PUBLIC_KEY_VALIDATION if a coordinate of PublicKeyA is not a valid wire encoding (see SIDH_curve_set_encoding()),
+  // and CRYPTO_ERROR_NO_MEMORY if the lookup tables cannot be allocated. CompressedPKA is zeroed on failure.
+  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+#if defined(SIDH_BOUNDED_STACK)
+    PSIDH_workspace ws = SIDH_WORKSPACE(CurveIsogeny);
+    point_full_proj *phP = ws->phP, *phQ = ws->phQ, *phX = ws->phX;
+    f2elm_t* PK = ws->PK;
+#else
+    point_full_proj_t phP, phQ, phX;
+    publickey_t PK;
+#endif
+    f2elm_t A;
+    unsigned int valid, encoding;
+    CRYPTO_STATUS Status = CRYPTO_ERROR_PUBLIC_KEY_VALIDATION;
+
+    if (PublicKeyA == NULL || CompressedPKA == NULL || is_CurveIsogenyStruct_null(CurveIsogeny)) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    encoding = SIDH_DISPATCH(CurveIsogeny)->encoding;
+
+    valid  = fp2_decode_bytes(&PublicKeyA[0], ((f2elm_t*)PK)[0], encoding);                     // Converting to Montgomery representation
+    valid &= fp2_decode_bytes(&PublicKeyA[sizeof(f2elm_t)], ((f2elm_t*)PK)[1], encoding);
+    valid &= fp2_decode_bytes(&PublicKeyA[2*sizeof(f2elm_t)], ((f2elm_t*)PK)[2], encoding);
+
+    if (valid != 0) {
+        recover_y(PK, phP, phQ, phX, A, CurveIsogeny);
+        Status = compress_A(phP, phQ, A, CompressedPKA, CurveIsogeny);
+    }
+    if (Status != CRYPTO_SUCCESS) {                                                           // No partial output for an invalid key or if the lookup tables cannot be allocated
+        memset(CompressedPKA, 0, 3*((CurveIsogeny->owordbits + 7)/8) + 2*((CurveIsogeny->pwordbits + 7)/8));
+    }
+    return Status;
+}
+
+
+void PublicKeyCompression_A(const unsigned char* PublicKeyA, unsigned char* CompressedPKA, PCurveIsogenyStruct CurveIsogeny)
+{ // Alice's public key compression
+  // It produces a compressed output that consists of three elements in Z_orderB and one field element
+  // Input : Alice's public key PublicKeyA, which consists of 3 elements in GF(p751^2).
+  // Output: a compressed value CompressedPKA that consists of three elements in Z_orderB and one element in GF(p751^2). 
+  //         The output is all zero if PublicKeyA is invalid or the lookup tables cannot be allocated; PublicKeyCompression_Checked_A() reports the error.
+  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+    PublicKeyCompression_Checked_A(PublicKeyA, CompressedPKA, CurveIsogeny);
+}
+
+
+CRYPTO_STATUS EphemeralKeyGeneration_Compressed_A(unsigned char* PrivateKeyA, unsigned char* CompressedPKA, PCurveIsogenyStruct CurveIsogeny)
+{ // Alice's ephemeral key-pair generation with a compressed public key
+  // It produces a private key PrivateKeyA as EphemeralKeyGeneration_A() does and directly outputs the compressed public key CompressedPKA, 
+  // which is identical to the output of PublicKeyCompression_A() on the uncompressed public key.
+  // The curve constant comes from the isogeny evaluation instead of get_A(), and a single inversion of Z(phiD)*C replaces 
+  // the 3-way normalization and the inversion in get_A().
+  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+    unsigned int pwords = NBITS_TO_NWORDS(CurveIsogeny->pwordbits);
+#if defined(SIDH_BOUNDED_STACK)
+    PSIDH_workspace ws = SIDH_WORKSPACE(CurveIsogeny);
+    point_full_proj *phP = ws->phP, *phQ = ws->phQ, *phX = ws->phX;
+    point_proj *phiP = ws->phiK[0], *phiQ = ws->phiK[1], *phiD = ws->phiK[2];
+#else
+    point_full_proj_t phP, phQ, phX;
+    point_proj_t phiP = {0}, phiQ = {0}, phiD = {0};
+#endif
+    f2elm_t A = {0}, C = {0}, t;
+    CRYPTO_STATUS Status = CRYPTO_ERROR_UNKNOWN; 
+
+    if (PrivateKeyA == NULL || CompressedPKA == NULL || is_CurveIsogenyStruct_null(CurveIsogeny)) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }  
+
+    Status = keygen_A(PrivateKeyA, phiP, phiQ, phiD, A, C, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        return Status;
+    }
+
+    fp2mul751_mont(phiD->Z, C, t);                   // t = Z(phiD)*C
+    fp2inv751_mont(t);                               // t = 1/(Z(phiD)*C)
+    fp2mul751_mont(phiD->X, C, phiD->X);
+    fp2mul751_mont(phiD->X, t, phiD->X);             // x(phiD) = X(phiD)/Z(phiD)
+    fp2mul751_mont(A, phiD->Z, A);
+    fp2mul751_mont(A, t, A);                         // A = A/C
+
+    recover_y_proj(phiP, phiQ, phiD->X, A, phP, phQ, phX, CurveIsogeny);
+    Status = compress_A(phP, phQ, A, CompressedPKA, CurveIsogeny);
+
+// Cleanup:
+    clear_words((void*)phiP, 2*2*pwords);
+    clear_words((void*)phiQ, 2*2*pwords);
+    clear_words((void*)phiD, 2*2*pwords);
+    clear_words((void*)A, 2*pwords);
+    clear_words((void*)C, 2*pwords);
+    clear_words((void*)t, 2*pwords);
+
+    return Status;
+}
+
+
+static void decompress_PKA(const unsigned char* SecretKeyB, const unsigned char* CompressedPKA, point_proj_t R, f2elm_t A, PCurveIsogenyStruct CurveIsogeny)
+{ // Decompression of Alice's public key by Bob into the kernel point R = (X:Z) and the curve constant A, both in Montgomery representation.
+  // CompressedPKA is left untouched. Only the basis point that is multiplied by the scalar is normalized, the other one stays projective.
+#if defined(SIDH_BOUNDED_STACK)
+    PSIDH_workspace ws = SIDH_WORKSPACE(CurveIsogeny);
+    point_full_proj *P = ws->P, *Q = ws->Q;
+    point_affine *S = ws->R1;
+#else
     point_full_proj_t P, Q;
-    digit_t* comp = (digit_t*)CompressedPKA;
-    digit_t* SKin = (digit_t*)SecretKeyB;
-    f2elm_t A24, vec[2], invs[2], one = {0};
-    felm_t* A = (felm_t*)param_A;
-    digit_t t1[NWORDS_ORDER], t2[NWORDS_ORDER], t3[NWORDS_ORDER], t4[NWORDS_ORDER], vone[NWORDS_ORDER] = {0};
+    point_t S;
+#endif
+    point_full_proj *RP, *SP;
+    digit_t comp[3*NWORDS_ORDER], SKin[NWORDS_ORDER];
+    f2elm_t A24, inv, one = {0};
+    digit_t t1[NWORDS_ORDER], t2[NWORDS_ORDER], t3[NWORDS_ORDER], c2[NWORDS_ORDER], vone[NWORDS_ORDER] = {0};
+    digit_t *cn, *cd;
     uint64_t Montgomery_Rprime[NWORDS64_ORDER] = {0x1A55482318541298, 0x070A6370DFA12A03, 0xCB1658E0E3823A40, 0xB3B7384EB5DEF3F9, 0xCBCA952F7006EA33, 0x00569EF8EC94864C}; // Value (2^384)^2 mod 3^239
     uint64_t Montgomery_rprime[NWORDS64_ORDER] = {0x48062A91D3AB563D, 0x6CE572751303C2F5, 0x5D1319F3F160EC9D, 0xE35554E8C2D5623A, 0xCA29300232BC79A5, 0x8AAD843D646D78C5}; // Value -(3^239)^-1 mod 2^384
     unsigned int bit;
     
     vone[0] = 1;
-    to_Montgomery_mod_order(vone, vone, CurveIsogeny->Border, (digit_t*)&Montgomery_rprime, (digit_t*)&Montgomery_Rprime);  // Converting to Montgomery representation
     fpcopy751(CurveIsogeny->Montgomery_one, one[0]);
-    to_fp2mont((felm_t*)&comp[3*NWORDS_ORDER], A);    // Converting to Montgomery representation
-    generate_3_torsion_basis(A, P, Q, CurveIsogeny);
+    load_words(CompressedPKA, comp, 3*NWORDS_ORDER);                                       // The caller's buffers are only read with memcpy (see load_words())
+    load_words(SecretKeyB, SKin, NWORDS_ORDER);
+    load_words(&CompressedPKA[3*NWORDS_ORDER*sizeof(digit_t)], (digit_t*)A, 2*NWORDS_FIELD);
+    to_fp2mont(A, A);                                 // Converting to Montgomery representation
+    generate_3_torsion_basis_entangled(A, P, Q, CurveIsogeny);
 
-    // Normalize basis points
-    fp2copy751(P->Z, vec[0]);
-    fp2copy751(Q->Z, vec[1]);
-    mont_n_way_inv(vec, 2, invs);
-    fp2mul751_mont(P->X, invs[0], R1->x);
-    fp2mul751_mont(P->Y, invs[0], R1->y);
-    fp2mul751_mont(Q->X, invs[1], R2->x);
-    fp2mul751_mont(Q->Y, invs[1], R2->y);
+    bit = comp[3*NWORDS_ORDER-1] >> (sizeof(digit_t)*8 - 1);   
+    copy_words(&comp[2*NWORDS_ORDER], c2, NWORDS_ORDER);
+    c2[NWORDS_ORDER-1] &= (digit_t)(-1) >> 1;               // Strip the flag bit from a copy, the input buffer stays intact
+    if (bit == 0) {                                         // R = P + a*Q with a = (c0 + SK*c2)/(1 + SK*c1)
+        RP = P; SP = Q; cn = c2; cd = &comp[NWORDS_ORDER];
+    } else {                                                // R = Q + a*P with a = (c0 + SK*c1)/(1 + SK*c2)
+        RP = Q; SP = P; cn = &comp[NWORDS_ORDER]; cd = c2;
+    }
+
+    // Normalize the basis point used in the ladder. The basis only depends on the public A, so the variable-time inversion is fine
+    fp2copy751(SP->Z, inv);
+    fp2inv751_mont_bingcd(inv);
+    fp2mul751_mont(SP->X, inv, S->x);
+    fp2mul751_mont(SP->Y, inv, S->y);
 
     fp2add751(A, one, A24);
     fp2add751(A24, one, A24);
     fp2div2_751(A24, A24);
     fp2div2_751(A24, A24);
 
-    bit = comp[3*NWORDS_ORDER-1] >> (sizeof(digit_t)*8 - 1);   
-    comp[3*NWORDS_ORDER-1] &= (digit_t)(-1) >> 1;
+    // Only SK is converted to Montgomery representation: products with it are reduced back to the plain representation, and the inverse of a 
+    // plain value comes out multiplied by the Montgomery constant twice, so the quotient needs a single conversion back
     to_Montgomery_mod_order(SKin, t1, CurveIsogeny->Border, (digit_t*)&Montgomery_rprime, (digit_t*)&Montgomery_Rprime);    // Converting to Montgomery representation 
-    to_Montgomery_mod_order(&comp[0], t2, CurveIsogeny->Border, (digit_t*)&Montgomery_rprime, (digit_t*)&Montgomery_Rprime); 
-    to_Montgomery_mod_order(&comp[NWORDS_ORDER], t3, CurveIsogeny->Border, (digit_t*)&Montgomery_rprime, (digit_t*)&Montgomery_Rprime);  
-    to_Montgomery_mod_order(&comp[2*NWORDS_ORDER], t4, CurveIsogeny->Border, (digit_t*)&Montgomery_rprime, (digit_t*)&Montgomery_Rprime); 
-
-    if (bit == 0) {    
-        Montgomery_multiply_mod_order(t1, t3, t3, CurveIsogeny->Border, (digit_t*)&Montgomery_rprime); 
-        mp_add(t3, vone, t3, NWORDS_ORDER);   
-        Montgomery_inversion_mod_order_bingcd(t3, t3, CurveIsogeny->Border, (digit_t*)&Montgomery_rprime, (digit_t*)&Montgomery_Rprime);
-        Montgomery_multiply_mod_order(t1, t4, t4, CurveIsogeny->Border, (digit_t*)&Montgomery_rprime); 
-        mp_add(t2, t4, t4, NWORDS_ORDER);   
-        Montgomery_multiply_mod_order(t3, t4, t3, CurveIsogeny->Border, (digit_t*)&Montgomery_rprime); 
-        from_Montgomery_mod_order(t3, t3, CurveIsogeny->Border, (digit_t*)&Montgomery_rprime);    // Converting back from Montgomery representation
-        mont_twodim_scalarmult(t3, R1, R2, A, A24, P, CurveIsogeny);
-    } else {   
-        Montgomery_multiply_mod_order(t1, t4, t4, CurveIsogeny->Border, (digit_t*)&Montgomery_rprime); 
-        mp_add(t4, vone, t4, NWORDS_ORDER);   
-        Montgomery_inversion_mod_order_bingcd(t4, t4, CurveIsogeny->Border, (digit_t*)&Montgomery_rprime, (digit_t*)&Montgomery_Rprime);
-        Montgomery_multiply_mod_order(t1, t3, t3, CurveIsogeny->Border, (digit_t*)&Montgomery_rprime); 
-        mp_add(t2, t3, t3, NWORDS_ORDER);   
-        Montgomery_multiply_mod_order(t3, t4, t3, CurveIsogeny->Border, (digit_t*)&Montgomery_rprime); 
-        from_Montgomery_mod_order(t3, t3, CurveIsogeny->Border, (digit_t*)&Montgomery_rprime);    // Converting back from Montgomery representation
-        mont_twodim_scalarmult(t3, R2, R1, A, A24, P, CurveIsogeny);
-    }
-
-    fp2copy751(P->X, R[0]->X);               
-    fp2copy751(P->Z, R[0]->Z);
+    Montgomery_multiply_mod_order(t1, cd, t2, CurveIsogeny->Border, (digit_t*)&Montgomery_rprime);      // t2 = SK*cd
+    mp_add(t2, vone, t2, NWORDS_ORDER);   
+    Montgomery_inversion_mod_orderB(t2, t2, CurveIsogeny->Border, (digit_t*)&Montgomery_rprime);        // Constant time, since t2 depends on the secret key
+    Montgomery_multiply_mod_order(t1, cn, t3, CurveIsogeny->Border, (digit_t*)&Montgomery_rprime);      // t3 = SK*cn
+    mp_add(&comp[0], t3, t3, NWORDS_ORDER);   
+    Montgomery_multiply_mod_order(t3, t2, t3, CurveIsogeny->Border, (digit_t*)&Montgomery_rprime); 
+    from_Montgomery_mod_order(t3, t3, CurveIsogeny->Border, (digit_t*)&Montgomery_rprime);              // Converting back from Montgomery representation
+    mont_twodim_scalarmult_xz(t3, RP, S, A, A24, CurveIsogeny->oBbits, R, CurveIsogeny);
+
+// Cleanup:
+    clear_words((void*)SKin, NWORDS_ORDER);
+    clear_words((void*)t1, NWORDS_ORDER);
+}
+
+
+void PublicKeyADecompression_B(const unsigned char* SecretKeyB, const unsigned char* CompressedPKA, unsigned char* point_R, unsigned char* param_A, PCurveIsogenyStruct CurveIsogeny)
+{ // Alice's public key value decompression computed by Bob
+  // Inputs: Bob's private key SecretKeyB, and
+  //         Alice's compressed public key data CompressedPKA, which consists of three elements in Z_orderB and one element in GF(p751^2),
+  // Output: a point point_R in coordinates (X:Z) and the curve parameter param_A in GF(p751^2). Outputs are stored in Montgomery representation.
+  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().                                                                                                                             
+    unsigned int pwords = NBITS_TO_NWORDS(CurveIsogeny->pwordbits);
+    point_proj_t R;
+    f2elm_t A;
+
+    decompress_PKA(SecretKeyB, CompressedPKA, R, A, CurveIsogeny);
+    store_words((digit_t*)R, point_R, 2*2*NWORDS_FIELD);                                  // The caller's buffers are only written with memcpy (see store_words())
+    store_words((digit_t*)A, param_A, 2*NWORDS_FIELD);
+
+// Cleanup:
+    clear_words((void*)R, 2*2*pwords);
+    clear_words((void*)A, 2*pwords);
+}
+
+static void agreement_compressed_A(point_proj_t R, const f2elm_t A0, f2elm_t C, unsigned char* SharedSecretA, PCurveIsogenyStruct CurveIsogeny)
+{ // Alice's shared secret from Bob's decompressed kernel point R and curve (A0:C), all in Montgomery representation. R and C are overwritten.
+  // Only the first 4-isogeny is computed with (A:C) output: isogeny_tree_A() converts the constants once and runs the dispatched A24 (or Edwards) 4-isogenies.
+    unsigned int pwords = NBITS_TO_NWORDS(CurveIsogeny->pwordbits);
+    f2elm_t jinv, A;
+
+    first_4_isog(R, A0, A, C, CurveIsogeny); 
+    isogeny_tree_A(R, A, C, NULL, NULL, NULL, CurveIsogeny);
+    j_inv(A, C, jinv);
+    fp2_encode_bytes(jinv, SharedSecretA, SIDH_DISPATCH(CurveIsogeny)->encoding);    // Converting to the wire encoding
+
+// Cleanup:
+    clear_words((void*)A, 2*pwords);
+    clear_words((void*)C, 2*pwords);
+    clear_words((void*)jinv, 2*pwords);
 }
 
 
@@ -525,81 +982,50 @@ CRYPTO_STATUS EphemeralSecretAgreement_Compression_A(const unsigned char* Privat
   //         Bob's decompressed data consists of point_R in (X:Z) coordinates and the curve paramater param_A in GF(p751^2).
   // Output: a shared secret SharedSecretA that consists of one element in GF(p751^2). 
   // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
-    unsigned int pwords = NBITS_TO_NWORDS(CurveIsogeny->pwordbits);
-    unsigned int i, row, m, index = 0, pts_index[MAX_INT_POINTS_ALICE], npts = 0; 
-    point_proj_t R, pts[MAX_INT_POINTS_ALICE];
-    f2elm_t jinv, coeff[5], A, C = {0};
+    unsigned int pwords;
+    point_proj_t R;
+    f2elm_t A, C = {0};
 
-    if (PrivateKeyA == NULL || SharedSecretA == NULL || is_CurveIsogenyStruct_null(CurveIsogeny)) {
+    if (PrivateKeyA == NULL || point_R == NULL || param_A == NULL || SharedSecretA == NULL || is_CurveIsogenyStruct_null(CurveIsogeny)) {
         return CRYPTO_ERROR_INVALID_PARAMETER;
     }
+    pwords = NBITS_TO_NWORDS(CurveIsogeny->pwordbits);
     
-    fp2copy751((((point_proj_t*)point_R)[0])->X, R->X);
-    fp2copy751((((point_proj_t*)point_R)[0])->Z, R->Z);
+    load_words(point_R, (digit_t*)R, 2*2*NWORDS_FIELD);                                   // The caller's buffers are only read with memcpy (see load_words())
+    load_words(param_A, (digit_t*)A, 2*NWORDS_FIELD);
     fpcopy751(CurveIsogeny->C, C[0]);
     to_mont(C[0], C[0]);
-    first_4_isog(R, (felm_t*)param_A, A, C, CurveIsogeny); 
-        
-    index = 0;  
-    for (row = 1; row < MAX_Alice; row++) {
-        while (index < MAX_Alice-row) {
-            fp2copy751(R->X, pts[npts]->X);
-            fp2copy751(R->Z, pts[npts]->Z);
-            pts_index[npts] = index;
-            npts += 1;
-            m = splits_Alice[MAX_Alice-index-row];
-            xDBLe(R, R, A, C, (int)(2*m));
-            index += m;
-        }
-        get_4_isog(R, A, C, coeff);        
-
-        for (i = 0; i < npts; i++) {
-            eval_4_isog(pts[i], coeff);
-        }
-
-        fp2copy751(pts[npts-1]->X, R->X); 
-        fp2copy751(pts[npts-1]->Z, R->Z);
-        index = pts_index[npts-1];
-        npts -= 1;
-    }
-    
-    get_4_isog(R, A, C, coeff); 
-    j_inv(A, C, jinv);
-    from_fp2mont(jinv, (felm_t*)SharedSecretA);      // Converting back to standard representation
+    agreement_compressed_A(R, A, C, SharedSecretA, CurveIsogeny);
 
 // Cleanup:
     clear_words((void*)R, 2*2*pwords);
-    clear_words((void*)pts, MAX_INT_POINTS_ALICE*2*2*pwords);
     clear_words((void*)A, 2*pwords);
-    clear_words((void*)C, 2*pwords);
-    clear_words((void*)jinv, 2*pwords);
-    clear_words((void*)coeff, 5*2*pwords);
       
     return CRYPTO_SUCCESS;
 }
 
 
-void PublicKeyCompression_B(const unsigned char* PublicKeyB, unsigned char* CompressedPKB, PCurveIsogenyStruct CurveIsogeny)
-{ // Bob's public key compression
-  // It produces a compressed output that consists of three elements in Z_orderA and one field element
-  // Input : Bob's public key PublicKeyB, which consists of 3 elements in GF(p751^2).
-  // Output: a compressed value CompressedPKB that consists of three elements in Z_orderA and one element in GF(p751^2). 
-  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().                                                       
-    point_full_proj_t P, Q, phP, phQ, phX;
+static CRYPTO_STATUS compress_B(const point_full_proj_t phP, const point_full_proj_t phQ, f2elm_t A, unsigned char* CompressedPKB, PCurveIsogenyStruct CurveIsogeny)
+{ // Core of Bob's public key compression
+  // Input : the points phP and phQ of the public key with recovered y-coordinates, and the constant A of their curve, all in Montgomery representation.
+  // Output: the compressed value CompressedPKB. A is overwritten.
+#if defined(SIDH_BOUNDED_STACK)
+    PSIDH_workspace ws = SIDH_WORKSPACE(CurveIsogeny);
+    point_full_proj *P = ws->P, *Q = ws->Q;
+    point_affine *R1 = ws->R1, *R2 = ws->R2, *phiP = ws->phiP, *phiQ = ws->phiQ;
+#else
+    point_full_proj_t P, Q;
     point_t R1, R2, phiP, phiQ;
-    publickey_t PK;
-    digit_t* comp = (digit_t*)CompressedPKB;
+#endif
+    digit_t comp[3*NWORDS_ORDER];
 	digit_t inv[NWORDS_ORDER];
-    f2elm_t A, vec[4], Zinv[4];
-    digit_t a0[NWORDS_ORDER], b0[NWORDS_ORDER], a1[NWORDS_ORDER], b1[NWORDS_ORDER], tmp[2*NWORDS_ORDER], mask = (digit_t)(-1);
+    f2elm_t vec[4], Zinv[4];
+    digit_t a0[NWORDS_ORDER], b0[NWORDS_ORDER], a1[NWORDS_ORDER], b1[NWORDS_ORDER], mask = (digit_t)(-1);
+    CRYPTO_STATUS Status;
     
     mask >>= (CurveIsogeny->owordbits - CurveIsogeny->oAbits);  
-    to_fp2mont(((f2elm_t*)PublicKeyB)[0], ((f2elm_t*)&PK)[0]);    // Converting to Montgomery representation
-    to_fp2mont(((f2elm_t*)PublicKeyB)[1], ((f2elm_t*)&PK)[1]); 
-    to_fp2mont(((f2elm_t*)PublicKeyB)[2], ((f2elm_t*)&PK)[2]); 
 
-    recover_y(PK, phP, phQ, phX, A, CurveIsogeny);
-    generate_2_torsion_basis(A, P, Q, CurveIsogeny);
+    generate_2_torsion_basis_entangled(A, P, Q, CurveIsogeny);
     fp2copy751(P->Z, vec[0]);
     fp2copy751(Q->Z, vec[1]);
     fp2copy751(phP->Z, vec[2]);
@@ -615,99 +1041,230 @@ void PublicKeyCompression_B(const unsigned char* PublicKeyB, unsigned char* Comp
     fp2mul751_mont(phQ->X, Zinv[3], phiQ->x);
     fp2mul751_mont(phQ->Y, Zinv[3], phiQ->y);
 
-    ph2(phiP, phiQ, R1, R2, A, (uint64_t*)a0, (uint64_t*)b0, (uint64_t*)a1, (uint64_t*)b1, CurveIsogeny);
+    Status = ph2(phiP, phiQ, R1, R2, A, (uint64_t*)a0, (uint64_t*)b0, (uint64_t*)a1, (uint64_t*)b1, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        return Status;
+    }
 
     if ((a0[0] & 1) == 1) {  // Storing [b1*a0inv, a1*a0inv, b0*a0inv] and setting bit384 to 0
         inv_mod_orderA(a0, inv);        
-		multiply(b0, inv, tmp, NWORDS_ORDER);
-		copy_words(tmp, &comp[0], NWORDS_ORDER);
+		mp_mul_low(b0, inv, &comp[0], NWORDS_ORDER);
 		comp[NWORDS_ORDER-1] &= mask;
-		multiply(a1, inv, tmp, NWORDS_ORDER);
-		copy_words(tmp, &comp[NWORDS_ORDER], NWORDS_ORDER);
+		mp_mul_low(a1, inv, &comp[NWORDS_ORDER], NWORDS_ORDER);
 		comp[2*NWORDS_ORDER-1] &= mask;
-		multiply(b1, inv, tmp, NWORDS_ORDER);
-		copy_words(tmp, &comp[2 * NWORDS_ORDER], NWORDS_ORDER);
+		mp_mul_low(b1, inv, &comp[2 * NWORDS_ORDER], NWORDS_ORDER);
 		comp[3*NWORDS_ORDER-1] &= mask;
     } else {  // Storing [b1*b0inv, a1*b0inv, a0*b0inv] and setting bit384 to 1
 		inv_mod_orderA(b0, inv);
-		multiply(a0, inv, tmp, NWORDS_ORDER);
-		copy_words(tmp, &comp[0], NWORDS_ORDER);
+		mp_mul_low(a0, inv, &comp[0], NWORDS_ORDER);
 		comp[NWORDS_ORDER - 1] &= mask;
-		multiply(a1, inv, tmp, NWORDS_ORDER);
-		copy_words(tmp, &comp[NWORDS_ORDER], NWORDS_ORDER);
+		mp_mul_low(a1, inv, &comp[NWORDS_ORDER], NWORDS_ORDER);
 		comp[2*NWORDS_ORDER-1] &= mask;
-		multiply(b1, inv, tmp, NWORDS_ORDER);
-		copy_words(tmp, &comp[2 * NWORDS_ORDER], NWORDS_ORDER);
+		mp_mul_low(b1, inv, &comp[2 * NWORDS_ORDER], NWORDS_ORDER);
 		comp[3*NWORDS_ORDER-1] &= mask;
 		comp[3*NWORDS_ORDER-1] |= (digit_t)1 << (sizeof(digit_t)*8 - 1);
     }
     
-    from_fp2mont(A, (felm_t*)&comp[3*NWORDS_ORDER]);  // Converting back from Montgomery representation
+    from_fp2mont(A, A);                                                                   // Converting back from Montgomery representation
+    store_words(comp, CompressedPKB, 3*NWORDS_ORDER);                                     // The caller's buffer is only written with memcpy (see store_words())
+    store_words((digit_t*)A, &CompressedPKB[3*NWORDS_ORDER*sizeof(digit_t)], 2*NWORDS_FIELD);
+
+    return CRYPTO_SUCCESS;
 }
 
 
-void PublicKeyBDecompression_A(const unsigned char* SecretKeyA, const unsigned char* CompressedPKB, unsigned char* point_R, unsigned char* param_A, PCurveIsogenyStruct CurveIsogeny)
-{ // Bob's public key value decompression computed by Alice
-  // Inputs: Alice's private key SecretKeyA, and
-  //         Bob's compressed public key data CompressedPKB, which consists of three elements in Z_orderA and one element in GF(p751^2).
-  // Output: a point point_R in coordinates (X:Z) and the curve parameter param_A in GF(p751^2). Outputs are stored in Montgomery representation.
-  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().                                                                                           
-    point_t R1, R2;
-    point_proj_t* R = (point_proj_t*)point_R;
+CRYPTO_STATUS PublicKeyCompression_Checked_B(const unsigned char* PublicKeyB, unsigned char* CompressedPKB, PCurveIsogenyStruct CurveIsogeny)
+{ // Bob's public key compression with validation of the public key
+  // It produces the same compressed output as PublicKeyCompression_B(), i.e., three elements in Z_orderA and one element in GF(p751^2).
+  // Returns CRYPTO_ERROR_PUBLIC_KEY_VALIDATION if a coordinate of PublicKeyB is not a valid wire encoding (see SIDH_curve_set_encoding()),
+  // and CRYPTO_ERROR_NO_MEMORY if the lookup tables cannot be allocated. CompressedPKB is zeroed on failure.
+  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+#if defined(SIDH_BOUNDED_STACK)
+    PSIDH_workspace ws = SIDH_WORKSPACE(CurveIsogeny);
+    point_full_proj *phP = ws->phP, *phQ = ws->phQ, *phX = ws->phX;
+    f2elm_t* PK = ws->PK;
+#else
+    point_full_proj_t phP, phQ, phX;
+    publickey_t PK;
+#endif
+    f2elm_t A;
+    unsigned int valid, encoding;
+    CRYPTO_STATUS Status = CRYPTO_ERROR_PUBLIC_KEY_VALIDATION;
+
+    if (PublicKeyB == NULL || CompressedPKB == NULL || is_CurveIsogenyStruct_null(CurveIsogeny)) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    encoding = SIDH_DISPATCH(CurveIsogeny)->encoding;
+
+    valid  = fp2_decode_bytes(&PublicKeyB[0], ((f2elm_t*)PK)[0], encoding);                     // Converting to Montgomery representation
+    valid &= fp2_decode_bytes(&PublicKeyB[sizeof(f2elm_t)], ((f2elm_t*)PK)[1], encoding);
+    valid &= fp2_decode_bytes(&PublicKeyB[2*sizeof(f2elm_t)], ((f2elm_t*)PK)[2], encoding);
+
+    if (valid != 0) {
+        recover_y(PK, phP, phQ, phX, A, CurveIsogeny);
+        Status = compress_B(phP, phQ, A, CompressedPKB, CurveIsogeny);
+    }
+    if (Status != CRYPTO_SUCCESS) {                                                           // No partial output for an invalid key or if the lookup tables cannot be allocated
+        memset(CompressedPKB, 0, 3*((CurveIsogeny->owordbits + 7)/8) + 2*((CurveIsogeny->pwordbits + 7)/8));
+    }
+    return Status;
+}
+
+
+void PublicKeyCompression_B(const unsigned char* PublicKeyB, unsigned char* CompressedPKB, PCurveIsogenyStruct CurveIsogeny)
+{ // Bob's public key compression
+  // It produces a compressed output that consists of three elements in Z_orderA and one field element
+  // Input : Bob's public key PublicKeyB, which consists of 3 elements in GF(p751^2).
+  // Output: a compressed value CompressedPKB that consists of three elements in Z_orderA and one element in GF(p751^2). 
+  //         The output is all zero if PublicKeyB is invalid or the lookup tables cannot be allocated; PublicKeyCompression_Checked_B() reports the error.
+  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+    PublicKeyCompression_Checked_B(PublicKeyB, CompressedPKB, CurveIsogeny);
+}
+
+
+CRYPTO_STATUS EphemeralKeyGeneration_Compressed_B(unsigned char* PrivateKeyB, unsigned char* CompressedPKB, PCurveIsogenyStruct CurveIsogeny)
+{ // Bob's ephemeral key-pair generation with a compressed public key
+  // It produces a private key PrivateKeyB as EphemeralKeyGeneration_B() does and directly outputs the compressed public key CompressedPKB, 
+  // which is identical to the output of PublicKeyCompression_B() on the uncompressed public key.
+  // The curve constant comes from the isogeny evaluation instead of get_A(), and a single inversion of Z(phiD)*C replaces 
+  // the 3-way normalization and the inversion in get_A().
+  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+    unsigned int pwords = NBITS_TO_NWORDS(CurveIsogeny->pwordbits);
+#if defined(SIDH_BOUNDED_STACK)
+    PSIDH_workspace ws = SIDH_WORKSPACE(CurveIsogeny);
+    point_full_proj *phP = ws->phP, *phQ = ws->phQ, *phX = ws->phX;
+    point_proj *phiP = ws->phiK[0], *phiQ = ws->phiK[1], *phiD = ws->phiK[2];
+#else
+    point_full_proj_t phP, phQ, phX;
+    point_proj_t phiP = {0}, phiQ = {0}, phiD = {0};
+#endif
+    f2elm_t A = {0}, C = {0}, t;
+    CRYPTO_STATUS Status = CRYPTO_ERROR_UNKNOWN; 
+
+    if (PrivateKeyB == NULL || CompressedPKB == NULL || is_CurveIsogenyStruct_null(CurveIsogeny)) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }  
+
+    Status = keygen_B(PrivateKeyB, phiP, phiQ, phiD, A, C, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        return Status;
+    }
+
+    fp2mul751_mont(phiD->Z, C, t);                   // t = Z(phiD)*C
+    fp2inv751_mont(t);                               // t = 1/(Z(phiD)*C)
+    fp2mul751_mont(phiD->X, C, phiD->X);
+    fp2mul751_mont(phiD->X, t, phiD->X);             // x(phiD) = X(phiD)/Z(phiD)
+    fp2mul751_mont(A, phiD->Z, A);
+    fp2mul751_mont(A, t, A);                         // A = A/C
+
+    recover_y_proj(phiP, phiQ, phiD->X, A, phP, phQ, phX, CurveIsogeny);
+    Status = compress_B(phP, phQ, A, CompressedPKB, CurveIsogeny);
+
+// Cleanup:
+    clear_words((void*)phiP, 2*2*pwords);
+    clear_words((void*)phiQ, 2*2*pwords);
+    clear_words((void*)phiD, 2*2*pwords);
+    clear_words((void*)A, 2*pwords);
+    clear_words((void*)C, 2*pwords);
+    clear_words((void*)t, 2*pwords);
+
+    return Status;
+}
+
+
+static void decompress_PKB(const unsigned char* SecretKeyA, const unsigned char* CompressedPKB, point_proj_t R, f2elm_t A, PCurveIsogenyStruct CurveIsogeny)
+{ // Decompression of Bob's public key by Alice into the kernel point R = (X:Z) and the curve constant A, both in Montgomery representation.
+  // CompressedPKB is left untouched. Only the basis point that is multiplied by the scalar is normalized, the other one stays projective.
+#if defined(SIDH_BOUNDED_STACK)
+    PSIDH_workspace ws = SIDH_WORKSPACE(CurveIsogeny);
+    point_full_proj *P = ws->P, *Q = ws->Q;
+    point_affine *S = ws->R1;
+#else
     point_full_proj_t P, Q;
-    digit_t* comp = (digit_t*)CompressedPKB;
-    f2elm_t A24, vec[2], invs[2], one = {0};
-    felm_t* A = (felm_t*)param_A;
-    digit_t tmp1[2*NWORDS_ORDER], tmp2[2*NWORDS_ORDER], vone[2*NWORDS_ORDER] = {0}, mask = (digit_t)(-1);
+    point_t S;
+#endif
+    point_full_proj *RP, *SP;
+    digit_t comp[3*NWORDS_ORDER], SKin[NWORDS_ORDER];
+    f2elm_t A24, inv, one = {0};
+    digit_t tmp1[NWORDS_ORDER], tmp2[NWORDS_ORDER], c2[NWORDS_ORDER], vone[NWORDS_ORDER] = {0}, mask = (digit_t)(-1);
+    digit_t *cn, *cd;
     unsigned int bit;
 
     mask >>= (CurveIsogeny->owordbits - CurveIsogeny->oAbits);  
     vone[0] = 1;
     fpcopy751(CurveIsogeny->Montgomery_one, one[0]);
-    to_fp2mont((felm_t*)&comp[3*NWORDS_ORDER], A);    // Converting to Montgomery representation
-    generate_2_torsion_basis(A, P, Q, CurveIsogeny);
+    load_words(CompressedPKB, comp, 3*NWORDS_ORDER);                                       // The caller's buffers are only read with memcpy (see load_words())
+    load_words(SecretKeyA, SKin, NWORDS_ORDER);
+    load_words(&CompressedPKB[3*NWORDS_ORDER*sizeof(digit_t)], (digit_t*)A, 2*NWORDS_FIELD);
+    to_fp2mont(A, A);                                 // Converting to Montgomery representation
+    generate_2_torsion_basis_entangled(A, P, Q, CurveIsogeny);
 
-    // normalize basis points
-    fp2copy751(P->Z, vec[0]);
-    fp2copy751(Q->Z, vec[1]);
-    mont_n_way_inv(vec, 2, invs);
-    fp2mul751_mont(P->X, invs[0], R1->x);
-    fp2mul751_mont(P->Y, invs[0], R1->y);
-    fp2mul751_mont(Q->X, invs[1], R2->x);
-    fp2mul751_mont(Q->Y, invs[1], R2->y);
+    bit = comp[3*NWORDS_ORDER-1] >> (sizeof(digit_t)*8 - 1);   
+    copy_words(&comp[2*NWORDS_ORDER], c2, NWORDS_ORDER);
+    c2[NWORDS_ORDER-1] &= (digit_t)(-1) >> 1;               // Strip the flag bit from a copy, the input buffer stays intact
+    if (bit == 0) {                                         // R = P + a*Q with a = (c0 + SK*c2)/(1 + SK*c1)
+        RP = P; SP = Q; cn = c2; cd = &comp[NWORDS_ORDER];
+    } else {                                                // R = Q + a*P with a = (c0 + SK*c1)/(1 + SK*c2)
+        RP = Q; SP = P; cn = &comp[NWORDS_ORDER]; cd = c2;
+    }
+
+    // Normalize the basis point used in the ladder. The basis only depends on the public A, so the variable-time inversion is fine
+    fp2copy751(SP->Z, inv);
+    fp2inv751_mont_bingcd(inv);
+    fp2mul751_mont(SP->X, inv, S->x);
+    fp2mul751_mont(SP->Y, inv, S->y);
 
     fp2add751(A, one, A24);
     fp2add751(A24, one, A24);
     fp2div2_751(A24, A24);
     fp2div2_751(A24, A24);
 
-    bit = comp[3*NWORDS_ORDER-1] >> (sizeof(digit_t)*8 - 1);   
-    comp[3*NWORDS_ORDER-1] &= (digit_t)(-1) >> 1;
-
-    if (bit == 0) {
-		multiply((digit_t*)SecretKeyA, &comp[NWORDS_ORDER], tmp1, NWORDS_ORDER);
-        mp_add(tmp1, vone, tmp1, NWORDS_ORDER);
-		tmp1[NWORDS_ORDER-1] &= mask;
-        inv_mod_orderA(tmp1, tmp2);  
-		multiply((digit_t*)SecretKeyA, &comp[2*NWORDS_ORDER], tmp1, NWORDS_ORDER);
-        mp_add(&comp[0], tmp1, tmp1, NWORDS_ORDER);  
-		multiply(tmp1, tmp2, vone, NWORDS_ORDER);  
-		vone[NWORDS_ORDER-1] &= mask;  
-        mont_twodim_scalarmult(vone, R1, R2, A, A24, P, CurveIsogeny);
-    } else {
-		multiply((digit_t*)SecretKeyA, &comp[2*NWORDS_ORDER], tmp1, NWORDS_ORDER);
-        mp_add(tmp1, vone, tmp1, NWORDS_ORDER);
-		tmp1[NWORDS_ORDER-1] &= mask;
-        inv_mod_orderA(tmp1, tmp2);  
-		multiply((digit_t*)SecretKeyA, &comp[NWORDS_ORDER], tmp1, NWORDS_ORDER);
-        mp_add(&comp[0], tmp1, tmp1, NWORDS_ORDER);  
-		multiply(tmp1, tmp2, vone, NWORDS_ORDER);  
-		vone[NWORDS_ORDER-1] &= mask;   
-        mont_twodim_scalarmult(vone, R2, R1, A, A24, P, CurveIsogeny);
-    }
+	mp_mul_low(SKin, cd, tmp1, NWORDS_ORDER);
+    mp_add(tmp1, vone, tmp1, NWORDS_ORDER);
+	tmp1[NWORDS_ORDER-1] &= mask;
+    inv_mod_orderA(tmp1, tmp2);  
+	mp_mul_low(SKin, cn, tmp1, NWORDS_ORDER);
+    mp_add(&comp[0], tmp1, tmp1, NWORDS_ORDER);  
+	mp_mul_low(tmp1, tmp2, vone, NWORDS_ORDER);  
+	vone[NWORDS_ORDER-1] &= mask;  
+    mont_twodim_scalarmult_xz(vone, RP, S, A, A24, CurveIsogeny->oAbits, R, CurveIsogeny);
+
+// Cleanup:
+    clear_words((void*)SKin, NWORDS_ORDER);
+}
+
+
+void PublicKeyBDecompression_A(const unsigned char* SecretKeyA, const unsigned char* CompressedPKB, unsigned char* point_R, unsigned char* param_A, PCurveIsogenyStruct CurveIsogeny)
+{ // Bob's public key value decompression computed by Alice
+  // Inputs: Alice's private key SecretKeyA, and
+  //         Bob's compressed public key data CompressedPKB, which consists of three elements in Z_orderA and one element in GF(p751^2).
+  // Output: a point point_R in coordinates (X:Z) and the curve parameter param_A in GF(p751^2). Outputs are stored in Montgomery representation.
+  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().                                                                                           
+    unsigned int pwords = NBITS_TO_NWORDS(CurveIsogeny->pwordbits);
+    point_proj_t R;
+    f2elm_t A;
 
-    fp2copy751(P->X, R[0]->X);               
-    fp2copy751(P->Z, R[0]->Z);
+    decompress_PKB(SecretKeyA, CompressedPKB, R, A, CurveIsogeny);
+    store_words((digit_t*)R, point_R, 2*2*NWORDS_FIELD);                                  // The caller's buffers are only written with memcpy (see store_words())
+    store_words((digit_t*)A, param_A, 2*NWORDS_FIELD);
+
+// Cleanup:
+    clear_words((void*)R, 2*2*pwords);
+    clear_words((void*)A, 2*pwords);
+}
+
+static void agreement_compressed_B(point_proj_t R, f2elm_t A, f2elm_t C, unsigned char* SharedSecretB, PCurveIsogenyStruct CurveIsogeny)
+{ // Bob's shared secret from Alice's decompressed kernel point R and curve (A:C), all in Montgomery representation. R, A and C are overwritten.
+    unsigned int pwords = NBITS_TO_NWORDS(CurveIsogeny->pwordbits);
+    f2elm_t jinv;
+
+    isogeny_tree_B(R, A, C, NULL, NULL, NULL, CurveIsogeny);
+    j_inv(A, C, jinv);
+    fp2_encode_bytes(jinv, SharedSecretB, SIDH_DISPATCH(CurveIsogeny)->encoding);    // Converting to the wire encoding
+
+// Cleanup:
+    clear_words((void*)C, 2*pwords);
+    clear_words((void*)jinv, 2*pwords);
 }
 
 
@@ -718,54 +1275,84 @@ CRYPTO_STATUS EphemeralSecretAgreement_Compression_B(const unsigned char* Privat
   //         Alice's decompressed data consists of point_R in (X:Z) coordinates and the curve paramater param_A in GF(p751^2).
   // Output: a shared secret SharedSecretB that consists of one element in GF(p751^2). 
   // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
-    unsigned int pwords = NBITS_TO_NWORDS(CurveIsogeny->pwordbits);
-    unsigned int i, row, m, index = 0, pts_index[MAX_INT_POINTS_BOB], npts = 0; 
-    point_proj_t R, pts[MAX_INT_POINTS_BOB];
-    f2elm_t jinv, A, C = {0};
+    unsigned int pwords;
+    point_proj_t R;
+    f2elm_t A, C = {0};
 
-    if (PrivateKeyB == NULL || SharedSecretB == NULL || is_CurveIsogenyStruct_null(CurveIsogeny)) {
+    if (PrivateKeyB == NULL || point_R == NULL || param_A == NULL || SharedSecretB == NULL || is_CurveIsogenyStruct_null(CurveIsogeny)) {
         return CRYPTO_ERROR_INVALID_PARAMETER;
     }
+    pwords = NBITS_TO_NWORDS(CurveIsogeny->pwordbits);
     
-    fp2copy751((((point_proj_t*)point_R)[0])->X, R->X);
-    fp2copy751((((point_proj_t*)point_R)[0])->Z, R->Z);
-    fp2copy751((felm_t*)param_A, A);
+    load_words(point_R, (digit_t*)R, 2*2*NWORDS_FIELD);                                   // The caller's buffers are only read with memcpy (see load_words())
+    load_words(param_A, (digit_t*)A, 2*NWORDS_FIELD);
     fpcopy751(CurveIsogeny->C, C[0]);
     to_mont(C[0], C[0]);
-    
-    index = 0;  
-    for (row = 1; row < MAX_Bob; row++) {
-        while (index < MAX_Bob-row) {
-            fp2copy751(R->X, pts[npts]->X);
-            fp2copy751(R->Z, pts[npts]->Z);
-            pts_index[npts] = index;
-            npts += 1;
-            m = splits_Bob[MAX_Bob-index-row];
-            xTPLe(R, R, A, C, (int)m);
-            index += m;
-        }
-        get_3_isog(R, A, C);        
+    agreement_compressed_B(R, A, C, SharedSecretB, CurveIsogeny);
+
+// Cleanup:
+    clear_words((void*)R, 2*2*pwords);
+    clear_words((void*)A, 2*pwords);
+      
+    return CRYPTO_SUCCESS;
+}
+
 
-        for (i = 0; i < npts; i++) {
-            eval_3_isog(R, pts[i]);
-        } 
+CRYPTO_STATUS EphemeralSecretAgreement_FromCompressed_A(const unsigned char* PrivateKeyA, const unsigned char* CompressedPKB, unsigned char* SharedSecretA, PCurveIsogenyStruct CurveIsogeny)
+{ // Alice's ephemeral shared secret computation straight from Bob's compressed public key
+  // It is equivalent to PublicKeyBDecompression_A followed by EphemeralSecretAgreement_Compression_A, but the kernel point R = (X:Z) and the curve 
+  // (A:C) stay projective in Montgomery representation from the decompression through to the isogeny walk, without going through the point_R and 
+  // param_A buffers. The decompressed curve has C = 1, so the constant is taken as is instead of being converted again.
+  // Inputs: Alice's PrivateKeyA is an even integer in the range [2, oA-2], where oA = 2^372. 
+  //         Bob's compressed public key data CompressedPKB, which consists of three elements in Z_orderA and one element in GF(p751^2).
+  // Output: a shared secret SharedSecretA that consists of one element in GF(p751^2). 
+  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+    unsigned int pwords;
+    point_proj_t R;
+    f2elm_t A, C = {0};
 
-        fp2copy751(pts[npts-1]->X, R->X); 
-        fp2copy751(pts[npts-1]->Z, R->Z);
-        index = pts_index[npts-1];
-        npts -= 1;
+    if (PrivateKeyA == NULL || CompressedPKB == NULL || SharedSecretA == NULL || is_CurveIsogenyStruct_null(CurveIsogeny)) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
     }
-    
-    get_3_isog(R, A, C);    
-    j_inv(A, C, jinv);
-    from_fp2mont(jinv, (felm_t*)SharedSecretB);      // Converting back to standard representation
+    pwords = NBITS_TO_NWORDS(CurveIsogeny->pwordbits);
+
+    decompress_PKB(PrivateKeyA, CompressedPKB, R, A, CurveIsogeny);
+    fpcopy751(CurveIsogeny->Montgomery_one, C[0]);
+    agreement_compressed_A(R, A, C, SharedSecretA, CurveIsogeny);
+
+// Cleanup:
+    clear_words((void*)R, 2*2*pwords);
+    clear_words((void*)A, 2*pwords);
+      
+    return CRYPTO_SUCCESS;
+}
+
+
+CRYPTO_STATUS EphemeralSecretAgreement_FromCompressed_B(const unsigned char* PrivateKeyB, const unsigned char* CompressedPKA, unsigned char* SharedSecretB, PCurveIsogenyStruct CurveIsogeny)
+{ // Bob's ephemeral shared secret computation straight from Alice's compressed public key
+  // It is equivalent to PublicKeyADecompression_B followed by EphemeralSecretAgreement_Compression_B, but the kernel point R = (X:Z) and the curve 
+  // (A:C) stay projective in Montgomery representation from the decompression through to the isogeny walk, without going through the point_R and 
+  // param_A buffers. The decompressed curve has C = 1, so the constant is taken as is instead of being converted again.
+  // Inputs: Bob's PrivateKeyB is an integer in the range [1, oB-1], where oB = 3^239. 
+  //         Alice's compressed public key data CompressedPKA, which consists of three elements in Z_orderB and one element in GF(p751^2).
+  // Output: a shared secret SharedSecretB that consists of one element in GF(p751^2). 
+  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+    unsigned int pwords;
+    point_proj_t R;
+    f2elm_t A, C = {0};
+
+    if (PrivateKeyB == NULL || CompressedPKA == NULL || SharedSecretB == NULL || is_CurveIsogenyStruct_null(CurveIsogeny)) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    pwords = NBITS_TO_NWORDS(CurveIsogeny->pwordbits);
+
+    decompress_PKA(PrivateKeyB, CompressedPKA, R, A, CurveIsogeny);
+    fpcopy751(CurveIsogeny->Montgomery_one, C[0]);
+    agreement_compressed_B(R, A, C, SharedSecretB, CurveIsogeny);
 
 // Cleanup:
     clear_words((void*)R, 2*2*pwords);
-    clear_words((void*)pts, MAX_INT_POINTS_BOB*2*2*pwords);
     clear_words((void*)A, 2*pwords);
-    clear_words((void*)C, 2*pwords);
-    clear_words((void*)jinv, 2*pwords);
       
     return CRYPTO_SUCCESS;
 }
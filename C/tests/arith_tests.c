@@ -23,6 +23,7 @@ extern const unsigned int splits_Bob[MAX_Bob];
 #if defined(GENERIC_IMPLEMENTATION) 
     #define BENCH_LOOPS           100       // Number of iterations per bench
     #define SMALL_BENCH_LOOPS     100       // Number of iterations per bench
+    #define LADDER_BENCH_LOOPS     10       // Number of iterations per scalar multiplication bench
     #define TEST_LOOPS             10       // Number of iterations per test
     #define ECPT_TEST_LOOPS         5       // Number of iterations per EC point generation test
     #define ECPAIR_TEST_LOOPS       5       // Number of iterations per pairing test
@@ -31,6 +32,7 @@ extern const unsigned int splits_Bob[MAX_Bob];
 #else
     #define BENCH_LOOPS        100000 
     #define SMALL_BENCH_LOOPS   10000       
+    #define LADDER_BENCH_LOOPS    100       
     #define TEST_LOOPS            100       
     #define ECPT_TEST_LOOPS        20       
     #define ECPAIR_TEST_LOOPS      20       
@@ -560,6 +562,67 @@ bool fp2_run()
 }
 
 
+static void ladder_3_pt_rl(const point_proj_t P, const point_proj_t Q, const point_proj_t PQ, const digit_t* m, const f2elm_t A24, const unsigned int order_bits, point_proj_t W)
+{ // Computes P+[m]Q via a right-to-left x-only ladder that scans the order_bits least significant bits of m. 
+  // Every step is one xDBLADD with a projective difference plus one multiplication, so none of the inputs has to be normalized.
+  // Benchmarked against the decompression path mont_twodim_scalarmult(), which it does not beat (see there), so it is not part of the library.
+  // Input:  projective x-coordinates of P, Q and PQ = P-Q, and Montgomery curve constant A24=(A+2)/4.
+  // Output: projective Montgomery x-coordinates of x(P+[m]Q)=WX/WZ
+    point_proj_t R0, R2;
+    unsigned int i, bit, prevbit = 0;
+    digit_t mask;
+
+    fp2copy751(Q->X, R0->X);
+    fp2copy751(Q->Z, R0->Z);
+    fp2copy751(PQ->X, R2->X);
+    fp2copy751(PQ->Z, R2->Z);
+    fp2copy751(P->X, W->X);
+    fp2copy751(P->Z, W->Z);
+
+    for (i = 0; i < order_bits; i++) {
+        bit = (unsigned int)((m[i/RADIX] >> (i % RADIX)) & 1);
+        mask = 0 - (digit_t)(bit ^ prevbit);
+        prevbit = bit;
+
+        swap_points(W, R2, mask);
+        xDBLADD(R0, R2, W->X, A24);                // R0 <- 2*R0 and R2 <- R0+R2, with the difference W = (WX:WZ) in projective form
+        fp2mul751_mont(R2->X, W->Z, R2->X);
+    }
+    mask = 0 - (digit_t)prevbit;
+    swap_points(W, R2, mask);
+}
+
+
+static void basis_x_only(const point_full_proj_t P, const point_full_proj_t Q, const f2elm_t A, point_proj_t xP, point_proj_t xQ, point_proj_t xPQ)
+{ // Drops the y-coordinates of the basis points P and Q and computes x(P-Q) in projective form, without any inversion.
+  // Input:  projective points P = (XP:YP:ZP) and Q = (XQ:YQ:ZQ) on the Montgomery curve y^2 = x^3+A*x^2+x.
+  // Output: xP = (XP:ZP), xQ = (XQ:ZQ) and xPQ = x(P-Q).
+  // With D = XP*ZQ-XQ*ZP and N = YP*ZQ+YQ*ZP, the slope through P and -Q is N/D and x(P-Q) = N^2/D^2-A-xP-xQ.
+    f2elm_t t0, t1, t2, t3;
+
+    fp2mul751_mont(P->X, Q->Z, t0);                  // t0 = XP*ZQ
+    fp2mul751_mont(Q->X, P->Z, t1);                  // t1 = XQ*ZP
+    fp2sub751(t0, t1, t2);                           // t2 = D
+    fp2add751(t0, t1, t3);                           // t3 = XP*ZQ+XQ*ZP
+    fp2mul751_mont(P->Y, Q->Z, t0);                  // t0 = YP*ZQ
+    fp2mul751_mont(Q->Y, P->Z, t1);                  // t1 = YQ*ZP
+    fp2add751(t0, t1, t0);                           // t0 = N
+    fp2mul751_mont(P->Z, Q->Z, t1);                  // t1 = ZP*ZQ
+    fp2sqr751_mont(t0, t0);                          // t0 = N^2
+    fp2sqr751_mont(t2, t2);                          // t2 = D^2
+    fp2mul751_mont(t0, t1, t0);                      // t0 = N^2*ZP*ZQ
+    fp2mul751_mont(t2, t1, xPQ->Z);                  // ZPQ = D^2*ZP*ZQ
+    fp2mul751_mont(A, t1, t1);                       // t1 = A*ZP*ZQ
+    fp2add751(t1, t3, t1);                           // t1 = A*ZP*ZQ+XP*ZQ+XQ*ZP
+    fp2mul751_mont(t2, t1, t1);                      // t1 = D^2*(A*ZP*ZQ+XP*ZQ+XQ*ZP)
+    fp2sub751(t0, t1, xPQ->X);                       // XPQ = N^2*ZP*ZQ-D^2*(A*ZP*ZQ+XP*ZQ+XQ*ZP)
+    fp2copy751(P->X, xP->X);
+    fp2copy751(P->Z, xP->Z);
+    fp2copy751(Q->X, xQ->X);
+    fp2copy751(Q->Z, xQ->Z);
+}
+
+
 bool ecisog_run(PCurveIsogenyStaticData CurveIsogenyData)
 {
     bool OK = true;
@@ -567,6 +630,10 @@ bool ecisog_run(PCurveIsogenyStaticData CurveIsogenyData)
     unsigned long long cycles, cycles1, cycles2;
     f2elm_t A24, C24, A4, A, C, Aout, Cout, coeff[5];
     point_proj_t P, Q;
+    point_full_proj_t RS, SS;
+    point_proj_t xR, xS, xRS;
+    point_t R1, R2;
+    f2elm_t vec[2], invs[2];
     PCurveIsogenyStruct CurveIsogeny = {0};
     CRYPTO_STATUS Status = CRYPTO_SUCCESS;
 
@@ -627,6 +694,34 @@ bool ecisog_run(PCurveIsogenyStaticData CurveIsogenyData)
     printf("  4-isogeny evaluation at projective point runs in ................ %7lld ", cycles/BENCH_LOOPS); print_unit;
     printf("\n");
 
+    // 4-isogeny of a projective point with three coefficients
+    cycles = 0;
+    for (n=0; n<BENCH_LOOPS; n++)
+    {
+        fp2random751_test(A); fp2random751_test(C);
+
+        cycles1 = cpucycles(); 
+        get_4_isog_A24(P, A, C, coeff);
+        cycles2 = cpucycles();
+        cycles = cycles+(cycles2-cycles1);
+    }
+    printf("  4-isogeny of projective point (A24 output) runs in .............. %7lld ", cycles/BENCH_LOOPS); print_unit;
+    printf("\n");
+
+    // 4-isogeny evaluation at projective point with three coefficients
+    cycles = 0;
+    for (n=0; n<BENCH_LOOPS; n++)
+    {
+        fp2random751_test(coeff[0]); fp2random751_test(coeff[1]); fp2random751_test(coeff[2]);
+
+        cycles1 = cpucycles(); 
+        eval_4_isog_A24(P, coeff);
+        cycles2 = cpucycles();
+        cycles = cycles+(cycles2-cycles1);
+    }
+    printf("  4-isogeny evaluation with three coefficients runs in ............ %7lld ", cycles/BENCH_LOOPS); print_unit;
+    printf("\n");
+
     // First 4-isogeny of projective point
     cycles = 0;
     for (n=0; n<BENCH_LOOPS; n++)
@@ -641,6 +736,100 @@ bool ecisog_run(PCurveIsogenyStaticData CurveIsogenyData)
     printf("  First 4-isogeny of projective point runs in ..................... %7lld ", cycles/BENCH_LOOPS); print_unit;
     printf("\n");
 
+    // Curve constant from three x-coordinates
+    cycles = 0;
+    for (n=0; n<BENCH_LOOPS; n++)
+    {
+        fp2random751_test(coeff[0]); fp2random751_test(coeff[1]); fp2random751_test(coeff[2]);
+
+        cycles1 = cpucycles(); 
+        get_A(coeff[0], coeff[1], coeff[2], A, CurveIsogeny);
+        cycles2 = cpucycles();
+        cycles = cycles+(cycles2-cycles1);
+    }
+    printf("  Curve constant A from three x-coordinates runs in ............... %7lld ", cycles/BENCH_LOOPS); print_unit;
+    printf("\n");
+
+    // Projective curve constant from three x-coordinates
+    cycles = 0;
+    for (n=0; n<BENCH_LOOPS; n++)
+    {
+        fp2random751_test(coeff[0]); fp2random751_test(coeff[1]); fp2random751_test(coeff[2]);
+
+        cycles1 = cpucycles(); 
+        get_A_proj(coeff[0], coeff[1], coeff[2], A, C, CurveIsogeny);
+        cycles2 = cpucycles();
+        cycles = cycles+(cycles2-cycles1);
+    }
+    printf("  Projective curve constant A/C from three x-coordinates runs in .. %7lld ", cycles/BENCH_LOOPS); print_unit;
+    printf("\n");
+
+    // Three-point ladder
+    cycles = 0;
+    for (n=0; n<LADDER_BENCH_LOOPS; n++)
+    {
+        fp2random751_test(coeff[0]); fp2random751_test(coeff[1]); fp2random751_test(coeff[2]); fp2random751_test(coeff[3]); fp2random751_test(A);
+
+        cycles1 = cpucycles(); 
+        ladder_3_pt(coeff[0], coeff[1], coeff[2], (digit_t*)coeff[3], ALICE, P, A, CurveIsogeny);
+        cycles2 = cpucycles();
+        cycles = cycles+(cycles2-cycles1);
+    }
+    printf("  Three-point ladder runs in ...................................... %7lld ", cycles/LADDER_BENCH_LOOPS); print_unit;
+    printf("\n");
+
+    // Three-point ladder with a projective curve constant
+    cycles = 0;
+    for (n=0; n<LADDER_BENCH_LOOPS; n++)
+    {
+        fp2random751_test(coeff[0]); fp2random751_test(coeff[1]); fp2random751_test(coeff[2]); fp2random751_test(coeff[3]); fp2random751_test(A); fp2random751_test(C);
+
+        cycles1 = cpucycles(); 
+        ladder_3_pt_proj(coeff[0], coeff[1], coeff[2], (digit_t*)coeff[3], ALICE, P, A, C, CurveIsogeny);
+        cycles2 = cpucycles();
+        cycles = cycles+(cycles2-cycles1);
+    }
+    printf("  Three-point ladder with projective A/C runs in .................. %7lld ", cycles/LADDER_BENCH_LOOPS); print_unit;
+    printf("\n");
+
+    // Decompression scalar multiplication R+[a]S with the Montgomery ladder, y-recovery and a full addition, including the normalization of R and S
+    cycles = 0;
+    for (n=0; n<LADDER_BENCH_LOOPS; n++)
+    {
+        fp2random751_test(RS->X); fp2random751_test(RS->Y); fp2random751_test(RS->Z); fp2random751_test(SS->X); fp2random751_test(SS->Y); fp2random751_test(SS->Z); 
+        fp2random751_test(coeff[3]); fp2random751_test(A); fp2random751_test(A24);
+
+        cycles1 = cpucycles(); 
+        fp2copy751(RS->Z, vec[0]);
+        fp2copy751(SS->Z, vec[1]);
+        mont_n_way_inv(vec, 2, invs);
+        fp2mul751_mont(RS->X, invs[0], R1->x);
+        fp2mul751_mont(RS->Y, invs[0], R1->y);
+        fp2mul751_mont(SS->X, invs[1], R2->x);
+        fp2mul751_mont(SS->Y, invs[1], R2->y);
+        mont_twodim_scalarmult((digit_t*)coeff[3], R1, R2, A, A24, CurveIsogeny->oBbits, RS, CurveIsogeny);
+        cycles2 = cpucycles();
+        cycles = cycles+(cycles2-cycles1);
+    }
+    printf("  R+[a]S via Montgomery ladder and y-recovery runs in ............. %7lld ", cycles/LADDER_BENCH_LOOPS); print_unit;
+    printf("\n");
+
+    // Decompression scalar multiplication R+[a]S with the right-to-left three-point ladder, including the computation of x(R-S)
+    cycles = 0;
+    for (n=0; n<LADDER_BENCH_LOOPS; n++)
+    {
+        fp2random751_test(RS->X); fp2random751_test(RS->Y); fp2random751_test(RS->Z); fp2random751_test(SS->X); fp2random751_test(SS->Y); fp2random751_test(SS->Z); 
+        fp2random751_test(coeff[3]); fp2random751_test(A); fp2random751_test(A24);
+
+        cycles1 = cpucycles(); 
+        basis_x_only(RS, SS, A, xR, xS, xRS);
+        ladder_3_pt_rl(xR, xS, xRS, (digit_t*)coeff[3], A24, CurveIsogeny->oBbits, P);
+        cycles2 = cpucycles();
+        cycles = cycles+(cycles2-cycles1);
+    }
+    printf("  R+[a]S via right-to-left three-point ladder runs in ............. %7lld ", cycles/LADDER_BENCH_LOOPS); print_unit;
+    printf("\n");
+
     // Point tripling
     cycles = 0;
     for (n=0; n<BENCH_LOOPS; n++)
@@ -681,6 +870,32 @@ bool ecisog_run(PCurveIsogenyStaticData CurveIsogenyData)
     printf("  3-isogeny evaluation at projective point runs in ................ %7lld ", cycles/BENCH_LOOPS); print_unit;
     printf("\n");
 
+    // 3-isogeny of a projective point with precomputed coefficients
+    cycles = 0;
+    for (n=0; n<BENCH_LOOPS; n++)
+    {
+        fp2random751_test(A); fp2random751_test(C);
+
+        cycles1 = cpucycles(); 
+        get_3_isog_coeff(P, A, C, coeff);
+        cycles2 = cpucycles();
+        cycles = cycles+(cycles2-cycles1);
+    }
+    printf("  3-isogeny of projective point (A24 output) runs in .............. %7lld ", cycles/BENCH_LOOPS); print_unit;
+    printf("\n");
+
+    // 3-isogeny evaluation at projective point with precomputed coefficients
+    cycles = 0;
+    for (n=0; n<BENCH_LOOPS; n++)
+    {
+        cycles1 = cpucycles(); 
+        eval_3_isog_coeff(Q, coeff);
+        cycles2 = cpucycles();
+        cycles = cycles+(cycles2-cycles1);
+    }
+    printf("  3-isogeny evaluation with precomputed coefficients runs in ...... %7lld ", cycles/BENCH_LOOPS); print_unit;
+    printf("\n");
+
 cleanup:
     SIDH_curve_free(CurveIsogeny);
     
@@ -691,12 +906,14 @@ cleanup:
 bool ecpoints_test(PCurveIsogenyStaticData CurveIsogenyData)
 {
 	bool OK = true;
-	unsigned int i;
+	unsigned int i, j, k;
 	unsigned int pbytes = (CurveIsogenyData->pwordbits + 7)/8;      // Number of bytes in a field element 
 	unsigned int obytes = (CurveIsogenyData->owordbits + 7)/8;      // Number of bytes in an element in [1, order]
 	unsigned char *PrivateKeyA, *PublicKeyA, *PrivateKeyB, *PublicKeyB;
 	f2elm_t t0, t1;
 	f2elm_t A, C, zero, one, PK0, PK1, PK2;
+	f2elm_t us[MAX_CUBE_BATCH+3];
+	bool cube, cubes[MAX_CUBE_BATCH+3];
 	point_full_proj_t R1, R2;
 	point_proj_t P1, P2, P3, P4;
 	PCurveIsogenyStruct CurveIsogeny = {0};
@@ -732,91 +949,137 @@ bool ecpoints_test(PCurveIsogenyStaticData CurveIsogenyData)
 	fpcopy751(CurveIsogeny->Montgomery_one, one[0]);
 	fpcopy751(one[0], C[0]);
 
-	// Generating a 2-torsion basis
+	// Cubic residuosity tests, checked against the exponentiation (conj(u)/u)^((p+1)/3) in the cyclotomic subgroup
 	passed = 1;
 	for (i = 0; i < ECPT_TEST_LOOPS; i++)
 	{
-		Status = EphemeralKeyGeneration_A(PrivateKeyA, PublicKeyA, CurveIsogeny);      // Get some value as Alice's secret key and compute Alice's public key
-		if (Status != CRYPTO_SUCCESS) {
-			OK = false;
-			goto cleanup;
+		for (j = 0; j < MAX_CUBE_BATCH+3; j++) {
+			fp2random751_test(t0);
+			to_fp2mont(t0, us[j]);
+			if ((j & 1) == 1) {                                  // Odd entries are cubes
+				fp2sqr751_mont(us[j], t0);
+				fp2mul751_mont(us[j], t0, us[j]);
+			}
 		}
-		to_fp2mont(((f2elm_t*)PublicKeyA)[0], PK0);
-		to_fp2mont(((f2elm_t*)PublicKeyA)[1], PK1);
-		to_fp2mont(((f2elm_t*)PublicKeyA)[2], PK2);
-		get_A(PK0, PK1, PK2, A, CurveIsogeny);
-
-		generate_2_torsion_basis(A, R1, R2, CurveIsogeny);
-
-		fp2copy751(R1->X, P1->X);
-		fp2copy751(R1->Z, P1->Z);
-		fp2copy751(R2->X, P2->X);
-		fp2copy751(R2->Z, P2->Z);
-
-		// Check order of R1 
-		xDBLe(P1, P3, A, C, 371);
-		xDBLe(P3, P1, A, C, 1);
-		fp2correction751(P1->Z);
-		if (fp2compare751(P1->Z, zero) != 0) { printf("R1\n"); passed = 0; break; }
-		// Check order of R2 
-		xDBLe(P2, P4, A, C, 371);
-		xDBLe(P4, P2, A, C, 1);
-		fp2correction751(P2->Z);
-		if (fp2compare751(P2->Z, zero) != 0) { printf("R2\n"); passed = 0; break; }
-		// Check that the order of WeilPairing(R1,R2) is oA
-		fp2mul751_mont(P3->Z, P4->X, t0);
-		fp2mul751_mont(P3->X, P4->Z, t1);
-		fp2sub751(t0, t1, t0);
-		fp2correction751(t0);
-		if (fp2compare751(t0, zero) == 0) { printf("e(R1,R2)\n"); passed = 0; break; }
-
+		is_cube_Fp2_batch(us, cubes, MAX_CUBE_BATCH+3, CurveIsogeny);
+
+		for (j = 0; j < MAX_CUBE_BATCH+3; j++) {
+			fp2copy751(us[j], t0);
+			fp2inv751_mont_bingcd(t0);
+			fp2copy751(us[j], t1);
+			fpneg751(t1[1]);
+			fp2mul751_mont(t0, t1, t0);                         // t0 = conj(u)/u
+			for (k = 0; k < 372; k++) sqr_Fp2_cycl(t0, one[0]);
+			for (k = 0; k < 238; k++) cube_Fp2_cycl(t0, one[0]);
+			fp2correction751(t0);
+			cube = (fp2compare751(t0, one) == 0);
+			if (is_cube_Fp2(us[j], CurveIsogeny) != cube || cubes[j] != cube || ((j & 1) == 1 && cube == false)) { passed = 0; break; }
+		}
+		if (passed == 0) break;
 	}
-	if (passed == 1) printf("  Computing 2-torsion basis tests........................................ PASSED");
-	else { printf("  Computing 2-torsion basis tests... FAILED"); printf("\n"); return false; }
+	if (passed == 1) printf("  Cubic residuosity tests................................................ PASSED");
+	else { printf("  Cubic residuosity tests... FAILED"); printf("\n"); return false; }
 	printf("\n");
 
-	// Generating a 3-torsion basis
-	passed = 1;
-	for (i = 0; i < ECPT_TEST_LOOPS; i++)
+	// Generating a 2-torsion basis with the search-based and the entangled generators
+	for (j = 0; j < 2; j++)
 	{
-		//printf("%d ",i);
-		Status = EphemeralKeyGeneration_B(PrivateKeyB, PublicKeyB, CurveIsogeny);      // Get some value as Alice's secret key and compute Alice's public key
-		if (Status != CRYPTO_SUCCESS) {
-			OK = false;
-			goto cleanup;
+		passed = 1;
+		for (i = 0; i < ECPT_TEST_LOOPS; i++)
+		{
+			Status = EphemeralKeyGeneration_A(PrivateKeyA, PublicKeyA, CurveIsogeny);      // Get some value as Alice's secret key and compute Alice's public key
+			if (Status != CRYPTO_SUCCESS) {
+				OK = false;
+				goto cleanup;
+			}
+			to_fp2mont(((f2elm_t*)PublicKeyA)[0], PK0);
+			to_fp2mont(((f2elm_t*)PublicKeyA)[1], PK1);
+			to_fp2mont(((f2elm_t*)PublicKeyA)[2], PK2);
+			get_A(PK0, PK1, PK2, A, CurveIsogeny);
+
+			if (j == 0) {
+				generate_2_torsion_basis(A, R1, R2, CurveIsogeny);
+			} else {
+				generate_2_torsion_basis_entangled(A, R1, R2, CurveIsogeny);
+			}
+
+			fp2copy751(R1->X, P1->X);
+			fp2copy751(R1->Z, P1->Z);
+			fp2copy751(R2->X, P2->X);
+			fp2copy751(R2->Z, P2->Z);
+
+			// Check order of R1 
+			xDBLe(P1, P3, A, C, 371);
+			xDBLe(P3, P1, A, C, 1);
+			fp2correction751(P1->Z);
+			if (fp2compare751(P1->Z, zero) != 0) { printf("R1\n"); passed = 0; break; }
+			// Check order of R2 
+			xDBLe(P2, P4, A, C, 371);
+			xDBLe(P4, P2, A, C, 1);
+			fp2correction751(P2->Z);
+			if (fp2compare751(P2->Z, zero) != 0) { printf("R2\n"); passed = 0; break; }
+			// Check that the order of WeilPairing(R1,R2) is oA
+			fp2mul751_mont(P3->Z, P4->X, t0);
+			fp2mul751_mont(P3->X, P4->Z, t1);
+			fp2sub751(t0, t1, t0);
+			fp2correction751(t0);
+			if (fp2compare751(t0, zero) == 0) { printf("e(R1,R2)\n"); passed = 0; break; }
+
 		}
-		to_fp2mont(((f2elm_t*)PublicKeyB)[0], PK0);
-		to_fp2mont(((f2elm_t*)PublicKeyB)[1], PK1);
-		to_fp2mont(((f2elm_t*)PublicKeyB)[2], PK2);
-		get_A(PK0, PK1, PK2, A, CurveIsogeny);
+		if (passed == 1) printf("  Computing 2-torsion basis tests, %-9s generator................... PASSED", (j == 0) ? "search" : "entangled");
+		else { printf("  Computing 2-torsion basis tests, %s generator... FAILED", (j == 0) ? "search" : "entangled"); printf("\n"); return false; }
+		printf("\n");
+	}
 
-		generate_3_torsion_basis(A, R1, R2, CurveIsogeny);
-
-		fp2copy751(R1->X, P1->X);
-		fp2copy751(R1->Z, P1->Z);
-		fp2copy751(R2->X, P2->X);
-		fp2copy751(R2->Z, P2->Z);
-
-		// Check order of R1 by xTPL(R1, P1, A, 1); and check that P1->Z is zero
-		xTPLe(P1, P3, A, C, 238);
-		xTPLe(P3, P1, A, C, 1);
-		fp2correction751(P1->Z);
-		if (fp2compare751(P1->Z, zero) != 0) { printf("R1\n"); passed = 0; break; }
-		// Check order of R2 by xTPL(R2, P2, A, 1); and check that P2->Z is zero
-		xTPLe(P2, P4, A, C, 238);
-		xTPLe(P4, P2, A, C, 1);
-		fp2correction751(P2->Z);
-		if (fp2compare751(P2->Z, zero) != 0) { printf("R2\n"); passed = 0; break; }
-		// Check that the order of WeilPairing(R1,R2) is oB
-		fp2mul751_mont(P3->Z, P4->X, t0);
-		fp2mul751_mont(P3->X, P4->Z, t1);
-		fp2sub751(t0, t1, t0);
-		fp2correction751(t0);
-		if (fp2compare751(t0, zero) == 0) { printf("e(R1,R2)\n"); passed = 0; break; }
+	// Generating a 3-torsion basis with the search-based and the entangled generators
+	for (j = 0; j < 2; j++)
+	{
+		passed = 1;
+		for (i = 0; i < ECPT_TEST_LOOPS; i++)
+		{
+			//printf("%d ",i);
+			Status = EphemeralKeyGeneration_B(PrivateKeyB, PublicKeyB, CurveIsogeny);      // Get some value as Alice's secret key and compute Alice's public key
+			if (Status != CRYPTO_SUCCESS) {
+				OK = false;
+				goto cleanup;
+			}
+			to_fp2mont(((f2elm_t*)PublicKeyB)[0], PK0);
+			to_fp2mont(((f2elm_t*)PublicKeyB)[1], PK1);
+			to_fp2mont(((f2elm_t*)PublicKeyB)[2], PK2);
+			get_A(PK0, PK1, PK2, A, CurveIsogeny);
+
+			if (j == 0) {
+				generate_3_torsion_basis(A, R1, R2, CurveIsogeny);
+			} else {
+				generate_3_torsion_basis_entangled(A, R1, R2, CurveIsogeny);
+			}
+
+			fp2copy751(R1->X, P1->X);
+			fp2copy751(R1->Z, P1->Z);
+			fp2copy751(R2->X, P2->X);
+			fp2copy751(R2->Z, P2->Z);
+
+			// Check order of R1 by xTPL(R1, P1, A, 1); and check that P1->Z is zero
+			xTPLe(P1, P3, A, C, 238);
+			xTPLe(P3, P1, A, C, 1);
+			fp2correction751(P1->Z);
+			if (fp2compare751(P1->Z, zero) != 0) { printf("R1\n"); passed = 0; break; }
+			// Check order of R2 by xTPL(R2, P2, A, 1); and check that P2->Z is zero
+			xTPLe(P2, P4, A, C, 238);
+			xTPLe(P4, P2, A, C, 1);
+			fp2correction751(P2->Z);
+			if (fp2compare751(P2->Z, zero) != 0) { printf("R2\n"); passed = 0; break; }
+			// Check that the order of WeilPairing(R1,R2) is oB
+			fp2mul751_mont(P3->Z, P4->X, t0);
+			fp2mul751_mont(P3->X, P4->Z, t1);
+			fp2sub751(t0, t1, t0);
+			fp2correction751(t0);
+			if (fp2compare751(t0, zero) == 0) { printf("e(R1,R2)\n"); passed = 0; break; }
+		}
+		if (passed == 1) printf("  Computing 3-torsion basis tests, %-9s generator................... PASSED", (j == 0) ? "search" : "entangled");
+		else { printf("  Computing 3-torsion basis tests, %s generator... FAILED", (j == 0) ? "search" : "entangled"); printf("\n"); return false; }
+		printf("\n");
 	}
-	if (passed == 1) printf("  Computing 3-torsion basis tests........................................ PASSED");
-	else { printf("  Computing 3-torsion basis tests... FAILED"); printf("\n"); return false; }
-	printf("\n");
 
 cleanup:
 	SIDH_curve_free(CurveIsogeny);    
@@ -829,6 +1092,123 @@ cleanup:
 }
 
 
+bool ecpoints_run(PCurveIsogenyStaticData CurveIsogenyData)
+{
+    bool OK = true;
+    unsigned int n, j;
+    unsigned int pbytes = (CurveIsogenyData->pwordbits + 7)/8;      // Number of bytes in a field element 
+    unsigned int obytes = (CurveIsogenyData->owordbits + 7)/8;      // Number of bytes in an element in [1, order]
+    unsigned char *PrivateKey, *PublicKey;
+    unsigned long long cycles[2][2] = {0}, cycles1, cycles2;
+    f2elm_t A, PK0, PK1, PK2, us[MAX_CUBE_BATCH];
+    bool cubes[MAX_CUBE_BATCH];
+    point_full_proj_t R1, R2;
+    PCurveIsogenyStruct CurveIsogeny = {0};
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+
+    PrivateKey = (unsigned char*)calloc(1, obytes);             // One element in [1, order]  
+    PublicKey = (unsigned char*)calloc(1, 3*2*pbytes);          // Three elements in GF(p^2)
+
+    // Curve isogeny system initialization
+    CurveIsogeny = SIDH_curve_allocate(CurveIsogenyData);
+    if (CurveIsogeny == NULL) {
+        OK = false;
+        goto cleanup;
+    }
+    Status = SIDH_curve_initialize(CurveIsogeny, &random_bytes_test, CurveIsogenyData);
+    if (Status != CRYPTO_SUCCESS) {
+        OK = false;
+        goto cleanup;
+    }
+        
+    printf("\n--------------------------------------------------------------------------------------------------------\n\n"); 
+    printf("Benchmarking elliptic curve point generation functions: \n\n"); 
+
+    for (n=0; n<ECPT_TEST_LOOPS; n++)
+    {
+        // Basis generation on the curves of Alice's and Bob's public keys, with the search-based and the entangled generators
+        Status = EphemeralKeyGeneration_A(PrivateKey, PublicKey, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            OK = false;
+            goto cleanup;
+        }
+        to_fp2mont(((f2elm_t*)PublicKey)[0], PK0);
+        to_fp2mont(((f2elm_t*)PublicKey)[1], PK1);
+        to_fp2mont(((f2elm_t*)PublicKey)[2], PK2);
+        get_A(PK0, PK1, PK2, A, CurveIsogeny);
+        for (j = 0; j < 2; j++) {
+            cycles1 = cpucycles(); 
+            if (j == 0) {
+                generate_3_torsion_basis(A, R1, R2, CurveIsogeny);
+            } else {
+                generate_3_torsion_basis_entangled(A, R1, R2, CurveIsogeny);
+            }
+            cycles2 = cpucycles();
+            cycles[1][j] = cycles[1][j]+(cycles2-cycles1);
+        }
+
+        Status = EphemeralKeyGeneration_B(PrivateKey, PublicKey, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            OK = false;
+            goto cleanup;
+        }
+        to_fp2mont(((f2elm_t*)PublicKey)[0], PK0);
+        to_fp2mont(((f2elm_t*)PublicKey)[1], PK1);
+        to_fp2mont(((f2elm_t*)PublicKey)[2], PK2);
+        get_A(PK0, PK1, PK2, A, CurveIsogeny);
+        for (j = 0; j < 2; j++) {
+            cycles1 = cpucycles(); 
+            if (j == 0) {
+                generate_2_torsion_basis(A, R1, R2, CurveIsogeny);
+            } else {
+                generate_2_torsion_basis_entangled(A, R1, R2, CurveIsogeny);
+            }
+            cycles2 = cpucycles();
+            cycles[0][j] = cycles[0][j]+(cycles2-cycles1);
+        }
+    }
+    // Cubic residuosity test, single and batched
+    cycles1 = 0;
+    for (n=0; n<SMALL_BENCH_LOOPS; n++)
+    {
+        fp2random751_test(us[0]);
+
+        cycles2 = cpucycles();
+        is_cube_Fp2(us[0], CurveIsogeny);
+        cycles1 = cycles1+(cpucycles()-cycles2);
+    }
+    printf("  Cubic residuosity test runs in .................................. %10lld ", cycles1/SMALL_BENCH_LOOPS); print_unit;
+    printf("\n");
+
+    cycles1 = 0;
+    for (n=0; n<SMALL_BENCH_LOOPS/MAX_CUBE_BATCH; n++)
+    {
+        for (j = 0; j < MAX_CUBE_BATCH; j++) fp2random751_test(us[j]);
+
+        cycles2 = cpucycles();
+        is_cube_Fp2_batch(us, cubes, MAX_CUBE_BATCH, CurveIsogeny);
+        cycles1 = cycles1+(cpucycles()-cycles2);
+    }
+    printf("  Batched cubic residuosity test runs in (per element) ............ %10lld ", cycles1/((SMALL_BENCH_LOOPS/MAX_CUBE_BATCH)*MAX_CUBE_BATCH)); print_unit;
+    printf("\n");
+    printf("  2-torsion basis generation runs in .............................. %10lld ", cycles[0][0]/ECPT_TEST_LOOPS); print_unit;
+    printf("\n");
+    printf("  2-torsion entangled basis generation runs in .................... %10lld ", cycles[0][1]/ECPT_TEST_LOOPS); print_unit;
+    printf("\n");
+    printf("  3-torsion basis generation runs in .............................. %10lld ", cycles[1][0]/ECPT_TEST_LOOPS); print_unit;
+    printf("\n");
+    printf("  3-torsion entangled basis generation runs in .................... %10lld ", cycles[1][1]/ECPT_TEST_LOOPS); print_unit;
+    printf("\n");
+
+cleanup:
+    SIDH_curve_free(CurveIsogeny);
+    free(PrivateKey);
+    free(PublicKey);
+    
+    return OK;
+}
+
+
 bool ecpairing_test(PCurveIsogenyStaticData CurveIsogenyData)
 {
 		bool OK = true;
@@ -891,7 +1271,7 @@ bool ecpairing_test(PCurveIsogenyStaticData CurveIsogenyData)
 		get_A(PK0, PK1, PK2, A, CurveIsogeny);
 		fp2correction751(A);
 
-		generate_2_torsion_basis(A, R1, R2, CurveIsogeny);
+		generate_2_torsion_basis_entangled(A, R1, R2, CurveIsogeny);
 
 		fp2copy751(R1->Z, S1->x);
 		fp2copy751(R2->Z, S2->x);
@@ -1083,7 +1463,7 @@ bool ecpairing_test(PCurveIsogenyStaticData CurveIsogenyData)
 		get_A(PK0, PK1, PK2, A, CurveIsogeny);
 		fp2correction751(A);
 
-		generate_3_torsion_basis(A, R1, R2, CurveIsogeny);
+		generate_3_torsion_basis_entangled(A, R1, R2, CurveIsogeny);
 
 		fp2copy751(R1->Z, S1->x);
 		fp2copy751(R2->Z, S2->x);
@@ -1277,38 +1657,54 @@ cleanup:
 }
 
 
+// Pohlig-Hellman configurations {ell, w, v} exercised by the tests and benchmarks
+static const unsigned int ph_configs[][3] = { {2, 1, 1}, {2, 4, 1}, {2, 5, 2}, {2, 6, 1}, {2, 6, 2}, {2, 7, 1}, {2, 8, 3}, 
+                                              {3, 1, 1}, {3, 2, 2}, {3, 3, 1}, {3, 4, 1}, {3, 4, 2}, {3, 5, 1} };
+#define NPH_CONFIGS    (sizeof(ph_configs)/sizeof(ph_configs[0]))
+#define PH_MAX_TABLE   (372*7)
+
+
+static void ph_test_generators(f2elm_t g, f2elm_t f)
+{ // Elements g of order 2^372 and f of order 3^239 in Fp2* (in Montgomery representation)
+	static uint64_t g0[NWORDS64_FIELD] = { 0x6DC1FB9744174A3B, 0x6FD2179F99D7C37B, 0x25369C448517FC40, 0xD8C81BAF4D65E1E6, 0x60AB3A6DA83F09E4, 0x754136F6128E14D7,
+										   0x35D613FB2FF4E209, 0x6806FCE2C60C4D15, 0x3327268789685473, 0xB1E3A35301572E7A, 0x247A710DAAFD3AF2, 0x000001D1269427DF };
+	static uint64_t g1[NWORDS64_FIELD] = { 0x0DF04275F2736D0F, 0x7AF3CB47093A6945, 0x2BF9DE10B80D4916, 0xF38473A6EBBD1190, 0x0AFA711413EEFF3A, 0x8B5ED7CB12A34D48,
+										   0x8A7744179FCABFB7, 0x767076DCEEBC6F42, 0xDD5257DEFED2BAD0, 0x29F9AAFDBEEA8CA6, 0x34E0880EE6DFE13B, 0x000032A0AFD7E55A };
+	static uint64_t f0[NWORDS64_FIELD] = { 0x236D32885248C251, 0xEE9FA7DE6BDF0A1A, 0x567F9615D3F7ED21, 0x8CAF3AEC939225BF, 0xCB62DF92F23880E9, 0x146022FAB57C79D3,
+										   0xEDAF5A48061F1786, 0x6234FB60033C0CA4, 0x43DA2B8D5139D295, 0x7297169BE2536FC1, 0xC7492AA82868F7F5, 0x00002672C6DBF252 };
+	static uint64_t f1[NWORDS64_FIELD] = { 0x072B8A1712B721F3, 0xAF25A23BA40155B3, 0x2249670B18510FBC, 0x481828E3334AB900, 0x295952F8CFED5755, 0x2A175E1E7089F203,
+		                                   0x26EF86CF533A402F, 0xF7416274E96F7A16, 0x858485BF1583B705, 0x80BD1C95101D12A7, 0xFF91E7A65D9DF44F, 0x00005B54A9C7FBB9 };
+
+	fpcopy751((digit_t*)g0, g[0]);
+	fpcopy751((digit_t*)g1, g[1]);
+	fpcopy751((digit_t*)f0, f[0]);
+	fpcopy751((digit_t*)f1, f[1]);
+}
+
+
 bool ecph_test(PCurveIsogenyStaticData CurveIsogenyData)
 {
 	bool OK = true;
-	unsigned int i, j;
-	unsigned int pbytes = (CurveIsogenyData->pwordbits+7)/8;   // Number of bytes in a field element 
-	unsigned int obytes = (CurveIsogenyData->owordbits+7)/8;   // Number of bytes in an element in [1, order]
-	unsigned char *PrivateKeyA, *PublicKeyA, *PrivateKeyB, *PublicKeyB;
-	f2elm_t f, g, h, u;
-	f2elm_t one;
-	f2elm_t t_ori[5], LUT[5], LUT_0[4], LUT_1[4], LUT_3[6];
-	f2elm_t t_ori3[5], LUT3[4], LUT3_0[4], LUT3_1[5];
+	unsigned int i, j, k;
+	f2elm_t f, g, u;
+	f2elm_t one, *T = NULL;
+	felm_t *leaf = NULL;
+	unsigned int *splits = NULL;
+	ph_params prm;
 	PCurveIsogenyStruct CurveIsogeny = {0};
 	CRYPTO_STATUS Status = CRYPTO_SUCCESS;
-	uint64_t m21[2], m0[NWORDS64_ORDER];
-	uint64_t n21[2], n0[NWORDS64_ORDER];
-	uint64_t m1, n1, m5, n5;
+	uint64_t m0[NWORDS64_ORDER], n0[NWORDS64_ORDER];
 	bool passed;
-	bool equ = 1;
-
-	// Allocating memory for private keys, public keys and shared secrets
-	// Do this to obtain "random" curves.
-	PrivateKeyA = (unsigned char*)calloc(1, obytes);        // One element in [1, order]  
-	PrivateKeyB = (unsigned char*)calloc(1, obytes);
-	PublicKeyA = (unsigned char*)calloc(1, 3*2*pbytes);     // Four elements in GF(p^2)
-	PublicKeyB = (unsigned char*)calloc(1, 3*2*pbytes);
 
 	printf("\n--------------------------------------------------------------------------------------------------------\n\n");
 	printf("Testing Pohlig-Hellman functions: \n\n");
 
 	// Curve isogeny system initialization
 	CurveIsogeny = SIDH_curve_allocate(CurveIsogenyData);
-	if (CurveIsogeny == NULL) {
+	T = (f2elm_t*)calloc(PH_MAX_TABLE, sizeof(f2elm_t));
+	leaf = (felm_t*)calloc(256, sizeof(felm_t));
+	splits = (unsigned int*)calloc(PH_MAX_LEAVES, sizeof(unsigned int));
+	if (CurveIsogeny == NULL || T == NULL || leaf == NULL || splits == NULL) {
 		OK = false;
 		Status = CRYPTO_ERROR_NO_MEMORY;
 		goto cleanup;
@@ -1321,143 +1717,329 @@ bool ecph_test(PCurveIsogenyStaticData CurveIsogenyData)
 
 	fp2zero751(one);
 	fpcopy751(CurveIsogeny->Montgomery_one, one[0]);
+	ph_test_generators(g, f);
 
-	// Element of order 2^372 in Fp2* (in Montgomery representation):
-	static uint64_t g0[NWORDS64_FIELD] = { 0x6DC1FB9744174A3B, 0x6FD2179F99D7C37B, 0x25369C448517FC40, 0xD8C81BAF4D65E1E6, 0x60AB3A6DA83F09E4, 0x754136F6128E14D7,
-										   0x35D613FB2FF4E209, 0x6806FCE2C60C4D15, 0x3327268789685473, 0xB1E3A35301572E7A, 0x247A710DAAFD3AF2, 0x000001D1269427DF };
-	static uint64_t g1[NWORDS64_FIELD] = { 0x0DF04275F2736D0F, 0x7AF3CB47093A6945, 0x2BF9DE10B80D4916, 0xF38473A6EBBD1190, 0x0AFA711413EEFF3A, 0x8B5ED7CB12A34D48,
-										   0x8A7744179FCABFB7, 0x767076DCEEBC6F42, 0xDD5257DEFED2BAD0, 0x29F9AAFDBEEA8CA6, 0x34E0880EE6DFE13B, 0x000032A0AFD7E55A };
-	fpcopy751((digit_t*)g0, g[0]);
-	fpcopy751((digit_t*)g1, g[1]);
-
-	// Element of order 3^239 in Fp2* (in Montgomery representation):
-	static uint64_t f0[NWORDS64_FIELD] = { 0x236D32885248C251, 0xEE9FA7DE6BDF0A1A, 0x567F9615D3F7ED21, 0x8CAF3AEC939225BF, 0xCB62DF92F23880E9, 0x146022FAB57C79D3,
-										   0xEDAF5A48061F1786, 0x6234FB60033C0CA4, 0x43DA2B8D5139D295, 0x7297169BE2536FC1, 0xC7492AA82868F7F5, 0x00002672C6DBF252 };
-	static uint64_t f1[NWORDS64_FIELD] = { 0x072B8A1712B721F3, 0xAF25A23BA40155B3, 0x2249670B18510FBC, 0x481828E3334AB900, 0x295952F8CFED5755, 0x2A175E1E7089F203,
-		                                   0x26EF86CF533A402F, 0xF7416274E96F7A16, 0x858485BF1583B705, 0x80BD1C95101D12A7, 0xFF91E7A65D9DF44F, 0x00005B54A9C7FBB9 };
-
-	fpcopy751((digit_t*)f0, f[0]);
-	fpcopy751((digit_t*)f1, f[1]);
-
-	// Build the look-up tables from these two elements.
-	build_LUTs(g, t_ori, LUT, LUT_0, LUT_1, LUT_3, one[0]);
-	build_LUTs_3(f, t_ori3, LUT3, LUT3_0, LUT3_1, one[0]);
-
-	// Testing Pohlig-Hellman DLP algorithms for the 2-torsion group
-	passed = 1;
-	for (i = 0; i < ECPH_TEST_LOOPS; i++)
+	// Testing the strategy-driven Pohlig-Hellman in the groups of order 2^372 and 3^239, for several window widths and comb table windows
+	for (k = 0; k < NPH_CONFIGS; k++)
 	{
-		Status = random_mod_order((digit_t*)m0, ALICE, CurveIsogeny);
+		prm.ell = ph_configs[k][0];
+		prm.e = (prm.ell == 2) ? CurveIsogeny->oAbits : CurveIsogeny->eB;
+		prm.w = ph_configs[k][1];
+		prm.v = ph_configs[k][2];
+		prm.splits = splits;
+		Status = ph_optimal_strategy(splits, prm.ell, prm.e, prm.w, prm.v);
 		if (Status != CRYPTO_SUCCESS) {
-			clear_words(m0, NWORDS_ORDER);
-			return false;
+			OK = false;
+			goto cleanup;
 		}
-
-		fp2copy751(g, h);
-		
-		// Test phn84, Pohlig-Hellman in a group of order 2^372.
-		exp_Fp2_cycl(h, m0, one[0], u, 372);
-		phn84(u, t_ori, LUT, LUT_0, LUT_1, LUT_3, one[0], n0);
-		for (j = 0; j < NWORDS64_ORDER; j++) {
-			equ = equ && (n0[j] == m0[j]);
+		ph_build_tables((prm.ell == 2) ? g : f, &prm, T, leaf, one[0]);
+
+		passed = 1;
+		for (i = 0; i < ECPH_TEST_LOOPS; i++)
+		{
+			Status = random_mod_order((digit_t*)m0, (prm.ell == 2) ? ALICE : BOB, CurveIsogeny);
+			if (Status != CRYPTO_SUCCESS) {
+				OK = false;
+				goto cleanup;
+			}
+			exp_Fp2_cycl((prm.ell == 2) ? g : f, m0, one[0], u, (prm.ell == 2) ? 372 : 379);
+			ph_strategy(u, &prm, T, leaf, one[0], (digit_t*)n0);
+			for (j = 0; j < NWORDS64_ORDER; j++) {
+				if (n0[j] != m0[j]) passed = 0;
+			}
+			if (passed == 0) break;
 		}
-		if (equ == 0) { passed = 0; break; }
-		
-		// Test phn21, Pohlig-Hellman in a group of order 2^84.
-		for (j = 0; j < 288; j++) sqr_Fp2_cycl(h, one[0]);
-		m21[0] = m0[0];
-		m21[1] = m0[1];
-		m21[1] = (m21[1] >> 44);
-		exp_Fp2_cycl(h, m21, one[0], u, 84);
-		phn21(u, LUT, LUT_0, LUT_1, one[0], n21);
-		if ((n21[0] != m21[0]) || (n21[1] != m21[1])) { passed = 0; break; }
-        
-		// Test phn5, Pohlig-Hellman in a group of order 2^21.
-		for (j = 0; j < 63; j++) sqr_Fp2_cycl(h, one[0]);
-		m5 = m0[0];
-		m5 = (m5 >> 43);
-		exp_Fp2_cycl(h, &m5, one[0], u, 21);
-		phn5(u, LUT, LUT_1, one[0], &n5);
-		if (n5 != m5) { passed = 0; break; }
-		
-		// Test phn1, Pohlig-Hellman in a group of order 2^5.
-		for (j = 0; j < 16; j++) sqr_Fp2_cycl(h, one[0]);
-		m1 = m0[0];
-		m1 = (m1 >> 59);
-		exp_Fp2_cycl(h, &m1, one[0], u, 5);
-		phn1(u, LUT, 5, one[0], &n1);
-		if (n1 != m1) { passed = 0; break; }
+		if (passed == 1) printf("  %u-torsion Pohlig-Hellman tests, w = %u, v = %u.......................... PASSED", prm.ell, prm.w, prm.v);
+		else { printf("  %u-torsion Pohlig-Hellman tests, w = %u, v = %u... FAILED", prm.ell, prm.w, prm.v); printf("\n"); OK = false; goto cleanup; }
+		printf("\n");
 	}
-	if (passed == 1) printf("  2-torsion Pohlig-Hellman tests......................................... PASSED");
-	else { printf("  2-torsion Pohlig-Hellman tests... FAILED"); printf("\n"); return false; }
-	printf("\n");
 
-	// Testing Pohlig-Hellman DLP algorithms for the 3-torsion group
-	passed = 1;
-	for (i = 0; i < ECPH_TEST_LOOPS; i++)
-	{
-		Status = random_mod_order((digit_t*)m0, BOB, CurveIsogeny);
-		if (Status != CRYPTO_SUCCESS) {
-			clear_words(m0, NWORDS_ORDER);
-			return false;
-		}
 
-		fp2copy751(f, h);
+cleanup:
+	SIDH_curve_free(CurveIsogeny);
+	free(T);
+	free(leaf);
+	free(splits);
 
-		// Test phn61, Pohlig-Hellman in a group of order 3^239.
-		exp_Fp2_cycl(h, m0, one[0], u, 379);
-		phn61(u, t_ori3, LUT3, LUT3_0, LUT3_1, one[0], n0);
-		for (j = 0; j < NWORDS64_ORDER; j++) {
-			equ = equ && (n0[j] == m0[j]);
-		}
-		if (equ == 0) { passed = 0; break; }
-
-		// Test phn15, Pohlig-Hellman in a group of order 3^61.
-		for (j = 0; j < 178; j++) cube_Fp2_cycl(h, one[0]);
-		m21[0] = m0[0];
-		m21[1] = m0[1] % 0x000000019AEB6ECC; //Reducing mod upper part of 3^61 to ensure scalar is smaller than that.
-		exp_Fp2_cycl(h, m21, one[0], u, 97);
-		phn15(u, LUT3, LUT3_0, LUT3_1, one[0], n21);
-		if ((n21[0] != m21[0]) || (n21[1] != m21[1])) { passed = 0; break; }
-
-		// Test phn15_1, Pohlig-Hellman in a group of order 3^56.
-		for (j = 0; j < 5; j++) cube_Fp2_cycl(h, one[0]);
-		m21[0] = m0[0];
-		m21[1] = m0[1] % 0x0000000001B0E72C;//Reducing mod upper part of 3^56 to ensure scalar is smaller than that.
-		exp_Fp2_cycl(h, m21, one[0], u, 89);
-		phn15_1(u, LUT3, LUT3_0, LUT3_1, one[0], n21);
-		if ((n21[0] != m21[0]) || (n21[1] != m21[1])) { passed = 0; break; }
-
-		// Test phn3, Pohlig-Hellman in a group of order 3^15.
-		for (j = 0; j < 41; j++) cube_Fp2_cycl(h, one[0]);
-		m1 = m0[0];
-		m1 = m1 % (uint64_t)0xDAF26B;
-		exp_Fp2_cycl(h, &m1, one[0], u, 24);
-		phn3(u, LUT3, LUT3_1, one[0], &n1);
-		if (n1 != m1) { passed = 0; break; }
-
-		// Test phn1_3, Pohlig-Hellman in a group of order 3^3.
-		for (j = 0; j < 12; j++) cube_Fp2_cycl(h, one[0]);
-		m1 = m0[0];
-		m1 = m1 % 27;
-		exp_Fp2_cycl(h, &m1, one[0], u, 5);
-		phn1_3(u, LUT3, 3, one[0], &n1);
-		if (n1 != m1) { passed = 0; break; }
-	
+	return OK;
+}
+
+
+bool ecph_run(PCurveIsogenyStaticData CurveIsogenyData)
+{
+    bool OK = true;
+    unsigned int n, k;
+    unsigned long long cycles, cycles1, cycles2;
+    f2elm_t f, g, u;
+    f2elm_t one, *T = NULL;
+    felm_t *leaf = NULL;
+    unsigned int *splits = NULL;
+    ph_params prm;
+    PCurveIsogenyStruct CurveIsogeny = {0};
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+    uint64_t m0[NWORDS64_ORDER], n0[NWORDS64_ORDER];
+
+    // Curve isogeny system initialization
+    CurveIsogeny = SIDH_curve_allocate(CurveIsogenyData);
+    T = (f2elm_t*)calloc(PH_MAX_TABLE, sizeof(f2elm_t));
+    leaf = (felm_t*)calloc(256, sizeof(felm_t));
+    splits = (unsigned int*)calloc(PH_MAX_LEAVES, sizeof(unsigned int));
+    if (CurveIsogeny == NULL || T == NULL || leaf == NULL || splits == NULL) {
+        OK = false;
+        goto cleanup;
+    }
+    Status = SIDH_curve_initialize(CurveIsogeny, &random_bytes_test, CurveIsogenyData);
+    if (Status != CRYPTO_SUCCESS) {
+        OK = false;
+        goto cleanup;
+    }
+
+    printf("\n--------------------------------------------------------------------------------------------------------\n\n"); 
+    printf("Benchmarking Pohlig-Hellman functions (w = window width, v = comb table window): \n\n"); 
+
+    fp2zero751(one);
+    fpcopy751(CurveIsogeny->Montgomery_one, one[0]);
+    ph_test_generators(g, f);
+
+    for (k = 0; k < NPH_CONFIGS; k++)
+    {
+        prm.ell = ph_configs[k][0];
+        prm.e = (prm.ell == 2) ? CurveIsogeny->oAbits : CurveIsogeny->eB;
+        prm.w = ph_configs[k][1];
+        prm.v = ph_configs[k][2];
+        prm.splits = splits;
+        Status = ph_optimal_strategy(splits, prm.ell, prm.e, prm.w, prm.v);
+        if (Status != CRYPTO_SUCCESS) {
+            OK = false;
+            goto cleanup;
+        }
+        ph_build_tables((prm.ell == 2) ? g : f, &prm, T, leaf, one[0]);
+
+        cycles = 0;
+        for (n=0; n<ECPH_TEST_LOOPS; n++)
+        {
+            Status = random_mod_order((digit_t*)m0, (prm.ell == 2) ? ALICE : BOB, CurveIsogeny);
+            if (Status != CRYPTO_SUCCESS) {
+                OK = false;
+                goto cleanup;
+            }
+            exp_Fp2_cycl((prm.ell == 2) ? g : f, m0, one[0], u, (prm.ell == 2) ? 372 : 379);
+
+            cycles1 = cpucycles(); 
+            ph_strategy(u, &prm, T, leaf, one[0], (digit_t*)n0);
+            cycles2 = cpucycles();
+            cycles = cycles+(cycles2-cycles1);
+        }
+        printf("  %u-torsion discrete logarithm, w = %u, v = %u, runs in ................. %10lld ", prm.ell, prm.w, prm.v, cycles/ECPH_TEST_LOOPS); print_unit;
+        printf("\n");
+    }
+
+cleanup:
+    SIDH_curve_free(CurveIsogeny);
+    free(T);
+    free(leaf);
+    free(splits);
+    
+    return OK;
+}
+
+
+static void Montgomery_multiply_mod_order_ref(const digit_t* ma, const digit_t* mb, digit_t* mc, const digit_t* order, const digit_t* Montgomery_rprime)
+{ // Reference Montgomery multiplication modulo the group order with separate multiplications, mc = ma*mb*r' mod order
+	unsigned int i, cout, bout;
+	digit_t mask, P[2*NWORDS_ORDER], Q[2*NWORDS_ORDER], temp[2*NWORDS_ORDER];
+
+	multiply(ma, mb, P, NWORDS_ORDER);                 // P = ma * mb
+	multiply(P, Montgomery_rprime, Q, NWORDS_ORDER);   // Q = P * r' mod 2^(log_2(r))
+	multiply(Q, order, temp, NWORDS_ORDER);            // temp = Q * r
+	cout = mp_add(P, temp, temp, 2*NWORDS_ORDER);      // (cout, temp) = P + Q * r     
+	copy_words(&temp[NWORDS_ORDER], mc, NWORDS_ORDER);
+	bout = mp_sub(mc, order, mc, NWORDS_ORDER);
+	mask = (digit_t)cout - (digit_t)bout;
+	for (i = 0; i < NWORDS_ORDER; i++) {
+		temp[i] = (order[i] & mask);
 	}
-	if (passed == 1) printf("  3-torsion Pohlig-Hellman tests......................................... PASSED");
-	else { printf("  3-torsion Pohlig-Hellman tests... FAILED"); printf("\n"); printf("%i", i); return false; }
-	printf("\n");
+	mp_add(mc, temp, mc, NWORDS_ORDER);
+}
 
 
+bool order_test(PCurveIsogenyStaticData CurveIsogenyData)
+{ // Tests for the arithmetic modulo the group orders
+    bool OK = true;
+    unsigned int n;
+    int passed;
+    digit_t a[NWORDS_ORDER], b[NWORDS_ORDER], c[NWORDS_ORDER], d[NWORDS_ORDER], e[NWORDS_ORDER], one[NWORDS_ORDER] = {0};
+    uint64_t Montgomery_rB[NWORDS64_ORDER] = {0x48062A91D3AB563D, 0x6CE572751303C2F5, 0x5D1319F3F160EC9D, 0xE35554E8C2D5623A, 0xCA29300232BC79A5, 0x8AAD843D646D78C5};  // Value -(3^239)^-1 mod 2^384
+    uint64_t Montgomery_RB[NWORDS64_ORDER] = {0x1A55482318541298, 0x070A6370DFA12A03, 0xCB1658E0E3823A40, 0xB3B7384EB5DEF3F9, 0xCBCA952F7006EA33, 0x00569EF8EC94864C};  // Value (2^384)^2 mod 3^239
+    PCurveIsogenyStruct CurveIsogeny = {0};
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+
+    // Curve isogeny system initialization
+    CurveIsogeny = SIDH_curve_allocate(CurveIsogenyData);
+    if (CurveIsogeny == NULL) {
+        OK = false;
+        goto cleanup;
+    }
+    Status = SIDH_curve_initialize(CurveIsogeny, &random_bytes_test, CurveIsogenyData);
+    if (Status != CRYPTO_SUCCESS) {
+        OK = false;
+        goto cleanup;
+    }
+
+    printf("\n--------------------------------------------------------------------------------------------------------\n\n"); 
+    printf("Testing arithmetic modulo the group orders: \n\n"); 
+
+    // Montgomery multiplication modulo 3^239, also on inputs in [0, 2*order-1]
+    passed = 1;
+    for (n=0; n<TEST_LOOPS; n++)
+    {
+        random_mod_order(a, BOB, CurveIsogeny); random_mod_order(b, BOB, CurveIsogeny);
+        if ((n & 1) == 1) {
+            mp_add(a, CurveIsogeny->Border, a, NWORDS_ORDER);
+        }
+
+        Montgomery_multiply_mod_order(a, b, c, CurveIsogeny->Border, (digit_t*)&Montgomery_rB);
+        Montgomery_multiply_mod_order_ref(a, b, d, CurveIsogeny->Border, (digit_t*)&Montgomery_rB);
+        if (compare_words(c, d, NWORDS_ORDER) != 0) { passed=0; break; }
+    }
+    if (passed==1) printf("  Montgomery multiplication modulo 3^239 tests ........................... PASSED");
+    else { printf("  Montgomery multiplication modulo 3^239 tests... FAILED"); printf("\n"); OK = false; goto cleanup; }
+    printf("\n");
+
+    // Constant-time inversion modulo 3^239
+    one[0] = 1;
+    to_Montgomery_mod_order(one, one, CurveIsogeny->Border, (digit_t*)&Montgomery_rB, (digit_t*)&Montgomery_RB);
+    passed = 1;
+    for (n=0; n<TEST_LOOPS; n++)
+    {
+        random_mod_order(a, BOB, CurveIsogeny);
+        if (mod3(a) == 0) {
+            continue;
+        }
+        to_Montgomery_mod_order(a, a, CurveIsogeny->Border, (digit_t*)&Montgomery_rB, (digit_t*)&Montgomery_RB);
+
+        Montgomery_inversion_mod_orderB(a, c, CurveIsogeny->Border, (digit_t*)&Montgomery_rB);
+        Montgomery_inversion_mod_order_bingcd(a, d, CurveIsogeny->Border, (digit_t*)&Montgomery_rB, (digit_t*)&Montgomery_RB);
+        Montgomery_multiply_mod_order(a, c, e, CurveIsogeny->Border, (digit_t*)&Montgomery_rB);
+        if (compare_words(c, d, NWORDS_ORDER) != 0 || compare_words(e, one, NWORDS_ORDER) != 0) { passed=0; break; }
+    }
+    if (passed==1) printf("  Constant-time inversion modulo 3^239 tests ............................. PASSED");
+    else { printf("  Constant-time inversion modulo 3^239 tests... FAILED"); printf("\n"); OK = false; goto cleanup; }
+    printf("\n");
+
+    // Inversion modulo 2^372
+    passed = 1;
+    for (n=0; n<TEST_LOOPS; n++)
+    {
+        random_mod_order(a, ALICE, CurveIsogeny);
+        a[0] |= 1;
+        if (n == 0) {
+            clear_words((void*)a, NWORDS_ORDER);
+            a[0] = 1;
+        }
+
+        inv_mod_orderA(a, c);
+        mp_mul_low(a, c, d, NWORDS_ORDER);
+        d[NWORDS_ORDER-1] &= (digit_t)(-1) >> 12;
+        clear_words((void*)e, NWORDS_ORDER);
+        e[0] = 1;
+        if (compare_words(d, e, NWORDS_ORDER) != 0 || (c[NWORDS_ORDER-1] >> (RADIX-12)) != 0) { passed=0; break; }
+    }
+    if (passed==1) printf("  Inversion modulo 2^372 tests ........................................... PASSED");
+    else { printf("  Inversion modulo 2^372 tests... FAILED"); printf("\n"); OK = false; goto cleanup; }
+    printf("\n");
+
 cleanup:
-	SIDH_curve_free(CurveIsogeny);    
-    free(PrivateKeyA);    
-    free(PrivateKeyB);    
-    free(PublicKeyA);    
-    free(PublicKeyB);
+    SIDH_curve_free(CurveIsogeny);
 
-	return OK;
+    return OK;
+}
+
+
+bool order_run(PCurveIsogenyStaticData CurveIsogenyData)
+{ // Benchmarking of the arithmetic modulo the group orders
+    bool OK = true;
+    unsigned int n;
+    unsigned long long cycles, cycles1, cycles2;
+    digit_t a[NWORDS_ORDER], b[NWORDS_ORDER], c[NWORDS_ORDER];
+    uint64_t Montgomery_rB[NWORDS64_ORDER] = {0x48062A91D3AB563D, 0x6CE572751303C2F5, 0x5D1319F3F160EC9D, 0xE35554E8C2D5623A, 0xCA29300232BC79A5, 0x8AAD843D646D78C5};  // Value -(3^239)^-1 mod 2^384
+    uint64_t Montgomery_RB[NWORDS64_ORDER] = {0x1A55482318541298, 0x070A6370DFA12A03, 0xCB1658E0E3823A40, 0xB3B7384EB5DEF3F9, 0xCBCA952F7006EA33, 0x00569EF8EC94864C};  // Value (2^384)^2 mod 3^239
+    PCurveIsogenyStruct CurveIsogeny = {0};
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+
+    // Curve isogeny system initialization
+    CurveIsogeny = SIDH_curve_allocate(CurveIsogenyData);
+    if (CurveIsogeny == NULL) {
+        OK = false;
+        goto cleanup;
+    }
+    Status = SIDH_curve_initialize(CurveIsogeny, &random_bytes_test, CurveIsogenyData);
+    if (Status != CRYPTO_SUCCESS) {
+        OK = false;
+        goto cleanup;
+    }
+
+    printf("\n--------------------------------------------------------------------------------------------------------\n\n"); 
+    printf("Benchmarking arithmetic modulo the group orders: \n\n"); 
+
+    random_mod_order(a, BOB, CurveIsogeny); random_mod_order(b, BOB, CurveIsogeny);
+    a[0] |= 1;
+    if (mod3(a) == 0) {
+        a[0] += 2;
+    }
+
+    // Montgomery multiplication modulo 3^239
+    cycles = 0;
+    for (n=0; n<BENCH_LOOPS; n++)
+    {
+        cycles1 = cpucycles(); 
+        Montgomery_multiply_mod_order(a, b, c, CurveIsogeny->Border, (digit_t*)&Montgomery_rB);
+        cycles2 = cpucycles();
+        cycles = cycles+(cycles2-cycles1);
+    }
+    printf("  Montgomery multiplication modulo 3^239 runs in .................... %7lld ", cycles/BENCH_LOOPS); print_unit;
+    printf("\n");
+
+    // Constant-time inversion modulo 3^239
+    cycles = 0;
+    for (n=0; n<SMALL_BENCH_LOOPS; n++)
+    {
+        cycles1 = cpucycles(); 
+        Montgomery_inversion_mod_orderB(a, c, CurveIsogeny->Border, (digit_t*)&Montgomery_rB);
+        cycles2 = cpucycles();
+        cycles = cycles+(cycles2-cycles1);
+    }
+    printf("  Inversion modulo 3^239 (exponentiation) runs in ................... %7lld ", cycles/SMALL_BENCH_LOOPS); print_unit;
+    printf("\n");
+
+    // Inversion modulo 3^239 using the binary GCD
+    cycles = 0;
+    for (n=0; n<SMALL_BENCH_LOOPS; n++)
+    {
+        cycles1 = cpucycles(); 
+        Montgomery_inversion_mod_order_bingcd(a, c, CurveIsogeny->Border, (digit_t*)&Montgomery_rB, (digit_t*)&Montgomery_RB);
+        cycles2 = cpucycles();
+        cycles = cycles+(cycles2-cycles1);
+    }
+    printf("  Inversion modulo 3^239 (binary GCD) runs in ....................... %7lld ", cycles/SMALL_BENCH_LOOPS); print_unit;
+    printf("\n");
+
+    // Inversion modulo 2^372
+    cycles = 0;
+    for (n=0; n<SMALL_BENCH_LOOPS; n++)
+    {
+        cycles1 = cpucycles(); 
+        inv_mod_orderA(a, c);
+        cycles2 = cpucycles();
+        cycles = cycles+(cycles2-cycles1);
+    }
+    printf("  Inversion modulo 2^372 runs in .................................... %7lld ", cycles/SMALL_BENCH_LOOPS); print_unit;
+    printf("\n");
+
+cleanup:
+    SIDH_curve_free(CurveIsogeny);
+
+    return OK;
 }
 
 
@@ -1472,7 +2054,7 @@ bool eccompress_test(PCurveIsogenyStaticData CurveIsogenyData)
     digit_t a0[NWORDS_ORDER], b0[NWORDS_ORDER], a1[NWORDS_ORDER], b1[NWORDS_ORDER];
     uint64_t Montgomery_rB[NWORDS64_ORDER] = {0x48062A91D3AB563D, 0x6CE572751303C2F5, 0x5D1319F3F160EC9D, 0xE35554E8C2D5623A, 0xCA29300232BC79A5, 0x8AAD843D646D78C5};  // Value -(3^239)^-1 mod 2^384
 	point_full_proj_t Q1, Q2, Q3, Q4;
-	point_proj_t P1, P2, R;
+	point_proj_t P1, P2, P3, R;
     point_t R1, R2, R3, R4;
 	PCurveIsogenyStruct CurveIsogeny = {0};
 	CRYPTO_STATUS Status = CRYPTO_SUCCESS;
@@ -1957,6 +2539,53 @@ bool eccompress_test(PCurveIsogenyStaticData CurveIsogenyData)
 	else { printf("  3-torsion compression tests... FAILED"); printf("\n"); return false; }
 	printf("\n");
 
+	// Testing the three-point ladder used in decompression against the Montgomery ladder with y-recovery
+	passed = 1;
+	for (i = 0; i < COMP_TEST_LOOPS; i++)  
+	{
+		Status = EphemeralKeyGeneration_A(PrivateKeyA, PublicKeyA, CurveIsogeny);      // Get a random curve and a random scalar in [1, 3^239-1]
+		if (Status != CRYPTO_SUCCESS) {
+			OK = false;
+			goto cleanup;
+		} 
+		Status = EphemeralKeyGeneration_B(PrivateKeyB, PublicKeyB, CurveIsogeny);
+		if (Status != CRYPTO_SUCCESS) {
+			OK = false;
+			goto cleanup;
+		}   
+		to_fp2mont(((f2elm_t*)PublicKeyA)[0], PK0);
+		to_fp2mont(((f2elm_t*)PublicKeyA)[1], PK1);
+		to_fp2mont(((f2elm_t*)PublicKeyA)[2], PK2);
+		get_A(PK0, PK1, PK2, A, CurveIsogeny);
+		fp2add751(A, one, A24);
+		fp2add751(A24, one, A24);
+		fp2div2_751(A24, A24);
+		fp2div2_751(A24, A24);
+		generate_3_torsion_basis_entangled(A, Q1, Q2, CurveIsogeny);
+
+		fp2copy751(Q1->Z, t0);
+		fp2inv751_mont_bingcd(t0);
+		fp2mul751_mont(Q1->X, t0, R1->x);
+		fp2mul751_mont(Q1->Y, t0, R1->y);
+		fp2copy751(Q2->Z, t0);
+		fp2inv751_mont_bingcd(t0);
+		fp2mul751_mont(Q2->X, t0, R2->x);
+		fp2mul751_mont(Q2->Y, t0, R2->y);
+		mont_twodim_scalarmult((digit_t*)PrivateKeyB, R1, R2, A, A24, CurveIsogeny->oBbits, Q3, CurveIsogeny);
+
+		basis_x_only(Q1, Q2, A, P1, P2, P3);
+		ladder_3_pt_rl(P1, P2, P3, (digit_t*)PrivateKeyB, A24, CurveIsogeny->oBbits, R);
+
+		fp2mul751_mont(Q3->X, R->Z, t0);                                  // x(R1+[a]R2) must agree projectively
+		fp2mul751_mont(R->X, Q3->Z, t1);
+		fp2correction751(t0);
+		fp2correction751(t1);
+		if (fp2compare751(t0, t1) != 0) { passed = 0; break; }
+	}
+	if (passed == 1) printf("  Decompression three-point ladder tests................................. PASSED");
+	else { printf("  Decompression three-point ladder tests... FAILED"); printf("\n"); return false; }
+	printf("\n");
+
 cleanup:
 	SIDH_curve_free(CurveIsogeny);   
     free(PrivateKeyA);    
@@ -1985,8 +2614,12 @@ int main()
     OK = OK && ecisog_run(&CurveIsogeny_SIDHp751);       // Benchmark elliptic curve and isogeny functions
 
     OK = OK && ecpoints_test(&CurveIsogeny_SIDHp751);    // Test point generation functions
+    OK = OK && ecpoints_run(&CurveIsogeny_SIDHp751);     // Benchmark point generation functions
     OK = OK && ecpairing_test(&CurveIsogeny_SIDHp751);   // Test pairing functions
     OK = OK && ecph_test(&CurveIsogeny_SIDHp751);        // Test Pohlig-Hellman functions    
+    OK = OK && ecph_run(&CurveIsogeny_SIDHp751);         // Benchmark Pohlig-Hellman functions
+    OK = OK && order_test(&CurveIsogeny_SIDHp751);       // Test arithmetic modulo the group orders
+    OK = OK && order_run(&CurveIsogeny_SIDHp751);        // Benchmark arithmetic modulo the group orders
     OK = OK && eccompress_test(&CurveIsogeny_SIDHp751);  // Test Pohlig-Hellman functions
 
     return OK;
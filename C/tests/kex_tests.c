@@ -10,9 +10,20 @@
 *********************************************************************************************/ 
 
 #include "../SIDH.h"
+#include "../SIDH_internal.h"
 #include "test_extras.h"
 #include <malloc.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if (OS_TARGET == OS_LINUX)
+    #include <ucontext.h>
+    #include <unistd.h>
+    #include <sys/wait.h>
+#endif
+#if defined(SIDH_PTHREADS)
+    #include <pthread.h>
+#endif
 
 
 // Benchmark and test parameters  
@@ -24,6 +35,9 @@
     #define TEST_LOOPS        10      
 #endif
 #define BIGMONT_TEST_LOOPS    10      // Number of iterations per BigMont test
+#define BIGMONT_BATCH_SIZE    16      // Number of scalar multiplications per BigMont batch
+#define STRATEGY_BENCH_LOOPS  1000    // Number of iterations per point operation benchmarked to tune the isogeny tree strategies
+#define STACK_MEASURE_BYTES   (512*1024)  // Size of the painted stack used to measure peak stack usage
 
 // Used in BigMont tests
 static const uint64_t output1[12] = { 0x30E9AFA5BF75A92F, 0x88BC71EE9E221028, 0x999A50A9EE3B9A8E, 0x77E2934BD8D38B5A, 0x2668CAFC2933DB58, 0x457C65F7AD941041, 
@@ -112,10 +126,11 @@ cleanup:
 
 CRYPTO_STATUS cryptotest_kex_compress(PCurveIsogenyStaticData CurveIsogenyData)
 { // Compression tests
-	unsigned int i;
+	unsigned int i, seed;
 	unsigned int pbytes = (CurveIsogenyData->pwordbits + 7)/8;    // Number of bytes in a field element 
 	unsigned int obytes = (CurveIsogenyData->owordbits + 7)/8;    // Number of bytes in an element in [1, order]
 	unsigned char *PrivateKeyA, *PublicKeyA, *PrivateKeyB, *PublicKeyB, *CompressedPKA, *CompressedPKB, *PublicKeyA_tmp, *PublicKeyB_tmp, *SharedSecretA, *SharedSecretB, *R, *A;
+	unsigned char *PrivateKey_tmp, *CompressedPK_tmp;
 	PCurveIsogenyStruct CurveIsogeny = {0};
 	CRYPTO_STATUS Status = CRYPTO_SUCCESS;
 	bool passed = true;
@@ -133,6 +148,8 @@ CRYPTO_STATUS cryptotest_kex_compress(PCurveIsogenyStaticData CurveIsogenyData)
     SharedSecretB = (unsigned char*)calloc(1, 2*pbytes);
     R = (unsigned char*)calloc(1, 2*2*pbytes);                         // One point in (X:Z) coordinates 
     A = (unsigned char*)calloc(1, 2*pbytes);                           // One element in GF(p^2)  
+    PrivateKey_tmp = (unsigned char*)calloc(1, obytes);                // Private key and compressed public key from the single-call key generation
+    CompressedPK_tmp = (unsigned char*)calloc(1, 3*obytes + 2*pbytes);
 
     printf("\n\nTESTING EPHEMERAL ISOGENY-BASED KEY EXCHANGE USING COMPRESSION \n");
     printf("--------------------------------------------------------------------------------------------------------\n\n");
@@ -151,18 +168,44 @@ CRYPTO_STATUS cryptotest_kex_compress(PCurveIsogenyStaticData CurveIsogenyData)
 
     for (i = 0; i < TEST_LOOPS; i++) 
     {
+        seed = (unsigned int)rand();
+        srand(seed);
         Status = EphemeralKeyGeneration_A(PrivateKeyA, PublicKeyA, CurveIsogeny);                            // Get some value as Alice's secret key and compute Alice's public key
         if (Status != CRYPTO_SUCCESS) {                                                  
             goto cleanup;
         } 
         PublicKeyCompression_A(PublicKeyA, CompressedPKA, CurveIsogeny);                                     // Alice compresses her public key
 
+        srand(seed);                                                                                         // Same key pair, compressed straight from the key generation
+        Status = EphemeralKeyGeneration_Compressed_A(PrivateKey_tmp, CompressedPK_tmp, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {                                                  
+            goto cleanup;
+        }
+        if (memcmp(PrivateKey_tmp, PrivateKeyA, obytes) != 0 || memcmp(CompressedPK_tmp, CompressedPKA, 3*obytes + 2*pbytes) != 0) {
+            passed = false;
+            Status = CRYPTO_ERROR_SHARED_KEY;
+            break;
+        }
+
+        seed = (unsigned int)rand();
+        srand(seed);
         Status = EphemeralKeyGeneration_B(PrivateKeyB, PublicKeyB, CurveIsogeny);                            // Get some value as Bob's secret key and compute Bob's public key
         if (Status != CRYPTO_SUCCESS) {                                                  
             goto cleanup;
         }
         PublicKeyCompression_B(PublicKeyB, CompressedPKB, CurveIsogeny);                                     // Bob compresses his public key
 
+        srand(seed);                                                                                         // Same key pair, compressed straight from the key generation
+        Status = EphemeralKeyGeneration_Compressed_B(PrivateKey_tmp, CompressedPK_tmp, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {                                                  
+            goto cleanup;
+        }
+        if (memcmp(PrivateKey_tmp, PrivateKeyB, obytes) != 0 || memcmp(CompressedPK_tmp, CompressedPKB, 3*obytes + 2*pbytes) != 0) {
+            passed = false;
+            Status = CRYPTO_ERROR_SHARED_KEY;
+            break;
+        }
+
         PublicKeyBDecompression_A(PrivateKeyA, CompressedPKB, R, A, CurveIsogeny);                           // Alice decompresses Bob's public key data using her private key
         Status = EphemeralSecretAgreement_Compression_A(PrivateKeyA, R, A, SharedSecretA, CurveIsogeny);     // Alice computes her shared secret using decompressed Bob's public key data
         if (Status != CRYPTO_SUCCESS) {
@@ -175,6 +218,25 @@ CRYPTO_STATUS cryptotest_kex_compress(PCurveIsogenyStaticData CurveIsogenyData)
             goto cleanup;
         }  
 
+        if (compare_words((digit_t*)SharedSecretA, (digit_t*)SharedSecretB, NBYTES_TO_NWORDS(2*pbytes)) != 0) {
+            passed = false;
+            Status = CRYPTO_ERROR_SHARED_KEY;
+            break;
+        }
+
+        Status = EphemeralSecretAgreement_FromCompressed_A(PrivateKeyA, CompressedPKB, SharedSecretA, CurveIsogeny);    // Single-call versions, the compressed keys must still be intact
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }  
+        if (compare_words((digit_t*)SharedSecretA, (digit_t*)SharedSecretB, NBYTES_TO_NWORDS(2*pbytes)) != 0) {
+            passed = false;
+            Status = CRYPTO_ERROR_SHARED_KEY;
+            break;
+        }
+        Status = EphemeralSecretAgreement_FromCompressed_B(PrivateKeyB, CompressedPKA, SharedSecretB, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }  
         if (compare_words((digit_t*)SharedSecretA, (digit_t*)SharedSecretB, NBYTES_TO_NWORDS(2*pbytes)) != 0) {
             passed = false;
             Status = CRYPTO_ERROR_SHARED_KEY;
@@ -199,6 +261,118 @@ cleanup:
     free(SharedSecretB);  
     free(R);    
     free(A); 
+    free(PrivateKey_tmp);
+    free(CompressedPK_tmp);
+
+    return Status;
+}
+
+
+static bool fp2_ratio_equal(const f2elm_t a, const f2elm_t b, const f2elm_t c, const f2elm_t d)
+{ // Checks a/b == c/d as a*d == b*c
+    f2elm_t t0, t1;
+
+    fp2mul751_mont(a, d, t0);
+    fp2mul751_mont(b, c, t1);
+    fp2correction751(t0);
+    fp2correction751(t1);
+    return (compare_words((digit_t*)t0, (digit_t*)t1, 2*NWORDS_FIELD) == 0);
+}
+
+
+CRYPTO_STATUS cryptotest_proj_constants(PCurveIsogenyStaticData CurveIsogenyData)
+{ // Testing the inversion-free shared-secret path against the affine one: get_A_proj(), ladder_3_pt_proj() and first_4_isog_proj()
+    unsigned int i, k, pbytes = (CurveIsogenyData->pwordbits + 7)/8;   // Number of bytes in a field element 
+    unsigned int obytes = (CurveIsogenyData->owordbits + 7)/8;         // Number of bytes in an element in [1, order]
+    unsigned char *PrivateKeyA, *PrivateKeyB, *PublicKeyA, *PublicKeyB;
+    f2elm_t PK[3], A, Ap, Cp, Aout, Cout, Aoutp, Coutp, one = {0};
+    point_proj_t W, Wp;
+    PCurveIsogenyStruct CurveIsogeny = {0};
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+    bool passed = true;
+        
+    PrivateKeyA = (unsigned char*)calloc(1, obytes);        // One element in [1, order]  
+    PrivateKeyB = (unsigned char*)calloc(1, obytes);
+    PublicKeyA = (unsigned char*)calloc(1, 3*2*pbytes);     // Three elements in GF(p^2)
+    PublicKeyB = (unsigned char*)calloc(1, 3*2*pbytes);
+
+    printf("\n\nTESTING PROJECTIVE CURVE CONSTANTS \n");
+    printf("--------------------------------------------------------------------------------------------------------\n\n");
+
+    // Curve isogeny system initialization
+    CurveIsogeny = SIDH_curve_allocate(CurveIsogenyData);
+    if (CurveIsogeny == NULL || PrivateKeyA == NULL || PrivateKeyB == NULL || PublicKeyA == NULL || PublicKeyB == NULL) {
+        Status = CRYPTO_ERROR_NO_MEMORY;
+        goto cleanup;
+    }
+    Status = SIDH_curve_initialize(CurveIsogeny, &random_bytes_test, CurveIsogenyData);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    fpcopy751(CurveIsogeny->Montgomery_one, one[0]);
+
+    for (i = 0; i < TEST_LOOPS && passed == true; i++)
+    {
+        Status = EphemeralKeyGeneration_A(PrivateKeyA, PublicKeyA, CurveIsogeny);    // Random bases: the public keys (x(P), x(Q), x(Q-P)) of random key pairs
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = EphemeralKeyGeneration_B(PrivateKeyB, PublicKeyB, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+
+        // Curve constant of Alice's public key: A == Ap/Cp
+        for (k = 0; k < 3; k++) {
+            fp2_decode_bytes(&PublicKeyA[k*2*pbytes], PK[k], SIDH_DISPATCH(CurveIsogeny)->encoding);
+        }
+        get_A(PK[0], PK[1], PK[2], A, CurveIsogeny);
+        get_A_proj(PK[0], PK[1], PK[2], Ap, Cp, CurveIsogeny);
+        if (fp2_ratio_equal(A, one, Ap, Cp) == false) {
+            passed = false;
+            break;
+        }
+
+        // Curve constant of Bob's public key, and Alice's shared-secret steps from it: kernel point and first 4-isogeny
+        for (k = 0; k < 3; k++) {
+            fp2_decode_bytes(&PublicKeyB[k*2*pbytes], PK[k], SIDH_DISPATCH(CurveIsogeny)->encoding);
+        }
+        get_A(PK[0], PK[1], PK[2], A, CurveIsogeny);
+        get_A_proj(PK[0], PK[1], PK[2], Ap, Cp, CurveIsogeny);
+        if (fp2_ratio_equal(A, one, Ap, Cp) == false) {
+            passed = false;
+            break;
+        }
+        Status = ladder_3_pt(PK[0], PK[1], PK[2], (digit_t*)PrivateKeyA, ALICE, W, A, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = ladder_3_pt_proj(PK[0], PK[1], PK[2], (digit_t*)PrivateKeyA, ALICE, Wp, Ap, Cp, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        if (fp2_ratio_equal(W->X, W->Z, Wp->X, Wp->Z) == false) {
+            passed = false;
+            break;
+        }
+        first_4_isog(W, A, Aout, Cout, CurveIsogeny);
+        first_4_isog_proj(Wp, Ap, Cp, Aoutp, Coutp);
+        if (fp2_ratio_equal(W->X, W->Z, Wp->X, Wp->Z) == false || fp2_ratio_equal(Aout, Cout, Aoutp, Coutp) == false) {
+            passed = false;
+            break;
+        }
+    }
+
+    if (passed == true) printf("  Projective curve constant, ladder and first 4-isogeny tests ... PASSED");
+    else { printf("  Projective curve constant, ladder and first 4-isogeny tests ... FAILED"); printf("\n"); Status = CRYPTO_ERROR_SHARED_KEY; goto cleanup; }
+    printf("\n"); 
+
+cleanup:
+    SIDH_curve_free(CurveIsogeny);
+    free(PrivateKeyA);
+    free(PrivateKeyB);
+    free(PublicKeyA);
+    free(PublicKeyB);
 
     return Status;
 }
@@ -208,7 +382,10 @@ CRYPTO_STATUS cryptotest_BigMont(PCurveIsogenyStaticData CurveIsogenyData)
 { // Testing BigMont
     unsigned int i, j; 
     digit_t scalar[BIGMONT_NWORDS_ORDER] = {0};
-    felm_t x = {0};
+    digit_t* scalars = NULL;
+    felm_t x = {0}, xout, xfixed;
+    felm_t *xs = NULL, *xbatch = NULL;
+    unsigned char *table = NULL, *table_buffer = NULL;
     PCurveIsogenyStruct CurveIsogeny = {0};
     CRYPTO_STATUS Status = CRYPTO_SUCCESS;
     bool passed = true;
@@ -252,8 +429,76 @@ CRYPTO_STATUS cryptotest_BigMont(PCurveIsogenyStaticData CurveIsogenyData)
     else { printf("  BigMont's scalar multiplication tests ... FAILED"); printf("\n"); goto cleanup; }
     printf("\n"); 
 
+    // Fixed-base and batch scalar multiplications must match the Montgomery ladder
+    table_buffer = (unsigned char*)malloc(BIGMONT_FIXED_BASE_TABLE_BYTES + 1);
+    table = table_buffer + 1;                                       // The table is a byte buffer at any offset
+    scalars = (digit_t*)calloc(BIGMONT_BATCH_SIZE, BIGMONT_NWORDS_ORDER*sizeof(digit_t));
+    xs = (felm_t*)calloc(BIGMONT_BATCH_SIZE, sizeof(felm_t));
+    xbatch = (felm_t*)calloc(BIGMONT_BATCH_SIZE, sizeof(felm_t));
+    if (table_buffer == NULL || scalars == NULL || xs == NULL || xbatch == NULL) {
+        Status = CRYPTO_ERROR_NO_MEMORY;
+        goto cleanup;
+    }
+
+    fpzero751(x);
+    x[0] = 2;                                                       // x = 2 is not on BigMont 
+    if (BigMont_fixed_base_precompute((unsigned char*)x, table, CurveIsogeny) != CRYPTO_ERROR_INVALID_PARAMETER) passed = false;
+    x[0] = 11;                                                      // (11:1) is on BigMont but its order is a multiple of 2
+    if (BigMont_fixed_base_precompute((unsigned char*)x, table, CurveIsogeny) != CRYPTO_ERROR_INVALID_PARAMETER) passed = false;
+    x[0] = 3;                                                       // (3:1) has order BigMont_order
+    Status = BigMont_fixed_base_precompute((unsigned char*)x, table, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+
+    for (i = 0; i < BIGMONT_TEST_LOOPS && passed == true; i++)
+    {
+        for (j = 0; j < BIGMONT_BATCH_SIZE; j++) {
+            Status = random_BigMont_mod_order(&scalars[j*BIGMONT_NWORDS_ORDER], CurveIsogeny);
+            if (Status != CRYPTO_SUCCESS) {
+                goto cleanup;
+            }
+            fpcopy751(x, xs[j]);
+        }
+        scalars[0] = 1;                                             // Edge cases: the smallest and largest scalars
+        for (j = 1; j < BIGMONT_NWORDS_ORDER; j++) scalars[j] = 0;
+        copy_words(CurveIsogeny->BigMont_order, &scalars[BIGMONT_NWORDS_ORDER], BIGMONT_NWORDS_ORDER);
+        scalars[BIGMONT_NWORDS_ORDER] -= 1;
+
+        Status = BigMont_fixed_base_batch(table, scalars, (unsigned char*)xbatch, BIGMONT_BATCH_SIZE, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = BigMont_ladder_batch((unsigned char*)xs, scalars, (unsigned char*)xs, BIGMONT_BATCH_SIZE, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        for (j = 0; j < BIGMONT_BATCH_SIZE; j++) {
+            Status = BigMont_ladder((unsigned char*)x, &scalars[j*BIGMONT_NWORDS_ORDER], (unsigned char*)xout, CurveIsogeny);
+            if (Status != CRYPTO_SUCCESS) {
+                goto cleanup;
+            }
+            Status = BigMont_fixed_base(table, &scalars[j*BIGMONT_NWORDS_ORDER], (unsigned char*)xfixed, CurveIsogeny);
+            if (Status != CRYPTO_SUCCESS) {
+                goto cleanup;
+            }
+            if (compare_words(xout, xfixed, NWORDS_FIELD) != 0 || compare_words(xout, xbatch[j], NWORDS_FIELD) != 0 || compare_words(xout, xs[j], NWORDS_FIELD) != 0) {
+                passed = false;
+                break;
+            }
+        }
+    }
+
+    if (passed == true) printf("  BigMont's fixed-base and batch scalar multiplication tests ... PASSED");
+    else { printf("  BigMont's fixed-base and batch scalar multiplication tests ... FAILED"); printf("\n"); Status = CRYPTO_ERROR_SHARED_KEY; goto cleanup; }
+    printf("\n"); 
+
 cleanup:
     SIDH_curve_free(CurveIsogeny);
+    free(table_buffer);
+    free(scalars);
+    free(xs);
+    free(xbatch);
 
     return Status;
 }
@@ -383,7 +628,7 @@ CRYPTO_STATUS cryptorun_kex_compress(PCurveIsogenyStaticData CurveIsogenyData)
     unsigned int n, obytes = (CurveIsogenyData->owordbits + 7)/8;   // Number of bytes in an element in [1, order]
     unsigned char *PrivateKeyA, *PrivateKeyB, *PublicKeyA, *PublicKeyB, *CompressedPKA, *CompressedPKB, *SharedSecretA, *SharedSecretB, *R, *A;
     PCurveIsogenyStruct CurveIsogeny = {0};
-    unsigned long long cycles, cycles1, cycles2;
+    unsigned long long cycles, cycles1, cycles2, cycles_two;
     CRYPTO_STATUS Status = CRYPTO_SUCCESS;
     bool passed;
         
@@ -442,6 +687,24 @@ CRYPTO_STATUS cryptorun_kex_compress(PCurveIsogenyStaticData CurveIsogenyData)
     else { printf("  Alice's public key compression failed"); goto cleanup; } 
     printf("\n");
 
+    // Benchmarking Alice's key generation straight to a compressed public key
+    passed = true;
+    cycles = 0;
+    for (n = 0; n < BENCH_LOOPS; n++)
+    {
+        cycles1 = cpucycles();
+        Status = EphemeralKeyGeneration_Compressed_A(PrivateKeyA, CompressedPKA, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {                                                  
+            passed = false;
+            break;
+        }    
+        cycles2 = cpucycles();
+        cycles = cycles+(cycles2-cycles1);
+    }
+    if (passed) { printf("  Alice's key generation with compression runs in .............. %10lld ", cycles/BENCH_LOOPS); print_unit; }
+    else { printf("  Alice's key generation with compression failed"); goto cleanup; } 
+    printf("\n");
+
     // Benchmarking Alice's key decompression
     passed = true;
     cycles = 0;
@@ -481,6 +744,38 @@ CRYPTO_STATUS cryptorun_kex_compress(PCurveIsogenyStaticData CurveIsogenyData)
     else { printf("  Bob's shared key computation failed"); goto cleanup; } 
     printf("\n");
 
+    // Benchmarking Bob's single-call shared key computation from Alice's compressed key against the two-call sequence, interleaved
+    passed = true;
+    cycles = 0;
+    cycles_two = 0;
+    for (n = 0; n < BENCH_LOOPS; n++)
+    {
+        cycles1 = cpucycles();
+        PublicKeyADecompression_B(PrivateKeyB, CompressedPKA, R, A, CurveIsogeny);
+        Status = EphemeralSecretAgreement_Compression_B(PrivateKeyB, R, A, SharedSecretB, CurveIsogeny);
+        cycles2 = cpucycles();
+        cycles_two = cycles_two+(cycles2-cycles1);
+        if (Status != CRYPTO_SUCCESS) {                                                  
+            passed = false;
+            break;
+        }    
+        cycles1 = cpucycles();
+        Status = EphemeralSecretAgreement_FromCompressed_B(PrivateKeyB, CompressedPKA, SharedSecretB, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {                                                  
+            passed = false;
+            break;
+        }    
+        cycles2 = cpucycles();
+        cycles = cycles+(cycles2-cycles1);
+    }
+    if (passed) { 
+        printf("  Bob's decompression and shared key in two calls runs in ...... %10lld ", cycles_two/BENCH_LOOPS); print_unit; printf("\n");
+        printf("  Bob's shared key from compressed key runs in ................. %10lld ", cycles/BENCH_LOOPS); print_unit;
+        printf(" (%+.1f%% vs two calls)", 100.0*((double)cycles/(double)cycles_two - 1.0));
+    }
+    else { printf("  Bob's shared key from compressed key failed"); goto cleanup; } 
+    printf("\n");
+
     // Benchmarking Bob's public key compression
     passed = true;
     cycles = 0;
@@ -499,6 +794,24 @@ CRYPTO_STATUS cryptorun_kex_compress(PCurveIsogenyStaticData CurveIsogenyData)
     else { printf("  Bob's public key compression failed"); goto cleanup; } 
     printf("\n");
 
+    // Benchmarking Bob's key generation straight to a compressed public key
+    passed = true;
+    cycles = 0;
+    for (n = 0; n < BENCH_LOOPS; n++)
+    {
+        cycles1 = cpucycles();
+        Status = EphemeralKeyGeneration_Compressed_B(PrivateKeyB, CompressedPKB, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {                                                  
+            passed = false;
+            break;
+        }    
+        cycles2 = cpucycles();
+        cycles = cycles+(cycles2-cycles1);
+    }
+    if (passed) { printf("  Bob's key generation with compression runs in ................ %10lld ", cycles/BENCH_LOOPS); print_unit; }
+    else { printf("  Bob's key generation with compression failed"); goto cleanup; } 
+    printf("\n");
+
     // Benchmarking Bob's key decompression
     passed = true;
     cycles = 0;
@@ -535,6 +848,38 @@ CRYPTO_STATUS cryptorun_kex_compress(PCurveIsogenyStaticData CurveIsogenyData)
     else { printf("  Alice's shared key computation failed"); goto cleanup; } 
     printf("\n");
 
+    // Benchmarking Alice's single-call shared key computation from Bob's compressed key against the two-call sequence, interleaved
+    passed = true;
+    cycles = 0;
+    cycles_two = 0;
+    for (n = 0; n < BENCH_LOOPS; n++)
+    {
+        cycles1 = cpucycles();
+        PublicKeyBDecompression_A(PrivateKeyA, CompressedPKB, R, A, CurveIsogeny);
+        Status = EphemeralSecretAgreement_Compression_A(PrivateKeyA, R, A, SharedSecretA, CurveIsogeny);
+        cycles2 = cpucycles();
+        cycles_two = cycles_two+(cycles2-cycles1);
+        if (Status != CRYPTO_SUCCESS) {                                                  
+            passed = false;
+            break;
+        }    
+        cycles1 = cpucycles();
+        Status = EphemeralSecretAgreement_FromCompressed_A(PrivateKeyA, CompressedPKB, SharedSecretA, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {                                                  
+            passed = false;
+            break;
+        }    
+        cycles2 = cpucycles();
+        cycles = cycles+(cycles2-cycles1);
+    }
+    if (passed) { 
+        printf("  Alice's decompression and shared key in two calls runs in .... %10lld ", cycles_two/BENCH_LOOPS); print_unit; printf("\n");
+        printf("  Alice's shared key from compressed key runs in ............... %10lld ", cycles/BENCH_LOOPS); print_unit;
+        printf(" (%+.1f%% vs two calls)", 100.0*((double)cycles/(double)cycles_two - 1.0));
+    }
+    else { printf("  Alice's shared key from compressed key failed"); goto cleanup; } 
+    printf("\n");
+
 cleanup:
     SIDH_curve_free(CurveIsogeny);   
     free(PrivateKeyA);    
@@ -554,9 +899,12 @@ cleanup:
 
 CRYPTO_STATUS cryptorun_BigMont(PCurveIsogenyStaticData CurveIsogenyData)
 { // Benchmarking BigMont
-    unsigned int i; 
+    unsigned int i, j; 
     digit_t scalar[BIGMONT_NWORDS_ORDER] = {0};
+    digit_t* scalars = NULL;
     f2elm_t x = {0};
+    felm_t* xs = NULL;
+    unsigned char* table = NULL;
     PCurveIsogenyStruct CurveIsogeny = {0};
     unsigned long long cycles, cycles1, cycles2;
     CRYPTO_STATUS Status = CRYPTO_SUCCESS;
@@ -600,52 +948,1728 @@ CRYPTO_STATUS cryptorun_BigMont(PCurveIsogenyStaticData CurveIsogenyData)
     else { printf("  BigMont's scalar multiplication failed"); goto cleanup; } 
     printf("\n");
 
-cleanup:
-    SIDH_curve_free(CurveIsogeny);
-
-    return Status;
-}
-
-
-int main()
-{
-    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
-    
-    Status = cryptotest_kex(&CurveIsogeny_SIDHp751);             // Test key exchange system "SIDHp751"
-    if (Status != CRYPTO_SUCCESS) {
-        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
-        return false;
+    // Fixed-base scalar multiplication of a point of order BigMont_order, one at a time and in batches 
+    table = (unsigned char*)malloc(BIGMONT_FIXED_BASE_TABLE_BYTES);
+    scalars = (digit_t*)calloc(BIGMONT_BATCH_SIZE, BIGMONT_NWORDS_ORDER*sizeof(digit_t));
+    xs = (felm_t*)calloc(BIGMONT_BATCH_SIZE, sizeof(felm_t));
+    if (table == NULL || scalars == NULL || xs == NULL) {
+        Status = CRYPTO_ERROR_NO_MEMORY;
+        goto cleanup;
     }
+    fpzero751(x[0]);
+    x[0][0] = 3;                                                    // (3:1) has order BigMont_order
 
-    Status = cryptorun_kex(&CurveIsogeny_SIDHp751);              // Benchmark key exchange system "SIDHp751"
-    if (Status != CRYPTO_SUCCESS) {
-        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
-        return false;
-    }
-    
-    Status = cryptotest_kex_compress(&CurveIsogeny_SIDHp751);    // Test key exchange system "SIDHp751" using compression
+    cycles1 = cpucycles();
+    Status = BigMont_fixed_base_precompute((unsigned char*)x, table, CurveIsogeny);
     if (Status != CRYPTO_SUCCESS) {
-        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
-        return false;
+        goto cleanup;
     }
+    cycles2 = cpucycles();
+    printf("  BigMont's fixed-base precomputation runs in ................. %10lld ", cycles2-cycles1); print_unit;
+    printf("\n");
 
-    Status = cryptorun_kex_compress(&CurveIsogeny_SIDHp751);     // Benchmark key exchange system "SIDHp751" using compression
-    if (Status != CRYPTO_SUCCESS) {
-        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
-        return false;
-    }
-    
-    Status = cryptotest_BigMont(&CurveIsogeny_SIDHp751);         // Test elliptic curve "BigMont"
-    if (Status != CRYPTO_SUCCESS) {
-        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
-        return false;
+    cycles = 0;
+    for (i = 0; i < BENCH_LOOPS; i++)
+    {        
+        Status = random_BigMont_mod_order(scalar, CurveIsogeny);    
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+
+        cycles1 = cpucycles();
+        Status = BigMont_fixed_base(table, scalar, (unsigned char*)xs[0], CurveIsogeny);   
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }   
+        cycles2 = cpucycles();
+        cycles = cycles+(cycles2-cycles1);
     }
+    printf("  BigMont's fixed-base scalar multiplication runs in ........... %10lld ", cycles/BENCH_LOOPS); print_unit;
+    printf("\n");
 
-    Status = cryptorun_BigMont(&CurveIsogeny_SIDHp751);          // Benchmark elliptic curve "BigMont"
-    if (Status != CRYPTO_SUCCESS) {
-        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
-        return false;
+    for (j = 0; j < BIGMONT_BATCH_SIZE; j++) {
+        Status = random_BigMont_mod_order(&scalars[j*BIGMONT_NWORDS_ORDER], CurveIsogeny);    
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
     }
+
+    cycles = 0;
+    for (i = 0; i < BENCH_LOOPS; i++)
+    {        
+        cycles1 = cpucycles();
+        Status = BigMont_fixed_base_batch(table, scalars, (unsigned char*)xs, BIGMONT_BATCH_SIZE, CurveIsogeny);   
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }   
+        cycles2 = cpucycles();
+        cycles = cycles+(cycles2-cycles1);
+    }
+    printf("  BigMont's fixed-base batch of %2u runs in (per element) ...... %10lld ", BIGMONT_BATCH_SIZE, cycles/(BENCH_LOOPS*BIGMONT_BATCH_SIZE)); print_unit;
+    printf("\n");
+
+    cycles = 0;
+    for (i = 0; i < BENCH_LOOPS; i++)
+    {        
+        for (j = 0; j < BIGMONT_BATCH_SIZE; j++) {
+            fpcopy751(x[0], xs[j]);
+        }
+        cycles1 = cpucycles();
+        Status = BigMont_ladder_batch((unsigned char*)xs, scalars, (unsigned char*)xs, BIGMONT_BATCH_SIZE, CurveIsogeny);   
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }   
+        cycles2 = cpucycles();
+        cycles = cycles+(cycles2-cycles1);
+    }
+    printf("  BigMont's ladder batch of %2u runs in (per element) .......... %10lld ", BIGMONT_BATCH_SIZE, cycles/(BENCH_LOOPS*BIGMONT_BATCH_SIZE)); print_unit;
+    printf("\n");
+
+cleanup:
+    SIDH_curve_free(CurveIsogeny);
+    free(table);
+    free(scalars);
+    free(xs);
+
+    return Status;
+}
+
+
+CRYPTO_STATUS cryptotest_models(PCurveIsogenyStaticData CurveIsogenyData)
+{ // Testing key exchange with every combination of curve models for the point operations
+    unsigned int pbytes = (CurveIsogenyData->pwordbits + 7)/8;      // Number of bytes in a field element 
+    unsigned int obytes = (CurveIsogenyData->owordbits + 7)/8;      // Number of bytes in an element in [1, order]
+    unsigned int models;
+    unsigned char *PrivateKeyA, *PrivateKeyB, *PublicKeyA, *PublicKeyB, *CompressedPKA, *SharedSecretA, *SharedSecretB, *R, *A;
+    PCurveIsogenyStruct CurveIsogeny = {0};
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+    bool passed = true;
+        
+    // Allocating memory for private keys, public keys and shared secrets
+    PrivateKeyA = (unsigned char*)calloc(1, obytes);                   // One element in [1, order]  
+    PrivateKeyB = (unsigned char*)calloc(1, obytes);
+    PublicKeyA = (unsigned char*)calloc(1, 3*2*pbytes);                // Three elements in GF(p^2)
+    PublicKeyB = (unsigned char*)calloc(1, 3*2*pbytes);
+    CompressedPKA = (unsigned char*)calloc(1, 3*obytes + 2*pbytes);    // Three elements in [1, order] plus one field element
+    SharedSecretA = (unsigned char*)calloc(1, 2*pbytes);               // One element in GF(p^2)  
+    SharedSecretB = (unsigned char*)calloc(1, 2*pbytes);
+    R = (unsigned char*)calloc(1, 2*2*pbytes);                         // One point in (X:Z) coordinates 
+    A = (unsigned char*)calloc(1, 2*pbytes);                           // One element in GF(p^2)  
+
+    printf("\n\nTESTING CURVE MODEL SELECTION \n");
+    printf("--------------------------------------------------------------------------------------------------------\n\n");
+    printf("Curve isogeny system: %s \n\n", CurveIsogenyData->CurveIsogeny);
+
+    // Curve isogeny system initialization
+    CurveIsogeny = SIDH_curve_allocate(CurveIsogenyData);
+    if (CurveIsogeny == NULL) {
+        Status = CRYPTO_ERROR_NO_MEMORY;
+        goto cleanup;
+    }
+    Status = SIDH_curve_initialize(CurveIsogeny, &random_bytes_test, CurveIsogenyData);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    printf("  Models selected at initialization: doubling %s, tripling %s, ladder %s \n\n", 
+           (SIDH_DISPATCH(CurveIsogeny)->model_DBL == SIDH_MODEL_EDWARDS) ? "Edwards" : "Montgomery", 
+           (SIDH_DISPATCH(CurveIsogeny)->model_TPL == SIDH_MODEL_EDWARDS) ? "Edwards" : "Montgomery", 
+           (SIDH_DISPATCH(CurveIsogeny)->model_ladder == SIDH_MODEL_EDWARDS) ? "Edwards" : "Montgomery");
+
+    for (models = 0; models < 8 && passed; models++) 
+    {
+        Status = SIDH_curve_select_models(CurveIsogeny, models & 1, (models >> 1) & 1, (models >> 2) & 1);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = EphemeralKeyGeneration_A(PrivateKeyA, PublicKeyA, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = EphemeralKeyGeneration_B(PrivateKeyB, PublicKeyB, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = EphemeralSecretAgreement_A(PrivateKeyA, PublicKeyB, SharedSecretA, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = EphemeralSecretAgreement_B(PrivateKeyB, PublicKeyA, SharedSecretB, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        if (compare_words((digit_t*)SharedSecretA, (digit_t*)SharedSecretB, NBYTES_TO_NWORDS(2*pbytes)) != 0) {
+            passed = false;
+        }
+
+        PublicKeyCompression_A(PublicKeyA, CompressedPKA, CurveIsogeny);                                     // Alice's compression uses the doubling chain
+        PublicKeyADecompression_B(PrivateKeyB, CompressedPKA, R, A, CurveIsogeny);
+        Status = EphemeralSecretAgreement_Compression_B(PrivateKeyB, R, A, SharedSecretB, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        if (compare_words((digit_t*)SharedSecretA, (digit_t*)SharedSecretB, NBYTES_TO_NWORDS(2*pbytes)) != 0) {
+            passed = false;
+        }
+    }
+    if (passed == true) printf("  Key exchange tests with all curve models ..................... PASSED");
+    else { printf("  Key exchange tests with all curve models ... FAILED"); printf("\n"); Status = CRYPTO_ERROR_SHARED_KEY; goto cleanup; }
+    printf("\n"); 
+
+cleanup:
+    SIDH_curve_free(CurveIsogeny);    
+    free(PrivateKeyA);    
+    free(PrivateKeyB);    
+    free(PublicKeyA);    
+    free(PublicKeyB);    
+    free(CompressedPKA);    
+    free(SharedSecretA);    
+    free(SharedSecretB);
+    free(R);    
+    free(A); 
+
+    return Status;
+}
+
+
+CRYPTO_STATUS cryptorun_models(PCurveIsogenyStaticData CurveIsogenyData)
+{ // Benchmarking the curve models for each point operation, in the API function that uses it the most.
+  // The Edwards timings are also given relative to the Montgomery ones, e.g., the Edwards pipeline of Alice's tree against the (A+2C:4C) path.
+    unsigned int pbytes = (CurveIsogenyData->pwordbits + 7)/8;      // Number of bytes in a field element 
+    unsigned int n, role, model, obytes = (CurveIsogenyData->owordbits + 7)/8;   // Number of bytes in an element in [1, order]
+    unsigned int selected[3];
+    unsigned char *PrivateKeyA, *PrivateKeyB, *PublicKeyA, *PublicKeyB, *SharedSecretA, *SharedSecretB;
+    PCurveIsogenyStruct CurveIsogeny = {0};
+    unsigned long long cycles, cycles1, cycles2, model_cycles[2];
+    const char* roles[3] = { "Doubling/4-isogeny pipeline, Alice's shared key", "Tripling, Bob's shared key", "Base-field ladder, Alice's key generation" };
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+        
+    // Allocating memory for private keys, public keys and shared secrets
+    PrivateKeyA = (unsigned char*)calloc(1, obytes);        // One element in [1, order]  
+    PrivateKeyB = (unsigned char*)calloc(1, obytes);
+    PublicKeyA = (unsigned char*)calloc(1, 3*2*pbytes);     // Three elements in GF(p^2)
+    PublicKeyB = (unsigned char*)calloc(1, 3*2*pbytes);
+    SharedSecretA = (unsigned char*)calloc(1, 2*pbytes);    // One element in GF(p^2)  
+    SharedSecretB = (unsigned char*)calloc(1, 2*pbytes);
+
+    printf("\n\nBENCHMARKING CURVE MODELS \n");
+    printf("--------------------------------------------------------------------------------------------------------\n\n");
+    printf("Curve isogeny system: %s \n\n", CurveIsogenyData->CurveIsogeny);
+
+    // Curve isogeny system initialization
+    CurveIsogeny = SIDH_curve_allocate(CurveIsogenyData);
+    if (CurveIsogeny == NULL) {
+        Status = CRYPTO_ERROR_NO_MEMORY;
+        goto cleanup;
+    }
+    Status = SIDH_curve_initialize(CurveIsogeny, &random_bytes_test, CurveIsogenyData);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    Status = EphemeralKeyGeneration_A(PrivateKeyA, PublicKeyA, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) goto cleanup;
+    Status = EphemeralKeyGeneration_B(PrivateKeyB, PublicKeyB, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) goto cleanup;
+
+    for (role = 0; role < 3; role++) {
+        for (model = 0; model < 2; model++) {
+            selected[0] = SIDH_DISPATCH(CurveIsogeny)->model_DBL;
+            selected[1] = SIDH_DISPATCH(CurveIsogeny)->model_TPL;
+            selected[2] = SIDH_DISPATCH(CurveIsogeny)->model_ladder;
+            selected[role] = model;
+            SIDH_curve_select_models(CurveIsogeny, selected[0], selected[1], selected[2]);
+
+            cycles = 0;
+            for (n = 0; n < BENCH_LOOPS; n++)
+            {
+                cycles1 = cpucycles();
+                if (role == 0) Status = EphemeralSecretAgreement_A(PrivateKeyA, PublicKeyB, SharedSecretA, CurveIsogeny);
+                else if (role == 1) Status = EphemeralSecretAgreement_B(PrivateKeyB, PublicKeyA, SharedSecretB, CurveIsogeny);
+                else Status = EphemeralKeyGeneration_A(PrivateKeyA, PublicKeyA, CurveIsogeny);
+                cycles2 = cpucycles();
+                if (Status != CRYPTO_SUCCESS) goto cleanup;
+                cycles = cycles+(cycles2-cycles1);
+            }
+            model_cycles[model] = cycles/BENCH_LOOPS;
+            printf("  %-48s %-10s runs in ..... %10lld ", roles[role], (model == SIDH_MODEL_EDWARDS) ? "Edwards" : "Montgomery", cycles/BENCH_LOOPS); print_unit;
+            if (model == SIDH_MODEL_EDWARDS && model_cycles[SIDH_MODEL_MONTGOMERY] != 0) {
+                printf(" (%+.1f%% vs Montgomery)", 100.0*((double)model_cycles[SIDH_MODEL_EDWARDS]/(double)model_cycles[SIDH_MODEL_MONTGOMERY] - 1.0));
+            }
+            printf("\n");
+        }
+    }
+
+cleanup:
+    SIDH_curve_free(CurveIsogeny);    
+    free(PrivateKeyA);    
+    free(PrivateKeyB);    
+    free(PublicKeyA);    
+    free(PublicKeyB);    
+    free(SharedSecretA);    
+    free(SharedSecretB);
+
+    return Status;
+}
+
+
+static unsigned long long strategy_agreement_cycles(unsigned char* PrivateKeyA, unsigned char* PrivateKeyB, unsigned char* PublicKeyA, unsigned char* PublicKeyB, 
+                                                    unsigned char* SharedSecretA, unsigned char* SharedSecretB, unsigned int AliceOrBob, PCurveIsogenyStruct CurveIsogeny, CRYPTO_STATUS* Status)
+{ // Average cycles of Alice's (AliceOrBob = 0) or Bob's (AliceOrBob = 1) shared key computation with the strategies currently set in CurveIsogeny
+    unsigned long long cycles = 0, cycles1, cycles2;
+    unsigned int n;
+
+    for (n = 0; n < BENCH_LOOPS; n++)
+    {
+        cycles1 = cpucycles();
+        if (AliceOrBob == ALICE) {
+            *Status = EphemeralSecretAgreement_A(PrivateKeyA, PublicKeyB, SharedSecretA, CurveIsogeny);
+        } else {
+            *Status = EphemeralSecretAgreement_B(PrivateKeyB, PublicKeyA, SharedSecretB, CurveIsogeny);
+        }
+        cycles2 = cpucycles();
+        if (*Status != CRYPTO_SUCCESS) {
+            return 0;
+        }
+        cycles = cycles+(cycles2-cycles1);
+    }
+    return cycles/BENCH_LOOPS;
+}
+
+
+CRYPTO_STATUS cryptorun_strategies(PCurveIsogenyStaticData CurveIsogenyData)
+{ // Tuning the isogeny tree strategies to the costs of the point operations measured on this machine
+  // The predicted cost counts only point multiplications and isogeny evaluations inside the tree; the measured cost is that of the full shared key computation.
+    unsigned int pbytes = (CurveIsogenyData->pwordbits + 7)/8;      // Number of bytes in a field element 
+    unsigned int n, obytes = (CurveIsogenyData->owordbits + 7)/8;   // Number of bytes in an element in [1, order]
+    unsigned char *PrivateKeyA, *PrivateKeyB, *PublicKeyA, *PublicKeyB, *SharedSecretA, *SharedSecretB;
+    PCurveIsogenyStruct CurveIsogeny = {0};
+    point_proj_t P, R;
+    f2elm_t A, C, coeff[5];
+    unsigned long long cycles1, cycles2, cyc_dbl, cyc_eval4, cyc_tpl, cyc_eval3, measured[4];
+    uint64_t predicted[4];
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+    bool passed = true;
+        
+    // Allocating memory for private keys, public keys and shared secrets
+    PrivateKeyA = (unsigned char*)calloc(1, obytes);        // One element in [1, order]  
+    PrivateKeyB = (unsigned char*)calloc(1, obytes);
+    PublicKeyA = (unsigned char*)calloc(1, 3*2*pbytes);     // Three elements in GF(p^2)
+    PublicKeyB = (unsigned char*)calloc(1, 3*2*pbytes);
+    SharedSecretA = (unsigned char*)calloc(1, 2*pbytes);    // One element in GF(p^2)  
+    SharedSecretB = (unsigned char*)calloc(1, 2*pbytes);
+
+    printf("\n\nTUNING ISOGENY TREE STRATEGIES \n");
+    printf("--------------------------------------------------------------------------------------------------------\n\n");
+    printf("Curve isogeny system: %s \n\n", CurveIsogenyData->CurveIsogeny);
+
+    // Curve isogeny system initialization
+    CurveIsogeny = SIDH_curve_allocate(CurveIsogenyData);
+    if (CurveIsogeny == NULL) {
+        Status = CRYPTO_ERROR_NO_MEMORY;
+        goto cleanup;
+    }
+    Status = SIDH_curve_initialize(CurveIsogeny, &random_bytes_test, CurveIsogenyData);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+
+    // Operands for the point operations, their values do not affect the timings
+    fp2zero751(P->X); fp2zero751(P->Z);
+    to_mont((digit_t*)CurveIsogeny->PA, P->X[0]);
+    fpcopy751(CurveIsogeny->Montgomery_one, P->Z[0]);
+    to_mont((digit_t*)CurveIsogeny->PB, P->Z[1]);
+    fp2copy751(P->X, A); fp2copy751(P->Z, C);
+    for (n = 0; n < 5; n++) {
+        fp2add751(A, C, A);
+        fp2copy751(A, coeff[n]);
+    }
+    fp2copy751(P->X, R->X); fp2copy751(P->Z, R->Z);
+
+    // Measuring the cost of the point operations, using the curve models selected at initialization
+    cycles1 = cpucycles();
+    for (n = 0; n < STRATEGY_BENCH_LOOPS; n++) SIDH_DISPATCH(CurveIsogeny)->DBLe(R, R, A, C, 2);
+    cycles2 = cpucycles();
+    cyc_dbl = (cycles2-cycles1)/STRATEGY_BENCH_LOOPS;
+    cycles1 = cpucycles();
+    for (n = 0; n < STRATEGY_BENCH_LOOPS; n++) SIDH_DISPATCH(CurveIsogeny)->eval_4_isog(R, coeff);
+    cycles2 = cpucycles();
+    cyc_eval4 = (cycles2-cycles1)/STRATEGY_BENCH_LOOPS;
+    cycles1 = cpucycles();
+    for (n = 0; n < STRATEGY_BENCH_LOOPS; n++) SIDH_DISPATCH(CurveIsogeny)->TPLe(R, R, A, C, 1);
+    cycles2 = cpucycles();
+    cyc_tpl = (cycles2-cycles1)/STRATEGY_BENCH_LOOPS;
+    cycles1 = cpucycles();
+    for (n = 0; n < STRATEGY_BENCH_LOOPS; n++) eval_3_isog_coeff(R, coeff);
+    cycles2 = cpucycles();
+    cyc_eval3 = (cycles2-cycles1)/STRATEGY_BENCH_LOOPS;
+    if (cyc_dbl == 0 || cyc_eval4 == 0 || cyc_tpl == 0 || cyc_eval3 == 0) {     // Timer too coarse to tune
+        printf("  Point operations too fast to be measured, strategies not tuned \n");
+        goto cleanup;
+    }
+    printf("  Doubling step (two doublings) runs in .......................... %10lld ", cyc_dbl); print_unit; printf("\n");
+    printf("  4-isogeny evaluation runs in ................................... %10lld ", cyc_eval4); print_unit; printf("\n");
+    printf("  Tripling step runs in .......................................... %10lld ", cyc_tpl); print_unit; printf("\n");
+    printf("  3-isogeny evaluation (eval_3_isog_coeff) runs in ............... %10lld ", cyc_eval3); print_unit; printf("\n\n");
+
+    // Default strategies
+    Status = EphemeralKeyGeneration_A(PrivateKeyA, PublicKeyA, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) goto cleanup;
+    Status = EphemeralKeyGeneration_B(PrivateKeyB, PublicKeyB, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) goto cleanup;
+    predicted[0] = SIDH_strategy_cost(CurveIsogeny, ALICE, (unsigned int)cyc_dbl, (unsigned int)cyc_eval4);
+    predicted[1] = SIDH_strategy_cost(CurveIsogeny, BOB, (unsigned int)cyc_tpl, (unsigned int)cyc_eval3);
+    measured[0] = strategy_agreement_cycles(PrivateKeyA, PrivateKeyB, PublicKeyA, PublicKeyB, SharedSecretA, SharedSecretB, ALICE, CurveIsogeny, &Status);
+    if (Status != CRYPTO_SUCCESS) goto cleanup;
+    measured[1] = strategy_agreement_cycles(PrivateKeyA, PrivateKeyB, PublicKeyA, PublicKeyB, SharedSecretA, SharedSecretB, BOB, CurveIsogeny, &Status);
+    if (Status != CRYPTO_SUCCESS) goto cleanup;
+
+    // Tuned strategies
+    Status = SIDH_curve_set_strategies(CurveIsogeny, (unsigned int)cyc_dbl, (unsigned int)cyc_eval4, (unsigned int)cyc_tpl, (unsigned int)cyc_eval3);
+    if (Status != CRYPTO_SUCCESS) goto cleanup;
+    predicted[2] = SIDH_strategy_cost(CurveIsogeny, ALICE, (unsigned int)cyc_dbl, (unsigned int)cyc_eval4);
+    predicted[3] = SIDH_strategy_cost(CurveIsogeny, BOB, (unsigned int)cyc_tpl, (unsigned int)cyc_eval3);
+    measured[2] = strategy_agreement_cycles(PrivateKeyA, PrivateKeyB, PublicKeyA, PublicKeyB, SharedSecretA, SharedSecretB, ALICE, CurveIsogeny, &Status);
+    if (Status != CRYPTO_SUCCESS) goto cleanup;
+    measured[3] = strategy_agreement_cycles(PrivateKeyA, PrivateKeyB, PublicKeyA, PublicKeyB, SharedSecretA, SharedSecretB, BOB, CurveIsogeny, &Status);
+    if (Status != CRYPTO_SUCCESS) goto cleanup;
+
+    printf("  Alice's tree, default strategy: predicted %10lld, measured shared key %10lld ", (unsigned long long)predicted[0], measured[0]); print_unit; printf("\n");
+    printf("  Alice's tree, tuned strategy:   predicted %10lld, measured shared key %10lld ", (unsigned long long)predicted[2], measured[2]); print_unit; printf("\n");
+    printf("  Bob's tree, default strategy:   predicted %10lld, measured shared key %10lld ", (unsigned long long)predicted[1], measured[1]); print_unit; printf("\n");
+    printf("  Bob's tree, tuned strategy:     predicted %10lld, measured shared key %10lld ", (unsigned long long)predicted[3], measured[3]); print_unit; printf("\n\n");
+
+    // The tuned strategies must still agree on the shared secret
+    if (predicted[0] == 0 || predicted[1] == 0 || predicted[2] == 0 || predicted[3] == 0 || memcmp(SharedSecretA, SharedSecretB, 2*pbytes) != 0) {
+        passed = false;
+        Status = CRYPTO_ERROR_SHARED_KEY;
+    }
+    if (passed == true) printf("  Key exchange tests with tuned strategies ..................... PASSED");
+    else { printf("  Key exchange tests with tuned strategies ... FAILED"); printf("\n"); goto cleanup; }
+    printf("\n"); 
+
+cleanup:
+    SIDH_curve_free(CurveIsogeny);    
+    free(PrivateKeyA);    
+    free(PrivateKeyB);    
+    free(PublicKeyA);    
+    free(PublicKeyB);    
+    free(SharedSecretA);    
+    free(SharedSecretB);
+
+    return Status;
+}
+
+
+CRYPTO_STATUS cryptotest_isogeny_degrees(PCurveIsogenyStaticData CurveIsogenyData)
+{ // Testing key exchange with every combination of isogeny degrees in the trees, with and without compression
+    unsigned int pbytes = (CurveIsogenyData->pwordbits + 7)/8;      // Number of bytes in a field element 
+    unsigned int obytes = (CurveIsogenyData->owordbits + 7)/8;      // Number of bytes in an element in [1, order]
+    unsigned int degrees;
+    unsigned char *PrivateKeyA, *PrivateKeyB, *PublicKeyA, *PublicKeyB, *CompressedPKA, *CompressedPKB, *SharedSecretA, *SharedSecretB, *R, *A;
+    PCurveIsogenyStruct CurveIsogeny = {0};
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+    bool passed = true;
+        
+    // Allocating memory for private keys, public keys and shared secrets
+    PrivateKeyA = (unsigned char*)calloc(1, obytes);                   // One element in [1, order]  
+    PrivateKeyB = (unsigned char*)calloc(1, obytes);
+    PublicKeyA = (unsigned char*)calloc(1, 3*2*pbytes);                // Three elements in GF(p^2)
+    PublicKeyB = (unsigned char*)calloc(1, 3*2*pbytes);
+    CompressedPKA = (unsigned char*)calloc(1, 3*obytes + 2*pbytes);    // Three elements in [1, order] plus one field element
+    CompressedPKB = (unsigned char*)calloc(1, 3*obytes + 2*pbytes);
+    SharedSecretA = (unsigned char*)calloc(1, 2*pbytes);               // One element in GF(p^2)  
+    SharedSecretB = (unsigned char*)calloc(1, 2*pbytes);
+    R = (unsigned char*)calloc(1, 2*2*pbytes);                         // One point in (X:Z) coordinates 
+    A = (unsigned char*)calloc(1, 2*pbytes);                           // One element in GF(p^2)  
+
+    printf("\n\nTESTING ISOGENY DEGREES \n");
+    printf("--------------------------------------------------------------------------------------------------------\n\n");
+    printf("Curve isogeny system: %s \n\n", CurveIsogenyData->CurveIsogeny);
+
+    // Curve isogeny system initialization
+    CurveIsogeny = SIDH_curve_allocate(CurveIsogenyData);
+    if (CurveIsogeny == NULL) {
+        Status = CRYPTO_ERROR_NO_MEMORY;
+        goto cleanup;
+    }
+    Status = SIDH_curve_initialize(CurveIsogeny, &random_bytes_test, CurveIsogenyData);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+
+    for (degrees = 0; degrees < 4 && passed; degrees++) 
+    {
+        Status = SIDH_curve_set_isogeny_degrees(CurveIsogeny, (degrees & 1) ? 8 : 4, (degrees & 2) ? 9 : 3);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = EphemeralKeyGeneration_A(PrivateKeyA, PublicKeyA, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = EphemeralKeyGeneration_B(PrivateKeyB, PublicKeyB, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = EphemeralSecretAgreement_A(PrivateKeyA, PublicKeyB, SharedSecretA, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = EphemeralSecretAgreement_B(PrivateKeyB, PublicKeyA, SharedSecretB, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        if (compare_words((digit_t*)SharedSecretA, (digit_t*)SharedSecretB, NBYTES_TO_NWORDS(2*pbytes)) != 0) {
+            passed = false;
+        }
+
+        PublicKeyCompression_A(PublicKeyA, CompressedPKA, CurveIsogeny);
+        PublicKeyADecompression_B(PrivateKeyB, CompressedPKA, R, A, CurveIsogeny);
+        Status = EphemeralSecretAgreement_Compression_B(PrivateKeyB, R, A, SharedSecretB, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        if (compare_words((digit_t*)SharedSecretA, (digit_t*)SharedSecretB, NBYTES_TO_NWORDS(2*pbytes)) != 0) {
+            passed = false;
+        }
+
+        PublicKeyCompression_B(PublicKeyB, CompressedPKB, CurveIsogeny);
+        PublicKeyBDecompression_A(PrivateKeyA, CompressedPKB, R, A, CurveIsogeny);
+        Status = EphemeralSecretAgreement_Compression_A(PrivateKeyA, R, A, SharedSecretA, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        if (compare_words((digit_t*)SharedSecretA, (digit_t*)SharedSecretB, NBYTES_TO_NWORDS(2*pbytes)) != 0) {
+            passed = false;
+        }
+    }
+    if (passed == true) printf("  Key exchange tests with 4/8- and 3/9-isogeny trees ........... PASSED");
+    else { printf("  Key exchange tests with 4/8- and 3/9-isogeny trees ... FAILED"); printf("\n"); Status = CRYPTO_ERROR_SHARED_KEY; goto cleanup; }
+    printf("\n"); 
+
+cleanup:
+    SIDH_curve_free(CurveIsogeny);    
+    free(PrivateKeyA);    
+    free(PrivateKeyB);    
+    free(PublicKeyA);    
+    free(PublicKeyB);    
+    free(CompressedPKA);    
+    free(CompressedPKB);    
+    free(SharedSecretA);    
+    free(SharedSecretB);
+    free(R);    
+    free(A); 
+
+    return Status;
+}
+
+
+static CRYPTO_STATUS degree_kex_cycles(unsigned char* PrivateKeyA, unsigned char* PrivateKeyB, unsigned char* PublicKeyA, unsigned char* PublicKeyB, 
+                                       unsigned char* SharedSecretA, unsigned char* SharedSecretB, PCurveIsogenyStruct CurveIsogeny, unsigned long long* cycles)
+{ // Average cycles of Alice's and Bob's key generation and shared key computation, in cycles[0..3]
+    unsigned int n, function;
+    unsigned long long cycles1, cycles2;
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+
+    for (function = 0; function < 4; function++) {
+        cycles[function] = 0;
+        for (n = 0; n < BENCH_LOOPS; n++)
+        {
+            cycles1 = cpucycles();
+            if (function == 0) Status = EphemeralKeyGeneration_A(PrivateKeyA, PublicKeyA, CurveIsogeny);
+            else if (function == 1) Status = EphemeralKeyGeneration_B(PrivateKeyB, PublicKeyB, CurveIsogeny);
+            else if (function == 2) Status = EphemeralSecretAgreement_A(PrivateKeyA, PublicKeyB, SharedSecretA, CurveIsogeny);
+            else Status = EphemeralSecretAgreement_B(PrivateKeyB, PublicKeyA, SharedSecretB, CurveIsogeny);
+            cycles2 = cpucycles();
+            if (Status != CRYPTO_SUCCESS) return Status;
+            cycles[function] = cycles[function]+(cycles2-cycles1);
+        }
+        cycles[function] = cycles[function]/BENCH_LOOPS;
+    }
+    return Status;
+}
+
+
+CRYPTO_STATUS cryptorun_isogeny_degrees(PCurveIsogenyStaticData CurveIsogenyData)
+{ // Benchmarking the trees of 8- and 9-isogenies against the trees of 4- and 3-isogenies
+    unsigned int pbytes = (CurveIsogenyData->pwordbits + 7)/8;      // Number of bytes in a field element 
+    unsigned int n, setting, obytes = (CurveIsogenyData->owordbits + 7)/8;   // Number of bytes in an element in [1, order]
+    unsigned char *PrivateKeyA, *PrivateKeyB, *PublicKeyA, *PublicKeyB, *SharedSecretA, *SharedSecretB;
+    PCurveIsogenyStruct CurveIsogeny = {0};
+    point_proj_t R;
+    f2elm_t A, C, coeff[5];
+    unsigned long long cycles1, cycles2, cyc_dbl, cyc_eval8, cyc_tpl, cyc_eval9, cycles[3][4];
+    const char* settings[3] = { "4- and 3-isogenies", "8- and 9-isogenies", "8- and 9-isogenies, tuned" };
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+        
+    // Allocating memory for private keys, public keys and shared secrets
+    PrivateKeyA = (unsigned char*)calloc(1, obytes);        // One element in [1, order]  
+    PrivateKeyB = (unsigned char*)calloc(1, obytes);
+    PublicKeyA = (unsigned char*)calloc(1, 3*2*pbytes);     // Three elements in GF(p^2)
+    PublicKeyB = (unsigned char*)calloc(1, 3*2*pbytes);
+    SharedSecretA = (unsigned char*)calloc(1, 2*pbytes);    // One element in GF(p^2)  
+    SharedSecretB = (unsigned char*)calloc(1, 2*pbytes);
+
+    printf("\n\nBENCHMARKING ISOGENY DEGREES \n");
+    printf("--------------------------------------------------------------------------------------------------------\n\n");
+    printf("Curve isogeny system: %s \n\n", CurveIsogenyData->CurveIsogeny);
+
+    // Curve isogeny system initialization
+    CurveIsogeny = SIDH_curve_allocate(CurveIsogenyData);
+    if (CurveIsogeny == NULL) {
+        Status = CRYPTO_ERROR_NO_MEMORY;
+        goto cleanup;
+    }
+    Status = SIDH_curve_initialize(CurveIsogeny, &random_bytes_test, CurveIsogenyData);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+
+    Status = degree_kex_cycles(PrivateKeyA, PrivateKeyB, PublicKeyA, PublicKeyB, SharedSecretA, SharedSecretB, CurveIsogeny, cycles[0]);
+    if (Status != CRYPTO_SUCCESS) goto cleanup;
+    Status = SIDH_curve_set_isogeny_degrees(CurveIsogeny, 8, 9);
+    if (Status != CRYPTO_SUCCESS) goto cleanup;
+    Status = degree_kex_cycles(PrivateKeyA, PrivateKeyB, PublicKeyA, PublicKeyB, SharedSecretA, SharedSecretB, CurveIsogeny, cycles[1]);
+    if (Status != CRYPTO_SUCCESS) goto cleanup;
+
+    // Strategies of the trees of 8- and 9-isogenies tuned to the costs of their steps on this machine
+    fp2zero751(R->X); fp2zero751(R->Z);
+    to_mont((digit_t*)CurveIsogeny->PA, R->X[0]);
+    fpcopy751(CurveIsogeny->Montgomery_one, R->Z[0]);
+    to_mont((digit_t*)CurveIsogeny->PB, R->Z[1]);
+    fp2copy751(R->X, A); fp2copy751(R->Z, C);
+    for (n = 0; n < 5; n++) {
+        fp2add751(A, C, A);
+        fp2copy751(A, coeff[n]);
+    }
+    cycles1 = cpucycles();
+    for (n = 0; n < STRATEGY_BENCH_LOOPS; n++) xDBLe_A24(R, R, A, C, 3);
+    cycles2 = cpucycles();
+    cyc_dbl = (cycles2-cycles1)/STRATEGY_BENCH_LOOPS;
+    cycles1 = cpucycles();
+    for (n = 0; n < STRATEGY_BENCH_LOOPS; n++) eval_8_isog(R, coeff);
+    cycles2 = cpucycles();
+    cyc_eval8 = (cycles2-cycles1)/STRATEGY_BENCH_LOOPS;
+    cycles1 = cpucycles();
+    for (n = 0; n < STRATEGY_BENCH_LOOPS; n++) SIDH_DISPATCH(CurveIsogeny)->TPLe(R, R, A, C, 2);
+    cycles2 = cpucycles();
+    cyc_tpl = (cycles2-cycles1)/STRATEGY_BENCH_LOOPS;
+    cycles1 = cpucycles();
+    for (n = 0; n < STRATEGY_BENCH_LOOPS; n++) eval_9_isog(R, coeff);
+    cycles2 = cpucycles();
+    cyc_eval9 = (cycles2-cycles1)/STRATEGY_BENCH_LOOPS;
+    if (cyc_dbl == 0 || cyc_eval8 == 0 || cyc_tpl == 0 || cyc_eval9 == 0) {     // Timer too coarse to tune
+        printf("  Point operations too fast to be measured, strategies not tuned \n");
+        goto cleanup;
+    }
+    Status = SIDH_curve_set_strategies(CurveIsogeny, (unsigned int)cyc_dbl, (unsigned int)cyc_eval8, (unsigned int)cyc_tpl, (unsigned int)cyc_eval9);
+    if (Status != CRYPTO_SUCCESS) goto cleanup;
+    Status = degree_kex_cycles(PrivateKeyA, PrivateKeyB, PublicKeyA, PublicKeyB, SharedSecretA, SharedSecretB, CurveIsogeny, cycles[2]);
+    if (Status != CRYPTO_SUCCESS) goto cleanup;
+
+    printf("  Doubling step (three doublings) runs in ........................ %10lld ", cyc_dbl); print_unit; printf("\n");
+    printf("  8-isogeny evaluation runs in ................................... %10lld ", cyc_eval8); print_unit; printf("\n");
+    printf("  Tripling step (two triplings) runs in .......................... %10lld ", cyc_tpl); print_unit; printf("\n");
+    printf("  9-isogeny evaluation runs in ................................... %10lld ", cyc_eval9); print_unit; printf("\n\n");
+    for (setting = 0; setting < 3; setting++) {
+        printf("  %s: \n", settings[setting]);
+        printf("    Alice's key generation runs in ............................... %10lld ", cycles[setting][0]); print_unit; printf("\n");
+        printf("    Bob's key generation runs in ................................. %10lld ", cycles[setting][1]); print_unit; printf("\n");
+        printf("    Alice's shared key computation runs in ....................... %10lld ", cycles[setting][2]); print_unit; printf("\n");
+        printf("    Bob's shared key computation runs in ......................... %10lld ", cycles[setting][3]); print_unit; printf("\n");
+    }
+
+cleanup:
+    SIDH_curve_free(CurveIsogeny);    
+    free(PrivateKeyA);    
+    free(PrivateKeyB);    
+    free(PublicKeyA);    
+    free(PublicKeyB);    
+    free(SharedSecretA);    
+    free(SharedSecretB);
+
+    return Status;
+}
+
+
+CRYPTO_STATUS cryptotest_ph_workers(PCurveIsogenyStaticData CurveIsogenyData)
+{ // Testing public key compression with the discrete logarithms shared by 1, 2 and 4 threads
+    unsigned int pbytes = (CurveIsogenyData->pwordbits + 7)/8;      // Number of bytes in a field element 
+    unsigned int n, workers, obytes = (CurveIsogenyData->owordbits + 7)/8;   // Number of bytes in an element in [1, order]
+    unsigned int cbytes = 3*obytes + 2*pbytes;                      // Number of bytes in a compressed public key
+    unsigned char *PrivateKeyA, *PrivateKeyB, *PublicKeyA, *PublicKeyB, *CompressedPKA, *CompressedPKB, *CompressedPK;
+    PCurveIsogenyStruct CurveIsogeny = {0};
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+    bool passed = true;
+        
+    // Allocating memory for private keys, public keys and compressed public keys
+    PrivateKeyA = (unsigned char*)calloc(1, obytes);        // One element in [1, order]  
+    PrivateKeyB = (unsigned char*)calloc(1, obytes);
+    PublicKeyA = (unsigned char*)calloc(1, 3*2*pbytes);     // Three elements in GF(p^2)
+    PublicKeyB = (unsigned char*)calloc(1, 3*2*pbytes);
+    CompressedPKA = (unsigned char*)calloc(1, cbytes);      // Three elements in [1, order] plus one field element
+    CompressedPKB = (unsigned char*)calloc(1, cbytes);
+    CompressedPK = (unsigned char*)calloc(1, cbytes);
+
+    printf("\n\nTESTING MULTITHREADED PUBLIC KEY COMPRESSION \n");
+    printf("--------------------------------------------------------------------------------------------------------\n\n");
+    printf("Curve isogeny system: %s \n\n", CurveIsogenyData->CurveIsogeny);
+
+    // Curve isogeny system initialization
+    CurveIsogeny = SIDH_curve_allocate(CurveIsogenyData);
+    if (CurveIsogeny == NULL) {
+        Status = CRYPTO_ERROR_NO_MEMORY;
+        goto cleanup;
+    }
+    Status = SIDH_curve_initialize(CurveIsogeny, &random_bytes_test, CurveIsogenyData);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+
+    for (n = 0; n < TEST_LOOPS/10 + 1 && passed; n++) 
+    {
+        Status = EphemeralKeyGeneration_A(PrivateKeyA, PublicKeyA, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = EphemeralKeyGeneration_B(PrivateKeyB, PublicKeyB, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        SIDH_curve_set_ph_workers(CurveIsogeny, 1);
+        PublicKeyCompression_A(PublicKeyA, CompressedPKA, CurveIsogeny);
+        PublicKeyCompression_B(PublicKeyB, CompressedPKB, CurveIsogeny);
+
+        // The compressed keys do not depend on the number of workers
+        for (workers = 2; workers <= SIDH_MAX_PH_WORKERS; workers *= 2) {
+            Status = SIDH_curve_set_ph_workers(CurveIsogeny, workers);
+            if (Status != CRYPTO_SUCCESS) {
+                goto cleanup;
+            }
+            PublicKeyCompression_A(PublicKeyA, CompressedPK, CurveIsogeny);
+            if (memcmp(CompressedPK, CompressedPKA, cbytes) != 0) {
+                passed = false;
+            }
+            PublicKeyCompression_B(PublicKeyB, CompressedPK, CurveIsogeny);
+            if (memcmp(CompressedPK, CompressedPKB, cbytes) != 0) {
+                passed = false;
+            }
+        }
+    }
+    if (SIDH_curve_set_ph_workers(CurveIsogeny, 2) == CRYPTO_ERROR_NOT_IMPLEMENTED) {
+        printf("  Multithreading not enabled in this build, tested with 1 worker only \n");
+    }
+    if (passed == true) printf("  Compression tests with 1, 2 and 4 workers ..................... PASSED");
+    else { printf("  Compression tests with 1, 2 and 4 workers ... FAILED"); printf("\n"); Status = CRYPTO_ERROR_DURING_TEST; goto cleanup; }
+    printf("\n"); 
+
+cleanup:
+    SIDH_curve_free(CurveIsogeny);    
+    free(PrivateKeyA);    
+    free(PrivateKeyB);    
+    free(PublicKeyA);    
+    free(PublicKeyB);    
+    free(CompressedPKA);    
+    free(CompressedPKB);    
+    free(CompressedPK);
+
+    return Status;
+}
+
+
+CRYPTO_STATUS cryptorun_ph_workers(PCurveIsogenyStaticData CurveIsogenyData)
+{ // Benchmarking public key compression with the discrete logarithms shared by 1, 2 and 4 threads
+    unsigned int pbytes = (CurveIsogenyData->pwordbits + 7)/8;      // Number of bytes in a field element 
+    unsigned int n, workers, obytes = (CurveIsogenyData->owordbits + 7)/8;   // Number of bytes in an element in [1, order]
+    unsigned char *PrivateKeyA, *PrivateKeyB, *PublicKeyA, *PublicKeyB, *CompressedPK;
+    PCurveIsogenyStruct CurveIsogeny = {0};
+    unsigned long long cyclesA, cyclesB, cycles1, cycles2;
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+        
+    // Allocating memory for private keys, public keys and compressed public keys
+    PrivateKeyA = (unsigned char*)calloc(1, obytes);        // One element in [1, order]  
+    PrivateKeyB = (unsigned char*)calloc(1, obytes);
+    PublicKeyA = (unsigned char*)calloc(1, 3*2*pbytes);     // Three elements in GF(p^2)
+    PublicKeyB = (unsigned char*)calloc(1, 3*2*pbytes);
+    CompressedPK = (unsigned char*)calloc(1, 3*obytes + 2*pbytes);    // Three elements in [1, order] plus one field element
+
+    printf("\n\nBENCHMARKING MULTITHREADED PUBLIC KEY COMPRESSION (latency) \n");
+    printf("--------------------------------------------------------------------------------------------------------\n\n");
+    printf("Curve isogeny system: %s \n\n", CurveIsogenyData->CurveIsogeny);
+
+    // Curve isogeny system initialization
+    CurveIsogeny = SIDH_curve_allocate(CurveIsogenyData);
+    if (CurveIsogeny == NULL) {
+        Status = CRYPTO_ERROR_NO_MEMORY;
+        goto cleanup;
+    }
+    Status = SIDH_curve_initialize(CurveIsogeny, &random_bytes_test, CurveIsogenyData);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    Status = EphemeralKeyGeneration_A(PrivateKeyA, PublicKeyA, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) goto cleanup;
+    Status = EphemeralKeyGeneration_B(PrivateKeyB, PublicKeyB, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) goto cleanup;
+
+    for (workers = 1; workers <= 4; workers *= 2) {
+        Status = SIDH_curve_set_ph_workers(CurveIsogeny, workers);
+        if (Status == CRYPTO_ERROR_NOT_IMPLEMENTED) {
+            printf("  %u workers: multithreading not enabled in this build \n", workers);
+            Status = CRYPTO_SUCCESS;
+            continue;
+        }
+        if (Status != CRYPTO_SUCCESS) goto cleanup;
+
+        cyclesA = 0;
+        cyclesB = 0;
+        for (n = 0; n < BENCH_LOOPS; n++)
+        {
+            cycles1 = cpucycles();
+            PublicKeyCompression_A(PublicKeyA, CompressedPK, CurveIsogeny);
+            cycles2 = cpucycles();
+            cyclesA = cyclesA+(cycles2-cycles1);
+            cycles1 = cpucycles();
+            PublicKeyCompression_B(PublicKeyB, CompressedPK, CurveIsogeny);
+            cycles2 = cpucycles();
+            cyclesB = cyclesB+(cycles2-cycles1);
+        }
+        printf("  %u workers: \n", workers);
+        printf("    Alice's public key compression runs in ....................... %10lld ", cyclesA/BENCH_LOOPS); print_unit; printf("\n");
+        printf("    Bob's public key compression runs in ......................... %10lld ", cyclesB/BENCH_LOOPS); print_unit; printf("\n");
+    }
+
+cleanup:
+    SIDH_curve_free(CurveIsogeny);    
+    free(PrivateKeyA);    
+    free(PrivateKeyB);    
+    free(PublicKeyA);    
+    free(PublicKeyB);    
+    free(CompressedPK);
+
+    return Status;
+}
+
+
+CRYPTO_STATUS cryptotest_encoding(PCurveIsogenyStaticData CurveIsogenyData)
+{ // Testing key exchange with public keys and shared secrets in Montgomery wire encoding
+    unsigned int i, j, seed, pbytes = (CurveIsogenyData->pwordbits + 7)/8;   // Number of bytes in a field element 
+    unsigned int obytes = (CurveIsogenyData->owordbits + 7)/8;               // Number of bytes in an element in [1, order]
+    unsigned int cbytes = 3*obytes + 2*pbytes;                                // Number of bytes in a compressed public key
+    unsigned char *PrivateKeyA, *PrivateKeyB, *PublicKeyA, *PublicKeyB, *PublicKeyA_mont, *PublicKeyB_mont, *SharedSecretA, *SharedSecretB, *SharedSecret_mont;
+    unsigned char *CompressedPK, *CompressedPK_mont, *zero;
+    PCurveIsogenyStruct CurveIsogeny = {0};
+    f2elm_t t;
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+    bool passed = true;
+        
+    // Allocating memory for private keys, public keys and shared secrets
+    PrivateKeyA = (unsigned char*)calloc(1, obytes);           // One element in [1, order]  
+    PrivateKeyB = (unsigned char*)calloc(1, obytes);
+    PublicKeyA = (unsigned char*)calloc(1, 3*2*pbytes);        // Three elements in GF(p^2)
+    PublicKeyB = (unsigned char*)calloc(1, 3*2*pbytes);
+    PublicKeyA_mont = (unsigned char*)calloc(1, 3*2*pbytes);
+    PublicKeyB_mont = (unsigned char*)calloc(1, 3*2*pbytes);
+    SharedSecretA = (unsigned char*)calloc(1, 2*pbytes);       // One element in GF(p^2)  
+    SharedSecretB = (unsigned char*)calloc(1, 2*pbytes);
+    SharedSecret_mont = (unsigned char*)calloc(1, 2*pbytes);
+    CompressedPK = (unsigned char*)calloc(1, cbytes);
+    CompressedPK_mont = (unsigned char*)calloc(1, cbytes);
+    zero = (unsigned char*)calloc(1, cbytes);
+
+    printf("\n\nTESTING KEY EXCHANGE WITH MONTGOMERY WIRE ENCODING \n");
+    printf("--------------------------------------------------------------------------------------------------------\n\n");
+    printf("Curve isogeny system: %s \n\n", CurveIsogenyData->CurveIsogeny);
+
+    // Curve isogeny system initialization
+    CurveIsogeny = SIDH_curve_allocate(CurveIsogenyData);
+    if (CurveIsogeny == NULL) {
+        Status = CRYPTO_ERROR_NO_MEMORY;
+        goto cleanup;
+    }
+    Status = SIDH_curve_initialize(CurveIsogeny, &random_bytes_test, CurveIsogenyData);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+
+    for (i = 0; i < TEST_LOOPS && passed; i++) 
+    {
+        seed = (unsigned int)rand();                                                                         // Same key pairs with both encodings
+        SIDH_curve_set_encoding(CurveIsogeny, SIDH_ENCODING_STANDARD);
+        srand(seed);
+        Status = EphemeralKeyGeneration_A(PrivateKeyA, PublicKeyA, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = EphemeralKeyGeneration_B(PrivateKeyB, PublicKeyB, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = EphemeralSecretAgreement_A(PrivateKeyA, PublicKeyB, SharedSecretA, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+
+        SIDH_curve_set_encoding(CurveIsogeny, SIDH_ENCODING_MONTGOMERY);
+        srand(seed);
+        Status = EphemeralKeyGeneration_A(PrivateKeyA, PublicKeyA_mont, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = EphemeralKeyGeneration_B(PrivateKeyB, PublicKeyB_mont, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = EphemeralSecretAgreement_A(PrivateKeyA, PublicKeyB_mont, SharedSecret_mont, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = EphemeralSecretAgreement_B(PrivateKeyB, PublicKeyA_mont, SharedSecretB, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+
+        for (j = 0; j < 3; j++) {                                                                            // The Montgomery encoding is a*R mod p751, fully reduced
+            to_fp2mont(((f2elm_t*)PublicKeyA)[j], t);
+            fp2correction751(t);
+            passed = passed && (memcmp(t, ((f2elm_t*)PublicKeyA_mont)[j], 2*pbytes) == 0);
+            to_fp2mont(((f2elm_t*)PublicKeyB)[j], t);
+            fp2correction751(t);
+            passed = passed && (memcmp(t, ((f2elm_t*)PublicKeyB_mont)[j], 2*pbytes) == 0);
+        }
+        to_fp2mont((felm_t*)SharedSecretA, t);
+        fp2correction751(t);
+        passed = passed && (memcmp(t, SharedSecret_mont, 2*pbytes) == 0) && (memcmp(SharedSecretB, SharedSecret_mont, 2*pbytes) == 0);
+
+        if (i == 0) {                                                                                        // Compression does not depend on the wire encoding
+            if (PublicKeyCompression_Checked_A(PublicKeyA_mont, CompressedPK_mont, CurveIsogeny) != CRYPTO_SUCCESS) {
+                passed = false;
+            }
+            SIDH_curve_set_encoding(CurveIsogeny, SIDH_ENCODING_STANDARD);
+            PublicKeyCompression_A(PublicKeyA, CompressedPK, CurveIsogeny);
+            SIDH_curve_set_encoding(CurveIsogeny, SIDH_ENCODING_MONTGOMERY);
+            passed = passed && (memcmp(CompressedPK, CompressedPK_mont, cbytes) == 0) && (memcmp(CompressedPK, zero, cbytes) != 0);
+        }
+
+        memset(((f2elm_t*)PublicKeyB_mont)[i % 3][i % 2], 0xFF, pbytes);                                    // A non-reduced coordinate must be rejected
+        if (EphemeralSecretAgreement_A(PrivateKeyA, PublicKeyB_mont, SharedSecret_mont, CurveIsogeny) != CRYPTO_ERROR_PUBLIC_KEY_VALIDATION) {
+            passed = false;
+        }
+        memset(CompressedPK_mont, 0xAA, cbytes);                                                            // and must not be compressed
+        if (PublicKeyCompression_Checked_B(PublicKeyB_mont, CompressedPK_mont, CurveIsogeny) != CRYPTO_ERROR_PUBLIC_KEY_VALIDATION) {
+            passed = false;
+        }
+        passed = passed && (memcmp(CompressedPK_mont, zero, cbytes) == 0);
+    }
+
+    if (passed == true) printf("  Key exchange tests with Montgomery encoding .................. PASSED");
+    else { printf("  Key exchange tests with Montgomery encoding ... FAILED"); printf("\n"); Status = CRYPTO_ERROR_SHARED_KEY; goto cleanup; }
+    printf("\n"); 
+
+cleanup:
+    SIDH_curve_free(CurveIsogeny);    
+    free(PrivateKeyA);    
+    free(PrivateKeyB);    
+    free(PublicKeyA);    
+    free(PublicKeyB);    
+    free(PublicKeyA_mont);    
+    free(PublicKeyB_mont);    
+    free(SharedSecretA);    
+    free(SharedSecretB);
+    free(SharedSecret_mont);
+    free(CompressedPK);
+    free(CompressedPK_mont);
+    free(zero);
+
+    return Status;
+}
+
+
+CRYPTO_STATUS cryptotest_packed(PCurveIsogenyStaticData CurveIsogenyData)
+{ // Testing key exchange with packed public keys and shared secrets, alternating the standard and Montgomery encodings
+    unsigned int i, j, seed, pbytes = (CurveIsogenyData->pwordbits + 7)/8;   // Number of bytes in a field element 
+    unsigned int obytes = (CurveIsogenyData->owordbits + 7)/8;               // Number of bytes in an element in [1, order]
+    unsigned char *PrivateKeyA, *PrivateKeyB, *PublicKeyA, *PublicKeyB, *SharedSecretA, *PrivateKey_tmp, *PackedA, *PackedB, *PackedSS;
+    PCurveIsogenyStruct CurveIsogeny = {0};
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+    bool passed = true;
+        
+    // Allocating memory for private keys, public keys and shared secrets. The packed buffers are deliberately misaligned
+    PrivateKeyA = (unsigned char*)calloc(1, obytes);                        // One element in [1, order]  
+    PrivateKeyB = (unsigned char*)calloc(1, obytes);
+    PrivateKey_tmp = (unsigned char*)calloc(1, obytes);
+    PublicKeyA = (unsigned char*)calloc(1, 3*2*pbytes);                     // Three elements in GF(p^2)
+    PublicKeyB = (unsigned char*)calloc(1, 3*2*pbytes);
+    SharedSecretA = (unsigned char*)calloc(1, 2*pbytes);                    // One element in GF(p^2)  
+    PackedA = (unsigned char*)calloc(1, 3*2*NBYTES_PACKED_FIELD + 1);       // Three packed elements in GF(p^2)
+    PackedB = (unsigned char*)calloc(1, 3*2*NBYTES_PACKED_FIELD + 1);
+    PackedSS = (unsigned char*)calloc(1, 2*NBYTES_PACKED_FIELD + 1);        // One packed element in GF(p^2)
+
+    printf("\n\nTESTING KEY EXCHANGE WITH PACKED KEYS \n");
+    printf("--------------------------------------------------------------------------------------------------------\n\n");
+    printf("Curve isogeny system: %s \n\n", CurveIsogenyData->CurveIsogeny);
+
+    // Curve isogeny system initialization
+    CurveIsogeny = SIDH_curve_allocate(CurveIsogenyData);
+    if (CurveIsogeny == NULL) {
+        Status = CRYPTO_ERROR_NO_MEMORY;
+        goto cleanup;
+    }
+    Status = SIDH_curve_initialize(CurveIsogeny, &random_bytes_test, CurveIsogenyData);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+
+    for (i = 0; i < TEST_LOOPS && passed; i++) 
+    {
+        SIDH_curve_set_encoding(CurveIsogeny, (i%2 == 0) ? SIDH_ENCODING_STANDARD : SIDH_ENCODING_MONTGOMERY);
+        seed = (unsigned int)rand();                                                                         // Same key pairs with both formats
+        srand(seed);
+        Status = EphemeralKeyGeneration_A(PrivateKeyA, PublicKeyA, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = EphemeralKeyGeneration_B(PrivateKeyB, PublicKeyB, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = EphemeralSecretAgreement_A(PrivateKeyA, PublicKeyB, SharedSecretA, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+
+        srand(seed);
+        Status = EphemeralKeyGeneration_Packed_A(PrivateKey_tmp, PackedA+1, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        passed = passed && (memcmp(PrivateKey_tmp, PrivateKeyA, obytes) == 0);
+        Status = EphemeralKeyGeneration_Packed_B(PrivateKey_tmp, PackedB+1, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        passed = passed && (memcmp(PrivateKey_tmp, PrivateKeyB, obytes) == 0);
+
+        for (j = 0; j < 6; j++) {                                                                            // Each packed element is the unpacked one without its two zero padding bytes
+            passed = passed && (memcmp(PackedA+1 + j*NBYTES_PACKED_FIELD, PublicKeyA + j*pbytes, NBYTES_PACKED_FIELD) == 0);
+            passed = passed && (memcmp(PackedB+1 + j*NBYTES_PACKED_FIELD, PublicKeyB + j*pbytes, NBYTES_PACKED_FIELD) == 0);
+            passed = passed && (PublicKeyA[j*pbytes + pbytes-1] == 0) && (PublicKeyA[j*pbytes + pbytes-2] == 0);
+        }
+
+        Status = EphemeralSecretAgreement_Packed_A(PrivateKeyA, PackedB+1, PackedSS+1, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        for (j = 0; j < 2; j++) {
+            passed = passed && (memcmp(PackedSS+1 + j*NBYTES_PACKED_FIELD, SharedSecretA + j*pbytes, NBYTES_PACKED_FIELD) == 0);
+        }
+        Status = EphemeralSecretAgreement_Packed_B(PrivateKeyB, PackedA+1, PackedSS+1, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        for (j = 0; j < 2; j++) {
+            passed = passed && (memcmp(PackedSS+1 + j*NBYTES_PACKED_FIELD, SharedSecretA + j*pbytes, NBYTES_PACKED_FIELD) == 0);
+        }
+
+        memset(PackedB+1 + (i%6)*NBYTES_PACKED_FIELD, 0xFF, NBYTES_PACKED_FIELD);                             // A non-reduced element must be rejected
+        if (EphemeralSecretAgreement_Packed_A(PrivateKeyA, PackedB+1, PackedSS+1, CurveIsogeny) != CRYPTO_ERROR_PUBLIC_KEY_VALIDATION) {
+            passed = false;
+        }
+    }
+
+    if (passed == true) printf("  Key exchange tests with packed keys .......................... PASSED");
+    else { printf("  Key exchange tests with packed keys ... FAILED"); printf("\n"); Status = CRYPTO_ERROR_SHARED_KEY; goto cleanup; }
+    printf("\n"); 
+
+cleanup:
+    SIDH_curve_free(CurveIsogeny);    
+    free(PrivateKeyA);    
+    free(PrivateKeyB);    
+    free(PrivateKey_tmp);    
+    free(PublicKeyA);    
+    free(PublicKeyB);    
+    free(SharedSecretA);    
+    free(PackedA);
+    free(PackedB);
+    free(PackedSS);
+
+    return Status;
+}
+
+
+CRYPTO_STATUS cryptotest_unaligned(PCurveIsogenyStaticData CurveIsogenyData)
+{ // Testing key exchange with public keys and shared secrets at unaligned offsets of aligned key buffers, alternating the standard and Montgomery encodings
+    unsigned int i, seed, offset, pbytes = (CurveIsogenyData->pwordbits + 7)/8;    // Number of bytes in a field element 
+    unsigned int obytes = (CurveIsogenyData->owordbits + 7)/8;                     // Number of bytes in an element in [1, order]
+    unsigned int cbytes = 3*obytes + 2*pbytes;                                     // Number of bytes in a compressed public key
+    unsigned int kA = 1, kB = kA + obytes, cA = kB + obytes, cB = cA + cbytes;     // Odd offsets of the compressed exchange buffers in Odd
+    unsigned int pR = cB + cbytes, pA = pR + 2*2*pbytes, sA = pA + 2*pbytes, sB = sA + 2*pbytes;
+    unsigned char *PrivateKeyA, *PrivateKeyB, *PrivateKey_tmp, *Ring = NULL, *Odd = NULL;
+    PublicKeyBuffer PublicKeyA, PublicKeyB;
+    SharedSecretBuffer SharedSecretA;
+    PCurveIsogenyStruct CurveIsogeny = {0};
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+    bool passed = true;
+        
+    // Allocating memory for private keys and for a buffer holding two public keys and a shared secret at any offset
+    PrivateKeyA = (unsigned char*)calloc(1, obytes);                        // One element in [1, order]  
+    PrivateKeyB = (unsigned char*)calloc(1, obytes);
+    PrivateKey_tmp = (unsigned char*)calloc(1, obytes);
+    Ring = SIDH_key_buffer_allocate(2*3*2*pbytes + 2*pbytes + sizeof(digit_t));    
+    Odd = (unsigned char*)calloc(1, sB + 2*pbytes);
+
+    printf("\n\nTESTING KEY EXCHANGE WITH UNALIGNED KEYS \n");
+    printf("--------------------------------------------------------------------------------------------------------\n\n");
+    printf("Curve isogeny system: %s \n\n", CurveIsogenyData->CurveIsogeny);
+
+    if (PrivateKeyA == NULL || PrivateKeyB == NULL || PrivateKey_tmp == NULL || Ring == NULL || Odd == NULL) {
+        Status = CRYPTO_ERROR_NO_MEMORY;
+        goto cleanup;
+    }
+    passed = passed && (((uintptr_t)Ring % SIDH_KEY_ALIGNMENT) == 0);
+
+    // Curve isogeny system initialization
+    CurveIsogeny = SIDH_curve_allocate(CurveIsogenyData);
+    if (CurveIsogeny == NULL) {
+        Status = CRYPTO_ERROR_NO_MEMORY;
+        goto cleanup;
+    }
+    Status = SIDH_curve_initialize(CurveIsogeny, &random_bytes_test, CurveIsogenyData);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+
+    for (i = 0; i < TEST_LOOPS && passed; i++) 
+    {
+        SIDH_curve_set_encoding(CurveIsogeny, (i%2 == 0) ? SIDH_ENCODING_STANDARD : SIDH_ENCODING_MONTGOMERY);
+        offset = i % sizeof(digit_t);                                                                        // Aligned once every sizeof(digit_t) iterations
+        seed = (unsigned int)rand();                                                                         // Same key pairs with both buffers
+        srand(seed);
+        Status = EphemeralKeyGeneration_A(PrivateKeyA, PublicKeyA.bytes, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = EphemeralKeyGeneration_B(PrivateKeyB, PublicKeyB.bytes, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = EphemeralSecretAgreement_A(PrivateKeyA, PublicKeyB.bytes, SharedSecretA.bytes, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+
+        srand(seed);
+        Status = EphemeralKeyGeneration_A(PrivateKey_tmp, &Ring[offset], CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = EphemeralKeyGeneration_B(PrivateKey_tmp, &Ring[offset + 3*2*pbytes], CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        passed = passed && (memcmp(&Ring[offset], PublicKeyA.bytes, 3*2*pbytes) == 0) && (memcmp(&Ring[offset + 3*2*pbytes], PublicKeyB.bytes, 3*2*pbytes) == 0);
+
+        Status = EphemeralSecretAgreement_A(PrivateKeyA, &Ring[offset + 3*2*pbytes], &Ring[offset + 2*3*2*pbytes], CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        passed = passed && (memcmp(&Ring[offset + 2*3*2*pbytes], SharedSecretA.bytes, 2*pbytes) == 0);
+        Status = EphemeralSecretAgreement_B(PrivateKeyB, &Ring[offset], &Ring[offset + 2*3*2*pbytes], CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        passed = passed && (memcmp(&Ring[offset + 2*3*2*pbytes], SharedSecretA.bytes, 2*pbytes) == 0);
+
+        if (i%2 == 1) {                                                                                      // A non-reduced Montgomery encoding must be rejected
+            memset(&Ring[offset + 3*2*pbytes + (i%6)*pbytes], 0xFF, pbytes);
+            if (EphemeralSecretAgreement_A(PrivateKeyA, &Ring[offset + 3*2*pbytes], &Ring[offset + 2*3*2*pbytes], CurveIsogeny) != CRYPTO_ERROR_PUBLIC_KEY_VALIDATION) {
+                passed = false;
+            }
+        }
+    }
+
+    // Key exchange with compressed public keys, with private keys, compressed keys, decompressed data and shared secrets at odd offsets
+    SIDH_curve_set_encoding(CurveIsogeny, SIDH_ENCODING_STANDARD);
+    Status = EphemeralKeyGeneration_Compressed_A(&Odd[kA], &Odd[cA], CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    Status = EphemeralKeyGeneration_Compressed_B(&Odd[kB], &Odd[cB], CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    PublicKeyBDecompression_A(&Odd[kA], &Odd[cB], &Odd[pR], &Odd[pA], CurveIsogeny);
+    Status = EphemeralSecretAgreement_Compression_A(&Odd[kA], &Odd[pR], &Odd[pA], &Odd[sA], CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    Status = EphemeralSecretAgreement_FromCompressed_B(&Odd[kB], &Odd[cA], &Odd[sB], CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    passed = passed && (memcmp(&Odd[sA], &Odd[sB], 2*pbytes) == 0);
+
+    if (passed == true) printf("  Key exchange tests with unaligned keys ....................... PASSED");
+    else { printf("  Key exchange tests with unaligned keys ... FAILED"); printf("\n"); Status = CRYPTO_ERROR_SHARED_KEY; goto cleanup; }
+    printf("\n"); 
+
+cleanup:
+    SIDH_curve_free(CurveIsogeny);    
+    free(PrivateKeyA);    
+    free(PrivateKeyB);    
+    free(PrivateKey_tmp);    
+    SIDH_key_buffer_free(Ring, 2*3*2*pbytes + 2*pbytes + sizeof(digit_t));
+    free(Odd);
+
+    return Status;
+}
+
+
+#if defined(SIDH_PTHREADS)
+typedef struct {
+    PCurveIsogenyStruct CurveIsogeny;
+    unsigned char*      PrivateKey;
+    CRYPTO_STATUS       Status;
+} drbg_thread_arg;
+
+
+static void* drbg_thread(void* arg)
+{ // Sample a private key from the DRBG of a new thread, which exits without calling SIDH_drbg_thread_free()
+    drbg_thread_arg* t = (drbg_thread_arg*)arg;
+
+    t->Status = random_mod_order((digit_t*)t->PrivateKey, ALICE, t->CurveIsogeny);
+    return NULL;
+}
+#endif
+
+
+CRYPTO_STATUS cryptotest_drbg(PCurveIsogenyStaticData CurveIsogenyData)
+{ // Testing key exchange with private keys sampled from the built-in DRBG, including a fork() of the process on Linux
+    unsigned int i, pbytes = (CurveIsogenyData->pwordbits + 7)/8;      // Number of bytes in a field element 
+    unsigned int obytes = (CurveIsogenyData->owordbits + 7)/8;         // Number of bytes in an element in [1, order]
+    unsigned char *PrivateKeyA, *PublicKeyA, *PrivateKeyB, *PublicKeyB, *SharedSecretA, *SharedSecretB, *PrivateKey_tmp;
+    PCurveIsogenyStruct CurveIsogeny = {0};
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+    bool passed = true;
+#if (OS_TARGET == OS_LINUX)
+    int fd[2];
+    pid_t pid;
+#endif
+#if defined(SIDH_PTHREADS)
+    pthread_t thread;
+    drbg_thread_arg t;
+#endif
+        
+    // Allocating memory for private keys, public keys and shared secrets
+    PrivateKeyA = (unsigned char*)calloc(1, obytes);        // One element in [1, order]  
+    PrivateKeyB = (unsigned char*)calloc(1, obytes);
+    PrivateKey_tmp = (unsigned char*)calloc(1, obytes);
+    PublicKeyA = (unsigned char*)calloc(1, 3*2*pbytes);     // Three elements in GF(p^2)
+    PublicKeyB = (unsigned char*)calloc(1, 3*2*pbytes);
+    SharedSecretA = (unsigned char*)calloc(1, 2*pbytes);    // One element in GF(p^2)  
+    SharedSecretB = (unsigned char*)calloc(1, 2*pbytes);
+
+    printf("\n\nTESTING KEY EXCHANGE WITH THE BUILT-IN DRBG \n");
+    printf("--------------------------------------------------------------------------------------------------------\n\n");
+    printf("Curve isogeny system: %s \n\n", CurveIsogenyData->CurveIsogeny);
+
+    // Curve isogeny system initialization
+    CurveIsogeny = SIDH_curve_allocate(CurveIsogenyData);
+    if (CurveIsogeny == NULL) {
+        Status = CRYPTO_ERROR_NO_MEMORY;
+        goto cleanup;
+    }
+    Status = SIDH_curve_initialize(CurveIsogeny, &random_bytes_test, CurveIsogenyData);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    Status = SIDH_curve_set_random_source(CurveIsogeny, SIDH_RANDOM_DRBG);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+
+    for (i = 0; i < TEST_LOOPS && passed; i++) 
+    {
+        Status = EphemeralKeyGeneration_A(PrivateKeyA, PublicKeyA, CurveIsogeny);            // Get some value as Alice's secret key and compute Alice's public key
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = EphemeralKeyGeneration_B(PrivateKeyB, PublicKeyB, CurveIsogeny);            // Get some value as Bob's secret key and compute Bob's public key
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = EphemeralSecretAgreement_A(PrivateKeyA, PublicKeyB, SharedSecretA, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = EphemeralSecretAgreement_B(PrivateKeyB, PublicKeyA, SharedSecretB, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        passed = passed && (memcmp(SharedSecretA, SharedSecretB, 2*pbytes) == 0);
+
+        Status = random_mod_order((digit_t*)PrivateKey_tmp, ALICE, CurveIsogeny);           // Consecutive keys must differ
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        passed = passed && (memcmp(PrivateKey_tmp, PrivateKeyA, obytes) != 0);
+    }
+
+#if (OS_TARGET == OS_LINUX)
+    if (passed && pipe(fd) == 0) {                                                           // A child process must not repeat the keys of its parent
+        pid = fork();
+        if (pid == 0) {
+            if (random_mod_order((digit_t*)PrivateKey_tmp, ALICE, CurveIsogeny) != CRYPTO_SUCCESS || write(fd[1], PrivateKey_tmp, obytes) != (ssize_t)obytes) {
+                _exit(1);
+            }
+            _exit(0);
+        }
+        close(fd[1]);
+        Status = random_mod_order((digit_t*)PrivateKeyA, ALICE, CurveIsogeny);
+        passed = passed && (pid > 0) && (read(fd[0], PrivateKey_tmp, obytes) == (ssize_t)obytes) && (memcmp(PrivateKey_tmp, PrivateKeyA, obytes) != 0);
+        close(fd[0]);
+        if (pid > 0) {
+            waitpid(pid, NULL, 0);
+        }
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+    }
+#endif
+#if defined(SIDH_PTHREADS)
+    t.CurveIsogeny = CurveIsogeny;                                                           // The state of an exiting thread is freed by its destructor
+    t.PrivateKey = PrivateKey_tmp;
+    t.Status = CRYPTO_ERROR_UNKNOWN;
+    for (i = 0; i < 4 && passed; i++) {
+        passed = (pthread_create(&thread, NULL, drbg_thread, (void*)&t) == 0) && (pthread_join(thread, NULL) == 0) && (t.Status == CRYPTO_SUCCESS);
+        passed = passed && (memcmp(PrivateKey_tmp, PrivateKeyA, obytes) != 0);
+    }
+#endif
+    SIDH_drbg_thread_free();
+
+    if (passed == true) printf("  Key exchange tests with the DRBG ............................. PASSED");
+    else { printf("  Key exchange tests with the DRBG ... FAILED"); printf("\n"); Status = CRYPTO_ERROR_SHARED_KEY; goto cleanup; }
+    printf("\n"); 
+
+cleanup:
+    SIDH_curve_free(CurveIsogeny);    
+    free(PrivateKeyA);    
+    free(PublicKeyA);
+    free(PrivateKeyB);    
+    free(PublicKeyB);
+    free(PrivateKey_tmp);    
+    free(SharedSecretA);
+    free(SharedSecretB);
+
+    return Status;
+}
+
+
+static CRYPTO_STATUS random_bytes_zeros(unsigned int nbytes, unsigned char* random_array)
+{ // Output "nbytes" zero bytes, the smallest sample of the random source
+    memset(random_array, 0x00, nbytes);
+    return CRYPTO_SUCCESS;
+}
+
+
+static CRYPTO_STATUS random_bytes_ones(unsigned int nbytes, unsigned char* random_array)
+{ // Output "nbytes" 0xFF bytes, the largest sample of the random source
+    memset(random_array, 0xFF, nbytes);
+    return CRYPTO_SUCCESS;
+}
+
+
+CRYPTO_STATUS cryptotest_key_sampling(PCurveIsogenyStaticData CurveIsogenyData)
+{ // Testing private-key sampling by reduction: ranges, extreme samples, batches and key exchange
+    unsigned int i, j, k, w, seed, pbytes = (CurveIsogenyData->pwordbits + 7)/8; // Number of bytes in a field element 
+    unsigned int obytes = (CurveIsogenyData->owordbits + 7)/8;                   // Number of bytes in an element in [1, order]
+    unsigned char *PrivateKeyA, *PublicKeyA, *PrivateKeyB, *PublicKeyB, *SharedSecretA, *SharedSecretB;
+    digit_t keys[4*NWORDS_ORDER], key[NWORDS_ORDER], t[NWORDS_ORDER], mod3;
+    uint64_t two[NWORDS64_ORDER] = {2}, three[NWORDS64_ORDER] = {3}, two_78[NWORDS64_ORDER] = {0, 0x4000};
+    uint64_t Bob_ones[NWORDS64_ORDER] = {0x180849FCF88CF80A, 0x23794D2740717C16, 0xBC820BC713658837, 0xF2ECA8FEAABAC4CC, 0x0CDF5787415456F3, 0x0468F892356E8005};   // 3*((2^448-1) mod 3^238)
+    PCurveIsogenyStruct CurveIsogeny = {0};
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+    bool passed = true;
+        
+    // Allocating memory for private keys, public keys and shared secrets
+    PrivateKeyA = (unsigned char*)calloc(1, obytes);        // One element in [1, order]  
+    PrivateKeyB = (unsigned char*)calloc(1, obytes);
+    PublicKeyA = (unsigned char*)calloc(1, 3*2*pbytes);     // Three elements in GF(p^2)
+    PublicKeyB = (unsigned char*)calloc(1, 3*2*pbytes);
+    SharedSecretA = (unsigned char*)calloc(1, 2*pbytes);    // One element in GF(p^2)  
+    SharedSecretB = (unsigned char*)calloc(1, 2*pbytes);
+
+    printf("\n\nTESTING PRIVATE-KEY SAMPLING BY REDUCTION \n");
+    printf("--------------------------------------------------------------------------------------------------------\n\n");
+    printf("Curve isogeny system: %s \n\n", CurveIsogenyData->CurveIsogeny);
+
+    // Curve isogeny system initialization
+    CurveIsogeny = SIDH_curve_allocate(CurveIsogenyData);
+    if (CurveIsogeny == NULL) {
+        Status = CRYPTO_ERROR_NO_MEMORY;
+        goto cleanup;
+    }
+    Status = SIDH_curve_initialize(CurveIsogeny, &random_bytes_test, CurveIsogenyData);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    Status = SIDH_curve_set_key_sampling(CurveIsogeny, SIDH_SAMPLING_REDUCTION);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+
+    // Extreme samples: all-zero samples give the smallest keys, all-one samples are reduced
+    CurveIsogeny->RandomBytesFunction = &random_bytes_zeros;
+    random_mod_order(key, ALICE, CurveIsogeny);
+    passed = passed && (compare_words(key, (digit_t*)two, NWORDS_ORDER) == 0);
+    random_mod_order(key, BOB, CurveIsogeny);
+    passed = passed && (compare_words(key, (digit_t*)three, NWORDS_ORDER) == 0);
+    CurveIsogeny->RandomBytesFunction = &random_bytes_ones;
+    random_mod_order(key, ALICE, CurveIsogeny);
+    passed = passed && (compare_words(key, (digit_t*)two_78, NWORDS_ORDER) == 0);
+    random_mod_order(key, BOB, CurveIsogeny);
+    passed = passed && (compare_words(key, (digit_t*)Bob_ones, NWORDS_ORDER) == 0);
+    CurveIsogeny->RandomBytesFunction = &random_bytes_test;
+
+    for (i = 0; i < TEST_LOOPS && passed; i++) 
+    {
+        for (k = ALICE; k <= BOB; k++) {
+            seed = (unsigned int)rand();                                                     // A batch consumes the same samples as consecutive keys
+            srand(seed);
+            Status = random_mod_order_batch(keys, 4, k, CurveIsogeny);
+            if (Status != CRYPTO_SUCCESS) {
+                goto cleanup;
+            }
+            srand(seed);
+            for (j = 0; j < 4; j++) {
+                Status = random_mod_order(key, k, CurveIsogeny);
+                if (Status != CRYPTO_SUCCESS) {
+                    goto cleanup;
+                }
+                passed = passed && (compare_words(key, &keys[j*NWORDS_ORDER], NWORDS_ORDER) == 0);
+                passed = passed && (mp_sub(key, (k == ALICE) ? CurveIsogeny->Aorder : CurveIsogeny->Border, t, NWORDS_ORDER) == 1);    // key < order
+                if (k == ALICE) {
+                    passed = passed && ((key[0] & 1) == 0) && (key[0] != 0 || key[1] != 0);                 // Even and nonzero
+                } else {
+                    mod3 = 0;
+                    for (w = 0; w < NWORDS_ORDER; w++) {                                                    // 2^RADIX = 1 mod 3
+                        mod3 += key[w] % 3;
+                    }
+                    passed = passed && (mod3 % 3 == 0) && (key[0] != 0 || key[1] != 0);                   // Multiple of 3 and nonzero
+                }
+            }
+        }
+
+        Status = EphemeralKeyGeneration_A(PrivateKeyA, PublicKeyA, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = EphemeralKeyGeneration_B(PrivateKeyB, PublicKeyB, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = EphemeralSecretAgreement_A(PrivateKeyA, PublicKeyB, SharedSecretA, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = EphemeralSecretAgreement_B(PrivateKeyB, PublicKeyA, SharedSecretB, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        passed = passed && (memcmp(SharedSecretA, SharedSecretB, 2*pbytes) == 0);
+    }
+
+    if (passed == true) printf("  Private-key sampling tests ................................... PASSED");
+    else { printf("  Private-key sampling tests ... FAILED"); printf("\n"); Status = CRYPTO_ERROR_SHARED_KEY; goto cleanup; }
+    printf("\n"); 
+
+cleanup:
+    SIDH_curve_free(CurveIsogeny);    
+    free(PrivateKeyA);    
+    free(PublicKeyA);
+    free(PrivateKeyB);    
+    free(PublicKeyB);
+    free(SharedSecretA);
+    free(SharedSecretB);
+
+    return Status;
+}
+
+
+#if (OS_TARGET == OS_LINUX)
+
+// Used in stack measurements
+#define STACK_PAINT           0xA5
+#define STACK_NFUNCTIONS      21
+
+static PCurveIsogenyStruct stack_curve;
+static unsigned char *stack_SKA, *stack_SKB, *stack_PKA, *stack_PKB, *stack_CPKA, *stack_CPKB, *stack_SS, *stack_R, *stack_A, *stack_G, *stack_T;
+static unsigned int stack_function;
+static CRYPTO_STATUS stack_status;
+static ucontext_t stack_caller, stack_callee;
+static const char* stack_names[STACK_NFUNCTIONS] = { "EphemeralKeyGeneration_A", "EphemeralKeyGeneration_B", "EphemeralSecretAgreement_A", "EphemeralSecretAgreement_B",
+                                                     "PublicKeyCompression_A", "PublicKeyCompression_B", "PublicKeyADecompression_B", "PublicKeyBDecompression_A",
+                                                     "EphemeralSecretAgreement_Compression_A", "EphemeralSecretAgreement_Compression_B", "EphemeralSecretAgreement_FromCompressed_A",
+                                                     "EphemeralSecretAgreement_FromCompressed_B", "EphemeralKeyGeneration_Compressed_A", "EphemeralKeyGeneration_Compressed_B",
+                                                     "EphemeralKeyGeneration_Packed_A", "EphemeralKeyGeneration_Packed_B", "EphemeralSecretAgreement_Packed_A", 
+                                                     "EphemeralSecretAgreement_Packed_B", "BigMont_fixed_base_precompute", "BigMont_fixed_base", "BigMont_ladder" };
+
+
+static void stack_run_function(void)
+{ // Calls the API function selected by "stack_function" on the painted stack
+    digit_t scalar[BIGMONT_NWORDS_ORDER] = {0};
+
+    switch (stack_function) {
+    case 0:  stack_status = EphemeralKeyGeneration_A(stack_SKA, stack_PKA, stack_curve); break;
+    case 1:  stack_status = EphemeralKeyGeneration_B(stack_SKB, stack_PKB, stack_curve); break;
+    case 2:  stack_status = EphemeralSecretAgreement_A(stack_SKA, stack_PKB, stack_SS, stack_curve); break;
+    case 3:  stack_status = EphemeralSecretAgreement_B(stack_SKB, stack_PKA, stack_SS, stack_curve); break;
+    case 4:  PublicKeyCompression_A(stack_PKA, stack_CPKA, stack_curve); break;
+    case 5:  PublicKeyCompression_B(stack_PKB, stack_CPKB, stack_curve); break;
+    case 6:  PublicKeyADecompression_B(stack_SKB, stack_CPKA, stack_R, stack_A, stack_curve); break;
+    case 7:  PublicKeyBDecompression_A(stack_SKA, stack_CPKB, stack_R, stack_A, stack_curve); break;
+    case 8:  stack_status = EphemeralSecretAgreement_Compression_A(stack_SKA, stack_R, stack_A, stack_SS, stack_curve); break;
+    case 9:  stack_status = EphemeralSecretAgreement_Compression_B(stack_SKB, stack_R, stack_A, stack_SS, stack_curve); break;
+    case 10: stack_status = EphemeralSecretAgreement_FromCompressed_A(stack_SKA, stack_CPKB, stack_SS, stack_curve); break;
+    case 11: stack_status = EphemeralSecretAgreement_FromCompressed_B(stack_SKB, stack_CPKA, stack_SS, stack_curve); break;
+    case 12: stack_status = EphemeralKeyGeneration_Compressed_A(stack_SKA, stack_CPKA, stack_curve); break;
+    case 13: stack_status = EphemeralKeyGeneration_Compressed_B(stack_SKB, stack_CPKB, stack_curve); break;
+    case 14: stack_status = EphemeralKeyGeneration_Packed_A(stack_SKA, stack_PKA, stack_curve); break;
+    case 15: stack_status = EphemeralKeyGeneration_Packed_B(stack_SKB, stack_PKB, stack_curve); break;
+    case 16: stack_status = EphemeralSecretAgreement_Packed_A(stack_SKA, stack_PKB, stack_SS, stack_curve); break;
+    case 17: stack_status = EphemeralSecretAgreement_Packed_B(stack_SKB, stack_PKA, stack_SS, stack_curve); break;
+    case 18: stack_status = BigMont_fixed_base_precompute(stack_G, stack_T, stack_curve); break;
+    case 19: copy_words((digit_t*)scalar1, scalar, BIGMONT_NWORDS_ORDER);
+             stack_status = BigMont_fixed_base(stack_T, scalar, stack_SS, stack_curve); break;
+    default: copy_words((digit_t*)scalar1, scalar, BIGMONT_NWORDS_ORDER);
+             stack_status = BigMont_ladder(stack_PKA, scalar, stack_PKA, stack_curve); break;
+    }
+}
+
+
+static unsigned int stack_peak(unsigned char* stack, unsigned int function)
+{ // Runs an API function on a freshly painted stack and returns the number of bytes it touched
+    unsigned int i;
+
+    memset(stack, STACK_PAINT, STACK_MEASURE_BYTES);
+    getcontext(&stack_callee);
+    stack_callee.uc_stack.ss_sp = stack;
+    stack_callee.uc_stack.ss_size = STACK_MEASURE_BYTES;
+    stack_callee.uc_link = &stack_caller;
+    makecontext(&stack_callee, stack_run_function, 0);
+    stack_function = function;
+    swapcontext(&stack_caller, &stack_callee);
+
+    for (i = 0; i < STACK_MEASURE_BYTES && stack[i] == STACK_PAINT; i++);
+    return STACK_MEASURE_BYTES - i;
+}
+
+
+CRYPTO_STATUS cryptorun_stack(PCurveIsogenyStaticData CurveIsogenyData)
+{ // Measuring peak stack usage of the API functions
+  // Each function is executed on a separate, painted stack (as done by user-space fibers) and the high-water mark is reported.
+    unsigned int i, pbytes = (CurveIsogenyData->pwordbits + 7)/8;   // Number of bytes in a field element 
+    unsigned int obytes = (CurveIsogenyData->owordbits + 7)/8;      // Number of bytes in an element in [1, order]
+    unsigned int peak, max_peak = 0;
+    unsigned char* stack;
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+
+    stack = (unsigned char*)malloc(STACK_MEASURE_BYTES);
+    stack_SKA = (unsigned char*)calloc(1, obytes);               // One element in [1, order]  
+    stack_SKB = (unsigned char*)calloc(1, obytes);
+    stack_PKA = (unsigned char*)calloc(1, 3*2*pbytes);           // Three elements in GF(p^2)
+    stack_PKB = (unsigned char*)calloc(1, 3*2*pbytes);
+    stack_CPKA = (unsigned char*)calloc(1, 3*obytes + 2*pbytes); // Three elements in [1, order] plus one field element
+    stack_CPKB = (unsigned char*)calloc(1, 3*obytes + 2*pbytes);
+    stack_SS = (unsigned char*)calloc(1, 2*pbytes);              // One element in GF(p^2)  
+    stack_R = (unsigned char*)calloc(1, 2*2*pbytes);             // One point in (X:Z) coordinates 
+    stack_A = (unsigned char*)calloc(1, 2*pbytes);               // One element in GF(p^2)  
+    stack_G = (unsigned char*)calloc(1, pbytes);                 // One element in GF(p)
+    stack_T = (unsigned char*)malloc(BIGMONT_FIXED_BASE_TABLE_BYTES);   // Fixed-base tables of BigMont
+
+    printf("\n\nMEASURING PEAK STACK USAGE \n");
+    printf("--------------------------------------------------------------------------------------------------------\n\n");
+#if defined(SIDH_BOUNDED_STACK)
+    printf("Bounded-stack mode: ON \n\n");
+#else
+    printf("Bounded-stack mode: OFF \n\n");
+#endif
+
+    // Curve isogeny system initialization
+    stack_curve = SIDH_curve_allocate(CurveIsogenyData);
+    if (stack == NULL || stack_curve == NULL || stack_G == NULL || stack_T == NULL) {
+        Status = CRYPTO_ERROR_NO_MEMORY;
+        goto cleanup;
+    }
+    stack_G[0] = 3;                                              // (3:1) has order BigMont_order
+    Status = SIDH_curve_initialize(stack_curve, &random_bytes_test, CurveIsogenyData);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+
+    // Functions are measured in the order in which a compressed key exchange uses them
+    for (i = 0; i < STACK_NFUNCTIONS; i++) {
+        stack_status = CRYPTO_SUCCESS;
+        peak = stack_peak(stack, i);
+        if (stack_status != CRYPTO_SUCCESS) {
+            Status = stack_status;
+            goto cleanup;
+        }
+        if (peak > max_peak) max_peak = peak;
+        printf("  %-42s peak stack usage ......... %8u bytes\n", stack_names[i], peak);
+    }
+    printf("  %-42s peak stack usage ......... %8u bytes\n", "Maximum over the API", max_peak);
+#if defined(SIDH_BOUNDED_STACK)
+    if (max_peak <= SIDH_MAX_STACK_BYTES) printf("  Peak stack usage within the bound of %u bytes ................ PASSED", SIDH_MAX_STACK_BYTES);
+    else { printf("  Peak stack usage within the bound of %u bytes ... FAILED", SIDH_MAX_STACK_BYTES); Status = CRYPTO_ERROR; }
+    printf("\n");
+#endif
+
+cleanup:
+    SIDH_curve_free(stack_curve);
+    free(stack);
+    free(stack_SKA);
+    free(stack_SKB);
+    free(stack_PKA);
+    free(stack_PKB);
+    free(stack_CPKA);
+    free(stack_CPKB);
+    free(stack_SS);
+    free(stack_R);
+    free(stack_A);
+    free(stack_G);
+    free(stack_T);
+
+    return Status;
+}
+
+#endif
+
+
+int main()
+{
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+    
+    Status = cryptotest_kex(&CurveIsogeny_SIDHp751);             // Test key exchange system "SIDHp751"
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptorun_kex(&CurveIsogeny_SIDHp751);              // Benchmark key exchange system "SIDHp751"
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+    
+    Status = cryptotest_kex_compress(&CurveIsogeny_SIDHp751);    // Test key exchange system "SIDHp751" using compression
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptorun_kex_compress(&CurveIsogeny_SIDHp751);     // Benchmark key exchange system "SIDHp751" using compression
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptotest_proj_constants(&CurveIsogeny_SIDHp751);  // Test the projective curve constants of the shared-secret path
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+    
+    Status = cryptotest_BigMont(&CurveIsogeny_SIDHp751);         // Test elliptic curve "BigMont"
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptorun_BigMont(&CurveIsogeny_SIDHp751);          // Benchmark elliptic curve "BigMont"
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptotest_models(&CurveIsogeny_SIDHp751);          // Test key exchange with every combination of curve models
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptorun_models(&CurveIsogeny_SIDHp751);           // Benchmark the curve models for each point operation
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptorun_strategies(&CurveIsogeny_SIDHp751);       // Tune the isogeny tree strategies to this machine
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptotest_isogeny_degrees(&CurveIsogeny_SIDHp751); // Test key exchange with trees of 8- and 9-isogenies
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptorun_isogeny_degrees(&CurveIsogeny_SIDHp751);  // Benchmark trees of 8- and 9-isogenies against 4- and 3-isogenies
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptotest_ph_workers(&CurveIsogeny_SIDHp751);      // Test compression with multithreaded discrete logarithms
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptorun_ph_workers(&CurveIsogeny_SIDHp751);       // Benchmark compression with 1, 2 and 4 workers
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptotest_encoding(&CurveIsogeny_SIDHp751);        // Test key exchange with the Montgomery wire encoding
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptotest_packed(&CurveIsogeny_SIDHp751);          // Test key exchange with packed keys
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptotest_unaligned(&CurveIsogeny_SIDHp751);       // Test key exchange with unaligned keys
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptotest_drbg(&CurveIsogeny_SIDHp751);            // Test key exchange with the built-in DRBG
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptotest_key_sampling(&CurveIsogeny_SIDHp751);    // Test private-key sampling by reduction
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+#if (OS_TARGET == OS_LINUX)
+    Status = cryptorun_stack(&CurveIsogeny_SIDHp751);            // Measure peak stack usage of the API
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+#endif
     
     return true;
 }